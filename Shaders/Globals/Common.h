@@ -30,13 +30,16 @@
 #define GlobalInstanceDataSSBOSlot      3
 #define SceneAABBsSSBOSlot              4
 #define PrevGlobalTransformDataSSBOSlot 5
+#define TransformScatterSSBOSlot        1
 
 #define GlobalGBufferPostProcessUBOSlot 1
 #define GlobalShadowMapUBOSlot          2
-#define RTSceneASBindingSlot            1
-#define RTInstanceHitDataBindingSlot    2
-#define RTSceneVertexBufferBindingSlot  3
-#define RTSceneIndexBufferBindingSlot   4
+#define RTSceneASBindingSlot              1
+#define RTInstanceHitDataBindingSlot      2
+#define RTSceneVertexBufferBindingSlot    3
+#define RTSceneIndexBufferBindingSlot     4
+#define RTSceneAttributeBufferBindingSlot 5
+#define RTSceneIndex16BufferBindingSlot   6
 
 // Canonical descriptor set indices (C++ and shader side must agree)
 #ifndef BindlessSet
@@ -3,6 +3,7 @@
 
 #include "GeometryPassData.h"
 #include "Utils/ScreenSpace.h"
+#include "VertexFormat.h"
 
 STRUCTDECL(GPUCompleteVertex)
     STRUCTFIELD(vec3, position)
@@ -38,6 +39,26 @@ FUNC_QUALIFIER mat3 BuildWorldTBN(mat4 worldMat, vec3 worldNormal, vec4 localTan
     vec3 worldBitangent = normalize(cross(worldNormal, worldTangent) * localTangent.w);
     return mat3(worldTangent, worldBitangent, worldNormal);
 }
+
+FUNC_QUALIFIER GPUCompleteVertex AssembleVertex(vec3 position, GPUCompleteVertexAttributes attributes)
+{
+    GPUCompleteVertex vertex;
+    vertex.position = position;
+    vertex.normal = attributes.normal;
+    vertex.tangent = attributes.tangent;
+    vertex.texCoord = attributes.texCoord;
+    return vertex;
+}
+
+FUNC_QUALIFIER GPUCompleteVertex AssembleVertex(vec3 position, GPUPackedVertexAttributes attributes)
+{
+    GPUCompleteVertex vertex;
+    vertex.position = position;
+    vertex.normal = DecodeOctahedral(unpackSnorm2x16(attributes.normalOct));
+    vertex.tangent = DecodePackedTangent(unpackSnorm2x16(attributes.tangentOct));
+    vertex.texCoord = unpackHalf2x16(attributes.texCoord);
+    return vertex;
+}
 #endif
 
 #endif // SHADERS_GEOMETRY_HELPERS_H
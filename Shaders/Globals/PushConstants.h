@@ -13,6 +13,10 @@ STRUCTDECL(FrustumCullingPushConstants)
     STRUCTFIELD(uint, objectCount)
 STRUCTEND()
 
+STRUCTDECL(TransformScatterPushConstants)
+    STRUCTFIELD(uint, entryCount)
+STRUCTEND()
+
 STRUCTDECL(TAAPushConstants)
     STRUCTFIELD(uint, frameIndex)
     STRUCTFIELD(uint, resetHistory)
@@ -18,13 +18,57 @@ struct IndexedIndirectDrawCmd
 };
 #endif
 
+// Meshes with at most 65536 vertices store 16 bit indices in their own index buffer
+// indexBufferOffset is always counted in elements of the buffer selected by indexType
+#define MESH_INDEX_TYPE_UINT32 0
+#define MESH_INDEX_TYPE_UINT16 1
+#define MESH_INDEX16_MAX_VERTICES 65536
+
+// Levels of detail per mesh including the full detail one, coarser levels index the same vertices
+#define MESH_MAX_LODS 4
+
 STRUCTDECL(MeshResourceData)
     STRUCTFIELD(uint, vertBufferOffset)
     STRUCTFIELD(uint, indexBufferOffset)
     STRUCTFIELD(uint, vertCount)
     STRUCTFIELD(uint, indexCount)
+    STRUCTFIELD(uint, indexType)
+    // Range in the meshlet buffer, meshlets only cover LOD 0
+    STRUCTFIELD(uint, meshletOffset)
+    STRUCTFIELD(uint, meshletCount)
+STRUCTEND()
+
+// Clusters of at most 64 vertices and 124 triangles, sized for mesh shading and fine grained culling
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+
+// vertexOffset and triangleOffset are counted in uints of the meshlet index buffer
+// Vertex entries are relative to the vertBufferOffset of the mesh, triangles are three 8 bit meshlet local indices
+// packed into one uint each. Backfacing if dot(center - viewPos, coneAxis) >= coneCutoff * |center - viewPos| + radius
+STRUCTDECL(MeshletData)
+    STRUCTFIELD(vec4, boundingSphere)
+    STRUCTFIELD(vec4, coneAxisCutoff)
+    STRUCTFIELD(uint, vertexOffset)
+    STRUCTFIELD(uint, triangleOffset)
+    STRUCTFIELD(uint, vertexCount)
+    STRUCTFIELD(uint, triangleCount)
 STRUCTEND()
 
+#ifndef __cplusplus
+// Bounds are in mesh local space, viewPos has to be transformed into the same space
+bool IsMeshletBackfacing(MeshletData meshlet, vec3 viewPos)
+{
+    vec3 toCenter = meshlet.boundingSphere.xyz - viewPos;
+    return dot(toCenter, meshlet.coneAxisCutoff.xyz) >=
+           meshlet.coneAxisCutoff.w * length(toCenter) + meshlet.boundingSphere.w;
+}
+
+uvec3 UnpackMeshletTriangle(uint packedTriangle)
+{
+    return uvec3(packedTriangle & 0xFF, (packedTriangle >> 8) & 0xFF, (packedTriangle >> 16) & 0xFF);
+}
+#endif
+
 STRUCTDECL(InstanceData)
     STRUCTFIELD(MeshResourceData, drawData)
     STRUCTFIELD(vec4, aabbCenterTransIdx)
@@ -0,0 +1,17 @@
+#ifndef SHADERS_TRANSFORM_SCATTER_H
+#define SHADERS_TRANSFORM_SCATTER_H
+#include "Types.h"
+
+#define TRANSFORM_SCATTER_TARGET_CURRENT 0u
+#define TRANSFORM_SCATTER_TARGET_PREV    1u
+#define TRANSFORM_SCATTER_TARGET_AABB    2u
+
+// One sparse update of the transform or scene AABB SSBOs, AABBs keep extents and center in the first two columns
+STRUCTDECL(TransformScatterEntry)
+    STRUCTFIELD(uint, dstIdx)
+    STRUCTFIELD(uint, target)
+    STRUCTFIELD(uint, pad0)
+    STRUCTFIELD(uint, pad1)
+    STRUCTFIELD(mat4, data)
+STRUCTEND()
+#endif // SHADERS_TRANSFORM_SCATTER_H
@@ -0,0 +1,60 @@
+#ifndef SHADERS_VERTEX_FORMAT_H
+#define SHADERS_VERTEX_FORMAT_H
+
+#include "Types.h"
+
+// Vertex layout of the scene geometry buffers, shared between the CPU upload path and every shader reading it
+// Positions always live in their own float3 stream (12 bytes) so depth only passes and BLAS builds touch nothing else
+// The attribute stream depends on the format:
+// Complete: float3 normal, float2 uv, float4 tangent (36 bytes)
+// Packed:   snorm16x4 octahedral normal.xy + tangent.xy, half2 uv (12 bytes)
+// The format is global instead of per mesh: every scene mesh is suballocated from the same attribute stream, each
+// geometry pass draws all of them with one pipeline through a single indirect draw, and RT hit shading indexes the
+// stream with one fixed stride. Per mesh formats would need a stream, a draw batch and a pipeline per format in the
+// GBuffer, depth and shadow passes plus a per instance format branch in the hit shaders
+// What that gives up: no mesh can opt out of packing. Half UVs step by 1/2048 in [0.5, 1) and get coarser with
+// tiling, so 4k textures or heavily tiled UVs snap between texels, and the tangent frame is quantized for everything
+// Meshes are cooked as CompleteVertex and only converted at upload, so switching the define only needs a shader and
+// engine rebuild, not a re-cook
+// Positions aren't quantized relative to the mesh AABB either, the BLAS builds read the position stream as float3
+// and every pass would need the per mesh decode scale. Neither per mesh selection nor position quantization exist
+#define SCENE_VERTEX_FORMAT_COMPLETE 0
+#define SCENE_VERTEX_FORMAT_PACKED   1
+
+#ifndef SCENE_VERTEX_FORMAT
+#define SCENE_VERTEX_FORMAT SCENE_VERTEX_FORMAT_PACKED
+#endif
+
+// Raw views of the attribute stream for storage buffer access (RT hit shading), scalar layout
+STRUCTDECL(GPUCompleteVertexAttributes)
+    STRUCTFIELD(vec3, normal)
+    STRUCTFIELD(vec2, texCoord)
+    STRUCTFIELD(vec4, tangent)
+STRUCTEND()
+
+STRUCTDECL(GPUPackedVertexAttributes)
+    STRUCTFIELD(uint, normalOct)
+    STRUCTFIELD(uint, tangentOct)
+    STRUCTFIELD(uint, texCoord)
+STRUCTEND()
+
+#ifndef __cplusplus
+FUNC_QUALIFIER vec3 DecodeOctahedral(vec2 f)
+{
+    vec3 n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+// The bitangent sign is folded into the sign of the second component, the magnitude is remapped to [0, 1]
+FUNC_QUALIFIER vec4 DecodePackedTangent(vec2 f)
+{
+    float tangentSign = f.y < 0.0 ? -1.0 : 1.0;
+    vec2 oct = vec2(f.x, abs(f.y) * 2.0 - 1.0);
+    return vec4(DecodeOctahedral(oct), tangentSign);
+}
+#endif
+
+#endif // SHADERS_VERTEX_FORMAT_H
@@ -8,9 +8,7 @@
 #include "SMAA.hlsl"
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inTangent;
 
 layout(location = 0) out vec2 texCoord;
 layout(location = 1) out vec2 pixCoord;
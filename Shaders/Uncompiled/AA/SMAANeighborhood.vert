@@ -4,9 +4,7 @@
 #extension GL_EXT_scalar_block_layout : enable
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
-layout(location = 3) in vec3 inTangent;
 
 layout(location = 0) out vec2 texCoord;
 layout(location = 1) out vec4 offset;
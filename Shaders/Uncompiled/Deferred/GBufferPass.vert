@@ -15,9 +15,14 @@
 
 
 layout(location = 0) in vec3 inPosition;
+#if SCENE_VERTEX_FORMAT == SCENE_VERTEX_FORMAT_PACKED
+layout(location = 1) in vec4 inNormalTangentOct;
+layout(location = 2) in vec2 inTexCoord0;
+#else
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord0;
 layout(location = 3) in vec4 inTangent;
+#endif
 
 layout(location = 0) out VertexOut
 {
@@ -37,10 +42,16 @@ void main()
     InstanceData iData = FetchInstanceData(instanceIdx);
     uint transformIdx = GetTransformIdx(iData);
     mat4 worldMat = FetchInstanceWorldMatrix(iData);
+#if SCENE_VERTEX_FORMAT == SCENE_VERTEX_FORMAT_PACKED
+    vec3 localNormal = DecodeOctahedral(inNormalTangentOct.xy);
+    vec4 localTangent = DecodePackedTangent(inNormalTangentOct.zw);
+#else
     vec3 localNormal = inNormal;
+    vec4 localTangent = inTangent;
+#endif
     OUT.worldNormal = TransformLocalNormalToWorld(worldMat, localNormal);
 
-    OUT.TBN = BuildWorldTBN(worldMat, OUT.worldNormal, inTangent);
+    OUT.TBN = BuildWorldTBN(worldMat, OUT.worldNormal, localTangent);
     OUT.matIdx = GetMaterialIdx(iData);
     OUT.fragTexCoord = inTexCoord0;
 
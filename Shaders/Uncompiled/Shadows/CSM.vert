@@ -13,9 +13,6 @@
 #include "../../Globals/GeometryPassData.h"
 
 layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec2 inTexCoord0;
-layout(location = 3) in vec4 inTangent;
 
 void main() {
     mat4 worldMat = FetchWorldMatrix(gl_InstanceIndex);
@@ -26,7 +26,7 @@ Application::Application(bool canRender, RenderLayer<RenderAPI>& layer)
     layer.InitRenderLayer(
         g_pWindowManager->GetScreenWidth(), g_pWindowManager->GetScreenHeight(), g_pWindowManager->GetTitle());
 
-    g_pGPUMemoryManager->Init();
+    g_pGPUMemoryManager->Init(CONV_GPU_ALLOCATOR);
     m_pProfiler->Init();
     g_pQueueHandler->Init();
     g_pTexManager->Init();
@@ -1,5 +1,7 @@
 #include "EntityManager.h"
 #include "Components/DebugRenderComponent.h"
+#include "Core/Global/GlobalVariables.h"
+#include "Core/SceneGraph/Mesh.h"
 #include "Systems/RenderThread/SRenderComponent.h"
 #include "Systems/RenderThread/SView.h"
 #include "Systems/SAABB.h"
@@ -93,6 +95,10 @@ Entity EntityManager::CreateEntity(const mathstl::Vector3& position, const stlty
 
 void EntityManager::DestroyEntity(Entity entity)
 {
+    // Scene unloads flush the mesh manager instead, single entities hand their instance back here
+    if (HasComponent<RenderComponent>(entity))
+        g_pMeshManager->RemoveMeshInstance(GetComponentUnsafe<RenderComponent>(entity)->pMesh);
+
     m_entities.erase(std::remove(m_entities.begin(), m_entities.end(), entity), m_entities.end());
     m_entityComponentMap.erase(entity);
     ClearCompIdx(entity.ID);
@@ -38,6 +38,11 @@ constexpr static inline mathstl::Vector2 CSM_DEFAULT_RES = mathstl::Vector2(4096
 constexpr static inline u32 MAX_BINDLESS_TEXTURES = 16536;
 constexpr static inline u32 MAX_MESHES = 8192;
 
+// GPU memory allocator the engine boots with, see Allocator in GPUMemoryManager.h
+#ifndef CONV_GPU_ALLOCATOR
+#define CONV_GPU_ALLOCATOR Allocator::VMA
+#endif
+
 #define SWAPCHAIN_FORMAT    FrameGlobals::GetSwapChainFormat()
 #define DEPTH_BUFFER_FORMAT TexFormat::D32_SFLOAT
 
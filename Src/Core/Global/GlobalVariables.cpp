@@ -3,6 +3,8 @@
 #include "Core/ECS/EntityManager.h"
 #include "Core/Events/EventSystem.h"
 #include "Core/Global/State/ApplicationState.h"
+#include "Core/Global/ThreadPool.h"
+#include "Core/IO/AssetCache.h"
 #include "Core/IO/FileReader.h"
 #include "Core/Rendering/Core/MaterialManager.h"
 #include "Core/Rendering/Core/ShaderManager.h"
@@ -24,6 +26,9 @@ stltype::unique_ptr<EventSystem> g_pEventSystem = stltype::make_unique<EventSyst
 stltype::unique_ptr<WindowManager> g_pWindowManager = nullptr;
 stltype::unique_ptr<ConsoleLogger> g_pConsoleLogger = stltype::make_unique<ConsoleLogger>();
 stltype::unique_ptr<TimeData> g_pGlobalTimeData = stltype::make_unique<TimeData>();
+// Ahead of the FileReader which submits to it, globals are destroyed in reverse order
+stltype::unique_ptr<ThreadPool> g_pJobPool = stltype::make_unique<ThreadPool>(CORE_COUNT_AVAILABLE);
+stltype::unique_ptr<AssetCache> g_pAssetCache = stltype::make_unique<AssetCache>();
 stltype::unique_ptr<FileReader> g_pFileReader = stltype::make_unique<FileReader>();
 stltype::unique_ptr<MaterialManager> g_pMaterialManager = stltype::make_unique<MaterialManager>();
 stltype::unique_ptr<AsyncQueueHandler> g_pQueueHandler = stltype::make_unique<AsyncQueueHandler>();
@@ -21,6 +21,8 @@ struct ApplicationState;
 class ApplicationStateManager;
 class ShaderManager;
 class MaterialManager;
+class AssetCache;
+class ThreadPool;
 
 #ifdef USE_VULKAN
 class VkTextureManager;
@@ -43,6 +45,9 @@ class EntityManager;
 extern stltype::unique_ptr<WindowManager> g_pWindowManager;
 extern stltype::unique_ptr<ConsoleLogger> g_pConsoleLogger;
 extern stltype::unique_ptr<TimeData> g_pGlobalTimeData;
+// Shared workers for CPU heavy jobs like file loads and the work they split up, sized to the core count
+extern stltype::unique_ptr<ThreadPool> g_pJobPool;
+extern stltype::unique_ptr<AssetCache> g_pAssetCache;
 extern stltype::unique_ptr<FileReader> g_pFileReader;
 extern stltype::unique_ptr<EventSystem> g_pEventSystem;
 extern stltype::unique_ptr<DeleteQueue> g_pDeleteQueue;
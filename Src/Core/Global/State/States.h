@@ -129,10 +129,44 @@ struct RendererState
     f32 gt7ReferenceLuminance{300.0f};
     f32 ambientIntensity{0.1f};
 
+    // Mesh LOD selection, projected simplification error in pixels and the fraction it has to be crossed by to switch
+    f32 lodPixelError{1.0f};
+    f32 lodHysteresis{0.2f};
+
+    // Texture mip streaming, the budget covers the streamed scene textures only
+    bool textureStreaming{true};
+    u32 textureStreamingBudgetMB{1024};
+    u32 streamedTextureCount{};
+    u32 pendingTextureStreamingLoads{};
+    u64 textureStreamingResidentBytes{};
+    u64 textureStreamingWantedBytes{};
+    // Texture residency against the VMA budget
+    u64 textureResidencyBudgetBytes{};
+    u64 vramBudgetBytes{};
+    u64 vramBudgetUsageBytes{};
+    u32 evictedTextureCount{};
+    u64 textureEvictionCount{};
+    // Texture uploads batched into one staging buffer per frame
+    u32 textureUploadBudgetMB{32};
+    u32 textureUploadQueueDepth{};
+    u64 textureUploadQueueBytes{};
+    u64 textureUploadedBytesLastFrame{};
+    // Buffer updates of the last frame, split by whether they went through the upload ring or a staging copy
+    u64 uploadRingBytes{};
+    u32 uploadRingUpdateCount{};
+    u64 stagedUploadBytes{};
+    u32 stagedUploadCount{};
+
     // Render info
     u32 triangleCount{};
     u32 vertexCount{};
 
+    // CPU reference meshlet culling, only updated while frustum culling debugging is enabled
+    u32 meshletCount{};
+    u32 frustumCulledMeshletCount{};
+    u32 backfaceCulledMeshletCount{};
+    u32 visibleMeshletTriangleCount{};
+
     // CSM/Shadow state
     u32 directionalLightCascades{CSM_INITIAL_CASCADES};
     mathstl::Vector2 csmResolution{CSM_DEFAULT_RES};
@@ -1,5 +1,9 @@
 #include "ThreadPool.h"
 #include "CoreCommon.h"
+#include <EASTL/algorithm.h>
+
+// Pool the current thread works for, nested waits only help out on their own pool
+static thread_local const ThreadPool* s_pWorkerPool = nullptr;
 
 ThreadPool::ThreadPool(u32 numThreads)
 {
@@ -31,60 +35,99 @@ ThreadPool::~ThreadPool()
     }
 }
 
-void ThreadPool::Submit(stltype::function<void()> job)
+void ThreadPool::Submit(stltype::function<void()> job, JobGroup* pGroup)
 {
     m_queueMutex.lock();
-    m_queue.push(stltype::move(job));
+    m_queue.push_back(Job{stltype::move(job), pGroup});
     m_activeJobs++;
+    if (pGroup)
+    {
+        pGroup->pendingJobs++;
+        // A worker waiting on the group can pick the new job up itself
+        pGroup->condition.Signal(true);
+    }
     m_queueMutex.unlock();
-    
+
     m_condition.Signal();
 }
 
+void ThreadPool::Wait(JobGroup& group)
+{
+    const bool canHelp = IsWorkerThread();
+    m_queueMutex.lock();
+    while (group.pendingJobs > 0)
+    {
+        auto it = m_queue.end();
+        if (canHelp)
+        {
+            it = stltype::find_if(
+                m_queue.begin(), m_queue.end(), [&group](const Job& job) { return job.pGroup == &group; });
+        }
+        if (it == m_queue.end())
+        {
+            group.condition.Wait(m_queueMutex.GetMutex());
+            continue;
+        }
+
+        Job job = stltype::move(*it);
+        m_queue.erase(it);
+        RunJobLocked(job);
+    }
+    m_queueMutex.unlock();
+}
+
 void ThreadPool::WaitAll()
 {
     m_queueMutex.lock();
-    while (m_activeJobs > 0 || !m_queue.empty())
+    while (m_activeJobs > 0)
     {
         m_waitCondition.Wait(m_queueMutex.GetMutex());
     }
     m_queueMutex.unlock();
 }
 
+bool ThreadPool::IsWorkerThread() const
+{
+    return s_pWorkerPool == this;
+}
+
+void ThreadPool::RunJobLocked(Job& job)
+{
+    m_queueMutex.unlock();
+    if (job.func)
+    {
+        job.func();
+    }
+    m_queueMutex.lock();
+
+    m_activeJobs--;
+    // Signalled under the lock, the waiter can't return and destroy the group before we're done with it
+    if (job.pGroup && --job.pGroup->pendingJobs == 0)
+        job.pGroup->condition.Signal(true);
+    if (m_activeJobs == 0)
+        m_waitCondition.Signal(true);
+}
+
 void ThreadPool::WorkerLoop()
 {
+    s_pWorkerPool = this;
     while (true)
     {
-        stltype::function<void()> job;
+        m_queueMutex.lock();
+        while (!m_stop && m_queue.empty())
         {
-            m_queueMutex.lock();
-            while (!m_stop && m_queue.empty())
-            {
-                m_condition.Wait(m_queueMutex.GetMutex());
-            }
-            
-            if (m_stop && m_queue.empty())
-            {
-                m_queueMutex.unlock();
-                return;
-            }
-
-            job = stltype::move(m_queue.front());
-            m_queue.pop();
-            m_queueMutex.unlock();
+            m_condition.Wait(m_queueMutex.GetMutex());
         }
 
-        if (job)
+        if (m_stop && m_queue.empty())
         {
-            job();
+            m_queueMutex.unlock();
+            return;
         }
 
-        m_queueMutex.lock();
-        m_activeJobs--;
-        if (m_activeJobs == 0 && m_queue.empty())
-        {
-            m_waitCondition.Signal(true);
-        }
+        Job job = stltype::move(m_queue.front());
+        m_queue.pop_front();
+        RunJobLocked(job);
         m_queueMutex.unlock();
     }
 }
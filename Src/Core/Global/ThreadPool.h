@@ -3,7 +3,7 @@
 #include "Core/Global/ThreadBase.h"
 #include "Typedefs.h"
 #include <EASTL/vector.h>
-#include <EASTL/queue.h>
+#include <EASTL/deque.h>
 #include <EASTL/functional.h>
 #include <eathread/eathread_mutex.h>
 #include <eathread/eathread_condition.h>
@@ -11,20 +11,41 @@
 class ThreadPool
 {
 public:
+    // Tracks the jobs submitted with it so a caller can wait for just those on a pool shared with other systems
+    struct JobGroup
+    {
+        u32 pendingJobs{0};
+        // Only the waiters of this group are woken when its jobs finish or new ones get queued
+        threadstl::Condition condition;
+    };
+
     ThreadPool() = default;
     ThreadPool(u32 numThreads);
     ~ThreadPool();
 
     void Init(u32 numThreads);
 
-    void Submit(stltype::function<void()> job);
-    void WaitAll(); 
+    void Submit(stltype::function<void()> job, JobGroup* pGroup = nullptr);
+    // Pool workers waiting from inside a job run the group's queued jobs themselves so nested waits can't starve the
+    // pool, other threads just block. Jobs of other groups are never picked up while waiting
+    void Wait(JobGroup& group);
+    // Blocks until the pool is idle, counts the calling job too so jobs have to wait on their own group instead
+    void WaitAll();
 
 private:
+    struct Job
+    {
+        stltype::function<void()> func;
+        JobGroup* pGroup{nullptr};
+    };
+
     void WorkerLoop();
+    // Runs a job popped off the queue, expects m_queueMutex to be held and holds it again on return
+    void RunJobLocked(Job& job);
+    bool IsWorkerThread() const;
 
     stltype::vector<threadstl::Thread> m_workers;
-    stltype::queue<stltype::function<void()>> m_queue;
+    stltype::deque<Job> m_queue;
 
     CustomMutex m_queueMutex;
     threadstl::Condition m_condition;
@@ -16,6 +16,7 @@ namespace mathstl
 }
 
 using u8 = uint8_t;
+using u16 = uint16_t;
 using u32 = uint32_t;
 using s32 = int32_t;
 using u64 = uint64_t;
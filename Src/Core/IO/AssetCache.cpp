@@ -0,0 +1,320 @@
+#include "AssetCache.h"
+#include "Core/Global/LogDefines.h"
+#include "Core/Global/Profiling.h"
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace AssetHashing
+{
+static inline u64 Mix(u64 v)
+{
+    v ^= v >> 33;
+    v *= 0xff51afd7ed558ccdull;
+    v ^= v >> 33;
+    v *= 0xc4ceb9fe1a85ec53ull;
+    v ^= v >> 33;
+    return v;
+}
+
+u64 HashBytes(const void* pData, u64 size, u64 seed)
+{
+    const u8* pBytes = static_cast<const u8*>(pData);
+    u64 h = seed ^ (size * 0x9e3779b97f4a7c15ull);
+
+    u64 i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        u64 v;
+        memcpy(&v, pBytes + i, sizeof(u64));
+        h = (h ^ Mix(v)) * 0x9e3779b97f4a7c15ull;
+    }
+
+    u64 tail = 0;
+    for (u64 shift = 0; i < size; ++i, shift += 8)
+    {
+        tail |= (u64)pBytes[i] << shift;
+    }
+    h ^= Mix(tail);
+
+    return Mix(h);
+}
+
+u64 Combine(u64 a, u64 b)
+{
+    return Mix(a ^ (b + 0x9e3779b97f4a7c15ull + (a << 6) + (a >> 2)));
+}
+} // namespace AssetHashing
+
+static const char* AssetKindName(AssetKind kind)
+{
+    switch (kind)
+    {
+        case AssetKind::Mesh:
+            return "Mesh";
+        case AssetKind::Texture:
+            return "Texture";
+        case AssetKind::Shader:
+            return "Shader";
+        default:
+            return "Unknown";
+    }
+}
+
+static f32 MillisecondsSince(stltype::chrono::steady_clock::time_point start)
+{
+    return stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+               stltype::chrono::steady_clock::now() - start)
+        .count();
+}
+
+AssetCache::AssetCache(const stltype::string& rootDir) : m_rootDir(rootDir)
+{
+    std::error_code ec;
+    for (u32 i = 0; i < (u32)AssetKind::Count; ++i)
+    {
+        fs::create_directories(fs::path(m_rootDir.c_str()) / AssetKindName((AssetKind)i), ec);
+    }
+    LoadIndex();
+}
+
+AssetCache::~AssetCache()
+{
+    SaveIndex();
+}
+
+AssetKey AssetCache::BuildKey(AssetKind kind, const void* pSource, u64 sourceSize, u64 importSettings) const
+{
+    AssetKey key = AssetHashing::HashBytes(pSource, sourceSize);
+    key = AssetHashing::Combine(key, importSettings);
+    key = AssetHashing::Combine(key, ((u64)kind << 32) | ASSET_CACHE_FORMAT_VERSION);
+    return key;
+}
+
+bool AssetCache::Contains(AssetKind kind, AssetKey key) const
+{
+    std::error_code ec;
+    return fs::exists(BuildEntryPath(kind, key).c_str(), ec);
+}
+
+bool AssetCache::Load(AssetKind kind, AssetKey key, const stltype::string& sourceName, stltype::vector<u8>& payload)
+{
+    ScopedZone("AssetCache::Load");
+    const auto start = stltype::chrono::steady_clock::now();
+    const stltype::string path = BuildEntryPath(kind, key);
+
+    bool isValid = false;
+    EntryHeader header{};
+    {
+        std::ifstream file(path.c_str(), std::ios::binary);
+        if (file.is_open())
+        {
+            file.read(reinterpret_cast<char*>(&header), sizeof(EntryHeader));
+            isValid = file.good() && header.magic == ENTRY_MAGIC &&
+                      header.formatVersion == ASSET_CACHE_FORMAT_VERSION && header.kind == (u32)kind &&
+                      header.key == key;
+            if (isValid)
+            {
+                payload.resize(header.payloadSize);
+                file.read(reinterpret_cast<char*>(payload.data()), header.payloadSize);
+                isValid = (u64)file.gcount() == header.payloadSize;
+            }
+        }
+    }
+
+    const f32 loadTimeMs = MillisecondsSince(start);
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    auto& stats = m_stats[(u32)kind];
+    ++stats.lookups;
+    if (isValid == false)
+    {
+        // Truncated or written by an older version, get rid of it so the next store starts clean
+        if (header.magic != 0)
+        {
+            std::error_code ec;
+            fs::remove(path.c_str(), ec);
+            ++stats.invalidations;
+        }
+        payload.clear();
+        return false;
+    }
+
+    const f32 savedMs = stltype::max(header.cookTimeMs - loadTimeMs, 0.0f);
+    ++stats.hits;
+    stats.bytesRead += header.payloadSize;
+    stats.loadTimeMs += loadTimeMs;
+    stats.timeSavedMs += savedMs;
+    SetSourceEntry(sourceName, kind, key);
+
+    DEBUG_LOGF("[AssetCache] {} hit for {}: {:.2f} ms load, {:.2f} ms saved",
+               AssetKindName(kind),
+               sourceName.c_str(),
+               loadTimeMs,
+               savedMs);
+    return true;
+}
+
+void AssetCache::Store(AssetKind kind,
+                       AssetKey key,
+                       const stltype::string& sourceName,
+                       const void* pPayload,
+                       u64 payloadSize,
+                       f32 cookTimeMs)
+{
+    ScopedZone("AssetCache::Store");
+    EntryHeader header{};
+    header.magic = ENTRY_MAGIC;
+    header.formatVersion = ASSET_CACHE_FORMAT_VERSION;
+    header.kind = (u32)kind;
+    header.cookTimeMs = cookTimeMs;
+    header.key = key;
+    header.payloadSize = payloadSize;
+
+    // Write to a temporary file first so concurrent loads never observe a half written entry
+    const stltype::string path = BuildEntryPath(kind, key);
+    const stltype::string tmpPath = path + ".tmp" + stltype::to_string(m_tmpFileCounter++);
+    {
+        std::ofstream file(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (file.is_open() == false)
+        {
+            DEBUG_LOGF("[AssetCache] Failed to open {} for writing", tmpPath.c_str());
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(EntryHeader));
+        file.write(reinterpret_cast<const char*>(pPayload), payloadSize);
+    }
+    std::error_code ec;
+    fs::rename(tmpPath.c_str(), path.c_str(), ec);
+    if (ec)
+    {
+        fs::remove(tmpPath.c_str(), ec);
+        return;
+    }
+
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    auto& stats = m_stats[(u32)kind];
+    ++stats.stores;
+    stats.bytesWritten += payloadSize;
+
+    SetSourceEntry(sourceName, kind, key);
+}
+
+void AssetCache::AddTimeSaved(AssetKind kind, f64 ms)
+{
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    m_stats[(u32)kind].timeSavedMs += stltype::max(ms, 0.0);
+}
+
+AssetCacheStats AssetCache::GetStats(AssetKind kind) const
+{
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    return m_stats[(u32)kind];
+}
+
+void AssetCache::LogReport() const
+{
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    for (u32 i = 0; i < (u32)AssetKind::Count; ++i)
+    {
+        const auto& stats = m_stats[i];
+        if (stats.lookups == 0 && stats.stores == 0)
+            continue;
+        const f64 hitRate = stats.lookups > 0 ? (f64)stats.hits / (f64)stats.lookups * 100.0 : 0.0;
+        DEBUG_LOGF("[AssetCache] {}: {}/{} hits ({:.1f}%), {} stored, {} invalidated, {:.2f} MB read, {:.2f} MB "
+                   "written, {:.2f} ms loading, {:.2f} ms saved",
+                   AssetKindName((AssetKind)i),
+                   stats.hits,
+                   stats.lookups,
+                   hitRate,
+                   stats.stores,
+                   stats.invalidations,
+                   (f64)stats.bytesRead / (1024.0 * 1024.0),
+                   (f64)stats.bytesWritten / (1024.0 * 1024.0),
+                   stats.loadTimeMs,
+                   stats.timeSavedMs);
+    }
+}
+
+void AssetCache::Clear()
+{
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    std::error_code ec;
+    for (u32 i = 0; i < (u32)AssetKind::Count; ++i)
+    {
+        const fs::path kindDir = fs::path(m_rootDir.c_str()) / AssetKindName((AssetKind)i);
+        fs::remove_all(kindDir, ec);
+        fs::create_directories(kindDir, ec);
+        m_stats[i] = {};
+    }
+    m_sourceIndex.clear();
+    m_keyRefCounts.clear();
+}
+
+stltype::string AssetCache::BuildEntryPath(AssetKind kind, AssetKey key) const
+{
+    char keyStr[17];
+    snprintf(keyStr, sizeof(keyStr), "%016llx", (unsigned long long)key);
+    return m_rootDir + "/" + AssetKindName(kind) + "/" + keyStr + ".bin";
+}
+
+void AssetCache::RemoveEntry(AssetKind kind, AssetKey key)
+{
+    std::error_code ec;
+    fs::remove(BuildEntryPath(kind, key).c_str(), ec);
+}
+
+void AssetCache::SetSourceEntry(const stltype::string& sourceName, AssetKind kind, AssetKey key)
+{
+    auto [it, isNew] = m_sourceIndex.insert(sourceName);
+    if (isNew == false)
+    {
+        if (it->second.key == key)
+            return;
+
+        // Source changed since the last cook, the old entry can never be hit again unless another source has the same
+        // content
+        const IndexEntry oldEntry = it->second;
+        auto refIt = m_keyRefCounts.find(oldEntry.key);
+        DEBUG_ASSERT(refIt != m_keyRefCounts.end() && refIt->second > 0);
+        if (refIt != m_keyRefCounts.end() && --refIt->second == 0)
+        {
+            m_keyRefCounts.erase(refIt);
+            RemoveEntry(oldEntry.kind, oldEntry.key);
+            ++m_stats[(u32)oldEntry.kind].invalidations;
+        }
+    }
+    it->second = {kind, key};
+    ++m_keyRefCounts[key];
+}
+
+void AssetCache::LoadIndex()
+{
+    std::ifstream file((m_rootDir + "/Index.txt").c_str());
+    if (file.is_open() == false)
+        return;
+
+    u32 kind;
+    unsigned long long key;
+    std::string sourceName;
+    while (file >> kind >> std::hex >> key >> std::dec && std::getline(file >> std::ws, sourceName))
+    {
+        if (kind < (u32)AssetKind::Count)
+        {
+            SetSourceEntry(sourceName.c_str(), (AssetKind)kind, (AssetKey)key);
+        }
+    }
+}
+
+void AssetCache::SaveIndex() const
+{
+    std::ofstream file((m_rootDir + "/Index.txt").c_str(), std::ios::trunc);
+    if (file.is_open() == false)
+        return;
+
+    SimpleScopedGuard<CustomMutex> lock(m_stateMutex);
+    for (const auto& [sourceName, entry] : m_sourceIndex)
+    {
+        file << (u32)entry.kind << " " << std::hex << entry.key << std::dec << " " << sourceName.c_str() << "\n";
+    }
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Global/ThreadBase.h"
+#include <EASTL/chrono.h>
+
+// Bump whenever the layout of any cooked payload changes, old entries are then treated as misses and dropped
+static inline constexpr u32 ASSET_CACHE_FORMAT_VERSION = 1;
+
+enum class AssetKind : u32
+{
+    Mesh,
+    Texture,
+    Shader,
+    Count
+};
+
+using AssetKey = u64;
+
+namespace AssetHashing
+{
+static inline constexpr u64 DEFAULT_SEED = 0xcbf29ce484222325ull;
+
+// Non-cryptographic 64 bit hash, processes 8 bytes per step so hashing whole texture files stays cheap
+u64 HashBytes(const void* pData, u64 size, u64 seed = DEFAULT_SEED);
+u64 Combine(u64 a, u64 b);
+} // namespace AssetHashing
+
+struct AssetCacheStats
+{
+    u32 lookups{0};
+    u32 hits{0};
+    u32 stores{0};
+    u32 invalidations{0};
+    u64 bytesRead{0};
+    u64 bytesWritten{0};
+    f64 loadTimeMs{0.0};
+    f64 timeSavedMs{0.0};
+};
+
+// Content addressed on-disk cache for cooked assets
+// Entries are keyed by a hash of the source bytes, the importer settings and the importer version so any change to
+// one of them produces a different key. The source name -> key index is used to drop the superseded entry once a
+// source gets re-cooked, identical sources share one entry so it is only dropped once no source references it
+class AssetCache
+{
+public:
+    AssetCache(const stltype::string& rootDir = "Cache");
+    ~AssetCache();
+
+    // importSettings should contain everything that influences the cooked output (flags, versions, formats, ...)
+    AssetKey BuildKey(AssetKind kind, const void* pSource, u64 sourceSize, u64 importSettings) const;
+
+    // Does not count towards the hit rate, only checks if an entry exists
+    bool Contains(AssetKind kind, AssetKey key) const;
+
+    // Returns false on a miss, otherwise the cooked payload is written to payload
+    bool Load(AssetKind kind, AssetKey key, const stltype::string& sourceName, stltype::vector<u8>& payload);
+
+    // cookTimeMs is the time it took to produce the payload from its source, used to report the time saved on hits
+    void Store(AssetKind kind,
+               AssetKey key,
+               const stltype::string& sourceName,
+               const void* pPayload,
+               u64 payloadSize,
+               f32 cookTimeMs);
+
+    // For savings that don't come from a single entry load, e.g. skipping importer post-processing
+    void AddTimeSaved(AssetKind kind, f64 ms);
+
+    AssetCacheStats GetStats(AssetKind kind) const;
+    void LogReport() const;
+
+    void Clear();
+
+private:
+    struct EntryHeader
+    {
+        u32 magic;
+        u32 formatVersion;
+        u32 kind;
+        f32 cookTimeMs;
+        u64 key;
+        u64 payloadSize;
+    };
+    static inline constexpr u32 ENTRY_MAGIC = 0x43564E43; // "CNVC"
+
+    stltype::string BuildEntryPath(AssetKind kind, AssetKey key) const;
+    void RemoveEntry(AssetKind kind, AssetKey key);
+    // Points sourceName at key, an entry no other source references anymore is removed from disk
+    void SetSourceEntry(const stltype::string& sourceName, AssetKind kind, AssetKey key);
+    void LoadIndex();
+    void SaveIndex() const;
+
+    struct IndexEntry
+    {
+        AssetKind kind;
+        AssetKey key;
+    };
+
+    stltype::string m_rootDir;
+    stltype::hash_map<stltype::string, IndexEntry> m_sourceIndex;
+    // Number of sources in m_sourceIndex per key, keys already include the kind
+    stltype::hash_map<AssetKey, u32> m_keyRefCounts;
+    AssetCacheStats m_stats[(u32)AssetKind::Count]{};
+    threadstl::AtomicUint32 m_tmpFileCounter{0};
+    mutable CustomMutex m_stateMutex;
+};
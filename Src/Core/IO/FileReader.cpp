@@ -1,24 +1,27 @@
-#define STB_IMAGE_IMPLEMENTATION
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <filesystem>
 #include <fstream>
 #undef abs
-#define STBI_NO_SIMD
 #define TINYDDSLOADER_IMPLEMENTATION
 #include <tinyddsloader.h>
-#include <stb/stb_image.h>
 
 
 #include "Core/Global/GlobalVariables.h"
 #include "Core/Global/Profiling.h"
+#include "AssetCache.h"
 #include "FileReader.h"
+#include "ImageDecoder.h"
+#include "KTX2Reader.h"
 #include "MeshConverter.h"
+#include "MipGenerator.h"
+#include "TextureCooker.h"
+#include "Core/Rendering/Vulkan/VkTextureManager.h"
 
 using namespace threadstl;
 
-FileReader::FileReader() : m_threadPool(CORE_COUNT_AVAILABLE)
+FileReader::FileReader()
 {
     m_ioThread = MakeThread([this]() { CheckIORequests(); });
     m_ioThread.SetName("Convolution_IO");
@@ -28,7 +31,7 @@ FileReader::~FileReader()
 {
     m_keepRunning = false;
     m_ioThread.WaitForEnd();
-    m_threadPool.WaitAll();
+    g_pJobPool->Wait(m_requestJobs);
 }
 
 void FileReader::FinishAllRequests()
@@ -37,7 +40,7 @@ void FileReader::FinishAllRequests()
     {
         Sleep(1);
     }
-    m_threadPool.WaitAll();
+    g_pJobPool->Wait(m_requestJobs);
 }
 
 void FileReader::CancelAllRequests()
@@ -78,17 +81,17 @@ void FileReader::CheckIORequests()
         {
             case RequestType::Bytes:
             {
-                m_threadPool.Submit([this, request]() { ReadFileAsGenericBytes(request); });
+                g_pJobPool->Submit([this, request]() { ReadFileAsGenericBytes(request); }, &m_requestJobs);
                 break;
             }
             case RequestType::Image:
             {
-                m_threadPool.Submit([this, request]() { ReadImageFile(request); });
+                g_pJobPool->Submit([this, request]() { ReadImageFile(request); }, &m_requestJobs);
                 break;
             }
             case RequestType::Mesh:
             {
-                m_threadPool.Submit([this, request]() { ReadMeshFile(request); });
+                g_pJobPool->Submit([this, request]() { ReadMeshFile(request); }, &m_requestJobs);
                 break;
             }
             default:
@@ -131,6 +134,78 @@ stltype::vector<char> FileReader::ReadFileAsGenericBytes(const char* filePath)
     return buffer;
 }
 
+// Copies the mips allowed by firstMipLevel and maxMipExtent of the first array slice out of the loaded DDS
+static bool ReadDDSImage(tinyddsloader::DDSFile& dds,
+                         const stltype::string& filePath,
+                         u32 firstMipLevel,
+                         u32 maxMipExtent,
+                         ReadTextureInfo& info)
+{
+    if (dds.GetMipCount() == 0)
+    {
+        DEBUG_LOGF("[FileReader] Empty mipmaps in DDS: {}", filePath.data());
+        return false;
+    }
+
+    firstMipLevel =
+        GetFirstRequestedMip(dds.GetWidth(), dds.GetHeight(), dds.GetMipCount(), firstMipLevel, maxMipExtent);
+    info.firstMipLevel = firstMipLevel;
+    info.fullMipCount = dds.GetMipCount();
+    info.fullExtents.x = dds.GetWidth();
+    info.fullExtents.y = dds.GetHeight();
+    info.extents.x = stltype::max(dds.GetWidth() >> firstMipLevel, 1u);
+    info.extents.y = stltype::max(dds.GetHeight() >> firstMipLevel, 1u);
+    info.ddsFormat = (u32)dds.GetFormat();
+    info.mipmapPixels.reserve(dds.GetMipCount() - firstMipLevel);
+    u64 imageSize = 0;
+    for (u32 i = firstMipLevel; i < dds.GetMipCount(); ++i)
+    {
+        auto imageData = dds.GetImageData(i, 0);
+        auto& mipData = info.mipmapPixels.emplace_back();
+        mipData.size = imageData->m_memSlicePitch;
+        mipData.pData = (unsigned char*)malloc(mipData.size);
+        memcpy(mipData.pData, imageData->m_mem, mipData.size);
+        imageSize = imageSize + mipData.size;
+    }
+
+    // Check if format has alpha. This is a bit simplified but usually works for common DDS formats.
+    auto format = dds.GetFormat();
+    info.supportsAlpha = true; // Most DXGI formats we care about support alpha, or we can check specifically if needed
+    using DXGIFormat = tinyddsloader::DDSFile::DXGIFormat;
+    if (format == DXGIFormat::BC4_SNorm || format == DXGIFormat::BC4_UNorm ||
+        format == DXGIFormat::BC5_SNorm || format == DXGIFormat::BC5_UNorm ||
+        format == DXGIFormat::R8_UNorm || format == DXGIFormat::R8G8_UNorm)
+    {
+        info.supportsAlpha = false;
+    }
+
+    info.dataSize = imageSize;
+    return true;
+}
+
+// Cooked and decoded images come out of the asset cache as a whole chain, the skipped mips are only dropped afterwards
+static void DropLeadingMips(ReadTextureInfo& info, u32 firstMipLevel, u32 maxMipExtent)
+{
+    const u32 mipCount = (u32)info.mipmapPixels.size();
+    info.firstMipLevel = 0;
+    info.fullMipCount = mipCount;
+    info.fullExtents = info.extents;
+    if (mipCount <= 1)
+        return;
+
+    const u32 droppedCount =
+        GetFirstRequestedMip(info.extents.x, info.extents.y, mipCount, firstMipLevel, maxMipExtent);
+    for (u32 i = 0; i < droppedCount; ++i)
+    {
+        info.dataSize -= info.mipmapPixels[i].size;
+        FileReader::FreeImageData(info.mipmapPixels[i].pData);
+    }
+    info.mipmapPixels.erase(info.mipmapPixels.begin(), info.mipmapPixels.begin() + droppedCount);
+    info.firstMipLevel = droppedCount;
+    info.extents.x = stltype::max(info.extents.x >> droppedCount, 1);
+    info.extents.y = stltype::max(info.extents.y >> droppedCount, 1);
+}
+
 void FileReader::ReadImageFile(const IORequest& request)
 {
     ScopedZone("FileReader::Read Image File");
@@ -146,50 +221,33 @@ void FileReader::ReadImageFile(const IORequest& request)
             isDDS = true;
         }
     }
+    bool isKTX2 = false;
+    if (request.filePath.size() > 5)
+    {
+        stltype::string extension = request.filePath.substr(request.filePath.size() - 5);
+        if (extension == ".ktx2" || extension == ".KTX2")
+        {
+            isKTX2 = true;
+        }
+    }
 
-    if (isDDS)
+    bool isRead = false;
+    if (isKTX2)
+    {
+        isRead = KTX2::ReadTexture(request.filePath, request.firstMipLevel, request.maxMipExtent, info);
+    }
+    else if (isDDS)
     {
         tinyddsloader::DDSFile dds;
         auto rslt = dds.Load(request.filePath.data());
         if (rslt != tinyddsloader::Result::Success)
         {
             DEBUG_LOGF("[FileReader] Failed to load DDS: {}", request.filePath.data());
-            return;
-        }
-
-        if (dds.GetMipCount() == 0)
-        {
-            DEBUG_LOGF("[FileReader] Empty mipmaps in DDS: {}", request.filePath.data());
-            return;
         }
-
-        info.extents.x = dds.GetWidth();
-        info.extents.y = dds.GetHeight();
-        info.ddsFormat = (u32)dds.GetFormat();
-        info.mipmapPixels.reserve(dds.GetMipCount());
-        u64 imageSize = 0;
-        for (u32 i = 0; i < dds.GetMipCount(); ++i)
-        {
-            auto imageData = dds.GetImageData(i, 0);
-            auto& mipData = info.mipmapPixels.emplace_back();
-            mipData.size = imageData->m_memSlicePitch;
-            mipData.pData = (unsigned char*)malloc(mipData.size);
-            memcpy(mipData.pData, imageData->m_mem, mipData.size);
-            imageSize = imageSize + mipData.size;
-        }
-        
-        // Check if format has alpha. This is a bit simplified but usually works for common DDS formats.
-        auto format = dds.GetFormat();
-        info.supportsAlpha = true; // Most DXGI formats we care about support alpha, or we can check specifically if needed
-        using DXGIFormat = tinyddsloader::DDSFile::DXGIFormat;
-        if (format == DXGIFormat::BC4_SNorm || format == DXGIFormat::BC4_UNorm ||
-            format == DXGIFormat::BC5_SNorm || format == DXGIFormat::BC5_UNorm ||
-            format == DXGIFormat::R8_UNorm || format == DXGIFormat::R8G8_UNorm)
+        else
         {
-            info.supportsAlpha = false;
+            isRead = ReadDDSImage(dds, request.filePath, request.firstMipLevel, request.maxMipExtent, info);
         }
-
-        info.dataSize = imageSize;
     }
     else
     {
@@ -203,27 +261,25 @@ void FileReader::ReadImageFile(const IORequest& request)
             }
         }
 
-        if (isHDR)
-        {
-            float* floatPixels = stbi_loadf(request.filePath.data(), &info.extents.x, &info.extents.y, &info.texChannels, STBI_rgb_alpha);
-            info.pixels = reinterpret_cast<unsigned char*>(floatPixels);
-            info.dataSize = (u64)info.extents.x * info.extents.y * 4 * sizeof(float);
-            info.ddsFormat = 0;
-            info.supportsAlpha = true;
-            DEBUG_ASSERT(info.pixels);
-        }
-        else
+        const bool cooked = isHDR == false && TextureCooking::ShouldCook(request.textureSemantic) &&
+                            CookImageCached(request.filePath, request.textureSemantic, info);
+        isRead = cooked || DecodeImageCached(request.filePath, isHDR, request.textureSemantic, info);
+        if (isRead)
+            DropLeadingMips(info, request.firstMipLevel, request.maxMipExtent);
+    }
+
+    if (isRead == false)
+    {
+        for (auto& mipData : info.mipmapPixels)
         {
-            info.pixels =
-                stbi_load(request.filePath.data(), &info.extents.x, &info.extents.y, &info.texChannels, STBI_rgb_alpha);
-            info.dataSize = (u64)info.extents.x * info.extents.y * 4;
-            info.ddsFormat = 0; // Standard RGBA8
-            info.supportsAlpha = true;
-            DEBUG_ASSERT(info.pixels);
+            FreeImageData(mipData.pData);
         }
+        info.mipmapPixels.clear();
+        info.dataSize = 0;
+        info.firstMipLevel = request.firstMipLevel;
+        info.isValid = false;
     }
 
-
     const IOImageReadCallback* callback = stltype::get_if<IOImageReadCallback>(&request.callback);
     if (callback)
     {
@@ -234,10 +290,182 @@ void FileReader::ReadImageFile(const IORequest& request)
 
 void FileReader::FreeImageData(const unsigned char* pixels)
 {
-    // stbi_image_free usually just calls free, and we use malloc for DDS
+    // Decoders and the DDS path both hand out malloc'd memory
     free((void*)pixels);
 }
 
+bool FileReader::DecodeImageCached(const stltype::string& filePath,
+                                   bool isHDR,
+                                   TextureSemantic semantic,
+                                   ReadTextureInfo& info)
+{
+    ScopedZone("FileReader::Decode Image");
+    struct CookedImageHeader
+    {
+        s32 width;
+        s32 height;
+        s32 channels;
+        u32 isHDR;
+        u32 mipCount;
+    };
+
+    MipGeneration::MipGenerationSettings mipSettings{};
+    mipSettings.format = isHDR ? MipGeneration::MipPixelFormat::RGBA16F : MipGeneration::MipPixelFormat::RGBA8;
+    mipSettings.isSRGB =
+        isHDR == false && (semantic == TextureSemantic::BaseColor || semantic == TextureSemantic::Emissive);
+    mipSettings.isNormalMap = isHDR == false && semantic == TextureSemantic::Normal;
+    const u32 texelSize = MipGeneration::GetTexelSize(mipSettings.format);
+
+    u64 importSettings = AssetHashing::Combine(isHDR ? 1 : 0, ImageDecoding::IMAGE_DECODE_VERSION);
+    const u64 mipFlags = ((u64)mipSettings.isSRGB << 1) | (u64)mipSettings.isNormalMap;
+    importSettings = AssetHashing::Combine(importSettings, mipFlags);
+    importSettings = AssetHashing::Combine(importSettings, MipGeneration::MIP_GENERATION_VERSION);
+    stltype::vector<char> sourceBytes;
+    const AssetKey key = GetImageSourceKey(filePath, importSettings, sourceBytes);
+    const stltype::string cacheName = filePath + "#" + stltype::to_string((u32)semantic);
+
+    info.ddsFormat = 0; // Standard RGBA8 or RGBA16F for HDR
+    info.supportsAlpha = true;
+    info.isHDR = isHDR;
+    info.pixels = nullptr;
+
+    stltype::vector<u8> cooked;
+    if (g_pAssetCache->Load(AssetKind::Texture, key, cacheName, cooked) && cooked.size() > sizeof(CookedImageHeader))
+    {
+        CookedImageHeader header;
+        memcpy(&header, cooked.data(), sizeof(CookedImageHeader));
+        info.extents.x = header.width;
+        info.extents.y = header.height;
+        info.texChannels = header.channels;
+        info.dataSize = cooked.size() - sizeof(CookedImageHeader);
+        info.mipmapPixels.reserve(header.mipCount);
+        u64 offset = sizeof(CookedImageHeader);
+        for (u32 i = 0; i < header.mipCount; ++i)
+        {
+            auto& mipData = info.mipmapPixels.emplace_back();
+            mipData.size = (u64)stltype::max(header.width >> i, 1) * stltype::max(header.height >> i, 1) * texelSize;
+            DEBUG_ASSERT(offset + mipData.size <= cooked.size());
+            mipData.pData = (unsigned char*)malloc(mipData.size);
+            memcpy(mipData.pData, cooked.data() + offset, mipData.size);
+            offset += mipData.size;
+        }
+        return true;
+    }
+
+    // Only read on a miss, cache hits got their key without touching the source
+    if (sourceBytes.empty())
+        sourceBytes = ReadFileAsGenericBytes(filePath.data());
+    const auto start = stltype::chrono::steady_clock::now();
+    ImageDecoding::DecodedImage image{};
+    const bool decoded = ImageDecoding::Decode(
+        (const u8*)sourceBytes.data(), sourceBytes.size(), ImageDecoding::ImageDecodeSettings{}, image);
+    // HDR is picked by extension for the cache key, a mismatching payload can't go through the mip settings above
+    const bool matchesFormat = image.format == (isHDR ? ImageDecoding::DecodedPixelFormat::RGBA16F
+                                                      : ImageDecoding::DecodedPixelFormat::RGBA8);
+    DEBUG_ASSERT(decoded && matchesFormat);
+    if (decoded == false || matchesFormat == false)
+    {
+        DEBUG_LOGF("[FileReader] Failed to decode image: {}", filePath.data());
+        free(image.pPixels);
+        return false;
+    }
+    unsigned char* pBasePixels = image.pPixels;
+    info.extents.x = (s32)image.width;
+    info.extents.y = (s32)image.height;
+    info.texChannels = image.sourceChannels;
+
+    stltype::vector<MipGeneration::MipLevel> mipLevels;
+    MipGeneration::GenerateMipChain(pBasePixels, info.extents.x, info.extents.y, mipSettings, mipLevels);
+    const f32 decodeTimeMs = stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+                                 stltype::chrono::steady_clock::now() - start)
+                                 .count();
+
+    // The decoded base level is handed over as is, FreeImageData releases it like every other mip
+    info.mipmapPixels.reserve(mipLevels.size() + 1);
+    info.mipmapPixels.push_back({pBasePixels, (u64)info.extents.x * info.extents.y * texelSize});
+    for (const auto& level : mipLevels)
+    {
+        auto& mipData = info.mipmapPixels.emplace_back();
+        mipData.size = level.pixels.size();
+        mipData.pData = (unsigned char*)malloc(mipData.size);
+        memcpy(mipData.pData, level.pixels.data(), mipData.size);
+    }
+    info.dataSize = 0;
+    for (const auto& mipData : info.mipmapPixels)
+    {
+        info.dataSize += mipData.size;
+    }
+
+    const CookedImageHeader header{
+        info.extents.x, info.extents.y, info.texChannels, isHDR ? 1u : 0u, (u32)info.mipmapPixels.size()};
+    cooked.resize(sizeof(CookedImageHeader) + info.dataSize);
+    memcpy(cooked.data(), &header, sizeof(CookedImageHeader));
+    u64 offset = sizeof(CookedImageHeader);
+    for (const auto& mipData : info.mipmapPixels)
+    {
+        memcpy(cooked.data() + offset, mipData.pData, mipData.size);
+        offset += mipData.size;
+    }
+    g_pAssetCache->Store(AssetKind::Texture, key, cacheName, cooked.data(), cooked.size(), decodeTimeMs);
+    return true;
+}
+
+bool FileReader::CookImageCached(const stltype::string& filePath, TextureSemantic semantic, ReadTextureInfo& info)
+{
+    ScopedZone("FileReader::Cook Image");
+
+    u64 importSettings = AssetHashing::Combine((u64)semantic, TextureCooking::TEXTURE_COOK_VERSION);
+    importSettings = AssetHashing::Combine(importSettings, ImageDecoding::IMAGE_DECODE_VERSION);
+    stltype::vector<char> sourceBytes;
+    const AssetKey key = GetImageSourceKey(filePath, importSettings, sourceBytes);
+    // Same source can be referenced with different semantics, e.g. as base color and as data
+    const stltype::string cacheName = filePath + "#" + stltype::to_string((u32)semantic);
+
+    stltype::vector<u8> cooked;
+    if (g_pAssetCache->Load(AssetKind::Texture, key, cacheName, cooked) == false)
+    {
+        if (sourceBytes.empty())
+            sourceBytes = ReadFileAsGenericBytes(filePath.data());
+        const auto start = stltype::chrono::steady_clock::now();
+        ImageDecoding::DecodedImage image{};
+        if (ImageDecoding::Decode(
+                (const u8*)sourceBytes.data(), sourceBytes.size(), ImageDecoding::ImageDecodeSettings{}, image) ==
+                false ||
+            image.format != ImageDecoding::DecodedPixelFormat::RGBA8)
+        {
+            DEBUG_LOGF("[FileReader] Failed to decode image for cooking: {}", filePath.data());
+            free(image.pPixels);
+            return false;
+        }
+        const u32 width = image.width;
+        const u32 height = image.height;
+
+        const auto cookInfo = TextureCooking::CookTexture(image.pPixels, width, height, semantic, cooked);
+        free(image.pPixels);
+        const f32 cookTimeMs = stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+                                   stltype::chrono::steady_clock::now() - start)
+                                   .count();
+
+        DEBUG_LOGF("[FileReader] Cooked {} to {}, {}x{} with {} mips, {} KB in {:.1f} ms",
+                   filePath.data(),
+                   TextureCooking::GetFormatName(cookInfo.format),
+                   width,
+                   height,
+                   cookInfo.mipCount,
+                   cookInfo.compressedSize / 1024,
+                   cookTimeMs);
+        g_pAssetCache->Store(AssetKind::Texture, key, cacheName, cooked.data(), cooked.size(), cookTimeMs);
+    }
+
+    tinyddsloader::DDSFile dds;
+    if (dds.Load(cooked.data(), cooked.size()) != tinyddsloader::Result::Success)
+    {
+        DEBUG_LOGF("[FileReader] Failed to load cooked DDS: {}", filePath.data());
+        return false;
+    }
+    return ReadDDSImage(dds, filePath, 0, 0, info);
+}
+
 void FileReader::ReadMeshFile(const IORequest& request)
 {
     ScopedZone("FileReader::Read Mesh File");
@@ -247,17 +475,70 @@ void FileReader::ReadMeshFile(const IORequest& request)
     const auto ext = path.substr(path.find_last_of('.'));
     DEBUG_ASSERT(importer.IsExtensionSupported(ext.data()));
 
-    importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, 
-        aiComponent_ANIMATIONS | aiComponent_BONEWEIGHTS | aiComponent_COLORS | aiComponent_TEXTURES);
-
-    const aiScene* pMeshScene = importer.ReadFile(
-        path.data(),
+    constexpr u32 rvcFlags = aiComponent_ANIMATIONS | aiComponent_BONEWEIGHTS | aiComponent_COLORS | aiComponent_TEXTURES;
+    constexpr u32 fullImportFlags =
         aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_FlipUVs | aiProcess_RemoveComponent |
-            aiProcess_RemoveRedundantMaterials | aiProcess_GenUVCoords | aiProcess_GenBoundingBoxes |
-            aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace);
+        aiProcess_RemoveRedundantMaterials | aiProcess_GenUVCoords | aiProcess_GenBoundingBoxes |
+        aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace;
+    // If every mesh is already cooked we only need the scene structure, materials and bounds from assimp
+    // None of these steps split or merge meshes, so mesh indices stay identical to a full import
+    constexpr u32 structureOnlyImportFlags = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_RemoveComponent |
+                                             aiProcess_RemoveRedundantMaterials | aiProcess_GenBoundingBoxes;
+
+    importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, rvcFlags);
+
+    struct CookedSceneRecord
+    {
+        u32 meshCount;
+        f32 fullImportTimeMs;
+    };
+
+    const stltype::vector<char> sourceBytes = ReadFileAsGenericBytes(path.data());
+    u64 importSettings = AssetHashing::Combine(((u64)rvcFlags << 32) | fullImportFlags, MeshConversion::MESH_COOK_VERSION);
+    importSettings = AssetHashing::Combine(importSettings, HashExternalMeshBuffers(request.filePath));
+    const AssetKey sceneKey =
+        g_pAssetCache->BuildKey(AssetKind::Mesh, sourceBytes.data(), sourceBytes.size(), importSettings);
+
+    CookedSceneRecord record{};
+    bool allMeshesCooked = false;
+    stltype::vector<u8> cooked;
+    if (g_pAssetCache->Load(AssetKind::Mesh, sceneKey, request.filePath, cooked) &&
+        cooked.size() == sizeof(CookedSceneRecord))
+    {
+        memcpy(&record, cooked.data(), sizeof(CookedSceneRecord));
+        allMeshesCooked = true;
+        for (u32 i = 0; i < record.meshCount && allMeshesCooked; ++i)
+        {
+            allMeshesCooked = g_pAssetCache->Contains(AssetKind::Mesh, MeshConversion::BuildMeshKey(sceneKey, i));
+        }
+    }
+
+    const auto start = stltype::chrono::steady_clock::now();
+    const aiScene* pMeshScene =
+        importer.ReadFile(path.data(), allMeshesCooked ? structureOnlyImportFlags : fullImportFlags);
+    const f32 importTimeMs = stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+                                 stltype::chrono::steady_clock::now() - start)
+                                 .count();
 
     DEBUG_ASSERT(pMeshScene);
-    auto scene = MeshConversion::Convert(pMeshScene);
+    if (allMeshesCooked && pMeshScene->mNumMeshes == record.meshCount)
+    {
+        g_pAssetCache->AddTimeSaved(AssetKind::Mesh, record.fullImportTimeMs - importTimeMs);
+    }
+    else
+    {
+        if (allMeshesCooked)
+        {
+            DEBUG_LOG_WARN("[FileReader] Cached mesh count doesn't match the source, re-importing");
+            pMeshScene = importer.ReadFile(path.data(), fullImportFlags);
+            DEBUG_ASSERT(pMeshScene);
+        }
+        record = {pMeshScene->mNumMeshes, importTimeMs};
+        g_pAssetCache->Store(AssetKind::Mesh, sceneKey, request.filePath, &record, sizeof(CookedSceneRecord), 0.0f);
+    }
+
+    auto scene = MeshConversion::Convert(pMeshScene, sceneKey, request.filePath);
+    g_pAssetCache->LogReport();
 
     const IOMeshReadCallback* callback = stltype::get_if<IOMeshReadCallback>(&request.callback);
     if (callback)
@@ -266,3 +547,60 @@ void FileReader::ReadMeshFile(const IORequest& request)
         (*callback)({scene});
     }
 }
+
+u64 FileReader::GetImageSourceKey(const stltype::string& filePath,
+                                  u64 importSettings,
+                                  stltype::vector<char>& sourceBytes)
+{
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path sourcePath(filePath.c_str());
+    const u64 fileSize = (u64)fs::file_size(sourcePath, ec);
+    const bool hasFileSize = !ec;
+    const u64 writeTime = (u64)fs::last_write_time(sourcePath, ec).time_since_epoch().count();
+    const bool canCache = hasFileSize && !ec;
+    const stltype::string entryName = filePath + "#" + stltype::to_string(importSettings);
+
+    if (canCache)
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_sourceKeyMutex);
+        const auto it = m_sourceKeys.find(entryName);
+        if (it != m_sourceKeys.end() && it->second.fileSize == fileSize && it->second.writeTime == writeTime)
+            return it->second.key;
+    }
+
+    sourceBytes = ReadFileAsGenericBytes(filePath.data());
+    const AssetKey key =
+        g_pAssetCache->BuildKey(AssetKind::Texture, sourceBytes.data(), sourceBytes.size(), importSettings);
+    if (canCache)
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_sourceKeyMutex);
+        m_sourceKeys[entryName] = {fileSize, writeTime, key};
+    }
+    return key;
+}
+
+u64 FileReader::HashExternalMeshBuffers(const stltype::string& filePath)
+{
+    // glTF and obj keep their geometry next to the main file, fold size and write time of those into the key so
+    // editing them invalidates the cooked meshes as well
+    namespace fs = std::filesystem;
+    u64 hash = 0;
+    std::error_code ec;
+    const fs::path sourcePath(filePath.c_str());
+    for (const auto& entry : fs::directory_iterator(sourcePath.parent_path(), ec))
+    {
+        const auto extension = entry.path().extension();
+        if (entry.is_regular_file() == false || (extension != ".bin" && extension != ".mtl"))
+            continue;
+        const u64 fileSize = (u64)entry.file_size(ec);
+        const u64 writeTime = (u64)entry.last_write_time(ec).time_since_epoch().count();
+        const stltype::string fileName = entry.path().filename().string().c_str();
+        u64 fileHash = AssetHashing::HashBytes(fileName.data(), fileName.size());
+        fileHash = AssetHashing::Combine(fileHash, fileSize);
+        fileHash = AssetHashing::Combine(fileHash, writeTime);
+        // Order independent since directory iteration order is unspecified
+        hash += fileHash;
+    }
+    return hash;
+}
@@ -6,8 +6,11 @@ struct SceneNode;
 #include "Core/Global/ThreadPool.h"
 #include "Core/SceneGraph/Scene.h"
 #include <EASTL/fixed_function.h>
+#include <EASTL/hash_map.h>
 #include <EASTL/queue.h>
 
+enum class TextureSemantic : u8;
+
 struct ReadMipmapInfo
 {
     unsigned char* pData;
@@ -23,8 +26,19 @@ struct ReadTextureInfo
     s32 texChannels;
     u64 dataSize = 0;
     u32 ddsFormat = 0;
+    // VkFormat of KTX2 sources, wins over ddsFormat since DXGI has no separate BC1 RGB and RGBA formats
+    u32 vkFormat = 0;
     bool supportsAlpha = false;
+    // RGBA16F texels instead of RGBA8 if ddsFormat isn't set
+    bool isHDR = false;
     bool autoFree = true;
+    // Level of the source's full chain that mipmapPixels[0] is, non zero if leading mips were skipped on request
+    u32 firstMipLevel = 0;
+    u32 fullMipCount = 0;
+    DirectX::XMINT2 fullExtents{};
+    // Reading or decoding failed and no pixels are set, the callback still runs so the requester isn't left waiting
+    // firstMipLevel is the requested one then
+    bool isValid = true;
 };
 
 struct ReadBytesInfo
@@ -56,8 +70,26 @@ struct IORequest
     stltype::string filePath;
     IOCallback callback;
     RequestType requestType;
+    // Image requests only, decides whether and how the source gets block compressed
+    TextureSemantic textureSemantic{};
+    // Image requests only, skips the most detailed mips, DDS and KTX2 files don't even read them
+    u32 firstMipLevel{0};
+    // Image requests only, skips further mips until the most detailed one fits into this extent, 0 keeps them all
+    u32 maxMipExtent{0};
 };
 
+// First mip of a width x height chain with mipCount levels that satisfies both limits of an image request
+inline u32 GetFirstRequestedMip(u32 width, u32 height, u32 mipCount, u32 firstMipLevel, u32 maxMipExtent)
+{
+    u32 mip = firstMipLevel;
+    if (maxMipExtent > 0)
+    {
+        while (stltype::max(width >> mip, height >> mip) > maxMipExtent)
+            ++mip;
+    }
+    return stltype::min(mip, stltype::max(mipCount, 1u) - 1);
+}
+
 class FileReader
 {
 public:
@@ -82,10 +114,33 @@ protected:
 
     void ReadMeshFile(const IORequest& request);
 
+    // Decodes PNG/JPG/TGA/HDR through ImageDecoding and generates the mip chain, the result is kept in the asset cache
+    bool DecodeImageCached(const stltype::string& filePath,
+                           bool isHDR,
+                           TextureSemantic semantic,
+                           ReadTextureInfo& info);
+    // Block compresses LDR sources into a DDS with a full mip chain, the cooked DDS is kept in the asset cache
+    bool CookImageCached(const stltype::string& filePath, TextureSemantic semantic, ReadTextureInfo& info);
+    // Asset cache key of an image source, only reads and hashes the file if its size or write time changed since the
+    // last request, sourceBytes is left empty otherwise
+    u64 GetImageSourceKey(const stltype::string& filePath, u64 importSettings, stltype::vector<char>& sourceBytes);
+    static u64 HashExternalMeshBuffers(const stltype::string& filePath);
+
     threadstl::Thread m_ioThread;
     CustomMutex m_requestSubmitMutex{};
     CustomMutex m_callbackMutex{};
     stltype::queue<IORequest> m_requests{}; // Pending requests, read by iothread
     bool m_keepRunning{true};
-    ThreadPool m_threadPool;
+    // Requests run on g_pJobPool
+    ThreadPool::JobGroup m_requestJobs;
+
+    struct ImageSourceKey
+    {
+        u64 fileSize;
+        u64 writeTime;
+        u64 key;
+    };
+    // Streaming reloads the same sources over and over, keyed by path and import settings
+    stltype::hash_map<stltype::string, ImageSourceKey> m_sourceKeys;
+    CustomMutex m_sourceKeyMutex{};
 };
\ No newline at end of file
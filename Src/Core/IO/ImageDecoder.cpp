@@ -0,0 +1,442 @@
+#undef abs
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+
+#include "Core/Global/GlobalVariables.h"
+#include "Core/Global/Profiling.h"
+#include "Core/Global/ThreadPool.h"
+#include "ImageDecoder.h"
+#include <DirectXPackedVector.h>
+#include <EASTL/chrono.h>
+#include <EASTL/hash_set.h>
+#include <fstream>
+
+namespace ImageDecoding
+{
+// Rows handed to a single job when an image is decoded in parallel
+static inline constexpr u32 ROWS_PER_JOB = 64;
+// Largest side of a Radiance file the decoder accepts, anything the header claims above it is treated as corrupt
+static inline constexpr u32 MAX_HDR_EXTENT = 16384;
+
+u32 GetTexelSize(DecodedPixelFormat format)
+{
+    switch (format)
+    {
+        case DecodedPixelFormat::RGBA16F:
+            return 4 * sizeof(u16);
+        case DecodedPixelFormat::RGBA32F:
+            return 4 * sizeof(f32);
+        case DecodedPixelFormat::RGBA8:
+        default:
+            return 4;
+    }
+}
+
+// Small images run inline, larger ones are split into row ranges
+template <typename TFunc>
+static void ForEachRowRange(u32 width, u32 height, const TFunc& func)
+{
+    if ((u64)width * height < PARALLEL_DECODE_MIN_TEXELS)
+    {
+        func(0, height);
+        return;
+    }
+
+    ThreadPool::JobGroup jobs;
+    for (u32 row = 0; row < height; row += ROWS_PER_JOB)
+    {
+        const u32 rowCount = stltype::min(ROWS_PER_JOB, height - row);
+        g_pJobPool->Submit([&func, row, rowCount]() { func(row, rowCount); }, &jobs);
+    }
+    g_pJobPool->Wait(jobs);
+}
+
+static u16* ConvertToHalf(const f32* pSrc, u32 width, u32 height)
+{
+    u16* pDst = (u16*)malloc((u64)width * height * 4 * sizeof(u16));
+    ForEachRowRange(width,
+                    height,
+                    [=](u32 firstRow, u32 rowCount)
+                    {
+                        const u64 offset = (u64)firstRow * width * 4;
+                        DirectX::PackedVector::XMConvertFloatToHalfStream(
+                            pDst + offset, sizeof(u16), pSrc + offset, sizeof(f32), (u64)rowCount * width * 4);
+                    });
+    return pDst;
+}
+
+// stb_image is built with its SSE2 paths (JPEG IDCT, YCbCr conversion and upsampling)
+// Covers PNG, JPEG, TGA, BMP, PSD, GIF and flat or old style RLE HDR files the Radiance decoder below doesn't take
+class StbImageDecoder : public ImageDecoder
+{
+public:
+    const char* GetName() const override
+    {
+        return "stb_image";
+    }
+
+    bool CanDecode(const u8* pData, u64 size) const override
+    {
+        s32 width, height, channels;
+        return stbi_info_from_memory(pData, (int)size, &width, &height, &channels) != 0;
+    }
+
+    bool Decode(const u8* pData, u64 size, const ImageDecodeSettings& settings, DecodedImage& out) const override
+    {
+        ScopedZone("StbImageDecoder::Decode");
+        s32 width, height, channels;
+        if (stbi_is_hdr_from_memory(pData, (int)size))
+        {
+            f32* pFloats = stbi_loadf_from_memory(pData, (int)size, &width, &height, &channels, STBI_rgb_alpha);
+            if (pFloats == nullptr)
+                return false;
+
+            out.width = (u32)width;
+            out.height = (u32)height;
+            out.sourceChannels = channels;
+            if (settings.halfFloatHDR)
+            {
+                out.pPixels = (u8*)ConvertToHalf(pFloats, out.width, out.height);
+                out.format = DecodedPixelFormat::RGBA16F;
+                stbi_image_free(pFloats);
+            }
+            else
+            {
+                out.pPixels = (u8*)pFloats;
+                out.format = DecodedPixelFormat::RGBA32F;
+            }
+            return true;
+        }
+
+        stbi_uc* pPixels = stbi_load_from_memory(pData, (int)size, &width, &height, &channels, STBI_rgb_alpha);
+        if (pPixels == nullptr)
+            return false;
+        out.pPixels = pPixels;
+        out.width = (u32)width;
+        out.height = (u32)height;
+        out.sourceChannels = channels;
+        out.format = DecodedPixelFormat::RGBA8;
+        return true;
+    }
+};
+
+// Radiance RGBE files with new style run length encoded scanlines
+// Every scanline carries its own header, so a cheap pass over the run lengths finds where each row starts and the rows
+// can then be expanded and converted in parallel, straight into half floats
+class RadianceHDRDecoder : public ImageDecoder
+{
+public:
+    const char* GetName() const override
+    {
+        return "Radiance HDR";
+    }
+
+    bool CanDecode(const u8* pData, u64 size) const override
+    {
+        Layout layout;
+        return ParseHeader(pData, size, layout);
+    }
+
+    bool Decode(const u8* pData, u64 size, const ImageDecodeSettings& settings, DecodedImage& out) const override
+    {
+        ScopedZone("RadianceHDRDecoder::Decode");
+        Layout layout;
+        if (ParseHeader(pData, size, layout) == false)
+            return false;
+        // Scanlines outside this range can't be run length encoded, those go to the fallback
+        if (layout.width < 8 || layout.width > 0x7fff)
+            return false;
+        // The header is untrusted, every scanline needs its 4 byte header plus at least one 2 byte run per 127 texels
+        // of each channel, so a size that can't hold that many rows is rejected before anything is allocated
+        if (layout.width > MAX_HDR_EXTENT || layout.height > MAX_HDR_EXTENT)
+            return false;
+        const u64 minRowBytes = 4 + 4 * 2 * (((u64)layout.width + 126) / 127);
+        if (layout.dataOffset > size || (u64)layout.height * minRowBytes > size - layout.dataOffset)
+            return false;
+
+        stltype::vector<u64> rowOffsets(layout.height);
+        u64 pos = layout.dataOffset;
+        for (u32 y = 0; y < layout.height; ++y)
+        {
+            if (pos + 4 > size || pData[pos] != 2 || pData[pos + 1] != 2 ||
+                (((u32)pData[pos + 2] << 8) | pData[pos + 3]) != layout.width)
+                return false;
+            rowOffsets[y] = pos;
+            pos += 4;
+            for (u32 channel = 0; channel < 4; ++channel)
+            {
+                u32 x = 0;
+                while (x < layout.width)
+                {
+                    if (pos >= size)
+                        return false;
+                    u32 count = pData[pos++];
+                    if (count > 128)
+                    {
+                        count -= 128;
+                        pos += 1;
+                    }
+                    else
+                    {
+                        pos += count;
+                    }
+                    x += count;
+                    if (count == 0 || x > layout.width || pos > size)
+                        return false;
+                }
+            }
+        }
+
+        const DecodedPixelFormat format =
+            settings.halfFloatHDR ? DecodedPixelFormat::RGBA16F : DecodedPixelFormat::RGBA32F;
+        const u64 rowPitch = (u64)layout.width * GetTexelSize(format);
+        u8* pPixels = (u8*)malloc(rowPitch * layout.height);
+
+        const u32 width = layout.width;
+        ForEachRowRange(width,
+                        layout.height,
+                        [&](u32 firstRow, u32 rowCount)
+                        {
+                            stltype::vector<u8> rgbe(width * 4);
+                            stltype::vector<f32> texels(width * 4);
+                            for (u32 y = firstRow; y < firstRow + rowCount; ++y)
+                            {
+                                ExpandScanline(pData + rowOffsets[y] + 4, width, rgbe.data());
+                                for (u32 x = 0; x < width; ++x)
+                                {
+                                    const u8* pRGBE = &rgbe[x * 4];
+                                    // Same reconstruction as stb so both decoders produce identical texels
+                                    const f32 scale = pRGBE[3] != 0 ? ldexpf(1.0f, (s32)pRGBE[3] - (128 + 8)) : 0.0f;
+                                    texels[x * 4 + 0] = pRGBE[0] * scale;
+                                    texels[x * 4 + 1] = pRGBE[1] * scale;
+                                    texels[x * 4 + 2] = pRGBE[2] * scale;
+                                    texels[x * 4 + 3] = 1.0f;
+                                }
+
+                                u8* pDstRow = pPixels + y * rowPitch;
+                                if (format == DecodedPixelFormat::RGBA16F)
+                                {
+                                    DirectX::PackedVector::XMConvertFloatToHalfStream(
+                                        (u16*)pDstRow, sizeof(u16), texels.data(), sizeof(f32), (u64)width * 4);
+                                }
+                                else
+                                {
+                                    memcpy(pDstRow, texels.data(), rowPitch);
+                                }
+                            }
+                        });
+
+        out.pPixels = pPixels;
+        out.width = layout.width;
+        out.height = layout.height;
+        out.sourceChannels = 3;
+        out.format = format;
+        return true;
+    }
+
+private:
+    struct Layout
+    {
+        u32 width{0};
+        u32 height{0};
+        u64 dataOffset{0};
+    };
+
+    static bool ParseHeader(const u8* pData, u64 size, Layout& layout)
+    {
+        const auto startsWith = [&](u64 pos, const char* pPrefix)
+        {
+            const u64 length = strlen(pPrefix);
+            return pos + length <= size && memcmp(pData + pos, pPrefix, length) == 0;
+        };
+        if (startsWith(0, "#?RADIANCE") == false && startsWith(0, "#?RGBE") == false)
+            return false;
+
+        // Header lines up to the first empty one, only the pixel format matters
+        bool isRGBE = true;
+        u64 pos = 0;
+        while (true)
+        {
+            const u8* pLineEnd = (const u8*)memchr(pData + pos, '\n', size - pos);
+            if (pLineEnd == nullptr)
+                return false;
+            const u64 lineEnd = pLineEnd - pData;
+            if (lineEnd == pos)
+            {
+                pos = lineEnd + 1;
+                break;
+            }
+            if (startsWith(pos, "FORMAT="))
+                isRGBE = startsWith(pos, "FORMAT=32-bit_rle_rgbe");
+            pos = lineEnd + 1;
+        }
+        if (isRGBE == false)
+            return false;
+
+        // Only the standard top to bottom, left to right orientation, anything else goes to the fallback
+        const u8* pLineEnd = (const u8*)memchr(pData + pos, '\n', size - pos);
+        if (pLineEnd == nullptr || pLineEnd - (pData + pos) >= 64)
+            return false;
+        char resolution[64]{};
+        memcpy(resolution, pData + pos, pLineEnd - (pData + pos));
+        if (sscanf(resolution, "-Y %u +X %u", &layout.height, &layout.width) != 2 || layout.width == 0 ||
+            layout.height == 0)
+            return false;
+        layout.dataOffset = (pLineEnd - pData) + 1;
+        return true;
+    }
+
+    // Channels are stored one after another, each as runs (count > 128) or literal spans
+    static void ExpandScanline(const u8* pSrc, u32 width, u8* pRGBE)
+    {
+        for (u32 channel = 0; channel < 4; ++channel)
+        {
+            u32 x = 0;
+            while (x < width)
+            {
+                u32 count = *pSrc++;
+                if (count > 128)
+                {
+                    count -= 128;
+                    const u8 value = *pSrc++;
+                    for (u32 i = 0; i < count; ++i)
+                    {
+                        pRGBE[(x + i) * 4 + channel] = value;
+                    }
+                }
+                else
+                {
+                    for (u32 i = 0; i < count; ++i)
+                    {
+                        pRGBE[(x + i) * 4 + channel] = *pSrc++;
+                    }
+                }
+                x += count;
+            }
+        }
+    }
+};
+
+// Built-in decoders are created on first use, later registrations are only expected before loading starts since
+// lookups don't lock
+struct DecoderRegistry
+{
+    stltype::vector<stltype::unique_ptr<ImageDecoder>> decoders;
+
+    DecoderRegistry()
+    {
+        decoders.push_back(stltype::make_unique<RadianceHDRDecoder>());
+        decoders.push_back(stltype::make_unique<StbImageDecoder>());
+    }
+};
+
+static DecoderRegistry& GetRegistry()
+{
+    static DecoderRegistry registry;
+    return registry;
+}
+
+void RegisterDecoder(stltype::unique_ptr<ImageDecoder>&& pDecoder)
+{
+    auto& decoders = GetRegistry().decoders;
+    decoders.insert(decoders.begin(), stltype::move(pDecoder));
+}
+
+bool Decode(const u8* pData, u64 size, const ImageDecodeSettings& settings, DecodedImage& out)
+{
+    ScopedZone("ImageDecoding::Decode");
+    for (const auto& pDecoder : GetRegistry().decoders)
+    {
+        if (pDecoder->CanDecode(pData, size) && pDecoder->Decode(pData, size, settings, out))
+            return true;
+    }
+    return false;
+}
+
+stltype::vector<DecodeBenchmarkEntry> RunDecodeBenchmark(const stltype::vector<stltype::string>& filePaths,
+                                                         u32 iterations)
+{
+    ScopedZone("ImageDecoding::Run Decode Benchmark");
+    using Clock = stltype::chrono::steady_clock;
+    const auto elapsedMs = [](Clock::time_point start)
+    {
+        return stltype::chrono::duration<f64, stltype::chrono::milliseconds::period>(Clock::now() - start).count();
+    };
+    iterations = stltype::max(iterations, 1u);
+
+    const auto& decoders = GetRegistry().decoders;
+    stltype::vector<DecodeBenchmarkEntry> results(decoders.size());
+    for (u32 i = 0; i < decoders.size(); ++i)
+    {
+        results[i].decoderName = decoders[i]->GetName();
+    }
+
+    // Materials reference the same file under several semantics, each image is measured once
+    stltype::hash_set<stltype::string> visitedPaths;
+    for (const auto& filePath : filePaths)
+    {
+        if (visitedPaths.insert(filePath).second == false)
+            continue;
+
+        std::ifstream fileStream(filePath.c_str(), std::ios::ate | std::ios::binary);
+        if (fileStream.is_open() == false)
+            continue;
+        stltype::vector<u8> bytes((u64)fileStream.tellg());
+        fileStream.seekg(0);
+        fileStream.read((char*)bytes.data(), bytes.size());
+
+        auto start = Clock::now();
+        bool referenceDecoded = true;
+        for (u32 it = 0; it < iterations && referenceDecoded; ++it)
+        {
+            referenceDecoded = DecodeReference(bytes.data(), bytes.size());
+        }
+        if (referenceDecoded == false)
+            continue;
+        const f64 referenceMs = elapsedMs(start) / iterations;
+
+        for (u32 i = 0; i < decoders.size(); ++i)
+        {
+            if (decoders[i]->CanDecode(bytes.data(), bytes.size()) == false)
+                continue;
+
+            DecodedImage image{};
+            bool decoded = true;
+            start = Clock::now();
+            for (u32 it = 0; it < iterations && decoded; ++it)
+            {
+                free(image.pPixels);
+                image = {};
+                decoded = decoders[i]->Decode(bytes.data(), bytes.size(), ImageDecodeSettings{}, image);
+            }
+            const f64 decodeMs = elapsedMs(start) / iterations;
+            free(image.pPixels);
+            if (decoded == false)
+                continue;
+
+            auto& result = results[i];
+            ++result.imageCount;
+            result.sourceBytes += bytes.size();
+            result.texelCount += (u64)image.width * image.height;
+            result.decodeTimeMs += decodeMs;
+            result.referenceTimeMs += referenceMs;
+        }
+    }
+
+    for (const auto& result : results)
+    {
+        if (result.imageCount == 0)
+            continue;
+        DEBUG_LOGF("[ImageDecoding] {}: {} images, {:.1f} MB, {:.2f} ms ({:.1f} MTexels/s), reference {:.2f} ms, "
+                   "{:.2f}x",
+                   result.decoderName.c_str(),
+                   result.imageCount,
+                   result.sourceBytes / (1024.0 * 1024.0),
+                   result.decodeTimeMs,
+                   result.texelCount / (result.decodeTimeMs * 1000.0),
+                   result.referenceTimeMs,
+                   result.referenceTimeMs / result.decodeTimeMs);
+    }
+    return results;
+}
+} // namespace ImageDecoding
@@ -0,0 +1,76 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include <EASTL/unique_ptr.h>
+
+// Decoding of source image files into plain texel arrays
+// Decoders are registered in priority order, the first one that recognizes the data and succeeds wins, later ones
+// act as fallbacks for encodings the earlier ones don't handle
+namespace ImageDecoding
+{
+// Bump whenever a decoder produces different texels so cached decodes get refreshed
+static inline constexpr u64 IMAGE_DECODE_VERSION = 1;
+
+// Images with at least this many texels are split into row ranges by decoders that support it
+static inline constexpr u64 PARALLEL_DECODE_MIN_TEXELS = 1024 * 1024;
+
+enum class DecodedPixelFormat : u8
+{
+    RGBA8,
+    RGBA16F,
+    RGBA32F
+};
+
+struct ImageDecodeSettings
+{
+    // HDR sources are written as half floats directly, halves the memory of the decode and the upload
+    bool halfFloatHDR{true};
+};
+
+struct DecodedImage
+{
+    // malloc'd, ownership goes to the caller
+    u8* pPixels{nullptr};
+    u32 width{0};
+    u32 height{0};
+    s32 sourceChannels{0};
+    DecodedPixelFormat format{DecodedPixelFormat::RGBA8};
+};
+
+u32 GetTexelSize(DecodedPixelFormat format);
+
+class ImageDecoder
+{
+public:
+    virtual ~ImageDecoder() = default;
+
+    virtual const char* GetName() const = 0;
+    // Only looks at the signature/header, Decode may still fail for unsupported encodings
+    virtual bool CanDecode(const u8* pData, u64 size) const = 0;
+    virtual bool Decode(const u8* pData, u64 size, const ImageDecodeSettings& settings, DecodedImage& out) const = 0;
+};
+
+// Registered decoders take priority over the built-in ones and over decoders registered before them
+void RegisterDecoder(stltype::unique_ptr<ImageDecoder>&& pDecoder);
+
+// Returns false if no decoder could handle the data
+bool Decode(const u8* pData, u64 size, const ImageDecodeSettings& settings, DecodedImage& out);
+
+struct DecodeBenchmarkEntry
+{
+    stltype::string decoderName;
+    u32 imageCount{0};
+    u64 sourceBytes{0};
+    u64 texelCount{0};
+    f64 decodeTimeMs{0.0};
+    // Against single threaded stb without SIMD over the same images, see DecodeReference
+    f64 referenceTimeMs{0.0};
+};
+
+// Single threaded stb built without SIMD into RGBA8 or RGBA32F, the benchmark's baseline. Returns false on failure
+bool DecodeReference(const u8* pData, u64 size);
+
+// Decodes every listed image iterations times with each decoder that recognizes it and with the reference path
+// Runs on the calling thread and logs a summary, duplicate paths are decoded once
+stltype::vector<DecodeBenchmarkEntry> RunDecodeBenchmark(const stltype::vector<stltype::string>& filePaths,
+                                                         u32 iterations = 3);
+} // namespace ImageDecoding
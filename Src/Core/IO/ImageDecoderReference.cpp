@@ -0,0 +1,36 @@
+#include "ImageDecoder.h"
+// Everything stb pulls in has to be included outside the namespace first
+#include <assert.h>
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Second stb_image build without its SSE2 paths for the decode benchmark's baseline
+// Static and in its own namespace so it can't collide with the SIMD build in ImageDecoder.cpp
+#undef abs
+#define STB_IMAGE_STATIC
+#define STBI_NO_SIMD
+#define STB_IMAGE_IMPLEMENTATION
+namespace StbNoSIMD
+{
+#include <stb/stb_image.h>
+} // namespace StbNoSIMD
+
+namespace ImageDecoding
+{
+bool DecodeReference(const u8* pData, u64 size)
+{
+    using namespace StbNoSIMD;
+    s32 width, height, channels;
+    void* pPixels = stbi_is_hdr_from_memory(pData, (int)size)
+                        ? (void*)stbi_loadf_from_memory(pData, (int)size, &width, &height, &channels, STBI_rgb_alpha)
+                        : (void*)stbi_load_from_memory(pData, (int)size, &width, &height, &channels, STBI_rgb_alpha);
+    stbi_image_free(pPixels);
+    return pPixels != nullptr;
+}
+} // namespace ImageDecoding
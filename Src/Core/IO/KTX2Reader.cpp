@@ -0,0 +1,242 @@
+#include "KTX2Reader.h"
+#include "Core/Global/GlobalVariables.h"
+#include "Core/Global/Profiling.h"
+#include "Core/Global/ThreadPool.h"
+#include "FileReader.h"
+#include <fstream>
+#include <zstd.h>
+
+namespace KTX2
+{
+static inline constexpr u8 KTX2_IDENTIFIER[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+struct Header
+{
+    u8 identifier[12];
+    u32 vkFormat;
+    u32 typeSize;
+    u32 pixelWidth;
+    u32 pixelHeight;
+    u32 pixelDepth;
+    u32 layerCount;
+    u32 faceCount;
+    u32 levelCount;
+    u32 supercompressionScheme;
+    u32 dfdByteOffset;
+    u32 dfdByteLength;
+    u32 kvdByteOffset;
+    u32 kvdByteLength;
+    u64 sgdByteOffset;
+    u64 sgdByteLength;
+};
+static_assert(sizeof(Header) == 80);
+
+struct LevelIndexEntry
+{
+    u64 byteOffset;
+    u64 byteLength;
+    u64 uncompressedByteLength;
+};
+static_assert(sizeof(LevelIndexEntry) == 24);
+
+enum class SupercompressionScheme : u32
+{
+    None = 0,
+    BasisLZ = 1,
+    Zstandard = 2,
+    ZLIB = 3
+};
+
+// KTX2 stores Vulkan formats, the rest of the loader passes DXGI formats around like for DDS
+// Both BC1 variants map to the same DXGI format, ReadTextureInfo::vkFormat keeps the cut-out alpha of BC1 RGBA
+static u32 GetDXGIFormat(u32 vkFormat)
+{
+    switch (vkFormat)
+    {
+        case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+            return 71;
+        case 132: // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+        case 134: // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+            return 72;
+        case 135: return 74; // VK_FORMAT_BC2_UNORM_BLOCK
+        case 136: return 75; // VK_FORMAT_BC2_SRGB_BLOCK
+        case 137: return 77; // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138: return 78; // VK_FORMAT_BC3_SRGB_BLOCK
+        case 139: return 80; // VK_FORMAT_BC4_UNORM_BLOCK
+        case 140: return 81; // VK_FORMAT_BC4_SNORM_BLOCK
+        case 141: return 83; // VK_FORMAT_BC5_UNORM_BLOCK
+        case 142: return 84; // VK_FORMAT_BC5_SNORM_BLOCK
+        case 143: return 95; // VK_FORMAT_BC6H_UFLOAT_BLOCK
+        case 144: return 96; // VK_FORMAT_BC6H_SFLOAT_BLOCK
+        case 145: return 98; // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146: return 99; // VK_FORMAT_BC7_SRGB_BLOCK
+        default: return 0;
+    }
+}
+
+static void FreeLevels(ReadTextureInfo& info)
+{
+    for (auto& mipData : info.mipmapPixels)
+    {
+        free(mipData.pData);
+    }
+    info.mipmapPixels.clear();
+}
+
+bool ReadTexture(const stltype::string& filePath, u32 firstMipLevel, u32 maxMipExtent, ReadTextureInfo& info)
+{
+    ScopedZone("KTX2::Read Texture");
+
+    std::ifstream fileStream(filePath.c_str(), std::ios::ate | std::ios::binary);
+    const u64 fileSize = fileStream.is_open() ? (u64)fileStream.tellg() : 0;
+    fileStream.seekg(0);
+    Header header{};
+    if (fileStream.read((char*)&header, sizeof(Header)).good() == false ||
+        memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+    {
+        DEBUG_LOGF("[KTX2] Not a KTX2 file: {}", filePath.data());
+        return false;
+    }
+
+    const u32 dxgiFormat = GetDXGIFormat(header.vkFormat);
+    if (dxgiFormat == 0)
+    {
+        DEBUG_LOGF(
+            "[KTX2] Unsupported format {} in {}, only BCn payloads are supported", header.vkFormat, filePath.data());
+        return false;
+    }
+    if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+    {
+        DEBUG_LOGF("[KTX2] Only single 2D images are supported: {}", filePath.data());
+        return false;
+    }
+    const auto scheme = (SupercompressionScheme)header.supercompressionScheme;
+    if (scheme != SupercompressionScheme::None && scheme != SupercompressionScheme::Zstandard)
+    {
+        DEBUG_LOGF(
+            "[KTX2] Unsupported supercompression scheme {} in {}", header.supercompressionScheme, filePath.data());
+        return false;
+    }
+
+    // A level count of 0 asks the loader to generate mips, which block compressed data can't go through
+    const u32 levelCount = stltype::max(header.levelCount, 1u);
+    // No u32 sized image has more than 32 levels, checked before the index is sized from the header
+    if (levelCount > 32 || sizeof(Header) + levelCount * sizeof(LevelIndexEntry) > fileSize)
+    {
+        DEBUG_LOGF("[KTX2] Level count {} doesn't fit in {}", levelCount, filePath.data());
+        return false;
+    }
+    stltype::vector<LevelIndexEntry> levelIndex(levelCount);
+    if (fileStream.read((char*)levelIndex.data(), levelCount * sizeof(LevelIndexEntry)).good() == false)
+    {
+        DEBUG_LOGF("[KTX2] Truncated level index: {}", filePath.data());
+        return false;
+    }
+
+    firstMipLevel = GetFirstRequestedMip(header.pixelWidth, header.pixelHeight, levelCount, firstMipLevel, maxMipExtent);
+    const u32 loadedLevelCount = levelCount - firstMipLevel;
+    const bool isSupercompressed = scheme == SupercompressionScheme::Zstandard;
+
+    // Every level has to lie inside the file and decompress to no more than its BCn size before anything is allocated
+    const bool isEightByteBlock = dxgiFormat == 71 || dxgiFormat == 72 || dxgiFormat == 80 || dxgiFormat == 81;
+    for (u32 i = firstMipLevel; i < levelCount; ++i)
+    {
+        const auto& level = levelIndex[i];
+        const u64 levelWidth = stltype::max(header.pixelWidth >> i, 1u);
+        const u64 levelHeight = stltype::max(header.pixelHeight >> i, 1u);
+        const u64 levelSize = ((levelWidth + 3) / 4) * ((levelHeight + 3) / 4) * (isEightByteBlock ? 8 : 16);
+        if (level.byteOffset > fileSize || level.byteLength > fileSize - level.byteOffset ||
+            (isSupercompressed && level.uncompressedByteLength > levelSize))
+        {
+            DEBUG_LOGF("[KTX2] Mip {} of {} has an out of range offset or size", i, filePath.data());
+            return false;
+        }
+    }
+
+    // Reads stay on this thread, only the decompression is spread out
+    stltype::vector<stltype::vector<u8>> compressedLevels(isSupercompressed ? loadedLevelCount : 0);
+    info.mipmapPixels.resize(loadedLevelCount, ReadMipmapInfo{nullptr, 0});
+    for (u32 i = 0; i < loadedLevelCount; ++i)
+    {
+        const auto& level = levelIndex[firstMipLevel + i];
+        auto& mipData = info.mipmapPixels[i];
+        mipData.size = isSupercompressed ? level.uncompressedByteLength : level.byteLength;
+        mipData.pData = (unsigned char*)malloc(mipData.size);
+
+        fileStream.seekg(level.byteOffset);
+        if (isSupercompressed)
+        {
+            compressedLevels[i].resize(level.byteLength);
+            fileStream.read((char*)compressedLevels[i].data(), level.byteLength);
+        }
+        else
+        {
+            fileStream.read((char*)mipData.pData, level.byteLength);
+        }
+
+        if (fileStream.good() == false)
+        {
+            DEBUG_LOGF("[KTX2] Failed to read mip {} of {}", firstMipLevel + i, filePath.data());
+            FreeLevels(info);
+            return false;
+        }
+    }
+
+    if (isSupercompressed)
+    {
+        ScopedZone("KTX2::Decompress Levels");
+        stltype::vector<size_t> results(loadedLevelCount);
+        const auto decompressLevel = [&](u32 i)
+        {
+            const auto& compressed = compressedLevels[i];
+            auto& mipData = info.mipmapPixels[i];
+            results[i] = ZSTD_decompress(mipData.pData, mipData.size, compressed.data(), compressed.size());
+        };
+
+        if (loadedLevelCount == 1)
+        {
+            decompressLevel(0);
+        }
+        else
+        {
+            ThreadPool::JobGroup jobs;
+            for (u32 i = 0; i < loadedLevelCount; ++i)
+            {
+                g_pJobPool->Submit([&decompressLevel, i]() { decompressLevel(i); }, &jobs);
+            }
+            g_pJobPool->Wait(jobs);
+        }
+
+        for (u32 i = 0; i < loadedLevelCount; ++i)
+        {
+            if (ZSTD_isError(results[i]) || results[i] != info.mipmapPixels[i].size)
+            {
+                DEBUG_LOGF("[KTX2] Failed to decompress mip {} of {}: {}",
+                           firstMipLevel + i,
+                           filePath.data(),
+                           ZSTD_isError(results[i]) ? ZSTD_getErrorName(results[i]) : "size mismatch");
+                FreeLevels(info);
+                return false;
+            }
+        }
+    }
+
+    info.extents.x = (s32)stltype::max(header.pixelWidth >> firstMipLevel, 1u);
+    info.extents.y = (s32)stltype::max(header.pixelHeight >> firstMipLevel, 1u);
+    info.firstMipLevel = firstMipLevel;
+    info.fullMipCount = levelCount;
+    info.fullExtents.x = (s32)header.pixelWidth;
+    info.fullExtents.y = (s32)stltype::max(header.pixelHeight, 1u);
+    info.ddsFormat = dxgiFormat;
+    info.vkFormat = header.vkFormat;
+    // Same simplification as for DDS, the single and dual channel formats are the only ones without alpha
+    info.supportsAlpha = dxgiFormat < 80 || dxgiFormat > 84;
+    info.dataSize = 0;
+    for (const auto& mipData : info.mipmapPixels)
+    {
+        info.dataSize += mipData.size;
+    }
+    return true;
+}
+} // namespace KTX2
@@ -0,0 +1,15 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+
+struct ReadTextureInfo;
+
+// KTX2 containers with block compressed payloads, either stored plain or Zstandard supercompressed
+// Only the header and the level index are read up front, every mip is then read through its own offset in the index so
+// levels that weren't requested are never touched
+namespace KTX2
+{
+// Reads the mips from the first one allowed by firstMipLevel and maxMipExtent (see GetFirstRequestedMip) down to the
+// smallest one, extents are those of the first read mip
+// Supercompressed levels are decompressed in parallel, one job per level
+bool ReadTexture(const stltype::string& filePath, u32 firstMipLevel, u32 maxMipExtent, ReadTextureInfo& info);
+} // namespace KTX2
@@ -14,6 +14,8 @@
 #include "Core/SceneGraph/Mesh.h"
 #include <initializer_list>
 #include "Core/Global/ThreadPool.h"
+#include "Core/IO/AssetCache.h"
+#include "Core/IO/MeshOptimizer.h"
 #include <eathread/eathread.h>
 
 namespace MeshConversion
@@ -38,7 +40,15 @@ DirectX::XMFLOAT2 ConvertUV(const aiVector3D& v)
     return DirectX::XMFLOAT2(v.x, v.y);
 }
 
-Entity ConvertScene(ThreadPool* pPool, const aiScene* pScene, const aiNode* pNode, Entity parentEntity)
+AssetKey BuildMeshKey(AssetKey sceneKey, u32 meshIdx)
+{
+    return AssetHashing::Combine(sceneKey, (u64)meshIdx + 1);
+}
+
+Entity ConvertScene(const aiScene* pScene,
+                    const aiNode* pNode,
+                    Entity parentEntity,
+                    stltype::vector<ExtractedMeshData>& extractedMeshes)
 {
     ScopedZone("Convert Assimp Node");
 
@@ -109,9 +119,23 @@ Entity ConvertScene(ThreadPool* pPool, const aiScene* pScene, const aiNode* pNod
         ScopedZone("Convert Assimp leaf Node");
 
         Entity childEntity = g_pEntityManager->CreateEntity();
-        const auto& pAiMesh = pScene->mMeshes[pNode->mMeshes[i]];
+        const u32 meshIdx = pNode->mMeshes[i];
+        const auto& pAiMesh = pScene->mMeshes[meshIdx];
 
-        auto pConvMesh = ExtractMesh(pAiMesh);
+        // Nodes referencing the same aiMesh and aiMeshes with identical geometry all end up on one Mesh
+        auto& extracted = extractedMeshes[meshIdx];
+        if (extracted.pMesh == nullptr)
+        {
+            extracted.pMesh = g_pMeshManager->FindOrAllocateMesh(stltype::move(extracted.vertices),
+                                                                 stltype::move(extracted.indices),
+                                                                 extracted.contentHash,
+                                                                 stltype::move(extracted.lods),
+                                                                 stltype::move(extracted.meshlets),
+                                                                 stltype::move(extracted.meshletIndices));
+            extracted.pMesh->uvDensity = extracted.uvDensity;
+        }
+        Mesh* pConvMesh = extracted.pMesh;
+        g_pMeshManager->AddMeshInstance(pConvMesh);
         auto* pConvMaterial = ExtractMaterial(pScene->mMaterials[pAiMesh->mMaterialIndex]);
 
         auto* pTransform = g_pEntityManager->GetComponentUnsafe<Components::Transform>(childEntity);
@@ -131,13 +155,13 @@ Entity ConvertScene(ThreadPool* pPool, const aiScene* pScene, const aiNode* pNod
 
     for (u32 i = 0; i < pNode->mNumChildren; ++i)
     {
-        ConvertScene(pPool, pScene, pNode->mChildren[i], nodeEntity);
+        ConvertScene(pScene, pNode->mChildren[i], nodeEntity, extractedMeshes);
     }
 
     return nodeEntity;
 }
 
-SceneNode Convert(const aiScene* pScene)
+SceneNode Convert(const aiScene* pScene, AssetKey sceneKey, const stltype::string& sourceName)
 {
     ScopedZone("Convert Assimp Scene");
     DEBUG_ASSERT(CheckScene(pScene));
@@ -164,20 +188,182 @@ SceneNode Convert(const aiScene* pScene)
         g_pApplicationState->RegisterUpdateFunction([camEnt](ApplicationState& state)
                                                     { state.mainCameraEntity = camEnt; });
     }
-    //ThreadPool pool(8);
-    ConvertScene(nullptr, pScene, pScene->mRootNode, rootEntity);
+
+    // Meshes are extracted in parallel, entity creation and mesh allocation happen afterwards in a single merge pass
+    stltype::vector<ExtractedMeshData> extractedMeshes(pScene->mNumMeshes);
+    {
+        ScopedZone("Extract Assimp Meshes");
+        ThreadPool::JobGroup jobs;
+        for (u32 i = 0; i < pScene->mNumMeshes; ++i)
+        {
+            g_pJobPool->Submit(
+                [pScene, i, sceneKey, &sourceName, &extractedMeshes]()
+                {
+                    auto& extracted = extractedMeshes[i];
+                    ExtractMeshData(pScene->mMeshes[i],
+                                    extracted,
+                                    sceneKey != 0 ? BuildMeshKey(sceneKey, i) : 0,
+                                    sourceName + "#" + stltype::to_string(i));
+                    extracted.contentHash = MeshManager::HashMeshContent(extracted.vertices, extracted.indices);
+                    extracted.uvDensity = MeshManager::ComputeUVDensity(extracted.vertices, extracted.indices);
+                },
+                &jobs);
+        }
+        g_pJobPool->Wait(jobs);
+    }
+
+    const u32 dedupedBefore = g_pMeshManager->GetDeduplicatedMeshCount();
+    ConvertScene(pScene, pScene->mRootNode, rootEntity, extractedMeshes);
+
+    stltype::hash_set<const Mesh*> uniqueMeshes;
+    for (const auto& extracted : extractedMeshes)
+    {
+        if (extracted.pMesh)
+            uniqueMeshes.insert(extracted.pMesh);
+    }
+    u32 instanceCount = 0;
+    u32 instancedMeshCount = 0;
+    for (const Mesh* pMesh : uniqueMeshes)
+    {
+        const u32 meshInstances = g_pMeshManager->GetMeshInstanceCount(pMesh);
+        instanceCount += meshInstances;
+        instancedMeshCount += meshInstances > 1 ? 1 : 0;
+    }
+    DEBUG_LOGF("[MeshConverter] {} assimp meshes -> {} unique meshes ({} merged by content), {} instances, {} meshes "
+               "instanced",
+               pScene->mNumMeshes,
+               (u32)uniqueMeshes.size(),
+               g_pMeshManager->GetDeduplicatedMeshCount() - dedupedBefore,
+               instanceCount,
+               instancedMeshCount);
     g_pQueueHandler->DispatchAllRequests();
     return SceneNode{rootEntity};
 }
 
-Mesh* ExtractMesh(const aiMesh* pMesh)
+// Layout: header, vertices, LOD 0 indices, meshlets, meshlet indices, then a CookedLODHeader followed by its indices
+// for every coarser LOD
+struct CookedMeshHeader
+{
+    u32 vertexCount;
+    u32 indexCount;
+    u32 meshletCount;
+    u32 meshletIndexCount;
+    u32 lodCount;
+};
+
+struct CookedLODHeader
+{
+    u32 indexCount;
+    f32 error;
+};
+
+static bool LoadCookedMesh(AssetKey meshKey, const stltype::string& sourceName, ExtractedMeshData& out)
+{
+    stltype::vector<u8> cooked;
+    if (g_pAssetCache->Load(AssetKind::Mesh, meshKey, sourceName, cooked) == false ||
+        cooked.size() < sizeof(CookedMeshHeader))
+        return false;
+
+    CookedMeshHeader header;
+    memcpy(&header, cooked.data(), sizeof(CookedMeshHeader));
+    const u64 vertexBytes = (u64)header.vertexCount * sizeof(CompleteVertex);
+    const u64 indexBytes = (u64)header.indexCount * sizeof(u32);
+    const u64 meshletBytes = (u64)header.meshletCount * sizeof(MeshletData);
+    const u64 meshletIndexBytes = (u64)header.meshletIndexCount * sizeof(u32);
+    if (header.lodCount >= MESH_MAX_LODS ||
+        cooked.size() < sizeof(CookedMeshHeader) + vertexBytes + indexBytes + meshletBytes + meshletIndexBytes)
+        return false;
+
+    out.vertices.resize(header.vertexCount);
+    out.indices.resize(header.indexCount);
+    out.meshlets.resize(header.meshletCount);
+    out.meshletIndices.resize(header.meshletIndexCount);
+    u64 offset = sizeof(CookedMeshHeader);
+    memcpy(out.vertices.data(), cooked.data() + offset, vertexBytes);
+    offset += vertexBytes;
+    memcpy(out.indices.data(), cooked.data() + offset, indexBytes);
+    offset += indexBytes;
+    memcpy(out.meshlets.data(), cooked.data() + offset, meshletBytes);
+    offset += meshletBytes;
+    memcpy(out.meshletIndices.data(), cooked.data() + offset, meshletIndexBytes);
+    offset += meshletIndexBytes;
+
+    out.lods.resize(header.lodCount);
+    for (auto& lod : out.lods)
+    {
+        CookedLODHeader lodHeader;
+        if (cooked.size() < offset + sizeof(CookedLODHeader))
+            return false;
+        memcpy(&lodHeader, cooked.data() + offset, sizeof(CookedLODHeader));
+        offset += sizeof(CookedLODHeader);
+
+        const u64 lodIndexBytes = (u64)lodHeader.indexCount * sizeof(u32);
+        if (cooked.size() < offset + lodIndexBytes)
+            return false;
+        lod.error = lodHeader.error;
+        lod.indices.resize(lodHeader.indexCount);
+        memcpy(lod.indices.data(), cooked.data() + offset, lodIndexBytes);
+        offset += lodIndexBytes;
+    }
+    return offset == cooked.size();
+}
+
+static void StoreCookedMesh(const ExtractedMeshData& mesh,
+                            AssetKey meshKey,
+                            const stltype::string& sourceName,
+                            f32 cookTimeMs)
+{
+    const CookedMeshHeader header{(u32)mesh.vertices.size(),
+                                  (u32)mesh.indices.size(),
+                                  (u32)mesh.meshlets.size(),
+                                  (u32)mesh.meshletIndices.size(),
+                                  (u32)mesh.lods.size()};
+    const u64 vertexBytes = (u64)header.vertexCount * sizeof(CompleteVertex);
+    const u64 indexBytes = (u64)header.indexCount * sizeof(u32);
+    const u64 meshletBytes = (u64)header.meshletCount * sizeof(MeshletData);
+    const u64 meshletIndexBytes = (u64)header.meshletIndexCount * sizeof(u32);
+    u64 lodBytes = 0;
+    for (const auto& lod : mesh.lods)
+    {
+        lodBytes += sizeof(CookedLODHeader) + lod.indices.size() * sizeof(u32);
+    }
+
+    stltype::vector<u8> cooked(sizeof(CookedMeshHeader) + vertexBytes + indexBytes + meshletBytes + meshletIndexBytes +
+                               lodBytes);
+    memcpy(cooked.data(), &header, sizeof(CookedMeshHeader));
+    u64 offset = sizeof(CookedMeshHeader);
+    memcpy(cooked.data() + offset, mesh.vertices.data(), vertexBytes);
+    offset += vertexBytes;
+    memcpy(cooked.data() + offset, mesh.indices.data(), indexBytes);
+    offset += indexBytes;
+    memcpy(cooked.data() + offset, mesh.meshlets.data(), meshletBytes);
+    offset += meshletBytes;
+    memcpy(cooked.data() + offset, mesh.meshletIndices.data(), meshletIndexBytes);
+    offset += meshletIndexBytes;
+    for (const auto& lod : mesh.lods)
+    {
+        const CookedLODHeader lodHeader{(u32)lod.indices.size(), lod.error};
+        memcpy(cooked.data() + offset, &lodHeader, sizeof(CookedLODHeader));
+        offset += sizeof(CookedLODHeader);
+        memcpy(cooked.data() + offset, lod.indices.data(), lod.indices.size() * sizeof(u32));
+        offset += lod.indices.size() * sizeof(u32);
+    }
+    g_pAssetCache->Store(AssetKind::Mesh, meshKey, sourceName, cooked.data(), cooked.size(), cookTimeMs);
+}
+
+void ExtractMeshData(const aiMesh* pMesh, ExtractedMeshData& out, AssetKey meshKey, const stltype::string& sourceName)
 {
     ScopedZone("Convert Assimp Mesh");
 
-    auto* pConvMesh = g_pMeshManager->AllocateMesh(pMesh->mNumVertices, pMesh->mNumFaces);
+    if (meshKey != 0 && LoadCookedMesh(meshKey, sourceName, out))
+        return;
+    const auto start = stltype::chrono::steady_clock::now();
+
+    out.vertices.reserve(pMesh->mNumVertices);
+    out.indices.reserve(pMesh->mNumFaces * 3);
     for (u32 i = 0; i < pMesh->mNumVertices; ++i)
     {
-        auto& vertex = pConvMesh->vertices.push_back();
+        auto& vertex = out.vertices.push_back();
         vertex.position = Convert(pMesh->mVertices[i]);
         if (pMesh->HasNormals() == false)
         {
@@ -211,11 +397,52 @@ Mesh* ExtractMesh(const aiMesh* pMesh)
 
     for (u32 i = 0; i < pMesh->mNumFaces; ++i)
     {
-        pConvMesh->indices.push_back(pMesh->mFaces[i].mIndices[0]);
-        pConvMesh->indices.push_back(pMesh->mFaces[i].mIndices[1]);
-        pConvMesh->indices.push_back(pMesh->mFaces[i].mIndices[2]);
+        out.indices.push_back(pMesh->mFaces[i].mIndices[0]);
+        out.indices.push_back(pMesh->mFaces[i].mIndices[1]);
+        out.indices.push_back(pMesh->mFaces[i].mIndices[2]);
+    }
+
+    const auto report = MeshOptimization::OptimizeMesh(out.vertices, out.indices);
+    DEBUG_LOGF("[MeshConverter] Optimized {}: ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, {} unused vertices removed",
+               pMesh->mName.C_Str(),
+               report.before.acmr,
+               report.after.acmr,
+               report.before.atvr,
+               report.after.atvr,
+               report.removedVertices);
+
+    MeshOptimization::BuildMeshlets(out.vertices, out.indices, out.meshlets, out.meshletIndices);
+    MeshOptimization::GenerateLODChain(out.vertices, out.indices, out.lods);
+    if (out.lods.empty() == false)
+    {
+        DEBUG_LOGF("[MeshConverter] {} LODs for {}: {} -> {} triangles, error {:.4f}",
+                   (u32)out.lods.size(),
+                   pMesh->mName.C_Str(),
+                   (u32)out.indices.size() / 3,
+                   (u32)out.lods.back().indices.size() / 3,
+                   out.lods.back().error);
+    }
+
+    if (meshKey != 0)
+    {
+        const f32 cookTimeMs = stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+                                   stltype::chrono::steady_clock::now() - start)
+                                   .count();
+        StoreCookedMesh(out, meshKey, sourceName, cookTimeMs);
     }
+}
 
+Mesh* ExtractMesh(const aiMesh* pMesh, AssetKey meshKey, const stltype::string& sourceName)
+{
+    ExtractedMeshData extracted;
+    ExtractMeshData(pMesh, extracted, meshKey, sourceName);
+    const f32 uvDensity = MeshManager::ComputeUVDensity(extracted.vertices, extracted.indices);
+    auto* pConvMesh =
+        g_pMeshManager->AllocateMesh(stltype::move(extracted.vertices), stltype::move(extracted.indices));
+    pConvMesh->lods = stltype::move(extracted.lods);
+    pConvMesh->meshlets = stltype::move(extracted.meshlets);
+    pConvMesh->meshletIndices = stltype::move(extracted.meshletIndices);
+    pConvMesh->uvDensity = uvDensity;
     return pConvMesh;
 }
 Material* ExtractMaterial(const aiMaterial* pMaterial)
@@ -254,9 +481,13 @@ Material* ExtractMaterial(const aiMaterial* pMaterial)
                 }
 
                 stltype::string fullPath = "Resources\\Models\\" + texPath;
-                outHandle = g_pTexManager->MakeTextureBindless(
+                const BindlessSlot slot = g_pTexManager->MakeTextureBindless(
                     g_pTexManager->SubmitAsyncTextureCreation({fullPath, true, semantic}));
-                
+                // Without a slot the material falls back to its untextured path instead of sampling the placeholder
+                if (slot.IsValid() == false)
+                    return false;
+                outHandle = slot.index;
+
                 SetMaterialFlag(mat.flags, bit, true);
                 return true;
             }
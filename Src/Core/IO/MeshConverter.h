@@ -1,18 +1,48 @@
 #pragma once
 #include "Core/Global/GlobalDefines.h"
+#include "Core/IO/AssetCache.h"
+#include "Core/SceneGraph/Mesh.h"
 #include "Core/SceneGraph/Scene.h"
 #include <assimp/scene.h>
 
 namespace MeshConversion
 {
+// Bump whenever the output of ExtractMesh changes so stale cooked meshes aren't picked up anymore
+static inline constexpr u64 MESH_COOK_VERSION = 4;
+
+// Key of the cooked data for the mesh at meshIdx of the scene identified by sceneKey
+AssetKey BuildMeshKey(AssetKey sceneKey, u32 meshIdx);
+
+// Result of extracting a single aiMesh, safe to produce from any thread since nothing is allocated in the managers
+struct ExtractedMeshData
+{
+    stltype::vector<CompleteVertex> vertices;
+    stltype::vector<u32> indices;
+    stltype::vector<MeshLOD> lods;
+    stltype::vector<MeshletData> meshlets;
+    stltype::vector<u32> meshletIndices;
+    u64 contentHash{0};
+    f32 uvDensity{0.0f};
+    // Set by the merge step once the mesh has been allocated in the MeshManager
+    Mesh* pMesh{nullptr};
+};
+
 // Creates an entity for every node in the assimp scene, creates appropriate components for all entities referencing
 // meshes, lights, cameras, etc. Also submits light data to the light manager, texture reads to the texture manager and
 // so on Adding this SceneNode to the scene should just work TM
-SceneNode Convert(const aiScene* pScene);
+// Meshes are read from/written to the asset cache if sceneKey is non-zero
+SceneNode Convert(const aiScene* pScene, AssetKey sceneKey = 0, const stltype::string& sourceName = {});
 
-Mesh* ExtractMesh(const aiMesh* pMesh);
+Mesh* ExtractMesh(const aiMesh* pMesh, AssetKey meshKey = 0, const stltype::string& sourceName = {});
+void ExtractMeshData(const aiMesh* pMesh,
+                     ExtractedMeshData& out,
+                     AssetKey meshKey = 0,
+                     const stltype::string& sourceName = {});
 stltype::vector<TextureHandle> ExtractMeshTextures(const aiMesh* pMesh);
 Material* ExtractMaterial(const aiMaterial* pMesh);
 
-ECS::Entity ConvertScene(const aiScene* pScene, const aiNode* pNode, ECS::Entity& parentEntity);
+ECS::Entity ConvertScene(const aiScene* pScene,
+                         const aiNode* pNode,
+                         ECS::Entity parentEntity,
+                         stltype::vector<ExtractedMeshData>& extractedMeshes);
 }; // namespace MeshConversion
\ No newline at end of file
@@ -0,0 +1,803 @@
+#include "MeshOptimizer.h"
+#include "Core/Global/Profiling.h"
+#include <EASTL/hash_set.h>
+#include <EASTL/sort.h>
+
+namespace MeshOptimization
+{
+static inline constexpr u32 INVALID_INDEX = ~0u;
+
+// Triangle adjacency per vertex in CSR layout
+struct VertexAdjacency
+{
+    stltype::vector<u32> offsets;
+    stltype::vector<u32> triangles;
+    stltype::vector<u32> liveTriangles;
+
+    VertexAdjacency(const stltype::vector<u32>& indices, u32 vertexCount)
+    {
+        offsets.assign(vertexCount + 1, 0);
+        liveTriangles.assign(vertexCount, 0);
+        for (u32 idx : indices)
+        {
+            ++liveTriangles[idx];
+        }
+        for (u32 v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + liveTriangles[v];
+        }
+
+        triangles.resize(indices.size());
+        stltype::vector<u32> fill(offsets.begin(), offsets.end() - 1);
+        const u32 triangleCount = (u32)indices.size() / 3;
+        for (u32 t = 0; t < triangleCount; ++t)
+        {
+            for (u32 c = 0; c < 3; ++c)
+            {
+                triangles[fill[indices[t * 3 + c]]++] = t;
+            }
+        }
+    }
+};
+
+VertexCacheStats AnalyzeVertexCache(const stltype::vector<u32>& indices, u32 vertexCount, u32 cacheSize)
+{
+    VertexCacheStats stats{};
+    if (indices.empty() || vertexCount == 0)
+        return stats;
+
+    // FIFO cache simulation through timestamps, a vertex is cached if it was pushed less than cacheSize misses ago
+    stltype::vector<u32> cacheTimestamps(vertexCount, 0);
+    stltype::vector<bool> isReferenced(vertexCount, false);
+    u32 timestamp = cacheSize + 1;
+    u32 misses = 0;
+    u32 referencedVertices = 0;
+    for (u32 idx : indices)
+    {
+        if (timestamp - cacheTimestamps[idx] > cacheSize)
+        {
+            cacheTimestamps[idx] = timestamp++;
+            ++misses;
+        }
+        if (isReferenced[idx] == false)
+        {
+            isReferenced[idx] = true;
+            ++referencedVertices;
+        }
+    }
+
+    stats.acmr = (f32)misses / (f32)(indices.size() / 3);
+    stats.atvr = referencedVertices > 0 ? (f32)misses / (f32)referencedVertices : 0.0f;
+    return stats;
+}
+
+static u32 SkipDeadEnd(const stltype::vector<u32>& liveTriangles,
+                       stltype::vector<u32>& deadEndStack,
+                       u32& inputCursor,
+                       u32 vertexCount)
+{
+    while (deadEndStack.empty() == false)
+    {
+        const u32 vertex = deadEndStack.back();
+        deadEndStack.pop_back();
+        if (liveTriangles[vertex] > 0)
+            return vertex;
+    }
+
+    while (inputCursor < vertexCount)
+    {
+        if (liveTriangles[inputCursor] > 0)
+            return inputCursor;
+        ++inputCursor;
+    }
+    return INVALID_INDEX;
+}
+
+static u32 GetNextVertex(const stltype::vector<u32>& candidates,
+                         const stltype::vector<u32>& liveTriangles,
+                         const stltype::vector<u32>& cacheTimestamps,
+                         u32 timestamp,
+                         u32 cacheSize)
+{
+    u32 bestVertex = INVALID_INDEX;
+    s32 bestPriority = -1;
+    for (u32 vertex : candidates)
+    {
+        if (liveTriangles[vertex] == 0)
+            continue;
+
+        // Prefer the oldest vertex that will still be in the cache after emitting all its remaining triangles
+        s32 priority = 0;
+        const u32 age = timestamp - cacheTimestamps[vertex];
+        if (age + 2 * liveTriangles[vertex] <= cacheSize)
+        {
+            priority = (s32)age;
+        }
+        if (priority > bestPriority)
+        {
+            bestPriority = priority;
+            bestVertex = vertex;
+        }
+    }
+    return bestVertex;
+}
+
+void OptimizeVertexCache(stltype::vector<u32>& indices,
+                         u32 vertexCount,
+                         u32 cacheSize,
+                         stltype::vector<u32>* pClusterStarts)
+{
+    ScopedZone("MeshOptimization::OptimizeVertexCache");
+    const u32 triangleCount = (u32)indices.size() / 3;
+    if (triangleCount == 0 || vertexCount == 0)
+        return;
+
+    VertexAdjacency adjacency(indices, vertexCount);
+    auto& liveTriangles = adjacency.liveTriangles;
+
+    stltype::vector<u32> cacheTimestamps(vertexCount, 0);
+    stltype::vector<bool> isEmitted(triangleCount, false);
+    stltype::vector<u32> deadEndStack;
+    deadEndStack.reserve(indices.size());
+    stltype::vector<u32> candidates;
+    candidates.reserve(64);
+
+    stltype::vector<u32> result;
+    result.reserve(indices.size());
+    if (pClusterStarts)
+    {
+        pClusterStarts->clear();
+    }
+
+    u32 timestamp = cacheSize + 1;
+    u32 inputCursor = 0;
+    u32 fanningVertex = SkipDeadEnd(liveTriangles, deadEndStack, inputCursor, vertexCount);
+    bool isRestart = true;
+    while (fanningVertex != INVALID_INDEX)
+    {
+        if (isRestart && pClusterStarts)
+        {
+            pClusterStarts->push_back((u32)result.size() / 3);
+        }
+
+        candidates.clear();
+        for (u32 i = adjacency.offsets[fanningVertex]; i < adjacency.offsets[fanningVertex + 1]; ++i)
+        {
+            const u32 triangle = adjacency.triangles[i];
+            if (isEmitted[triangle])
+                continue;
+
+            for (u32 c = 0; c < 3; ++c)
+            {
+                const u32 vertex = indices[triangle * 3 + c];
+                result.push_back(vertex);
+                deadEndStack.push_back(vertex);
+                candidates.push_back(vertex);
+                --liveTriangles[vertex];
+                if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                {
+                    cacheTimestamps[vertex] = timestamp++;
+                }
+            }
+            isEmitted[triangle] = true;
+        }
+
+        fanningVertex = GetNextVertex(candidates, liveTriangles, cacheTimestamps, timestamp, cacheSize);
+        isRestart = fanningVertex == INVALID_INDEX;
+        if (isRestart)
+        {
+            fanningVertex = SkipDeadEnd(liveTriangles, deadEndStack, inputCursor, vertexCount);
+        }
+    }
+
+    DEBUG_ASSERT(result.size() == indices.size());
+    indices = stltype::move(result);
+}
+
+void OptimizeOverdraw(stltype::vector<u32>& indices,
+                      const stltype::vector<CompleteVertex>& vertices,
+                      const stltype::vector<u32>& clusterStarts,
+                      f32 threshold,
+                      u32 cacheSize)
+{
+    ScopedZone("MeshOptimization::OptimizeOverdraw");
+    const u32 triangleCount = (u32)indices.size() / 3;
+    if (triangleCount == 0 || clusterStarts.empty())
+        return;
+
+    const u32 vertexCount = (u32)vertices.size();
+    const f32 targetAcmr = AnalyzeVertexCache(indices, vertexCount, cacheSize).acmr * threshold;
+
+    // Soft boundaries: split a cluster once its own miss ratio is already as good as the mesh average
+    // Restarting the cache there costs at most the threshold factor
+    stltype::vector<u32> boundaries;
+    boundaries.reserve(clusterStarts.size() * 2 + 1);
+    stltype::vector<u32> cacheTimestamps(vertexCount, 0);
+    u32 timestamp = cacheSize + 1;
+    for (u32 c = 0; c < clusterStarts.size(); ++c)
+    {
+        const u32 clusterEnd = c + 1 < clusterStarts.size() ? clusterStarts[c + 1] : triangleCount;
+        u32 start = clusterStarts[c];
+        u32 misses = 0;
+        timestamp += cacheSize + 1;
+        boundaries.push_back(start);
+        for (u32 t = start; t < clusterEnd; ++t)
+        {
+            for (u32 i = 0; i < 3; ++i)
+            {
+                const u32 vertex = indices[t * 3 + i];
+                if (timestamp - cacheTimestamps[vertex] > cacheSize)
+                {
+                    cacheTimestamps[vertex] = timestamp++;
+                    ++misses;
+                }
+            }
+
+            const u32 clusterTriangles = t - start + 1;
+            if (t + 1 < clusterEnd && clusterTriangles >= cacheSize &&
+                (f32)misses / (f32)clusterTriangles <= targetAcmr)
+            {
+                start = t + 1;
+                misses = 0;
+                timestamp += cacheSize + 1;
+                boundaries.push_back(start);
+            }
+        }
+    }
+
+    mathstl::Vector3 meshCentroid{0.0f, 0.0f, 0.0f};
+    for (u32 idx : indices)
+    {
+        meshCentroid += vertices[idx].position;
+    }
+    meshCentroid /= (f32)indices.size();
+
+    // Clusters whose area weighted normal points away from the mesh center are most likely to occlude others
+    struct ClusterSortData
+    {
+        u32 start;
+        u32 end;
+        f32 sortKey;
+    };
+    stltype::vector<ClusterSortData> clusters;
+    clusters.reserve(boundaries.size());
+    for (u32 c = 0; c < boundaries.size(); ++c)
+    {
+        ClusterSortData& cluster = clusters.emplace_back();
+        cluster.start = boundaries[c];
+        cluster.end = c + 1 < boundaries.size() ? boundaries[c + 1] : triangleCount;
+
+        mathstl::Vector3 centroid{0.0f, 0.0f, 0.0f};
+        mathstl::Vector3 normal{0.0f, 0.0f, 0.0f};
+        f32 area = 0.0f;
+        for (u32 t = cluster.start; t < cluster.end; ++t)
+        {
+            const auto& p0 = vertices[indices[t * 3 + 0]].position;
+            const auto& p1 = vertices[indices[t * 3 + 1]].position;
+            const auto& p2 = vertices[indices[t * 3 + 2]].position;
+            const mathstl::Vector3 triNormal = (p1 - p0).Cross(p2 - p0);
+            const f32 triArea = triNormal.Length();
+            centroid += (p0 + p1 + p2) * (triArea / 3.0f);
+            normal += triNormal;
+            area += triArea;
+        }
+        if (area > 0.0f)
+        {
+            centroid /= area;
+        }
+        normal.Normalize();
+        cluster.sortKey = (centroid - meshCentroid).Dot(normal);
+    }
+
+    stltype::stable_sort(clusters.begin(),
+                         clusters.end(),
+                         [](const ClusterSortData& a, const ClusterSortData& b) { return a.sortKey > b.sortKey; });
+
+    stltype::vector<u32> result;
+    result.reserve(indices.size());
+    for (const auto& cluster : clusters)
+    {
+        result.insert(result.end(), indices.begin() + cluster.start * 3, indices.begin() + cluster.end * 3);
+    }
+    indices = stltype::move(result);
+}
+
+u32 OptimizeVertexFetch(stltype::vector<CompleteVertex>& vertices, stltype::vector<u32>& indices)
+{
+    ScopedZone("MeshOptimization::OptimizeVertexFetch");
+    stltype::vector<u32> remap(vertices.size(), INVALID_INDEX);
+    stltype::vector<CompleteVertex> result;
+    result.reserve(vertices.size());
+    for (u32& idx : indices)
+    {
+        if (remap[idx] == INVALID_INDEX)
+        {
+            remap[idx] = (u32)result.size();
+            result.push_back(vertices[idx]);
+        }
+        idx = remap[idx];
+    }
+    vertices = stltype::move(result);
+    return (u32)vertices.size();
+}
+
+OptimizationReport OptimizeMesh(stltype::vector<CompleteVertex>& vertices, stltype::vector<u32>& indices)
+{
+    ScopedZone("MeshOptimization::OptimizeMesh");
+    OptimizationReport report{};
+    if (indices.size() < 3 || indices.size() % 3 != 0)
+        return report;
+
+    const u32 vertexCount = (u32)vertices.size();
+    report.before = AnalyzeVertexCache(indices, vertexCount);
+
+    stltype::vector<u32> clusterStarts;
+    OptimizeVertexCache(indices, vertexCount, DEFAULT_CACHE_SIZE, &clusterStarts);
+    OptimizeOverdraw(indices, vertices, clusterStarts);
+    report.removedVertices = vertexCount - OptimizeVertexFetch(vertices, indices);
+
+    report.after = AnalyzeVertexCache(indices, (u32)vertices.size());
+    return report;
+}
+
+// Symmetric error quadric, p^T A p + 2 b^T p + c with only the upper triangle of A stored
+struct Quadric
+{
+    f32 a00{0.0f}, a11{0.0f}, a22{0.0f}, a01{0.0f}, a02{0.0f}, a12{0.0f};
+    f32 b0{0.0f}, b1{0.0f}, b2{0.0f};
+    f32 c{0.0f};
+    f32 weight{0.0f};
+
+    static Quadric FromPlane(const mathstl::Vector3& n, f32 d, f32 w)
+    {
+        Quadric q;
+        q.a00 = n.x * n.x * w;
+        q.a11 = n.y * n.y * w;
+        q.a22 = n.z * n.z * w;
+        q.a01 = n.x * n.y * w;
+        q.a02 = n.x * n.z * w;
+        q.a12 = n.y * n.z * w;
+        q.b0 = n.x * d * w;
+        q.b1 = n.y * d * w;
+        q.b2 = n.z * d * w;
+        q.c = d * d * w;
+        q.weight = w;
+        return q;
+    }
+
+    void Add(const Quadric& o)
+    {
+        a00 += o.a00;
+        a11 += o.a11;
+        a22 += o.a22;
+        a01 += o.a01;
+        a02 += o.a02;
+        a12 += o.a12;
+        b0 += o.b0;
+        b1 += o.b1;
+        b2 += o.b2;
+        c += o.c;
+        weight += o.weight;
+    }
+
+    // Area weighted mean squared distance of p to the accumulated planes
+    f32 Evaluate(const mathstl::Vector3& p) const
+    {
+        const f32 rx = a00 * p.x + a01 * p.y + a02 * p.z + b0;
+        const f32 ry = a01 * p.x + a11 * p.y + a12 * p.z + b1;
+        const f32 rz = a02 * p.x + a12 * p.y + a22 * p.z + b2;
+        const f32 error = p.x * rx + p.y * ry + p.z * rz + b0 * p.x + b1 * p.y + b2 * p.z + c;
+        return weight > 0.0f ? stltype::max(error / weight, 0.0f) : 0.0f;
+    }
+};
+
+static bool IsPositionLess(const mathstl::Vector3& a, const mathstl::Vector3& b)
+{
+    if (a.x != b.x)
+        return a.x < b.x;
+    if (a.y != b.y)
+        return a.y < b.y;
+    return a.z < b.z;
+}
+
+// Moving from onto to must not turn any of the remaining triangles around from upside down
+static bool DoesCollapseFlipTriangle(const VertexAdjacency& adjacency,
+                                     const stltype::vector<u32>& trianglePositions,
+                                     const stltype::vector<mathstl::Vector3>& positions,
+                                     u32 from,
+                                     u32 to)
+{
+    for (u32 i = adjacency.offsets[from]; i < adjacency.offsets[from + 1]; ++i)
+    {
+        const u32* pTriangle = &trianglePositions[adjacency.triangles[i] * 3];
+        if (pTriangle[0] == to || pTriangle[1] == to || pTriangle[2] == to)
+            continue;
+
+        mathstl::Vector3 corners[3];
+        mathstl::Vector3 movedCorners[3];
+        for (u32 c = 0; c < 3; ++c)
+        {
+            corners[c] = positions[pTriangle[c]];
+            movedCorners[c] = pTriangle[c] == from ? positions[to] : corners[c];
+        }
+        const mathstl::Vector3 normal = (corners[1] - corners[0]).Cross(corners[2] - corners[0]);
+        const mathstl::Vector3 movedNormal =
+            (movedCorners[1] - movedCorners[0]).Cross(movedCorners[2] - movedCorners[0]);
+        if (normal.Dot(movedNormal) <= 0.0f)
+            return true;
+    }
+    return false;
+}
+
+stltype::vector<u32> SimplifyMesh(const stltype::vector<CompleteVertex>& vertices,
+                                  const stltype::vector<u32>& indices,
+                                  u32 targetIndexCount,
+                                  f32 maxError,
+                                  f32* pResultError)
+{
+    ScopedZone("MeshOptimization::SimplifyMesh");
+    if (pResultError)
+    {
+        *pResultError = 0.0f;
+    }
+    const u32 vertexCount = (u32)vertices.size();
+    if (indices.size() <= targetIndexCount || indices.size() % 3 != 0 || vertexCount == 0)
+        return indices;
+
+    // Weld vertices sharing a position, the collapse has to work on the surface and not on the attribute split copies
+    stltype::vector<u32> sortedVertices(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        sortedVertices[v] = v;
+    }
+    stltype::sort(sortedVertices.begin(),
+                  sortedVertices.end(),
+                  [&vertices](u32 a, u32 b) { return IsPositionLess(vertices[a].position, vertices[b].position); });
+
+    stltype::vector<u32> positionIds(vertexCount);
+    // The only vertex at a position, INVALID_INDEX if there are several, which makes the position part of a seam
+    stltype::vector<u32> positionVertex;
+    positionVertex.reserve(vertexCount);
+    for (u32 i = 0; i < vertexCount; ++i)
+    {
+        const u32 v = sortedVertices[i];
+        if (i == 0 || vertices[sortedVertices[i - 1]].position != vertices[v].position)
+        {
+            positionVertex.push_back(v);
+        }
+        else
+        {
+            positionVertex.back() = INVALID_INDEX;
+        }
+        positionIds[v] = (u32)positionVertex.size() - 1;
+    }
+    const u32 positionCount = (u32)positionVertex.size();
+
+    // Positions are normalized to the bounding sphere so the error comes out relative to the mesh radius
+    mathstl::Vector3 boundsMin = vertices[0].position;
+    mathstl::Vector3 boundsMax = vertices[0].position;
+    for (const auto& vertex : vertices)
+    {
+        boundsMin = mathstl::Vector3::Min(boundsMin, vertex.position);
+        boundsMax = mathstl::Vector3::Max(boundsMax, vertex.position);
+    }
+    const mathstl::Vector3 center = (boundsMin + boundsMax) * 0.5f;
+    const f32 invRadius = 1.0f / stltype::max((boundsMax - boundsMin).Length() * 0.5f, 1e-12f);
+    stltype::vector<mathstl::Vector3> positions(positionCount);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        positions[positionIds[v]] = (vertices[v].position - center) * invRadius;
+    }
+
+    stltype::vector<Quadric> quadrics(positionCount);
+    stltype::hash_set<u64> directedEdges;
+    directedEdges.reserve(indices.size());
+    for (u32 t = 0; t < indices.size() / 3; ++t)
+    {
+        const u32 p[3] = {positionIds[indices[t * 3 + 0]], positionIds[indices[t * 3 + 1]],
+                          positionIds[indices[t * 3 + 2]]};
+        for (u32 c = 0; c < 3; ++c)
+        {
+            directedEdges.insert(((u64)p[c] << 32) | p[(c + 1) % 3]);
+        }
+
+        mathstl::Vector3 normal = (positions[p[1]] - positions[p[0]]).Cross(positions[p[2]] - positions[p[0]]);
+        const f32 doubleArea = normal.Length();
+        if (doubleArea <= 0.0f)
+            continue;
+        normal /= doubleArea;
+        const Quadric q = Quadric::FromPlane(normal, -normal.Dot(positions[p[0]]), doubleArea * 0.5f);
+        for (u32 c = 0; c < 3; ++c)
+        {
+            quadrics[p[c]].Add(q);
+        }
+    }
+
+    // Seams and open borders stay where they are, an edge without its opposite half edge is a border
+    stltype::vector<bool> isLocked(positionCount, false);
+    for (u32 p = 0; p < positionCount; ++p)
+    {
+        isLocked[p] = positionVertex[p] == INVALID_INDEX;
+    }
+    for (u64 edge : directedEdges)
+    {
+        const u32 a = (u32)(edge >> 32);
+        const u32 b = (u32)edge;
+        if (directedEdges.find(((u64)b << 32) | a) == directedEdges.end())
+        {
+            isLocked[a] = true;
+            isLocked[b] = true;
+        }
+    }
+
+    struct Collapse
+    {
+        u32 from;
+        u32 to;
+        f32 error;
+    };
+    stltype::vector<Collapse> collapses;
+    stltype::vector<u32> trianglePositions;
+    stltype::vector<bool> isTouched(positionCount);
+    stltype::vector<u32> vertexRemap(vertexCount);
+    for (u32 v = 0; v < vertexCount; ++v)
+    {
+        vertexRemap[v] = v;
+    }
+
+    const f32 maxErrorSq = maxError * maxError;
+    f32 resultErrorSq = 0.0f;
+    stltype::vector<u32> result = indices;
+    while (result.size() > targetIndexCount)
+    {
+        trianglePositions.resize(result.size());
+        for (u32 i = 0; i < result.size(); ++i)
+        {
+            trianglePositions[i] = positionIds[result[i]];
+        }
+        const VertexAdjacency adjacency(trianglePositions, positionCount);
+
+        collapses.clear();
+        for (u32 i = 0; i < trianglePositions.size(); ++i)
+        {
+            const u32 a = trianglePositions[i];
+            const u32 b = trianglePositions[i - i % 3 + (i + 1) % 3];
+            // Interior edges show up once per direction, border edges only once but can't collapse anyway
+            if (a > b)
+                continue;
+
+            Quadric q = quadrics[a];
+            q.Add(quadrics[b]);
+            Collapse best{INVALID_INDEX, INVALID_INDEX, FLT_MAX};
+            if (isLocked[a] == false && positionVertex[b] != INVALID_INDEX)
+            {
+                best = {a, b, q.Evaluate(positions[b])};
+            }
+            if (isLocked[b] == false && positionVertex[a] != INVALID_INDEX)
+            {
+                const f32 error = q.Evaluate(positions[a]);
+                if (error < best.error)
+                {
+                    best = {b, a, error};
+                }
+            }
+            if (best.from != INVALID_INDEX && best.error <= maxErrorSq)
+            {
+                collapses.push_back(best);
+            }
+        }
+        if (collapses.empty())
+            break;
+        stltype::sort(collapses.begin(),
+                      collapses.end(),
+                      [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+        // Collapses within one pass must not share any triangles, everything around a collapsed vertex is frozen
+        const u32 trianglesToRemove = ((u32)result.size() - targetIndexCount) / 3;
+        u32 removedTriangles = 0;
+        isTouched.assign(positionCount, false);
+        for (const Collapse& collapse : collapses)
+        {
+            if (removedTriangles >= trianglesToRemove)
+                break;
+            if (isTouched[collapse.from] || isTouched[collapse.to])
+                continue;
+            if (DoesCollapseFlipTriangle(adjacency, trianglePositions, positions, collapse.from, collapse.to))
+                continue;
+
+            vertexRemap[positionVertex[collapse.from]] = positionVertex[collapse.to];
+            quadrics[collapse.to].Add(quadrics[collapse.from]);
+            resultErrorSq = stltype::max(resultErrorSq, collapse.error);
+            for (u32 i = adjacency.offsets[collapse.from]; i < adjacency.offsets[collapse.from + 1]; ++i)
+            {
+                const u32* pTriangle = &trianglePositions[adjacency.triangles[i] * 3];
+                bool isDegenerate = false;
+                for (u32 c = 0; c < 3; ++c)
+                {
+                    isTouched[pTriangle[c]] = true;
+                    isDegenerate |= pTriangle[c] == collapse.to;
+                }
+                removedTriangles += isDegenerate ? 1 : 0;
+            }
+        }
+        if (removedTriangles == 0)
+            break;
+
+        u32 writeIdx = 0;
+        for (u32 t = 0; t < result.size() / 3; ++t)
+        {
+            const u32 a = vertexRemap[result[t * 3 + 0]];
+            const u32 b = vertexRemap[result[t * 3 + 1]];
+            const u32 c = vertexRemap[result[t * 3 + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            result[writeIdx++] = a;
+            result[writeIdx++] = b;
+            result[writeIdx++] = c;
+        }
+        result.resize(writeIdx);
+    }
+
+    if (pResultError)
+    {
+        *pResultError = sqrtf(resultErrorSq);
+    }
+    return result;
+}
+
+void GenerateLODChain(const stltype::vector<CompleteVertex>& vertices,
+                      const stltype::vector<u32>& indices,
+                      stltype::vector<MeshLOD>& lods)
+{
+    ScopedZone("MeshOptimization::GenerateLODChain");
+    lods.clear();
+    f32 accumulatedError = 0.0f;
+    for (u32 level = 1; level < MESH_MAX_LODS; ++level)
+    {
+        // Each level starts from the previous one, which is a lot cheaper than going back to the full mesh every time
+        const auto& sourceIndices = lods.empty() ? indices : lods.back().indices;
+        const u32 targetIndexCount = (u32)(sourceIndices.size() / 6) * 3;
+        if (targetIndexCount < MIN_LOD_TRIANGLES * 3)
+            break;
+
+        f32 error = 0.0f;
+        stltype::vector<u32> lodIndices =
+            SimplifyMesh(vertices, sourceIndices, targetIndexCount, DEFAULT_LOD_MAX_ERROR, &error);
+        if ((f32)lodIndices.size() > (f32)sourceIndices.size() * MIN_LOD_REDUCTION)
+            break;
+
+        OptimizeVertexCache(lodIndices, (u32)vertices.size());
+        // Errors stack up since every level deviates from the one it was simplified from
+        accumulatedError += error;
+        MeshLOD& lod = lods.emplace_back();
+        lod.indices = stltype::move(lodIndices);
+        lod.error = accumulatedError;
+    }
+}
+static void ComputeMeshletBounds(const stltype::vector<CompleteVertex>& vertices,
+                                 const stltype::vector<u32>& meshletIndices,
+                                 MeshletData& meshlet)
+{
+    const u32* pVertices = &meshletIndices[meshlet.vertexOffset];
+    const u32* pTriangles = &meshletIndices[meshlet.triangleOffset];
+
+    mathstl::Vector3 boundsMin = vertices[pVertices[0]].position;
+    mathstl::Vector3 boundsMax = boundsMin;
+    for (u32 v = 1; v < meshlet.vertexCount; ++v)
+    {
+        boundsMin = mathstl::Vector3::Min(boundsMin, vertices[pVertices[v]].position);
+        boundsMax = mathstl::Vector3::Max(boundsMax, vertices[pVertices[v]].position);
+    }
+    const mathstl::Vector3 center = (boundsMin + boundsMax) * 0.5f;
+    f32 radiusSq = 0.0f;
+    for (u32 v = 0; v < meshlet.vertexCount; ++v)
+    {
+        radiusSq = stltype::max(radiusSq, (vertices[pVertices[v]].position - center).LengthSquared());
+    }
+    meshlet.boundingSphere = mathstl::Vector4(center.x, center.y, center.z, sqrtf(radiusSq));
+
+    // Unweighted normals so a few large triangles can't hide the small ones facing elsewhere
+    stltype::vector<mathstl::Vector3> normals;
+    normals.reserve(meshlet.triangleCount);
+    mathstl::Vector3 axis{0.0f, 0.0f, 0.0f};
+    for (u32 t = 0; t < meshlet.triangleCount; ++t)
+    {
+        const u32 packedTriangle = pTriangles[t];
+        const auto& p0 = vertices[pVertices[packedTriangle & 0xFF]].position;
+        const auto& p1 = vertices[pVertices[(packedTriangle >> 8) & 0xFF]].position;
+        const auto& p2 = vertices[pVertices[(packedTriangle >> 16) & 0xFF]].position;
+        mathstl::Vector3 normal = (p1 - p0).Cross(p2 - p0);
+        const f32 length = normal.Length();
+        if (length <= 0.0f)
+            continue;
+        normal /= length;
+        normals.push_back(normal);
+        axis += normal;
+    }
+
+    // A cutoff of one can never pass the backface test, used when the normals spread too far to cull anything
+    meshlet.coneAxisCutoff = mathstl::Vector4(0.0f, 0.0f, 1.0f, 1.0f);
+    const f32 axisLength = axis.Length();
+    if (normals.empty() || axisLength <= 0.0f)
+        return;
+    axis /= axisLength;
+
+    f32 minDot = 1.0f;
+    for (const auto& normal : normals)
+    {
+        minDot = stltype::min(minDot, normal.Dot(axis));
+    }
+    if (minDot <= 0.1f)
+        return;
+    meshlet.coneAxisCutoff = mathstl::Vector4(axis.x, axis.y, axis.z, sqrtf(1.0f - minDot * minDot));
+}
+
+void BuildMeshlets(const stltype::vector<CompleteVertex>& vertices,
+                   const stltype::vector<u32>& indices,
+                   stltype::vector<MeshletData>& meshlets,
+                   stltype::vector<u32>& meshletIndices,
+                   u32 maxVertices,
+                   u32 maxTriangles)
+{
+    ScopedZone("MeshOptimization::BuildMeshlets");
+    DEBUG_ASSERT(maxVertices <= 256 && maxTriangles > 0);
+    meshlets.clear();
+    meshletIndices.clear();
+    const u32 triangleCount = (u32)indices.size() / 3;
+    if (triangleCount == 0 || vertices.empty())
+        return;
+
+    stltype::vector<u32> localIndices(vertices.size(), INVALID_INDEX);
+    stltype::vector<u32> meshletVertices;
+    stltype::vector<u32> meshletTriangles;
+    meshletVertices.reserve(maxVertices);
+    meshletTriangles.reserve(maxTriangles);
+
+    const auto finishMeshlet = [&]()
+    {
+        MeshletData& meshlet = meshlets.emplace_back();
+        meshlet.vertexOffset = (u32)meshletIndices.size();
+        meshlet.vertexCount = (u32)meshletVertices.size();
+        meshletIndices.insert(meshletIndices.end(), meshletVertices.begin(), meshletVertices.end());
+        meshlet.triangleOffset = (u32)meshletIndices.size();
+        meshlet.triangleCount = (u32)meshletTriangles.size();
+        meshletIndices.insert(meshletIndices.end(), meshletTriangles.begin(), meshletTriangles.end());
+        ComputeMeshletBounds(vertices, meshletIndices, meshlet);
+
+        for (u32 vertex : meshletVertices)
+        {
+            localIndices[vertex] = INVALID_INDEX;
+        }
+        meshletVertices.clear();
+        meshletTriangles.clear();
+    };
+
+    for (u32 t = 0; t < triangleCount; ++t)
+    {
+        const u32* pTriangle = &indices[t * 3];
+        u32 newVertices = 0;
+        for (u32 c = 0; c < 3; ++c)
+        {
+            newVertices += localIndices[pTriangle[c]] == INVALID_INDEX ? 1 : 0;
+        }
+        if (meshletVertices.size() + newVertices > maxVertices || meshletTriangles.size() + 1 > maxTriangles)
+        {
+            finishMeshlet();
+        }
+
+        u32 packedTriangle = 0;
+        for (u32 c = 0; c < 3; ++c)
+        {
+            u32& localIdx = localIndices[pTriangle[c]];
+            if (localIdx == INVALID_INDEX)
+            {
+                localIdx = (u32)meshletVertices.size();
+                meshletVertices.push_back(pTriangle[c]);
+            }
+            packedTriangle |= localIdx << (c * 8);
+        }
+        meshletTriangles.push_back(packedTriangle);
+    }
+    finishMeshlet();
+}
+} // namespace MeshOptimization
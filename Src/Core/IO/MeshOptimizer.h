@@ -0,0 +1,86 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Rendering/Core/Defines/VertexDefines.h"
+#include "Core/SceneGraph/Mesh.h"
+
+// Import time optimizations for triangle lists, all of them keep the rendered result identical
+// The only exception is the simplifier which produces the LOD chain next to the original indices
+namespace MeshOptimization
+{
+// Small FIFO post-transform cache, conservative for current hardware so the ordering holds up everywhere
+static inline constexpr u32 DEFAULT_CACHE_SIZE = 16;
+// Overdraw sorting may worsen the cache miss ratio of a cluster by at most this factor
+static inline constexpr f32 DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+// LOD generation stops once a level would be smaller than this or no longer removes a meaningful amount of triangles
+static inline constexpr u32 MIN_LOD_TRIANGLES = 64;
+static inline constexpr f32 MIN_LOD_REDUCTION = 0.85f;
+// Upper bound for the simplification error relative to the mesh radius, collapses above it are never made
+static inline constexpr f32 DEFAULT_LOD_MAX_ERROR = 0.1f;
+
+struct VertexCacheStats
+{
+    // Average cache miss ratio, transformed vertices per triangle (0.5 is optimal for large regular meshes)
+    f32 acmr{0.0f};
+    // Average transform to vertex ratio, transformed vertices per referenced vertex (1.0 is optimal)
+    f32 atvr{0.0f};
+};
+
+struct OptimizationReport
+{
+    VertexCacheStats before;
+    VertexCacheStats after;
+    u32 removedVertices{0};
+};
+
+VertexCacheStats AnalyzeVertexCache(const stltype::vector<u32>& indices,
+                                    u32 vertexCount,
+                                    u32 cacheSize = DEFAULT_CACHE_SIZE);
+
+// Tipsify (Sander et al. 2007) triangle reordering for the post-transform cache
+// pClusterStarts receives the triangle offsets where the walk had to restart, the cache is cold at these points anyway
+void OptimizeVertexCache(stltype::vector<u32>& indices,
+                         u32 vertexCount,
+                         u32 cacheSize = DEFAULT_CACHE_SIZE,
+                         stltype::vector<u32>* pClusterStarts = nullptr);
+
+// Splits the cache optimized clusters further where that's cheap and sorts them so outward facing clusters are drawn
+// first, which lets early depth testing reject more of the inner ones
+void OptimizeOverdraw(stltype::vector<u32>& indices,
+                      const stltype::vector<CompleteVertex>& vertices,
+                      const stltype::vector<u32>& clusterStarts,
+                      f32 threshold = DEFAULT_OVERDRAW_THRESHOLD,
+                      u32 cacheSize = DEFAULT_CACHE_SIZE);
+
+// Reorders vertices by first use in the index buffer and drops unreferenced ones, returns the new vertex count
+u32 OptimizeVertexFetch(stltype::vector<CompleteVertex>& vertices, stltype::vector<u32>& indices);
+
+// Runs the whole chain above, expects a triangle list
+OptimizationReport OptimizeMesh(stltype::vector<CompleteVertex>& vertices, stltype::vector<u32>& indices);
+
+// Quadric error metric edge collapse (Garland and Heckbert 1997) that only ever moves a vertex onto one of its
+// neighbours, so the result indexes the original vertices and needs no vertex data of its own
+// Border vertices and vertices on attribute seams stay in place to keep silhouettes and UV layouts intact
+// Returns the simplified indices, pResultError receives the largest collapse error relative to the mesh radius
+stltype::vector<u32> SimplifyMesh(const stltype::vector<CompleteVertex>& vertices,
+                                  const stltype::vector<u32>& indices,
+                                  u32 targetIndexCount,
+                                  f32 maxError = DEFAULT_LOD_MAX_ERROR,
+                                  f32* pResultError = nullptr);
+
+// Splits the triangle list into meshlets in index order, each one is closed once the next triangle would exceed the
+// vertex or triangle limit. Run it after OptimizeMesh so consecutive triangles are spatially close
+// Every meshlet gets a bounding sphere and a normal cone, the cone is widened to never cull if the normals diverge
+void BuildMeshlets(const stltype::vector<CompleteVertex>& vertices,
+                   const stltype::vector<u32>& indices,
+                   stltype::vector<MeshletData>& meshlets,
+                   stltype::vector<u32>& meshletIndices,
+                   u32 maxVertices = MESHLET_MAX_VERTICES,
+                   u32 maxTriangles = MESHLET_MAX_TRIANGLES);
+
+// Halves the triangle count per level until MESH_MAX_LODS levels exist or the simplifier can't keep up
+// Expects the final vertex order, so run it after OptimizeMesh
+void GenerateLODChain(const stltype::vector<CompleteVertex>& vertices,
+                      const stltype::vector<u32>& indices,
+                      stltype::vector<MeshLOD>& lods);
+} // namespace MeshOptimization
@@ -0,0 +1,356 @@
+#include "MipGenerator.h"
+#include "Core/Global/GlobalVariables.h"
+#include "Core/Global/Profiling.h"
+#include "Core/Global/ThreadPool.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include <DirectXPackedVector.h>
+
+using namespace DirectX;
+
+namespace MipGeneration
+{
+// Destination rows handed to a single job
+static inline constexpr u32 ROWS_PER_JOB = 16;
+// Smaller levels are filtered inline, handing them out costs more than the filtering itself
+static inline constexpr u64 MIN_PARALLEL_TEXELS = 128 * 128;
+static inline constexpr u32 LINEAR_TO_SRGB_TABLE_SIZE = 4096;
+
+struct SRGBTables
+{
+    f32 toLinear[256];
+    u8 fromLinear[LINEAR_TO_SRGB_TABLE_SIZE];
+
+    SRGBTables()
+    {
+        for (u32 i = 0; i < 256; ++i)
+        {
+            const f32 c = (f32)i / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (u32 i = 0; i < LINEAR_TO_SRGB_TABLE_SIZE; ++i)
+        {
+            const f32 c = (f32)i / (f32)(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+            const f32 srgb = c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+            fromLinear[i] = (u8)(srgb * 255.0f + 0.5f);
+        }
+    }
+};
+
+static const SRGBTables& GetSRGBTables()
+{
+    static const SRGBTables tables;
+    return tables;
+}
+
+// Weights per destination texel, source taps outside the level are clamped to the edge
+struct FilterTaps
+{
+    stltype::vector<s32> first;
+    stltype::vector<f32> weights;
+    u32 tapCount{0};
+};
+
+static f32 BesselI0(f32 x)
+{
+    f32 sum = 1.0f;
+    f32 term = 1.0f;
+    const f32 halfXSq = x * x * 0.25f;
+    for (u32 k = 1; k < 32 && term > sum * 1e-7f; ++k)
+    {
+        term *= halfXSq / (f32)(k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static f32 Sinc(f32 x)
+{
+    if (mathstl::abs(x) < 1e-5f)
+        return 1.0f;
+    const f32 px = DirectX::XM_PI * x;
+    return sinf(px) / px;
+}
+
+// x is the distance in destination texels
+static f32 KaiserWeight(f32 x)
+{
+    const f32 t = x / KAISER_RADIUS;
+    if (mathstl::abs(t) >= 1.0f)
+        return 0.0f;
+    return Sinc(x) * BesselI0(KAISER_ALPHA * sqrtf(1.0f - t * t)) / BesselI0(KAISER_ALPHA);
+}
+
+static FilterTaps BuildTaps(MipFilter filter, u32 srcSize, u32 dstSize)
+{
+    FilterTaps taps{};
+    taps.first.resize(dstSize);
+
+    // Axis that already reached a single texel while the other one keeps shrinking
+    if (srcSize == dstSize)
+    {
+        taps.tapCount = 1;
+        taps.weights.assign(dstSize, 1.0f);
+        for (u32 i = 0; i < dstSize; ++i)
+        {
+            taps.first[i] = (s32)i;
+        }
+        return taps;
+    }
+
+    if (filter == MipFilter::Box)
+    {
+        // Odd sizes leave the last source texel over, the last destination texel averages it in as a third tap
+        const bool hasLeftover = (srcSize & 1) != 0;
+        taps.tapCount = hasLeftover ? 3 : 2;
+        taps.weights.assign(dstSize * taps.tapCount, 0.0f);
+        for (u32 i = 0; i < dstSize; ++i)
+        {
+            taps.first[i] = (s32)(i * 2);
+            f32* pWeights = &taps.weights[i * taps.tapCount];
+            const bool isLast = hasLeftover && i == dstSize - 1;
+            const f32 weight = isLast ? 1.0f / 3.0f : 0.5f;
+            pWeights[0] = weight;
+            pWeights[1] = weight;
+            if (isLast)
+                pWeights[2] = weight;
+        }
+        return taps;
+    }
+
+    // Non power of two sizes don't halve exactly, the kernel is stretched by the actual ratio
+    const f32 scale = (f32)srcSize / (f32)dstSize;
+    const f32 support = KAISER_RADIUS * scale;
+    taps.tapCount = (u32)ceilf(support * 2.0f) + 1;
+    taps.weights.resize(dstSize * taps.tapCount);
+    for (u32 i = 0; i < dstSize; ++i)
+    {
+        const f32 center = ((f32)i + 0.5f) * scale;
+        taps.first[i] = (s32)floorf(center - support);
+        f32* pWeights = &taps.weights[i * taps.tapCount];
+        f32 sum = 0.0f;
+        for (u32 k = 0; k < taps.tapCount; ++k)
+        {
+            pWeights[k] = KaiserWeight(((f32)(taps.first[i] + (s32)k) + 0.5f - center) / scale);
+            sum += pWeights[k];
+        }
+        for (u32 k = 0; k < taps.tapCount; ++k)
+        {
+            pWeights[k] /= sum;
+        }
+    }
+    return taps;
+}
+
+static inline XMVECTOR LoadTexel(const u8* pRow, u32 x, const MipGenerationSettings& settings, const SRGBTables& tables)
+{
+    if (settings.format == MipPixelFormat::RGBA32F)
+        return XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(pRow) + x);
+    if (settings.format == MipPixelFormat::RGBA16F)
+        return PackedVector::XMLoadHalf4(reinterpret_cast<const PackedVector::XMHALF4*>(pRow) + x);
+
+    const u8* pTexel = pRow + x * 4;
+    if (settings.isSRGB)
+    {
+        return XMVectorSet(tables.toLinear[pTexel[0]],
+                           tables.toLinear[pTexel[1]],
+                           tables.toLinear[pTexel[2]],
+                           (f32)pTexel[3] * (1.0f / 255.0f));
+    }
+
+    const XMVECTOR value = PackedVector::XMLoadUByteN4(reinterpret_cast<const PackedVector::XMUBYTEN4*>(pTexel));
+    if (settings.isNormalMap)
+        return XMVectorSelect(value, XMVectorMultiplyAdd(value, g_XMTwo, g_XMNegativeOne), g_XMSelect1110);
+    return value;
+}
+
+static inline void StoreTexel(u8* pRow,
+                              u32 x,
+                              FXMVECTOR value,
+                              const MipGenerationSettings& settings,
+                              const SRGBTables& tables)
+{
+    if (settings.format == MipPixelFormat::RGBA32F)
+    {
+        // Negative lobes of the Kaiser kernel can undershoot next to bright texels
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(pRow) + x, XMVectorMax(value, g_XMZero));
+        return;
+    }
+    if (settings.format == MipPixelFormat::RGBA16F)
+    {
+        PackedVector::XMStoreHalf4(reinterpret_cast<PackedVector::XMHALF4*>(pRow) + x, XMVectorMax(value, g_XMZero));
+        return;
+    }
+
+    XMVECTOR result = value;
+    if (settings.isNormalMap)
+    {
+        const XMVECTOR normal = XMVectorGetX(XMVector3LengthSq(value)) > FLOAT_TOLERANCE
+                                    ? XMVector3Normalize(value)
+                                    : g_XMIdentityR2.v;
+        result = XMVectorSelect(value, XMVectorMultiplyAdd(normal, g_XMOneHalf, g_XMOneHalf), g_XMSelect1110);
+    }
+    result = XMVectorSaturate(result);
+
+    u8* pTexel = pRow + x * 4;
+    if (settings.isSRGB)
+    {
+        XMFLOAT4 linear;
+        XMStoreFloat4(&linear, result);
+        constexpr f32 tableScale = (f32)(LINEAR_TO_SRGB_TABLE_SIZE - 1);
+        pTexel[0] = tables.fromLinear[(u32)(linear.x * tableScale + 0.5f)];
+        pTexel[1] = tables.fromLinear[(u32)(linear.y * tableScale + 0.5f)];
+        pTexel[2] = tables.fromLinear[(u32)(linear.z * tableScale + 0.5f)];
+        pTexel[3] = (u8)(linear.w * 255.0f + 0.5f);
+        return;
+    }
+
+    XMFLOAT4 scaled;
+    XMStoreFloat4(&scaled, XMVectorMultiplyAdd(result, XMVectorReplicate(255.0f), g_XMOneHalf));
+    pTexel[0] = (u8)scaled.x;
+    pTexel[1] = (u8)scaled.y;
+    pTexel[2] = (u8)scaled.z;
+    pTexel[3] = (u8)scaled.w;
+}
+
+struct DownsamplePass
+{
+    const u8* pSrc;
+    u32 srcWidth;
+    u32 srcHeight;
+    u8* pDst;
+    u32 dstWidth;
+    u32 texelSize;
+    const FilterTaps* pHorizontal;
+    const FilterTaps* pVertical;
+    const MipGenerationSettings* pSettings;
+};
+
+// Vertical taps are accumulated into a full width source row first, the horizontal taps then run over that row
+static void FilterRows(const DownsamplePass& pass, u32 firstRow, u32 rowCount)
+{
+    const SRGBTables& tables = GetSRGBTables();
+    const MipGenerationSettings& settings = *pass.pSettings;
+    const FilterTaps& vertical = *pass.pVertical;
+    const FilterTaps& horizontal = *pass.pHorizontal;
+    const u64 srcPitch = (u64)pass.srcWidth * pass.texelSize;
+    const u64 dstPitch = (u64)pass.dstWidth * pass.texelSize;
+
+    stltype::vector<XMFLOAT4> filteredRow(pass.srcWidth);
+    for (u32 y = firstRow; y < firstRow + rowCount; ++y)
+    {
+        for (auto& texel : filteredRow)
+        {
+            texel = XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f);
+        }
+
+        for (u32 k = 0; k < vertical.tapCount; ++k)
+        {
+            const f32 weight = vertical.weights[y * vertical.tapCount + k];
+            if (weight == 0.0f)
+                continue;
+            const s32 srcY = mathstl::clamp(vertical.first[y] + (s32)k, 0, (s32)pass.srcHeight - 1);
+            const u8* pSrcRow = pass.pSrc + srcY * srcPitch;
+            const XMVECTOR weightV = XMVectorReplicate(weight);
+            for (u32 x = 0; x < pass.srcWidth; ++x)
+            {
+                const XMVECTOR texel = LoadTexel(pSrcRow, x, settings, tables);
+                XMStoreFloat4(&filteredRow[x], XMVectorMultiplyAdd(texel, weightV, XMLoadFloat4(&filteredRow[x])));
+            }
+        }
+
+        u8* pDstRow = pass.pDst + y * dstPitch;
+        for (u32 x = 0; x < pass.dstWidth; ++x)
+        {
+            XMVECTOR acc = XMVectorZero();
+            for (u32 k = 0; k < horizontal.tapCount; ++k)
+            {
+                const f32 weight = horizontal.weights[x * horizontal.tapCount + k];
+                const s32 srcX = mathstl::clamp(horizontal.first[x] + (s32)k, 0, (s32)pass.srcWidth - 1);
+                acc = XMVectorMultiplyAdd(XMLoadFloat4(&filteredRow[srcX]), XMVectorReplicate(weight), acc);
+            }
+            StoreTexel(pDstRow, x, acc, settings, tables);
+        }
+    }
+}
+
+u32 GetMipCount(u32 width, u32 height)
+{
+    u32 largestSide = stltype::max(width, height);
+    u32 mipCount = 1;
+    while (largestSide > 1)
+    {
+        largestSide >>= 1;
+        ++mipCount;
+    }
+    return mipCount;
+}
+
+u32 GetTexelSize(MipPixelFormat format)
+{
+    switch (format)
+    {
+        case MipPixelFormat::RGBA16F:
+            return sizeof(PackedVector::XMHALF4);
+        case MipPixelFormat::RGBA32F:
+            return sizeof(XMFLOAT4);
+        case MipPixelFormat::RGBA8:
+        default:
+            return 4;
+    }
+}
+
+void GenerateMipChain(const u8* pPixels,
+                      u32 width,
+                      u32 height,
+                      const MipGenerationSettings& settings,
+                      stltype::vector<MipLevel>& levels)
+{
+    ScopedZone("MipGeneration::Generate Mip Chain");
+    DEBUG_ASSERT(pPixels && width > 0 && height > 0);
+    DEBUG_ASSERT(settings.format == MipPixelFormat::RGBA8 ||
+                 (settings.isSRGB == false && settings.isNormalMap == false));
+
+    const u32 mipCount = GetMipCount(width, height);
+    if (mipCount <= 1)
+        return;
+
+    const u32 texelSize = GetTexelSize(settings.format);
+    const u64 firstLevel = levels.size();
+    levels.resize(firstLevel + mipCount - 1);
+
+    const u8* pSrc = pPixels;
+    u32 srcWidth = width;
+    u32 srcHeight = height;
+    for (u32 i = 1; i < mipCount; ++i)
+    {
+        MipLevel& level = levels[firstLevel + i - 1];
+        level.width = stltype::max(width >> i, 1u);
+        level.height = stltype::max(height >> i, 1u);
+        level.pixels.resize((u64)level.width * level.height * texelSize);
+
+        const FilterTaps horizontal = BuildTaps(settings.filter, srcWidth, level.width);
+        const FilterTaps vertical = BuildTaps(settings.filter, srcHeight, level.height);
+        const DownsamplePass pass{
+            pSrc, srcWidth, srcHeight, level.pixels.data(), level.width, texelSize, &horizontal, &vertical, &settings};
+
+        if ((u64)level.width * level.height < MIN_PARALLEL_TEXELS)
+        {
+            FilterRows(pass, 0, level.height);
+        }
+        else
+        {
+            ThreadPool::JobGroup jobs;
+            for (u32 row = 0; row < level.height; row += ROWS_PER_JOB)
+            {
+                const u32 rowCount = stltype::min(ROWS_PER_JOB, level.height - row);
+                g_pJobPool->Submit([&pass, row, rowCount]() { FilterRows(pass, row, rowCount); }, &jobs);
+            }
+            g_pJobPool->Wait(jobs);
+        }
+
+        pSrc = level.pixels.data();
+        srcWidth = level.width;
+        srcHeight = level.height;
+    }
+}
+} // namespace MipGeneration
@@ -0,0 +1,56 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+
+// CPU mip chain generation for textures that don't ship their own mips
+// Every level is filtered from the one above with a separable filter, texels are processed as SIMD vectors
+namespace MipGeneration
+{
+// Bump whenever the filtered output changes so cached chains get regenerated
+static inline constexpr u64 MIP_GENERATION_VERSION = 1;
+
+// Support of the Kaiser filter in destination texels on each side and its window shape
+static inline constexpr f32 KAISER_RADIUS = 2.0f;
+static inline constexpr f32 KAISER_ALPHA = 4.0f;
+
+enum class MipFilter : u8
+{
+    Box,   // 2x2 average, cheapest but blurs and aliases the most
+    Kaiser // Kaiser windowed sinc, keeps distant detail sharper without ringing much
+};
+
+enum class MipPixelFormat : u8
+{
+    RGBA8,
+    RGBA16F,
+    RGBA32F
+};
+
+struct MipGenerationSettings
+{
+    MipFilter filter{MipFilter::Kaiser};
+    MipPixelFormat format{MipPixelFormat::RGBA8};
+    // Filters in linear space, RGBA8 only, alpha is always linear
+    bool isSRGB{false};
+    // Texels are decoded as [0, 1] -> [-1, 1] vectors and renormalized after filtering, alpha is left alone
+    bool isNormalMap{false};
+};
+
+struct MipLevel
+{
+    u32 width{0};
+    u32 height{0};
+    stltype::vector<u8> pixels;
+};
+
+// Number of levels in a full chain down to 1x1 including the base level
+u32 GetMipCount(u32 width, u32 height);
+u32 GetTexelSize(MipPixelFormat format);
+
+// Appends every level below the base one to levels, the base level itself is not copied
+// Rows of a level are filtered in parallel, levels are produced one after another since each reads the previous one
+void GenerateMipChain(const u8* pPixels,
+                      u32 width,
+                      u32 height,
+                      const MipGenerationSettings& settings,
+                      stltype::vector<MipLevel>& levels);
+} // namespace MipGeneration
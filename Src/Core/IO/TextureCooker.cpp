@@ -0,0 +1,638 @@
+#include "TextureCooker.h"
+#include "MipGenerator.h"
+#include "Core/Global/GlobalVariables.h"
+#include "Core/Global/Profiling.h"
+#include "Core/Global/ThreadPool.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include "Core/Rendering/Vulkan/VkTextureManager.h"
+
+namespace TextureCooking
+{
+// Block rows handed to a single job, small enough to balance across workers on the lower mips
+static inline constexpr u32 BLOCK_ROWS_PER_JOB = 8;
+
+struct DDSPixelFormat
+{
+    u32 size;
+    u32 flags;
+    u32 fourCC;
+    u32 rgbBitCount;
+    u32 rBitMask;
+    u32 gBitMask;
+    u32 bBitMask;
+    u32 aBitMask;
+};
+
+struct DDSHeader
+{
+    u32 size;
+    u32 flags;
+    u32 height;
+    u32 width;
+    u32 pitchOrLinearSize;
+    u32 depth;
+    u32 mipMapCount;
+    u32 reserved1[11];
+    DDSPixelFormat pixelFormat;
+    u32 caps;
+    u32 caps2;
+    u32 caps3;
+    u32 caps4;
+    u32 reserved2;
+};
+
+struct DDSHeaderDX10
+{
+    u32 dxgiFormat;
+    u32 resourceDimension;
+    u32 miscFlag;
+    u32 arraySize;
+    u32 miscFlags2;
+};
+
+static inline constexpr u32 DDS_MAGIC = 0x20534444;  // "DDS "
+static inline constexpr u32 DDS_FOURCC_DX10 = 0x30315844; // "DX10"
+static inline constexpr u32 DDSD_REQUIRED = 0x1 | 0x2 | 0x4 | 0x1000; // Caps, height, width, pixel format
+static inline constexpr u32 DDSD_MIPMAPCOUNT = 0x20000;
+static inline constexpr u32 DDSD_LINEARSIZE = 0x80000;
+static inline constexpr u32 DDPF_FOURCC = 0x4;
+static inline constexpr u32 DDSCAPS_COMPLEX = 0x8;
+static inline constexpr u32 DDSCAPS_TEXTURE = 0x1000;
+static inline constexpr u32 DDSCAPS_MIPMAP = 0x400000;
+static inline constexpr u32 D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3;
+static inline constexpr u64 DDS_HEADER_SIZE = sizeof(u32) + sizeof(DDSHeader) + sizeof(DDSHeaderDX10);
+
+static inline constexpr u32 BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Writes the bits LSB first, the target has to be zeroed
+struct BlockBitWriter
+{
+    u8* pData;
+    u32 bit{0};
+
+    void Write(u32 value, u32 count)
+    {
+        for (u32 i = 0; i < count; ++i, ++bit)
+        {
+            if ((value >> i) & 1)
+                pData[bit >> 3] |= (u8)(1u << (bit & 7));
+        }
+    }
+};
+
+// Endpoints along the principal axis of the block colors, a cheap and decent starting point for every BC format with
+// a single line segment
+template <u32 N>
+static void FindPrincipalEndpoints(const f32 (&pixels)[16][N], f32 (&e0)[N], f32 (&e1)[N])
+{
+    f32 mean[N]{};
+    f32 minValue[N];
+    f32 maxValue[N];
+    for (u32 c = 0; c < N; ++c)
+    {
+        minValue[c] = 255.0f;
+        maxValue[c] = 0.0f;
+    }
+    for (u32 p = 0; p < 16; ++p)
+    {
+        for (u32 c = 0; c < N; ++c)
+        {
+            mean[c] += pixels[p][c];
+            minValue[c] = stltype::min(minValue[c], pixels[p][c]);
+            maxValue[c] = stltype::max(maxValue[c], pixels[p][c]);
+        }
+    }
+    for (u32 c = 0; c < N; ++c)
+    {
+        mean[c] /= 16.0f;
+    }
+
+    f32 covariance[N][N]{};
+    for (u32 p = 0; p < 16; ++p)
+    {
+        for (u32 i = 0; i < N; ++i)
+        {
+            for (u32 j = 0; j < N; ++j)
+            {
+                covariance[i][j] += (pixels[p][i] - mean[i]) * (pixels[p][j] - mean[j]);
+            }
+        }
+    }
+
+    // Power iteration starting from the bounding box diagonal
+    f32 axis[N];
+    for (u32 c = 0; c < N; ++c)
+    {
+        axis[c] = maxValue[c] - minValue[c];
+    }
+    for (u32 iteration = 0; iteration < 8; ++iteration)
+    {
+        f32 next[N]{};
+        f32 largest = 0.0f;
+        for (u32 i = 0; i < N; ++i)
+        {
+            for (u32 j = 0; j < N; ++j)
+            {
+                next[i] += covariance[i][j] * axis[j];
+            }
+            largest = stltype::max(largest, mathstl::abs(next[i]));
+        }
+        if (largest < FLOAT_TOLERANCE)
+            break;
+        for (u32 c = 0; c < N; ++c)
+        {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    f32 lengthSq = 0.0f;
+    for (u32 c = 0; c < N; ++c)
+    {
+        lengthSq += axis[c] * axis[c];
+    }
+    if (lengthSq < FLOAT_TOLERANCE)
+    {
+        for (u32 c = 0; c < N; ++c)
+        {
+            e0[c] = e1[c] = mean[c];
+        }
+        return;
+    }
+    const f32 invLength = 1.0f / sqrtf(lengthSq);
+    for (u32 c = 0; c < N; ++c)
+    {
+        axis[c] *= invLength;
+    }
+
+    f32 tMin = FLT_MAX;
+    f32 tMax = -FLT_MAX;
+    for (u32 p = 0; p < 16; ++p)
+    {
+        f32 t = 0.0f;
+        for (u32 c = 0; c < N; ++c)
+        {
+            t += (pixels[p][c] - mean[c]) * axis[c];
+        }
+        tMin = stltype::min(tMin, t);
+        tMax = stltype::max(tMax, t);
+    }
+    for (u32 c = 0; c < N; ++c)
+    {
+        e0[c] = mathstl::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f);
+        e1[c] = mathstl::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f);
+    }
+}
+
+template <u32 N>
+static void LoadBlock(const u8* pRGBA, f32 (&pixels)[16][N])
+{
+    for (u32 p = 0; p < 16; ++p)
+    {
+        for (u32 c = 0; c < N; ++c)
+        {
+            pixels[p][c] = (f32)pRGBA[p * 4 + c];
+        }
+    }
+}
+
+template <u32 N, u32 PaletteSize>
+static u32 FindClosestPaletteEntry(const f32* pPixel, const s32 (&palette)[PaletteSize][N], u32& distance)
+{
+    u32 bestIdx = 0;
+    distance = ~0u;
+    for (u32 i = 0; i < PaletteSize; ++i)
+    {
+        u32 d = 0;
+        for (u32 c = 0; c < N; ++c)
+        {
+            const s32 diff = (s32)pPixel[c] - palette[i][c];
+            d += (u32)(diff * diff);
+        }
+        if (d < distance)
+        {
+            distance = d;
+            bestIdx = i;
+        }
+    }
+    return bestIdx;
+}
+
+static u16 PackRGB565(const f32* pColor)
+{
+    const u32 r = (u32)(pColor[0] * (31.0f / 255.0f) + 0.5f);
+    const u32 g = (u32)(pColor[1] * (63.0f / 255.0f) + 0.5f);
+    const u32 b = (u32)(pColor[2] * (31.0f / 255.0f) + 0.5f);
+    return (u16)((r << 11) | (g << 5) | b);
+}
+
+static void UnpackRGB565(u16 packed, s32* pColor)
+{
+    const s32 r = packed >> 11;
+    const s32 g = (packed >> 5) & 63;
+    const s32 b = packed & 31;
+    pColor[0] = (r << 3) | (r >> 2);
+    pColor[1] = (g << 2) | (g >> 4);
+    pColor[2] = (b << 3) | (b >> 2);
+}
+
+// Always uses the four color mode so it can be shared with BC3, where the endpoint order doesn't select a mode
+static void EncodeColorBlock(const u8* pRGBA, u8* pOut)
+{
+    f32 pixels[16][3];
+    LoadBlock(pRGBA, pixels);
+    f32 e0[3], e1[3];
+    FindPrincipalEndpoints(pixels, e0, e1);
+
+    u16 c0 = PackRGB565(e1);
+    u16 c1 = PackRGB565(e0);
+    if (c0 < c1)
+        stltype::swap(c0, c1);
+
+    u32 indices = 0;
+    if (c0 != c1)
+    {
+        s32 palette[4][3];
+        UnpackRGB565(c0, palette[0]);
+        UnpackRGB565(c1, palette[1]);
+        for (u32 c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (u32 p = 0; p < 16; ++p)
+        {
+            u32 distance;
+            indices |= FindClosestPaletteEntry(pixels[p], palette, distance) << (2 * p);
+        }
+    }
+
+    pOut[0] = (u8)(c0 & 0xFF);
+    pOut[1] = (u8)(c0 >> 8);
+    pOut[2] = (u8)(c1 & 0xFF);
+    pOut[3] = (u8)(c1 >> 8);
+    for (u32 b = 0; b < 4; ++b)
+    {
+        pOut[4 + b] = (u8)((indices >> (8 * b)) & 0xFF);
+    }
+}
+
+void EncodeBC1Block(const u8* pRGBA, u8* pOut)
+{
+    EncodeColorBlock(pRGBA, pOut);
+}
+
+void EncodeBC3Block(const u8* pRGBA, u8* pOut)
+{
+    EncodeBC4Block(pRGBA, 3, pOut);
+    EncodeColorBlock(pRGBA, pOut + 8);
+}
+
+// Eight value mode only, the six value mode with explicit 0 and 255 rarely wins for texture data
+void EncodeBC4Block(const u8* pRGBA, u32 channel, u8* pOut)
+{
+    u8 minValue = 255;
+    u8 maxValue = 0;
+    for (u32 p = 0; p < 16; ++p)
+    {
+        minValue = stltype::min(minValue, pRGBA[p * 4 + channel]);
+        maxValue = stltype::max(maxValue, pRGBA[p * 4 + channel]);
+    }
+
+    pOut[0] = maxValue;
+    pOut[1] = minValue;
+    u64 indices = 0;
+    if (maxValue != minValue)
+    {
+        s32 palette[8][1];
+        palette[0][0] = maxValue;
+        palette[1][0] = minValue;
+        for (u32 i = 2; i < 8; ++i)
+        {
+            palette[i][0] = ((8 - i) * maxValue + (i - 1) * minValue + 3) / 7;
+        }
+        for (u32 p = 0; p < 16; ++p)
+        {
+            const f32 value = (f32)pRGBA[p * 4 + channel];
+            u32 distance;
+            indices |= (u64)FindClosestPaletteEntry(&value, palette, distance) << (3 * p);
+        }
+    }
+    for (u32 b = 0; b < 6; ++b)
+    {
+        pOut[2 + b] = (u8)((indices >> (8 * b)) & 0xFF);
+    }
+}
+
+void EncodeBC5Block(const u8* pRGBA, u8* pOut)
+{
+    EncodeBC4Block(pRGBA, 0, pOut);
+    EncodeBC4Block(pRGBA, 1, pOut + 8);
+}
+
+// Mode 6 only: a single RGBA line with 7 bit endpoints plus a p-bit each and 4 bit indices
+// Handles smooth color and alpha gradients well, blocks with several distinct colors lose some detail compared to a
+// full multi-partition search
+void EncodeBC7Block(const u8* pRGBA, u8* pOut)
+{
+    f32 pixels[16][4];
+    LoadBlock(pRGBA, pixels);
+    f32 e0[4], e1[4];
+    FindPrincipalEndpoints(pixels, e0, e1);
+
+    u32 bestQuantized[2][4]{};
+    u32 bestPBits[2]{};
+    u32 bestIndices[16]{};
+    u64 bestError = ~0ull;
+    for (u32 pBits = 0; pBits < 4; ++pBits)
+    {
+        const u32 p[2] = {pBits & 1, pBits >> 1};
+        const f32* endpoints[2] = {e0, e1};
+        u32 quantized[2][4];
+        s32 expanded[2][4];
+        for (u32 e = 0; e < 2; ++e)
+        {
+            for (u32 c = 0; c < 4; ++c)
+            {
+                quantized[e][c] = (u32)mathstl::clamp((s32)((endpoints[e][c] - (f32)p[e]) * 0.5f + 0.5f), 0, 127);
+                expanded[e][c] = (s32)((quantized[e][c] << 1) | p[e]);
+            }
+        }
+
+        s32 palette[16][4];
+        for (u32 i = 0; i < 16; ++i)
+        {
+            for (u32 c = 0; c < 4; ++c)
+            {
+                palette[i][c] =
+                    ((64 - (s32)BC7_WEIGHTS4[i]) * expanded[0][c] + (s32)BC7_WEIGHTS4[i] * expanded[1][c] + 32) >> 6;
+            }
+        }
+
+        u64 error = 0;
+        u32 indices[16];
+        for (u32 px = 0; px < 16; ++px)
+        {
+            u32 distance;
+            indices[px] = FindClosestPaletteEntry(pixels[px], palette, distance);
+            error += distance;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            memcpy(bestQuantized, quantized, sizeof(quantized));
+            bestPBits[0] = p[0];
+            bestPBits[1] = p[1];
+            memcpy(bestIndices, indices, sizeof(indices));
+        }
+    }
+
+    // The anchor index drops its top bit, flip the line if the first pixel would need it
+    if (bestIndices[0] & 8)
+    {
+        for (u32 c = 0; c < 4; ++c)
+        {
+            stltype::swap(bestQuantized[0][c], bestQuantized[1][c]);
+        }
+        stltype::swap(bestPBits[0], bestPBits[1]);
+        for (u32& idx : bestIndices)
+        {
+            idx = 15 - idx;
+        }
+    }
+
+    memset(pOut, 0, 16);
+    BlockBitWriter writer{pOut};
+    writer.Write(1u << 6, 7);
+    for (u32 c = 0; c < 4; ++c)
+    {
+        writer.Write(bestQuantized[0][c], 7);
+        writer.Write(bestQuantized[1][c], 7);
+    }
+    writer.Write(bestPBits[0], 1);
+    writer.Write(bestPBits[1], 1);
+    writer.Write(bestIndices[0], 3);
+    for (u32 i = 1; i < 16; ++i)
+    {
+        writer.Write(bestIndices[i], 4);
+    }
+}
+
+static void EncodeBlock(BCFormat format, const u8* pRGBA, u8* pOut)
+{
+    switch (format)
+    {
+        case BCFormat::BC1:
+            EncodeBC1Block(pRGBA, pOut);
+            break;
+        case BCFormat::BC3:
+            EncodeBC3Block(pRGBA, pOut);
+            break;
+        case BCFormat::BC4:
+            EncodeBC4Block(pRGBA, 0, pOut);
+            break;
+        case BCFormat::BC5:
+            EncodeBC5Block(pRGBA, pOut);
+            break;
+        case BCFormat::BC7:
+            EncodeBC7Block(pRGBA, pOut);
+            break;
+    }
+}
+
+bool ShouldCook(TextureSemantic semantic)
+{
+    return semantic != TextureSemantic::Auto;
+}
+
+BCFormat ChooseFormat(TextureSemantic semantic, bool hasAlpha)
+{
+    switch (semantic)
+    {
+        case TextureSemantic::BaseColor:
+        case TextureSemantic::Emissive:
+            return BCFormat::BC7;
+        case TextureSemantic::Normal:
+            return BCFormat::BC5;
+        // Only the red channel is ever sampled from these
+        case TextureSemantic::Sheen:
+        case TextureSemantic::Clearcoat:
+            return BCFormat::BC4;
+        case TextureSemantic::Data:
+        case TextureSemantic::Specular:
+        default:
+            return hasAlpha ? BCFormat::BC3 : BCFormat::BC1;
+    }
+}
+
+u32 GetDXGIFormat(BCFormat format, bool isSRGB)
+{
+    switch (format)
+    {
+        case BCFormat::BC1:
+            return isSRGB ? 72 : 71;
+        case BCFormat::BC3:
+            return isSRGB ? 78 : 77;
+        case BCFormat::BC4:
+            return 80;
+        case BCFormat::BC5:
+            return 83;
+        case BCFormat::BC7:
+        default:
+            return isSRGB ? 99 : 98;
+    }
+}
+
+u32 GetBlockSize(BCFormat format)
+{
+    return format == BCFormat::BC1 || format == BCFormat::BC4 ? 8 : 16;
+}
+
+const char* GetFormatName(BCFormat format)
+{
+    switch (format)
+    {
+        case BCFormat::BC1:
+            return "BC1";
+        case BCFormat::BC3:
+            return "BC3";
+        case BCFormat::BC4:
+            return "BC4";
+        case BCFormat::BC5:
+            return "BC5";
+        case BCFormat::BC7:
+        default:
+            return "BC7";
+    }
+}
+
+struct CookMipLevel
+{
+    const u8* pPixels;
+    u32 width;
+    u32 height;
+    u32 blocksX;
+    u32 blocksY;
+    u64 offset;
+};
+
+static void EncodeBlockRows(BCFormat format, const CookMipLevel& mip, u32 firstRow, u32 rowCount, u8* pDst)
+{
+    const u32 blockSize = GetBlockSize(format);
+    u8 block[16 * 4];
+    for (u32 by = firstRow; by < firstRow + rowCount; ++by)
+    {
+        for (u32 bx = 0; bx < mip.blocksX; ++bx)
+        {
+            // Blocks hanging over the edge of small or odd sized mips repeat the last row/column
+            for (u32 py = 0; py < 4; ++py)
+            {
+                const u32 y = stltype::min(by * 4 + py, mip.height - 1);
+                for (u32 px = 0; px < 4; ++px)
+                {
+                    const u32 x = stltype::min(bx * 4 + px, mip.width - 1);
+                    memcpy(&block[(py * 4 + px) * 4], &mip.pPixels[((u64)y * mip.width + x) * 4], 4);
+                }
+            }
+            EncodeBlock(format, block, pDst + mip.offset + ((u64)by * mip.blocksX + bx) * blockSize);
+        }
+    }
+}
+
+CookedTextureInfo CookTexture(const u8* pRGBA,
+                              u32 width,
+                              u32 height,
+                              TextureSemantic semantic,
+                              stltype::vector<u8>& ddsBytes)
+{
+    DEBUG_ASSERT(pRGBA && width > 0 && height > 0);
+
+    bool hasAlpha = false;
+    for (u64 i = 0; i < (u64)width * height && hasAlpha == false; ++i)
+    {
+        hasAlpha = pRGBA[i * 4 + 3] != 255;
+    }
+
+    CookedTextureInfo result{};
+    result.format = ChooseFormat(semantic, hasAlpha);
+    const bool isSRGB = semantic == TextureSemantic::BaseColor || semantic == TextureSemantic::Emissive;
+    const u32 blockSize = GetBlockSize(result.format);
+
+    // Filtered before compression so normals get renormalized and colors averaged in linear space
+    MipGeneration::MipGenerationSettings mipSettings{};
+    mipSettings.isSRGB = isSRGB;
+    mipSettings.isNormalMap = semantic == TextureSemantic::Normal;
+    stltype::vector<MipGeneration::MipLevel> mipLevels;
+    MipGeneration::GenerateMipChain(pRGBA, width, height, mipSettings, mipLevels);
+    result.mipCount = (u32)mipLevels.size() + 1;
+
+    stltype::vector<CookMipLevel> mips(result.mipCount);
+    u64 offset = DDS_HEADER_SIZE;
+    for (u32 i = 0; i < result.mipCount; ++i)
+    {
+        CookMipLevel& mip = mips[i];
+        mip.pPixels = i == 0 ? pRGBA : mipLevels[i - 1].pixels.data();
+        mip.width = stltype::max(width >> i, 1u);
+        mip.height = stltype::max(height >> i, 1u);
+        mip.blocksX = (mip.width + 3) / 4;
+        mip.blocksY = (mip.height + 3) / 4;
+        mip.offset = offset;
+        offset += (u64)mip.blocksX * mip.blocksY * blockSize;
+    }
+    result.compressedSize = offset - DDS_HEADER_SIZE;
+
+    ddsBytes.resize(offset);
+    DDSHeader header{};
+    header.size = sizeof(DDSHeader);
+    header.flags = DDSD_REQUIRED | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height = height;
+    header.width = width;
+    header.pitchOrLinearSize = (u32)((u64)mips[0].blocksX * mips[0].blocksY * blockSize);
+    header.depth = 1;
+    header.mipMapCount = result.mipCount;
+    header.pixelFormat.size = sizeof(DDSPixelFormat);
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+    header.caps = DDSCAPS_TEXTURE | DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+    DDSHeaderDX10 headerDX10{};
+    headerDX10.dxgiFormat = GetDXGIFormat(result.format, isSRGB);
+    headerDX10.resourceDimension = D3D10_RESOURCE_DIMENSION_TEXTURE2D;
+    headerDX10.arraySize = 1;
+
+    const u32 magic = DDS_MAGIC;
+    memcpy(ddsBytes.data(), &magic, sizeof(u32));
+    memcpy(ddsBytes.data() + sizeof(u32), &header, sizeof(DDSHeader));
+    memcpy(ddsBytes.data() + sizeof(u32) + sizeof(DDSHeader), &headerDX10, sizeof(DDSHeaderDX10));
+
+    u32 jobCount = 0;
+    for (const auto& mip : mips)
+    {
+        jobCount += (mip.blocksY + BLOCK_ROWS_PER_JOB - 1) / BLOCK_ROWS_PER_JOB;
+    }
+
+    ScopedZone("TextureCooking::Encode Blocks");
+    if (jobCount <= 1)
+    {
+        for (const auto& mip : mips)
+        {
+            EncodeBlockRows(result.format, mip, 0, mip.blocksY, ddsBytes.data());
+        }
+        return result;
+    }
+
+    ThreadPool::JobGroup jobs;
+    u8* pDst = ddsBytes.data();
+    const BCFormat format = result.format;
+    for (const auto& mip : mips)
+    {
+        for (u32 row = 0; row < mip.blocksY; row += BLOCK_ROWS_PER_JOB)
+        {
+            const u32 rowCount = stltype::min(BLOCK_ROWS_PER_JOB, mip.blocksY - row);
+            g_pJobPool->Submit([format, &mip, row, rowCount, pDst]()
+                               { EncodeBlockRows(format, mip, row, rowCount, pDst); },
+                               &jobs);
+        }
+    }
+    g_pJobPool->Wait(jobs);
+    return result;
+}
+} // namespace TextureCooking
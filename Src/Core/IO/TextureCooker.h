@@ -0,0 +1,52 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+
+enum class TextureSemantic : u8;
+
+// Offline block compression of decoded source textures
+// The cooked result is a complete DDS file (DX10 header, full mip chain) so it goes through the same loading path as
+// DDS files shipped with the assets
+namespace TextureCooking
+{
+// Bump whenever the cooked output changes so stale entries in the asset cache aren't picked up anymore
+static inline constexpr u64 TEXTURE_COOK_VERSION = 2;
+
+enum class BCFormat : u8
+{
+    BC1, // RGB, 4 bpp, opaque data maps
+    BC3, // RGBA, 8 bpp, data maps with alpha
+    BC4, // R, 4 bpp, single channel data
+    BC5, // RG, 8 bpp, tangent space normals, z is reconstructed in the shader
+    BC7  // RGBA, 8 bpp, colors
+};
+
+// Auto is left alone since it's used for lookup tables and other textures that must stay bit exact
+bool ShouldCook(TextureSemantic semantic);
+
+BCFormat ChooseFormat(TextureSemantic semantic, bool hasAlpha);
+u32 GetDXGIFormat(BCFormat format, bool isSRGB);
+u32 GetBlockSize(BCFormat format);
+const char* GetFormatName(BCFormat format);
+
+// Single 4x4 block encoders, pRGBA points to 16 RGBA8 pixels in row order
+void EncodeBC1Block(const u8* pRGBA, u8* pOut);
+void EncodeBC3Block(const u8* pRGBA, u8* pOut);
+void EncodeBC4Block(const u8* pRGBA, u32 channel, u8* pOut);
+void EncodeBC5Block(const u8* pRGBA, u8* pOut);
+void EncodeBC7Block(const u8* pRGBA, u8* pOut);
+
+struct CookedTextureInfo
+{
+    BCFormat format{BCFormat::BC7};
+    u32 mipCount{0};
+    u64 compressedSize{0};
+};
+
+// Compresses RGBA8 pixels into a DDS file with a full mip chain, block rows are encoded in parallel
+// The chain comes from MipGeneration with sRGB and normal map handling picked by the semantic
+CookedTextureInfo CookTexture(const u8* pRGBA,
+                              u32 width,
+                              u32 height,
+                              TextureSemantic semantic,
+                              stltype::vector<u8>& ddsBytes);
+} // namespace TextureCooking
@@ -52,6 +52,7 @@ enum class RayTracingVertexFormat : u8
 enum class RayTracingIndexType : u8
 {
     UInt32 = 0,
+    UInt16 = 1,
 };
 
 enum class RayTracingAccess : u64
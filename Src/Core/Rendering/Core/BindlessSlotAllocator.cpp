@@ -0,0 +1,91 @@
+#include "BindlessSlotAllocator.h"
+
+void BindlessSlotAllocator::Init(u32 capacity, u32 persistentSlotCount)
+{
+    DEBUG_ASSERT(persistentSlotCount < capacity);
+    m_transientEnd = capacity - persistentSlotCount;
+    m_generations.assign(capacity, 0);
+    m_retiredSlots.clear();
+
+    m_transient = Partition{};
+    m_transient.begin = 1;
+    m_transient.end = m_transientEnd;
+    m_transient.nextUnused = m_transient.begin;
+
+    m_persistent = Partition{};
+    m_persistent.begin = m_transientEnd;
+    m_persistent.end = capacity;
+    m_persistent.nextUnused = m_persistent.begin;
+}
+
+stltype::vector<u32> BindlessSlotAllocator::FreeAll(bool isPersistent, u64 frameNumber)
+{
+    stltype::vector<u32> freed;
+    Partition& partition = isPersistent ? m_persistent : m_transient;
+    for (u32 i = partition.begin; i < partition.nextUnused; ++i)
+    {
+        if ((m_generations[i] & 1u) && Free(BindlessSlot{i, m_generations[i]}, frameNumber))
+            freed.push_back(i);
+    }
+    return freed;
+}
+
+BindlessSlot BindlessSlotAllocator::Allocate(bool isPersistent)
+{
+    Partition& partition = isPersistent ? m_persistent : m_transient;
+
+    u32 index = BindlessSlot::InvalidIndex;
+    if (partition.freeSlots.empty() == false)
+    {
+        index = partition.freeSlots.back();
+        partition.freeSlots.pop_back();
+    }
+    else if (partition.nextUnused < partition.end)
+    {
+        index = partition.nextUnused++;
+    }
+    else
+    {
+        DEBUG_LOGF("[BindlessSlotAllocator] Out of {} bindless slots, {} waiting for frames in flight",
+                   isPersistent ? "persistent" : "transient",
+                   m_retiredSlots.size());
+        return BindlessSlot{};
+    }
+
+    ++m_generations[index];
+    ++partition.allocatedCount;
+    return BindlessSlot{index, m_generations[index]};
+}
+
+bool BindlessSlotAllocator::Free(const BindlessSlot& slot, u64 frameNumber)
+{
+    if (IsAlive(slot) == false)
+    {
+        DEBUG_LOGF("[BindlessSlotAllocator] Tried to free stale bindless slot {} (generation {}, current {})",
+                   slot.index,
+                   slot.generation,
+                   slot.index < m_generations.size() ? m_generations[slot.index] : 0u);
+        return false;
+    }
+
+    ++m_generations[slot.index];
+    --GetPartition(slot.index).allocatedCount;
+    m_retiredSlots.push_back(RetiredSlot{slot.index, frameNumber + FRAMES_IN_FLIGHT});
+    return true;
+}
+
+void BindlessSlotAllocator::ReleaseRetiredSlots(u64 frameNumber)
+{
+    while (m_retiredSlots.empty() == false && m_retiredSlots.front().releaseFrame <= frameNumber)
+    {
+        const u32 index = m_retiredSlots.front().index;
+        m_retiredSlots.pop_front();
+        GetPartition(index).freeSlots.push_back(index);
+    }
+}
+
+bool BindlessSlotAllocator::IsAlive(const BindlessSlot& slot) const
+{
+    return slot.IsValid() && slot.index < m_generations.size() && m_generations[slot.index] == slot.generation &&
+           (slot.generation & 1u);
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include <EASTL/deque.h>
+
+// Slots of the bindless texture table reserved for persistent textures at its end by default
+static inline constexpr u32 DEFAULT_PERSISTENT_BINDLESS_SLOTS = 2536;
+
+// Index into a bindless table together with the generation it was handed out with
+struct BindlessSlot
+{
+    static inline constexpr u32 InvalidIndex = 0;
+
+    u32 index{InvalidIndex};
+    u32 generation{0};
+
+    bool IsValid() const
+    {
+        return index != InvalidIndex;
+    }
+};
+
+// Hands out bindless indices from two partitions, transient slots [1, transientEnd) and persistent slots
+// [transientEnd, capacity), slot 0 stays reserved for the placeholder
+// Freed slots only become available again once the frames that might still sample them are done, every allocation
+// bumps the slot's generation so handles kept around after a free can be detected
+// Not thread safe, the owner is expected to lock around it
+class BindlessSlotAllocator
+{
+public:
+    void Init(u32 capacity, u32 persistentSlotCount);
+    // Drops every slot of the partition, they're reused once the frames in flight are done with them
+    // Returns the freed indices so the caller can point their descriptors at the placeholder
+    stltype::vector<u32> FreeAll(bool isPersistent, u64 frameNumber);
+
+    // Invalid slot once the partition is exhausted, callers fall back to the placeholder
+    BindlessSlot Allocate(bool isPersistent);
+    // False for stale slots, the caller should reset the descriptor of a freed slot right away
+    bool Free(const BindlessSlot& slot, u64 frameNumber);
+    // Moves slots freed at least FRAMES_IN_FLIGHT frames ago back to their free list
+    void ReleaseRetiredSlots(u64 frameNumber);
+
+    bool IsAlive(const BindlessSlot& slot) const;
+
+    u32 GetCapacity() const
+    {
+        return (u32)m_generations.size();
+    }
+    u32 GetTransientEnd() const
+    {
+        return m_transientEnd;
+    }
+    u32 GetAllocatedCount(bool isPersistent) const
+    {
+        return isPersistent ? m_persistent.allocatedCount : m_transient.allocatedCount;
+    }
+    u32 GetRetiringCount() const
+    {
+        return (u32)m_retiredSlots.size();
+    }
+
+protected:
+    struct Partition
+    {
+        u32 begin{0};
+        u32 end{0};
+        // Next never used slot, everything below it was handed out at least once
+        u32 nextUnused{0};
+        u32 allocatedCount{0};
+        stltype::vector<u32> freeSlots;
+    };
+    struct RetiredSlot
+    {
+        u32 index;
+        u64 releaseFrame;
+    };
+
+    Partition& GetPartition(u32 index)
+    {
+        return index >= m_transientEnd ? m_persistent : m_transient;
+    }
+
+    Partition m_transient{};
+    Partition m_persistent{};
+    u32 m_transientEnd{0};
+    // Odd generations are allocated, even ones free
+    stltype::vector<u32> m_generations;
+    stltype::deque<RetiredSlot> m_retiredSlots;
+};
@@ -21,9 +21,23 @@ enum class BufferUsage
     AccelerationStructureStorage,
     AccelerationStructureScratch,
     AccelerationStructureInstances,
-    Texture
+    Texture,
+    // Persistently mapped copy source, prefers device local host visible memory when the device has it
+    Upload
 };
 
+// Element type of an index buffer, values match MESH_INDEX_TYPE_* in Scene.h
+enum class IndexType : u8
+{
+    UInt32 = 0,
+    UInt16 = 1,
+};
+
+static inline u32 GetIndexSize(IndexType type)
+{
+    return type == IndexType::UInt16 ? sizeof(u16) : sizeof(u32);
+}
+
 struct BufferCreateInfo
 {
     u64 size;
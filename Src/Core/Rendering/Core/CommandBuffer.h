@@ -85,10 +85,17 @@ struct BinRenderDataCmd : public CommandBase
 {
     VertexBuffer* vertexBuffer{nullptr};
     IndexBuffer* indexBuffer{nullptr};
+    // Second stream of split geometry, left empty by passes that only read positions
+    VertexBuffer* attributeBuffer{nullptr};
+    IndexType indexType{IndexType::UInt32};
 
     BinRenderDataCmd(VertexBuffer& vB, IndexBuffer& iB) : vertexBuffer(&vB), indexBuffer(&iB)
     {
     }
+    BinRenderDataCmd(VertexBuffer& vB, VertexBuffer& aB, IndexBuffer& iB)
+        : vertexBuffer(&vB), indexBuffer(&iB), attributeBuffer(&aB)
+    {
+    }
 };
 
 struct EndRenderingCmd : public CommandBase
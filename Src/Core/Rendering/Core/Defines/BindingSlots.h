@@ -21,7 +21,10 @@ static constexpr u32 s_globalBindlessViewMatricesBufferBindingSlot = 300;
 static constexpr u32 s_clusterGridSSBOBindingSlot = ClusterGridSSBOSlot;
 static constexpr u32 s_sceneAABBsSSBOBindingSlot = SceneAABBsSSBOSlot;
 static constexpr u32 s_viewSpaceLightsSSBOBindingSlot = GlobalViewSpaceLightsSSBOSlot;
+static constexpr u32 s_transformScatterSSBOBindingSlot = TransformScatterSSBOSlot;
 static constexpr u32 s_rtSceneASBindingSlot = RTSceneASBindingSlot;
 static constexpr u32 s_rtInstanceHitDataBindingSlot = RTInstanceHitDataBindingSlot;
 static constexpr u32 s_rtSceneVertexBufferBindingSlot = RTSceneVertexBufferBindingSlot;
 static constexpr u32 s_rtSceneIndexBufferBindingSlot = RTSceneIndexBufferBindingSlot;
+static constexpr u32 s_rtSceneAttributeBufferBindingSlot = RTSceneAttributeBufferBindingSlot;
+static constexpr u32 s_rtSceneIndex16BufferBindingSlot = RTSceneIndex16BufferBindingSlot;
@@ -80,6 +80,8 @@ inline stltype::vector<PipelineDescriptorLayout> RTScene(bool includeGeometry =
         out.push_back(makeLayout(DescriptorType::StorageBuffer, s_rtInstanceHitDataBindingSlot));
         out.push_back(makeLayout(DescriptorType::StorageBuffer, s_rtSceneVertexBufferBindingSlot));
         out.push_back(makeLayout(DescriptorType::StorageBuffer, s_rtSceneIndexBufferBindingSlot));
+        out.push_back(makeLayout(DescriptorType::StorageBuffer, s_rtSceneAttributeBufferBindingSlot));
+        out.push_back(makeLayout(DescriptorType::StorageBuffer, s_rtSceneIndex16BufferBindingSlot));
     }
     return out;
 }
@@ -7,6 +7,7 @@
 #include "../../../../Shaders/Globals/GBuffer/GBufferSampling.h"
 #include "../../../../Shaders/Globals/GeometryPassData.h"
 #include "../../../../Shaders/Globals/Shadows/Data.h"
+#include "../../../../Shaders/Globals/TransformScatter.h"
 
 namespace UBO
 {
@@ -101,6 +102,11 @@ struct PerPassObjectDataSSBO
 };
 static constexpr u64 PerPassObjectDataSSBOSize = sizeof(PerPassObjectBuffer);
 
+// Sparse transform and AABB updates of one frame, applied by the transform scatter pass
+using TransformScatterEntry = ::TransformScatterEntry;
+static constexpr u32 MaxTransformScatterEntries = 16384;
+static constexpr u64 TransformScatterSSBOSize = MaxTransformScatterEntries * sizeof(TransformScatterEntry);
+
 struct RenderPassUBO
 {
     stltype::vector<u32> entityIndices{};
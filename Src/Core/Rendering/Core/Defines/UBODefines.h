@@ -27,6 +27,7 @@ enum class BufferType : u32
     InstanceDataSSBO,
     SceneAABBsSSBO,
     ViewSpaceLightsSSBO,
+    TransformScatterSSBO,
     Custom // Just indicate the class itself will specify all binding slots and so on
 };
 
@@ -58,6 +59,7 @@ static inline stltype::hash_map<BufferType, u32> s_UBOTypeToBindingSlot = {
     {BufferType::PrevTransformSSBO, s_prevModelSSBOBindingSlot},
     {BufferType::SceneAABBsSSBO, s_sceneAABBsSSBOBindingSlot},
     {BufferType::ViewSpaceLightsSSBO, s_viewSpaceLightsSSBOBindingSlot},
+    {BufferType::TransformScatterSSBO, s_transformScatterSSBOBindingSlot},
     {BufferType::LightUniformsUBO, s_globalLightUniformsBindingSlot},
     {BufferType::GBufferUBO, s_globalGbufferPostProcessUBOSlot},
     {BufferType::ShadowmapUBO, s_shadowmapUBOBindingSlot},
@@ -77,6 +79,7 @@ static inline stltype::hash_map<BufferType, ShaderTypeBits> s_UBOTypeToShaderSta
     {BufferType::TransformSSBO, ShaderTypeBits::All},
     {BufferType::PrevTransformSSBO, ShaderTypeBits::All},
     {BufferType::ViewSpaceLightsSSBO, ShaderTypeBits::All},
+    {BufferType::TransformScatterSSBO, ShaderTypeBits::Compute},
     {BufferType::LightUniformsUBO, ShaderTypeBits::All},
     {BufferType::GBufferUBO, ShaderTypeBits::All},
     {BufferType::ShadowmapUBO, ShaderTypeBits::All},
@@ -1,5 +1,6 @@
 #pragma once
 #include "../RenderingTypeDefs.h"
+#include "../../../../Shaders/Globals/VertexFormat.h"
 
 struct MinVertex
 {
@@ -26,13 +27,43 @@ struct CompleteVertex : SimpleVertex
         : SimpleVertex(p, n), texCoord(uv), tangent(t) {}
 };
 
+// The scene geometry buffer is split into a position stream (MinVertex) and an attribute stream holding everything
+// else, so depth only passes fetch 12 bytes per vertex
+struct CompleteVertexAttributes
+{
+    mathstl::Vector3 normal;
+    mathstl::Vector2 texCoord;
+    mathstl::Vector4 tangent;
+};
+static_assert(sizeof(CompleteVertexAttributes) == 36, "CompleteVertexAttributes must match GPUCompleteVertexAttributes");
+
+// Bandwidth friendly attributes, see VertexFormat.h for the encoding
+// Normal and tangent are octahedral encoded into one snorm16x4, the bitangent sign lives in the sign of tangent.y
+struct PackedVertexAttributes
+{
+    DirectX::PackedVector::XMSHORTN4 normalTangentOct;
+    DirectX::PackedVector::XMHALF2 texCoord;
+};
+static_assert(sizeof(PackedVertexAttributes) == 12, "PackedVertexAttributes must match GPUPackedVertexAttributes");
+
+// One format for the whole scene, see VertexFormat.h for why it isn't selected per mesh
+using ScenePositionVertex = MinVertex;
+#if SCENE_VERTEX_FORMAT == SCENE_VERTEX_FORMAT_PACKED
+using SceneVertexAttributes = PackedVertexAttributes;
+#else
+using SceneVertexAttributes = CompleteVertexAttributes;
+#endif
+
 namespace VertexInputDefines
 {
 enum class VertexAttributeTemplates
 {
     None,
     Complete,
-    PositionOnly
+    PositionOnly,
+    // Split layouts, position in binding 0 and the remaining attributes in binding 1
+    CompleteSplit,
+    Packed
 };
 
 enum class VertexAttributes
@@ -46,12 +77,27 @@ enum class VertexAttributes
     TexCoord0,
     TexCoord1,
     TexCoord2,
+    PackedNormalTangent,
+    PackedTexCoord0,
 };
 
 struct VertexAttributeInfo
 {
     stltype::vector<VertexAttributes> attributes;
+    // Position is read from its own vertex buffer binding, everything else from ATTRIBUTE_STREAM_BINDING
+    bool separatePositionStream{false};
 };
+
+static inline constexpr u32 POSITION_STREAM_BINDING = 0;
+static inline constexpr u32 ATTRIBUTE_STREAM_BINDING = 1;
+
+// Layout of the scene geometry buffers, every pass that needs more than positions should use this template
+// Depth only passes use PositionOnly and bind just the position stream
+#if SCENE_VERTEX_FORMAT == SCENE_VERTEX_FORMAT_PACKED
+static inline constexpr VertexAttributeTemplates SceneVertexTemplate = VertexAttributeTemplates::Packed;
+#else
+static inline constexpr VertexAttributeTemplates SceneVertexTemplate = VertexAttributeTemplates::CompleteSplit;
+#endif
 } // namespace VertexInputDefines
 namespace ConcreteVIS
 {
@@ -62,34 +108,52 @@ static inline const VertexAttributeInfo g_completeVertexInputInfo = {
 
 static inline const VertexAttributeInfo g_positionOnlyVertexInputInfo = {
     .attributes = stltype::vector<VertexAttributes>{VertexAttributes::Position}};
+
+static inline const VertexAttributeInfo g_completeSplitVertexInputInfo = {
+    .attributes = stltype::vector<VertexAttributes>{
+        VertexAttributes::Position, VertexAttributes::Normal, VertexAttributes::TexCoord0, VertexAttributes::Tangent},
+    .separatePositionStream = true};
+
+static inline const VertexAttributeInfo g_packedVertexInputInfo = {
+    .attributes = stltype::vector<VertexAttributes>{
+        VertexAttributes::Position, VertexAttributes::PackedNormalTangent, VertexAttributes::PackedTexCoord0},
+    .separatePositionStream = true};
 } // namespace ConcreteVIS
 
 static inline const stltype::hash_map<VertexInputDefines::VertexAttributeTemplates,
                                       VertexInputDefines::VertexAttributeInfo>
     g_VertexInputToRenderDefs = {
         {VertexInputDefines::VertexAttributeTemplates::Complete, ConcreteVIS::g_completeVertexInputInfo},
-        {VertexInputDefines::VertexAttributeTemplates::PositionOnly, ConcreteVIS::g_positionOnlyVertexInputInfo}};
+        {VertexInputDefines::VertexAttributeTemplates::PositionOnly, ConcreteVIS::g_positionOnlyVertexInputInfo},
+        {VertexInputDefines::VertexAttributeTemplates::CompleteSplit, ConcreteVIS::g_completeSplitVertexInputInfo},
+        {VertexInputDefines::VertexAttributeTemplates::Packed, ConcreteVIS::g_packedVertexInputInfo}};
 
 static inline const stltype::hash_map<VertexInputDefines::VertexAttributes, u32> g_VertexAttributeSizeMap = {
     {VertexInputDefines::VertexAttributes::Position, sizeof(mathstl::Vector3)},
     {VertexInputDefines::VertexAttributes::Color0, sizeof(mathstl::Vector3)},
     {VertexInputDefines::VertexAttributes::TexCoord0, sizeof(mathstl::Vector2)},
     {VertexInputDefines::VertexAttributes::Normal, sizeof(mathstl::Vector3)},
-    {VertexInputDefines::VertexAttributes::Tangent, sizeof(mathstl::Vector4)}};
+    {VertexInputDefines::VertexAttributes::Tangent, sizeof(mathstl::Vector4)},
+    {VertexInputDefines::VertexAttributes::PackedNormalTangent, sizeof(DirectX::PackedVector::XMSHORTN4)},
+    {VertexInputDefines::VertexAttributes::PackedTexCoord0, sizeof(DirectX::PackedVector::XMHALF2)}};
 
 static inline const stltype::hash_map<VertexInputDefines::VertexAttributes, u32> g_VertexAttributeBindingMap = {
     {VertexInputDefines::VertexAttributes::Position, 0},
     {VertexInputDefines::VertexAttributes::Color0, 0},
     {VertexInputDefines::VertexAttributes::TexCoord0, 0},
     {VertexInputDefines::VertexAttributes::Normal, 0},
-    {VertexInputDefines::VertexAttributes::Tangent, 0}};
+    {VertexInputDefines::VertexAttributes::Tangent, 0},
+    {VertexInputDefines::VertexAttributes::PackedNormalTangent, 0},
+    {VertexInputDefines::VertexAttributes::PackedTexCoord0, 0}};
 
 static inline const stltype::hash_map<VertexInputDefines::VertexAttributes, u32> g_VertexAttributeLocationMap = {
     {VertexInputDefines::VertexAttributes::Position, 0},
     {VertexInputDefines::VertexAttributes::Color0, 8},
     {VertexInputDefines::VertexAttributes::TexCoord0, 2},
     {VertexInputDefines::VertexAttributes::Normal, 1},
-    {VertexInputDefines::VertexAttributes::Tangent, 3}};
+    {VertexInputDefines::VertexAttributes::Tangent, 3},
+    {VertexInputDefines::VertexAttributes::PackedNormalTangent, 1},
+    {VertexInputDefines::VertexAttributes::PackedTexCoord0, 2}};
 
 #ifdef USE_VULKAN
 static inline const stltype::hash_map<VertexInputDefines::VertexAttributes, VkFormat> g_VertexAttributeVkFormatMap = {
@@ -97,5 +161,7 @@ static inline const stltype::hash_map<VertexInputDefines::VertexAttributes, VkFo
     {VertexInputDefines::VertexAttributes::Color0, TEXFORMAT(R32G32B32_SFLOAT)},
     {VertexInputDefines::VertexAttributes::TexCoord0, TEXFORMAT(R32G32_SFLOAT)},
     {VertexInputDefines::VertexAttributes::Normal, TEXFORMAT(R32G32B32_SFLOAT)},
-    {VertexInputDefines::VertexAttributes::Tangent, TEXFORMAT(R32G32B32A32_SFLOAT)}};
+    {VertexInputDefines::VertexAttributes::Tangent, TEXFORMAT(R32G32B32A32_SFLOAT)},
+    {VertexInputDefines::VertexAttributes::PackedNormalTangent, TEXFORMAT(R16G16B16A16_SNORM)},
+    {VertexInputDefines::VertexAttributes::PackedTexCoord0, TEXFORMAT(R16G16_SFLOAT)}};
 #endif
\ No newline at end of file
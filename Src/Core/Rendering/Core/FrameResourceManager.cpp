@@ -7,7 +7,10 @@
 #include "Core/Rendering/Core/ShaderManager.h"
 #include "Core/Rendering/Core/Synchronization.h"
 #include "Core/Rendering/Core/TransferUtils/TransferQueueHandler.h"
+#include "Core/Rendering/Core/Utils/MeshLODSelection.h"
+#include "Core/Rendering/Core/Utils/MeshletCulling.h"
 #include "Core/Rendering/Core/Utils/TAA/JitterFunctions.h"
+#include "Core/Rendering/Core/Utils/TextureStreamingSelection.h"
 #include "Core/Rendering/Core/View.h"
 #include "Core/Rendering/Passes/PassManager.h"
 #include "Core/Rendering/Passes/ShadowPass.h"
@@ -17,6 +20,7 @@
 #include "Core/Rendering/Vulkan/VkTextureManager.h"
 #include "Core/WindowManager.h"
 #include <EASTL/algorithm.h>
+#include <EASTL/sort.h>
 
 namespace RenderPasses
 {
@@ -30,6 +34,40 @@ int ResolveJitterPhaseCount(const mathstl::Vector2& renderResolution, const Rend
     const f32 scaleRatio = renderState.swapchainResolution.x / renderResolution.x;
     return stltype::max(1, static_cast<int>(8.0f * scaleRatio * scaleRatio + 0.5f));
 }
+
+// A scatter entry carries an index on top of its matrix, so the compact list only pays off once few of the indices
+// in the dirty span actually changed
+constexpr f32 TRANSFORM_SCATTER_MAX_DENSITY = 0.25f;
+// Short spans are cheaper to copy as one range than to dispatch for
+constexpr u32 TRANSFORM_SCATTER_MIN_SPAN = 256;
+
+bool ShouldScatterTransforms(u32 dirtyCount, u32 dirtyMin, u32 dirtyMax)
+{
+    if (dirtyCount == 0 || dirtyMin > dirtyMax)
+        return false;
+    const u32 span = dirtyMax - dirtyMin + 1;
+    return span >= TRANSFORM_SCATTER_MIN_SPAN && (f32)dirtyCount <= (f32)span * TRANSFORM_SCATTER_MAX_DENSITY;
+}
+
+// Instance slots are keyed per sub mesh, the sub mesh index sits in the low bits below the entity ID
+constexpr u32 INSTANCE_SLOT_SUBMESH_BITS = 16;
+
+u64 MakeInstanceSlotKey(ECS::EntityID entityID, u32 subMeshIdx)
+{
+    DEBUG_ASSERT(subMeshIdx < (1u << INSTANCE_SLOT_SUBMESH_BITS) &&
+                 (entityID >> (64 - INSTANCE_SLOT_SUBMESH_BITS)) == 0);
+    return (entityID << INSTANCE_SLOT_SUBMESH_BITS) | subMeshIdx;
+}
+
+ECS::EntityID GetInstanceSlotEntity(u64 key)
+{
+    return key >> INSTANCE_SLOT_SUBMESH_BITS;
+}
+
+u32 GetInstanceSlotSubMesh(u64 key)
+{
+    return (u32)(key & ((1ull << INSTANCE_SLOT_SUBMESH_BITS) - 1));
+}
 } // namespace
 
 void FrameResourceManager::BuildSharedDataForView(const RenderView& mainView,
@@ -160,10 +198,14 @@ void FrameResourceManager::Init()
     m_cachedTransformSSBO.resize(MAX_ENTITIES);
     m_cachedPrevTransformSSBO.resize(MAX_ENTITIES);
     m_cachedSceneAABBs.resize(MAX_ENTITIES);
+    m_transformSlots.Init(MAX_ENTITIES);
+    m_instanceSlots.Init(MAX_ENTITIES);
 
     m_skyboxTextureHandle = g_pTexManager->SubmitAsyncTextureCreation(
         {"../../Resources/Skyboxes/mpumalanga_veld_puresky_4k.hdr", false, TextureSemantic::Auto, true});
-    m_skyboxBindlessHandle = g_pTexManager->MakeTextureBindless(m_skyboxTextureHandle, true);
+    const BindlessSlot skyboxSlot = g_pTexManager->MakeTextureBindless(m_skyboxTextureHandle, true);
+    DEBUG_ASSERT(skyboxSlot.IsValid());
+    m_skyboxBindlessHandle = skyboxSlot.index;
 }
 
 void FrameResourceManager::CreatePassObjectsAndLayouts()
@@ -425,6 +467,8 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
     }
 
     auto& resourceManager = pPassManager->GetResourceManager();
+    resourceManager.ResetTransformScatter(frameIdx);
+    bool isGeometryPublished = false;
 
     if (m_dataToBePreProcessed.IsEmpty() && !m_transformsPendingPrevCatchup.empty())
     {
@@ -437,9 +481,19 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
             prevDirtyMax = (stltype::max)(prevDirtyMax, ssboIdx);
         }
 
-        const u32 prevDirtyCount = prevDirtyMax - prevDirtyMin + 1;
-        resourceManager.UpdatePrevTransformRange(
-            m_cachedPrevTransformSSBO, prevDirtyMin, prevDirtyCount, currentSwapChainIdx);
+        const u32 catchupCount = (u32)m_transformsPendingPrevCatchup.size();
+        if (ShouldScatterTransforms(catchupCount, prevDirtyMin, prevDirtyMax) &&
+            resourceManager.CanScatter(catchupCount, frameIdx))
+        {
+            resourceManager.ScatterTransforms(
+                m_cachedPrevTransformSSBO, m_transformsPendingPrevCatchup, true, frameIdx);
+        }
+        else
+        {
+            const u32 prevDirtyCount = prevDirtyMax - prevDirtyMin + 1;
+            resourceManager.UpdatePrevTransformRange(
+                m_cachedPrevTransformSSBO, prevDirtyMin, prevDirtyCount, currentSwapChainIdx);
+        }
         m_transformsPendingPrevCatchup.clear();
     }
 
@@ -448,32 +502,34 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
         DEBUG_ASSERT(m_dataToBePreProcessed.IsValid());
         PassGeometryData passData{};
 
+        m_dirtyTransformIndices.clear();
+
         if (m_dataToBePreProcessed.entityMeshData.empty() == false)
         {
-            stltype::hash_map<u64, u32> entityToMeshIdx;
-            entityToMeshIdx.reserve(m_dataToBePreProcessed.entityMeshData.size());
-            u32 meshIdx = 0;
-
-            for (const auto& data : m_dataToBePreProcessed.entityMeshData)
-            {
-                const auto& entityID = data.first;
-                DEBUG_ASSERT(entityToMeshIdx.find(entityID) == entityToMeshIdx.end());
-                entityToMeshIdx.insert({entityID, meshIdx});
-                ++meshIdx;
-            }
+            const auto& entityMeshData = m_dataToBePreProcessed.entityMeshData;
+            AssignInstanceSlots(entityMeshData);
 
-            passData.staticMeshPassData.reserve(m_dataToBePreProcessed.entityMeshData.size());
-            m_entityToTransformUBOIdx = entityToMeshIdx;
-            for (const auto& meshDataVecPair : m_dataToBePreProcessed.entityMeshData)
+            passData.staticMeshPassData.reserve(m_instanceSlots.GetLiveCount());
+            for (const auto& [entityID, meshDataVec] : entityMeshData)
             {
-                const auto& entityID = meshDataVecPair.first;
-                for (const auto& meshData : meshDataVecPair.second)
+                const u32 bufferIndex = m_transformSlots.Find(entityID);
+                if (bufferIndex == InstanceSlotAllocator::InvalidSlot)
+                    continue;
+                for (const auto& meshData : meshDataVec)
                 {
-                    DEBUG_ASSERT(m_entityToTransformUBOIdx.find(entityID) != m_entityToTransformUBOIdx.end());
-                    const auto& bufferIndex = m_entityToTransformUBOIdx[entityID];
-                    passData.staticMeshPassData.emplace_back(meshData, bufferIndex);
+                    const u32 instanceIdx = m_instanceSlots.Find(MakeInstanceSlotKey(entityID, meshData.subMeshIdx));
+                    if (instanceIdx == InstanceSlotAllocator::InvalidSlot)
+                        continue;
+                    auto& passMeshData = passData.staticMeshPassData.emplace_back(meshData, bufferIndex);
+                    passMeshData.meshData.instanceDataIdx = instanceIdx;
                 }
             }
+            // Ordering by slot keeps the draw order independent of how the hash map happens to iterate, so an
+            // unchanged scene compares equal below
+            stltype::sort(passData.staticMeshPassData.begin(),
+                          passData.staticMeshPassData.end(),
+                          [](const PassMeshData& a, const PassMeshData& b)
+                          { return a.meshData.instanceDataIdx < b.meshData.instanceDataIdx; });
 
             // Compare to current state
             bool needsRebuild = false;
@@ -482,9 +538,11 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
             {
                 for (u32 i = 0; i < m_currentPassGeometryState.staticMeshPassData.size(); ++i)
                 {
-                    const auto& currentMeshData = m_currentPassGeometryState.staticMeshPassData[i].meshData;
-                    const auto& newMeshData = passData.staticMeshPassData[i].meshData;
-                    if (newMeshData.DidGeometryChange(currentMeshData))
+                    const auto& currentMesh = m_currentPassGeometryState.staticMeshPassData[i];
+                    const auto& newMesh = passData.staticMeshPassData[i];
+                    if (newMesh.meshData.DidGeometryChange(currentMesh.meshData) ||
+                        newMesh.transformIdx != currentMesh.transformIdx ||
+                        newMesh.meshData.instanceDataIdx != currentMesh.meshData.instanceDataIdx)
                     {
                         needsRebuild = true;
                         break;
@@ -495,15 +553,17 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
             {
                 needsRebuild = true;
             }
+            needsRebuild |= resourceManager.HasUnpublishedGeometryMoves();
             if (needsRebuild)
             {
-                pPassManager->GetResourceManager().UpdateInstanceDataSSBO(passData.staticMeshPassData,
-                                                                          currentSwapChainIdx);
+                resourceManager.UpdateInstanceDataSSBO(
+                    passData.staticMeshPassData, m_instanceSlots.GetUsedRange(), currentSwapChainIdx);
                 const u32 previousImageIdx =
                     (currentSwapChainIdx == 0) ? (SWAPCHAIN_IMAGES - 1) : (currentSwapChainIdx - 1);
                 pPassManager->PreProcessMeshDataPublic(
                     passData.staticMeshPassData, previousImageIdx, currentSwapChainIdx);
                 m_currentPassGeometryState = passData;
+                isGeometryPublished = true;
             }
             pPassManager->TransferPassDataPublic(std::move(passData), m_dataToBePreProcessed.frameIdx);
         }
@@ -523,25 +583,22 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
         for (const auto& data : m_dataToBePreProcessed.entityTransformData)
         {
             const auto& entityID = data.first;
-            auto uboIt = m_entityToTransformUBOIdx.find(entityID);
-            if (uboIt == m_entityToTransformUBOIdx.end())
+            const u32 ssboIdx = m_transformSlots.Find(entityID);
+            if (ssboIdx == InstanceSlotAllocator::InvalidSlot)
+            {
+                m_unslottedTransforms[entityID] = data.second;
                 continue;
+            }
 
-            const u32 ssboIdx = uboIt->second;
             m_cachedPrevTransformSSBO[ssboIdx] = m_cachedTransformSSBO[ssboIdx];
             m_cachedTransformSSBO[ssboIdx] = data.second;
             m_transformsToPropagateToPrev.push_back(ssboIdx);
             m_transformsPendingPrevCatchup.push_back(ssboIdx);
+            m_dirtyTransformIndices.push_back(ssboIdx);
+        }
 
-            AABB aabb{};
-            if (m_dataToBePreProcessed.entityMeshData.find(entityID) != m_dataToBePreProcessed.entityMeshData.end())
-            {
-                const auto& meshDataVec = m_dataToBePreProcessed.entityMeshData.at(entityID);
-                if (!meshDataVec.empty())
-                    aabb = meshDataVec[0].aabb;
-            }
-            m_cachedSceneAABBs[ssboIdx] = aabb;
-
+        for (u32 ssboIdx : m_dirtyTransformIndices)
+        {
             dirtyMin = (stltype::min)(dirtyMin, ssboIdx);
             dirtyMax = (stltype::max)(dirtyMax, ssboIdx);
         }
@@ -551,7 +608,13 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
             prevDirtyMin = (stltype::min)(prevDirtyMin, ssboIdx);
             prevDirtyMax = (stltype::max)(prevDirtyMax, ssboIdx);
         }
-        if (prevDirtyMin <= prevDirtyMax)
+        const u32 prevUpdateCount = (u32)m_transformsToPropagateToPrev.size();
+        if (ShouldScatterTransforms(prevUpdateCount, prevDirtyMin, prevDirtyMax) &&
+            resourceManager.CanScatter(prevUpdateCount, frameIdx))
+        {
+            resourceManager.ScatterTransforms(m_cachedPrevTransformSSBO, m_transformsToPropagateToPrev, true, frameIdx);
+        }
+        else if (prevDirtyMin <= prevDirtyMax)
         {
             const u32 prevDirtyCount = prevDirtyMax - prevDirtyMin + 1;
             resourceManager.UpdatePrevTransformRange(
@@ -559,7 +622,15 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
         }
         m_transformsToPropagateToPrev.clear();
 
-        if (dirtyMin <= dirtyMax)
+        // Every moved transform takes its AABB along, so the scatter needs two entries per index
+        const u32 dirtyUpdateCount = (u32)m_dirtyTransformIndices.size();
+        if (ShouldScatterTransforms(dirtyUpdateCount, dirtyMin, dirtyMax) &&
+            resourceManager.CanScatter(dirtyUpdateCount * 2, frameIdx))
+        {
+            resourceManager.ScatterTransforms(m_cachedTransformSSBO, m_dirtyTransformIndices, false, frameIdx);
+            resourceManager.ScatterSceneAABBs(m_cachedSceneAABBs, m_dirtyTransformIndices, frameIdx);
+        }
+        else if (dirtyMin <= dirtyMax)
         {
             const u32 dirtyCount = dirtyMax - dirtyMin + 1;
             resourceManager.UpdateTransformRange(m_cachedTransformSSBO, dirtyMin, dirtyCount, currentSwapChainIdx);
@@ -679,9 +750,176 @@ void FrameResourceManager::PreProcessDataForCurrentFrame(u32 frameIdx,
         g_pQueueHandler->DispatchAllRequests();
     }
 
+    // Defragmentation moved meshes without the scene changing, the instance data and draws need their new offsets
+    if (isGeometryPublished == false && m_currentPassGeometryState.staticMeshPassData.empty() == false &&
+        resourceManager.HasUnpublishedGeometryMoves())
+    {
+        resourceManager.UpdateInstanceDataSSBO(
+            m_currentPassGeometryState.staticMeshPassData, m_instanceSlots.GetUsedRange(), currentSwapChainIdx);
+        const u32 previousImageIdx = (currentSwapChainIdx == 0) ? (SWAPCHAIN_IMAGES - 1) : (currentSwapChainIdx - 1);
+        pPassManager->PreProcessMeshDataPublic(
+            m_currentPassGeometryState.staticMeshPassData, previousImageIdx, currentSwapChainIdx);
+    }
+
+    // LODs follow the camera every frame, only the image we're preparing is rebuilt since the other one may still be in
+    // flight, it catches up once it's prepared next
+    if (m_currentPassGeometryState.staticMeshPassData.empty() == false)
+    {
+        if (SelectMeshLODs(m_currentPassGeometryState.staticMeshPassData,
+                           m_dataToBePreProcessed.mainView,
+                           passManagerRenderState.renderResolution,
+                           renderState))
+        {
+            m_lodRebuildImageMask = (1u << SWAPCHAIN_IMAGES) - 1;
+        }
+        if (m_lodRebuildImageMask & (1u << currentSwapChainIdx))
+        {
+            const u32 previousImageIdx =
+                (currentSwapChainIdx == 0) ? (SWAPCHAIN_IMAGES - 1) : (currentSwapChainIdx - 1);
+            pPassManager->RebuildMeshDataForImagePublic(
+                m_currentPassGeometryState.staticMeshPassData, previousImageIdx, currentSwapChainIdx);
+            m_lodRebuildImageMask &= ~(1u << currentSwapChainIdx);
+        }
+    }
+    UpdateTextureStreamingFeedback(m_currentPassGeometryState.staticMeshPassData,
+                                   m_dataToBePreProcessed.mainView,
+                                   passManagerRenderState.renderResolution,
+                                   renderState);
+
+    const FrameUploadStats uploadStats = g_pQueueHandler->GetUploadStats();
+    g_pApplicationState->RegisterUpdateFunction(
+        [uploadStats](ApplicationState& state)
+        {
+            state.renderState.uploadRingBytes = uploadStats.ringBytes;
+            state.renderState.uploadRingUpdateCount = uploadStats.ringUpdateCount;
+            state.renderState.stagedUploadBytes = uploadStats.stagedBytes;
+            state.renderState.stagedUploadCount = uploadStats.stagedUpdateCount;
+        });
+
+    if (mathstl::isFlagSet(renderState.debugFlags, (u32)DebugFlags::CullFrustum))
+    {
+        RunReferenceMeshletCulling(m_dataToBePreProcessed.mainView.position);
+    }
+
     m_frameRendererContexts[currentSwapChainIdx].numLights = m_lightCluster->numLights;
 }
 
+bool FrameResourceManager::SelectMeshLODs(stltype::vector<PassMeshData>& meshes,
+                                          const RenderView& mainView,
+                                          const mathstl::Vector2& renderResolution,
+                                          const RendererState& renderState) const
+{
+    ScopedZone("FrameResourceManager::SelectMeshLODs");
+    const f32 projectionScale =
+        Utils::ComputeLODProjectionScale(DirectX::XMConvertToRadians(mainView.fov), renderResolution.y);
+    const f32 zNear = stltype::max(mainView.zNear, 0.000001f);
+
+    bool selectionChanged = false;
+    for (auto& mesh : meshes)
+    {
+        const auto& meshHandle = mesh.meshData.meshResourceHandle;
+        if (meshHandle.lodCount <= 1 || mesh.transformIdx >= m_cachedTransformSSBO.size())
+            continue;
+
+        const mathstl::Matrix world(m_cachedTransformSSBO[mesh.transformIdx]);
+        const f32 projectedRadius = Utils::ComputeProjectedRadius(
+            mesh.meshData.aabb, world, mainView.position, projectionScale, zNear);
+        const u32 lodIdx = Utils::SelectMeshLOD(
+            meshHandle, projectedRadius, mesh.lodIdx, renderState.lodPixelError, renderState.lodHysteresis);
+        selectionChanged |= lodIdx != mesh.lodIdx;
+        mesh.lodIdx = lodIdx;
+    }
+    return selectionChanged;
+}
+
+void FrameResourceManager::UpdateTextureStreamingFeedback(const stltype::vector<PassMeshData>& meshes,
+                                                          const RenderView& mainView,
+                                                          const mathstl::Vector2& renderResolution,
+                                                          const RendererState& renderState) const
+{
+    ScopedZone("FrameResourceManager::UpdateTextureStreamingFeedback");
+    const f32 projectionScale =
+        Utils::ComputeLODProjectionScale(DirectX::XMConvertToRadians(mainView.fov), renderResolution.y);
+    const f32 zNear = stltype::max(mainView.zNear, 0.000001f);
+
+    stltype::vector<stltype::pair<BindlessTextureHandle, f32>> requiredExtents;
+    requiredExtents.reserve(meshes.size() * 2);
+    for (const auto& mesh : meshes)
+    {
+        const Material* pMaterial = mesh.meshData.pMaterial;
+        const Mesh* pMesh = mesh.meshData.pMesh;
+        if (pMaterial == nullptr || pMesh == nullptr || mesh.transformIdx >= m_cachedTransformSSBO.size())
+            continue;
+
+        const auto& aabb = mesh.meshData.aabb;
+        const mathstl::Matrix world(m_cachedTransformSSBO[mesh.transformIdx]);
+        const f32 projectedRadius = Utils::ComputeProjectedRadius(aabb, world, mainView.position, projectionScale, zNear);
+        const f32 localRadius = mathstl::Vector3(aabb.extents.x, aabb.extents.y, aabb.extents.z).Length();
+        const f32 requiredExtent = Utils::ComputeRequiredTextureExtent(projectedRadius, localRadius, pMesh->uvDensity);
+
+        const auto addTexture = [&](u32 flagBit, BindlessTextureHandle slot)
+        {
+            if (IsMaterialFlagSet(pMaterial->flags, flagBit))
+                requiredExtents.emplace_back(slot, requiredExtent);
+        };
+        addTexture(MATERIAL_FLAG_DIFFUSE_BIT, pMaterial->diffuseTexture);
+        addTexture(MATERIAL_FLAG_NORMAL_BIT, pMaterial->normalTexture);
+        addTexture(MATERIAL_FLAG_METALLIC_ROUGHNESS_BIT, pMaterial->metallicRoughnessTexture);
+        addTexture(MATERIAL_FLAG_EMISSIVE_BIT, pMaterial->emissiveTexture);
+        addTexture(MATERIAL_FLAG_SHEEN_BIT, pMaterial->sheenTexture);
+        addTexture(MATERIAL_FLAG_CLEARCOAT_BIT, pMaterial->clearcoatTexture);
+        addTexture(MATERIAL_FLAG_SPECULAR_GLOSSINESS_BIT, pMaterial->specularTexture);
+    }
+    const TextureStreamingStats stats = g_pTexManager->SubmitStreamingFeedback(
+        TextureStreamingSettings{renderState.textureStreaming,
+                                 (u64)renderState.textureStreamingBudgetMB * 1024 * 1024,
+                                 (u64)renderState.textureUploadBudgetMB * 1024 * 1024},
+        stltype::move(requiredExtents));
+    g_pApplicationState->RegisterUpdateFunction(
+        [stats](ApplicationState& state)
+        {
+            state.renderState.streamedTextureCount = stats.streamedTextureCount;
+            state.renderState.pendingTextureStreamingLoads = stats.pendingLoadCount;
+            state.renderState.textureStreamingResidentBytes = stats.residentBytes;
+            state.renderState.textureStreamingWantedBytes = stats.wantedBytes;
+            state.renderState.textureResidencyBudgetBytes = stats.budgetBytes;
+            state.renderState.vramBudgetBytes = stats.vramBudgetBytes;
+            state.renderState.vramBudgetUsageBytes = stats.vramUsageBytes;
+            state.renderState.evictedTextureCount = stats.evictedTextureCount;
+            state.renderState.textureEvictionCount = stats.evictionCount;
+            state.renderState.textureUploadQueueDepth = stats.uploadQueueDepth;
+            state.renderState.textureUploadQueueBytes = stats.uploadQueueBytes;
+            state.renderState.textureUploadedBytesLastFrame = stats.uploadedBytesLastFrame;
+        });
+}
+
+void FrameResourceManager::RunReferenceMeshletCulling(const mathstl::Vector3& viewPos) const
+{
+    ScopedZone("FrameResourceManager::RunReferenceMeshletCulling");
+    const auto view = Utils::BuildMeshletCullingView(m_currentSharedDataUBO.viewProjection, viewPos);
+    Utils::MeshletCullingStats totalStats{};
+    for (const auto& mesh : m_currentPassGeometryState.staticMeshPassData)
+    {
+        if (mesh.meshData.IsDebugMesh() || mesh.transformIdx >= m_cachedTransformSSBO.size())
+            continue;
+        const auto stats = Utils::CullMeshlets(
+            mesh.meshData.pMesh->meshlets, mathstl::Matrix(m_cachedTransformSSBO[mesh.transformIdx]), view);
+        totalStats.testedMeshlets += stats.testedMeshlets;
+        totalStats.frustumCulledMeshlets += stats.frustumCulledMeshlets;
+        totalStats.backfaceCulledMeshlets += stats.backfaceCulledMeshlets;
+        totalStats.visibleTriangles += stats.visibleTriangles;
+    }
+
+    g_pApplicationState->RegisterUpdateFunction(
+        [totalStats](ApplicationState& state)
+        {
+            state.renderState.meshletCount = totalStats.testedMeshlets;
+            state.renderState.frustumCulledMeshletCount = totalStats.frustumCulledMeshlets;
+            state.renderState.backfaceCulledMeshletCount = totalStats.backfaceCulledMeshlets;
+            state.renderState.visibleMeshletTriangleCount = totalStats.visibleTriangles;
+        });
+}
+
 void FrameResourceManager::SetEntityMeshDataForFrame(EntityMeshDataMap&& data, u32 frameIdx)
 {
     m_passDataMutex.lock();
@@ -779,11 +1017,95 @@ void FrameResourceManager::DispatchSSBOTransfer(void* data,
     g_pQueueHandler->SubmitTransferCommandAsync(transfer);
 }
 
+void FrameResourceManager::AssignInstanceSlots(const EntityMeshDataMap& entityMeshData)
+{
+    ScopedZone("FrameResourceManager::AssignInstanceSlots");
+
+    // Mesh data is a full snapshot, whatever isn't in it anymore frees its slots
+    m_transformSlots.ReleaseUnused([&entityMeshData](u64 entityID)
+                                   { return entityMeshData.find(entityID) != entityMeshData.end(); });
+    m_instanceSlots.ReleaseUnused(
+        [&entityMeshData](u64 key)
+        {
+            const auto it = entityMeshData.find(GetInstanceSlotEntity(key));
+            return it != entityMeshData.end() && GetInstanceSlotSubMesh(key) < it->second.size();
+        });
+
+    stltype::vector<InstanceSlotMove> moves;
+    if (m_transformSlots.NeedsCompaction())
+    {
+        m_transformSlots.Compact(moves);
+        stltype::hash_map<u32, u32> movedSlots;
+        movedSlots.reserve(moves.size());
+        for (const auto& move : moves)
+        {
+            m_cachedTransformSSBO[move.to] = m_cachedTransformSSBO[move.from];
+            m_cachedPrevTransformSSBO[move.to] = m_cachedPrevTransformSSBO[move.from];
+            m_cachedSceneAABBs[move.to] = m_cachedSceneAABBs[move.from];
+            m_dirtyTransformIndices.push_back(move.to);
+            m_transformsToPropagateToPrev.push_back(move.to);
+            movedSlots[move.from] = move.to;
+        }
+        // Last frame's transforms still waiting for their prev copy have to follow their slot
+        for (u32& ssboIdx : m_transformsPendingPrevCatchup)
+        {
+            if (const auto it = movedSlots.find(ssboIdx); it != movedSlots.end())
+                ssboIdx = it->second;
+        }
+        DEBUG_LOGF("[FrameResourceManager] Compacted transform slots, moved {}", (u32)moves.size());
+    }
+    if (m_instanceSlots.NeedsCompaction())
+    {
+        // Instance data gets rebuilt from the pass data anyway, moved slots simply show up as changed ones
+        moves.clear();
+        m_instanceSlots.Compact(moves);
+        DEBUG_LOGF("[FrameResourceManager] Compacted instance slots, moved {}", (u32)moves.size());
+    }
+
+    for (const auto& [entityID, meshDataVec] : entityMeshData)
+    {
+        bool isNewSlot = false;
+        const u32 transformIdx = m_transformSlots.Acquire(entityID, &isNewSlot);
+        if (transformIdx == InstanceSlotAllocator::InvalidSlot)
+            continue;
+
+        const AABB aabb = meshDataVec.empty() ? AABB{} : meshDataVec[0].aabb;
+        if (isNewSlot)
+        {
+            // Transforms only get sent when they change, so use the one that arrived before the entity had a slot
+            if (const auto it = m_unslottedTransforms.find(entityID); it != m_unslottedTransforms.end())
+            {
+                m_cachedTransformSSBO[transformIdx] = it->second;
+                m_unslottedTransforms.erase(it);
+            }
+            else
+            {
+                m_cachedTransformSSBO[transformIdx] = mathstl::Matrix::Identity;
+            }
+            m_cachedPrevTransformSSBO[transformIdx] = m_cachedTransformSSBO[transformIdx];
+            m_cachedSceneAABBs[transformIdx] = aabb;
+            m_dirtyTransformIndices.push_back(transformIdx);
+            m_transformsToPropagateToPrev.push_back(transformIdx);
+        }
+        else if (memcmp(&m_cachedSceneAABBs[transformIdx], &aabb, sizeof(AABB)) != 0)
+        {
+            m_cachedSceneAABBs[transformIdx] = aabb;
+            m_dirtyTransformIndices.push_back(transformIdx);
+        }
+
+        for (const auto& meshData : meshDataVec)
+            m_instanceSlots.Acquire(MakeInstanceSlotKey(entityID, meshData.subMeshIdx));
+    }
+}
+
 void FrameResourceManager::ClearGeometryCaches()
 {
     SimpleScopedGuard lock(m_passDataMutex);
     m_currentPassGeometryState = PassGeometryData{};
     m_dataToBePreProcessed.Clear();
+    m_transformSlots.Clear();
+    m_instanceSlots.Clear();
+    m_unslottedTransforms.clear();
 }
 
 } // namespace RenderPasses
@@ -13,11 +13,13 @@
 #include "Core/Rendering/Core/RenderingForwardDecls.h"
 #include "Core/Rendering/Vulkan/VkBuffer.h"
 #include "Core/Rendering/Core/DescriptorPool.h"
+#include "Core/Rendering/Core/InstanceSlotAllocator.h"
 #include "Core/Rendering/Passes/PassManagerDefines.h"
 #include <EASTL/fixed_vector.h>
 #include <EASTL/unique_ptr.h>
 
 class SharedResourceManager;
+struct RendererState;
 
 namespace RenderPasses
 {
@@ -192,6 +194,22 @@ private:
                                 mathstl::Matrix& viewProj,
                                 mathstl::Vector2& jitter,
                                 FrameCameraData& cameraData) const;
+    // Picks the LOD of every mesh from its projected size, returns true if any selection changed
+    bool SelectMeshLODs(stltype::vector<PassMeshData>& meshes,
+                        const RenderView& mainView,
+                        const mathstl::Vector2& renderResolution,
+                        const RendererState& renderState) const;
+    // Texels every material texture needs from the projected size and UV density of the meshes using it, drives the
+    // texture manager's mip streaming
+    void UpdateTextureStreamingFeedback(const stltype::vector<PassMeshData>& meshes,
+                                        const RenderView& mainView,
+                                        const mathstl::Vector2& renderResolution,
+                                        const RendererState& renderState) const;
+    // CPU cluster culling of the current geometry, only run for debugging to validate the meshlet data
+    void RunReferenceMeshletCulling(const mathstl::Vector3& viewPos) const;
+    // Keeps the transform and instance slots of every entity and sub mesh in the snapshot, releases the rest and
+    // compacts on demand. New and moved transform slots get queued for upload
+    void AssignInstanceSlots(const EntityMeshDataMap& entityMeshData);
 
     ProfiledLockable(CustomMutex, m_passDataMutex);
     RenderDataForPreProcessing m_dataToBePreProcessed;
@@ -220,7 +238,11 @@ private:
 
     UBO::SharedDataUBO m_currentSharedDataUBO{};
     PassGeometryData m_currentPassGeometryState{};
-    stltype::hash_map<ECS::EntityID, u32> m_entityToTransformUBOIdx{};
+    // One transform slot per entity and one instance slot per sub mesh, stable for as long as they exist
+    InstanceSlotAllocator m_transformSlots{};
+    InstanceSlotAllocator m_instanceSlots{};
+    // Latest transform of entities that have no mesh data yet, picked up once they get a slot
+    stltype::hash_map<ECS::EntityID, DirectX::XMFLOAT4X4> m_unslottedTransforms{};
     stltype::hash_map<ECS::EntityID, u32> m_entityToObjectDataIdx{};
     DirLightVector m_cachedDirLights{};
     stltype::vector<DirectX::XMFLOAT4X4> m_cachedTransformSSBO{};
@@ -228,11 +250,15 @@ private:
     stltype::vector<AABB> m_cachedSceneAABBs{};
     stltype::vector<u32> m_transformsToPropagateToPrev{};
     stltype::vector<u32> m_transformsPendingPrevCatchup{};
+    // Transforms written this frame, decides between a scatter and a range upload
+    stltype::vector<u32> m_dirtyTransformIndices{};
 
     bool m_needsToPropagateMainDataUpdate{false};
     u32 m_frameIdxToPropagate{0};
 
     u32 m_framesToRebuild{0};
+    // Swapchain images whose indirect draws still use an outdated LOD selection
+    u32 m_lodRebuildImageMask{0};
 
     ShadowMapState m_currentShadowMapState{};
 
@@ -7,10 +7,82 @@ enum class Allocator
     Default,
     // Classic vulkan memory allocator library
     VMA,
-    // Own memory allocator, which I will implement one day TM
+    // Own allocator, sub-allocates buffers and textures from large device memory blocks with TLSF, render targets get
+    // dedicated allocations
     Convolution
 };
 
+// Buckets the Convolution allocator keeps budgets and stats for
+enum class GPUMemoryCategory : u8
+{
+    // Vertex and index buffers
+    Geometry,
+    // Device local storage, indirect and acceleration structure buffers
+    Buffers,
+    // Mappable staging, upload, uniform and host storage buffers
+    HostUpload,
+    // Sampled images
+    Textures,
+    // Color, depth and storage images, every one gets its own device memory
+    RenderTargets,
+    Count
+};
+
+static inline const char* GetGPUMemoryCategoryName(GPUMemoryCategory category)
+{
+    switch (category)
+    {
+        case GPUMemoryCategory::Geometry:
+            return "Geometry";
+        case GPUMemoryCategory::Buffers:
+            return "Buffers";
+        case GPUMemoryCategory::HostUpload:
+            return "Host Upload";
+        case GPUMemoryCategory::Textures:
+            return "Textures";
+        case GPUMemoryCategory::RenderTargets:
+            return "Render Targets";
+        default:
+            break;
+    }
+    return "Unknown";
+}
+
+struct GPUMemoryCategoryStats
+{
+    // Soft limit, allocations past it still succeed but get counted
+    u64 budgetBytes{0};
+    u64 allocatedBytes{0};
+    // Device memory held by the category's blocks and dedicated allocations
+    u64 reservedBytes{0};
+    // Free bytes inside the category's blocks and the largest range among them
+    u64 freeBytes{0};
+    u64 largestFreeBlock{0};
+    u32 allocationCount{0};
+    u32 blockCount{0};
+    u32 dedicatedCount{0};
+    u32 freeRangeCount{0};
+    u32 overBudgetAllocations{0};
+
+    // 0 while the free memory is one contiguous range, approaching 1 the more it's scattered into small ones
+    f32 GetFragmentation() const
+    {
+        return freeBytes > 0 ? 1.0f - (f32)((f64)largestFreeBlock / (f64)freeBytes) : 0.0f;
+    }
+};
+
+struct GPUAllocatorBenchmark
+{
+    u32 allocationCount{0};
+    f64 vmaAllocateMs{0.0};
+    f64 vmaFreeMs{0.0};
+    f64 convolutionAllocateMs{0.0};
+    f64 convolutionFreeMs{0.0};
+    // The replay ran out of memory and was stopped, the timings of that allocator are incomplete
+    bool vmaOutOfMemory{false};
+    bool convolutionOutOfMemory{false};
+};
+
 IMPLEMENT_GRAPHICS_API
 class GPUMemManager
 {
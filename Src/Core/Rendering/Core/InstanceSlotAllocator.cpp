@@ -0,0 +1,110 @@
+#include "InstanceSlotAllocator.h"
+#include <EASTL/sort.h>
+
+// Compacting rewrites every moved slot on the GPU, only worth it once a good share of the used range are holes
+static constexpr u32 INSTANCE_SLOT_COMPACTION_MIN_HOLES = 64;
+static constexpr u32 INSTANCE_SLOT_COMPACTION_HOLE_RATIO = 4;
+
+void InstanceSlotAllocator::Init(u32 capacity)
+{
+    m_capacity = capacity;
+    Clear();
+}
+
+void InstanceSlotAllocator::Clear()
+{
+    m_keyToSlot.clear();
+    m_slotKeys.clear();
+    m_freeSlots.clear();
+}
+
+u32 InstanceSlotAllocator::Acquire(u64 key, bool* pIsNew)
+{
+    DEBUG_ASSERT(key != InvalidKey);
+    if (pIsNew)
+        *pIsNew = false;
+
+    if (const auto it = m_keyToSlot.find(key); it != m_keyToSlot.end())
+        return it->second;
+
+    u32 slot = InvalidSlot;
+    if (m_freeSlots.empty() == false)
+    {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else if (m_slotKeys.size() < m_capacity)
+    {
+        slot = (u32)m_slotKeys.size();
+        m_slotKeys.push_back(InvalidKey);
+    }
+    else
+    {
+        DEBUG_LOGF("[InstanceSlotAllocator] Out of instance slots, all {} are in use", m_capacity);
+        return InvalidSlot;
+    }
+
+    m_slotKeys[slot] = key;
+    m_keyToSlot.emplace(key, slot);
+    if (pIsNew)
+        *pIsNew = true;
+    return slot;
+}
+
+bool InstanceSlotAllocator::Release(u64 key)
+{
+    const auto it = m_keyToSlot.find(key);
+    if (it == m_keyToSlot.end())
+        return false;
+
+    const u32 slot = it->second;
+    m_keyToSlot.erase(it);
+    m_slotKeys[slot] = InvalidKey;
+    m_freeSlots.push_back(slot);
+    return true;
+}
+
+u32 InstanceSlotAllocator::Find(u64 key) const
+{
+    const auto it = m_keyToSlot.find(key);
+    return it != m_keyToSlot.end() ? it->second : InvalidSlot;
+}
+
+bool InstanceSlotAllocator::NeedsCompaction() const
+{
+    return GetFreeCount() >= INSTANCE_SLOT_COMPACTION_MIN_HOLES &&
+           GetFreeCount() * INSTANCE_SLOT_COMPACTION_HOLE_RATIO >= GetUsedRange();
+}
+
+void InstanceSlotAllocator::Compact(stltype::vector<InstanceSlotMove>& outMoves)
+{
+    if (m_freeSlots.empty())
+        return;
+
+    const auto trimTrailingHoles = [this](u32 usedRange)
+    {
+        while (usedRange > 0 && m_slotKeys[usedRange - 1] == InvalidKey)
+            --usedRange;
+        return usedRange;
+    };
+
+    stltype::sort(m_freeSlots.begin(), m_freeSlots.end());
+    u32 usedRange = trimTrailingHoles(GetUsedRange());
+    for (u32 freeIdx = 0; freeIdx < m_freeSlots.size() && m_freeSlots[freeIdx] < usedRange; ++freeIdx)
+    {
+        const u32 from = usedRange - 1;
+        const u32 to = m_freeSlots[freeIdx];
+        const u64 key = m_slotKeys[from];
+
+        m_slotKeys[to] = key;
+        m_slotKeys[from] = InvalidKey;
+        m_keyToSlot[key] = to;
+        outMoves.push_back(InstanceSlotMove{from, to});
+
+        usedRange = trimTrailingHoles(from);
+    }
+
+    m_slotKeys.resize(usedRange);
+    m_freeSlots.clear();
+    DEBUG_ASSERT(GetUsedRange() == GetLiveCount());
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include <EASTL/hash_map.h>
+
+// Slot moved by compaction, whatever the owner stores at from has to be copied to to
+struct InstanceSlotMove
+{
+    u32 from;
+    u32 to;
+};
+
+// Hands out stable indices into per-instance GPU buffers for u64 keys like entity IDs
+// A key keeps its slot until it's released and freed slots are reused before the used range grows, so adding or
+// removing a key only touches that key's slot. Compaction moves the highest slots into the holes on demand
+// Not thread safe, the owner is expected to lock around it
+class InstanceSlotAllocator
+{
+public:
+    static inline constexpr u32 InvalidSlot = ~0u;
+    static inline constexpr u64 InvalidKey = ~0ull;
+
+    void Init(u32 capacity);
+    void Clear();
+
+    // Returns the key's slot and allocates one if it has none yet, InvalidSlot once the capacity is exhausted
+    u32 Acquire(u64 key, bool* pIsNew = nullptr);
+    bool Release(u64 key);
+    u32 Find(u64 key) const;
+
+    // Releases every live key the predicate doesn't want to keep, O(used slots)
+    template <typename KeepFn>
+    u32 ReleaseUnused(KeepFn&& keep)
+    {
+        u32 releasedCount = 0;
+        for (u32 slot = 0; slot < GetUsedRange(); ++slot)
+        {
+            const u64 key = m_slotKeys[slot];
+            if (key != InvalidKey && keep(key) == false)
+            {
+                Release(key);
+                ++releasedCount;
+            }
+        }
+        return releasedCount;
+    }
+
+    // True once enough holes piled up below the used range that compacting is worth touching the moved slots
+    bool NeedsCompaction() const;
+    // Moves the highest live slots into the lowest free ones until the used range has no holes left
+    void Compact(stltype::vector<InstanceSlotMove>& outMoves);
+
+    u32 GetCapacity() const
+    {
+        return m_capacity;
+    }
+    // Every live slot lies below this, GPU buffers have to cover at least this many entries
+    u32 GetUsedRange() const
+    {
+        return (u32)m_slotKeys.size();
+    }
+    u32 GetLiveCount() const
+    {
+        return (u32)m_keyToSlot.size();
+    }
+    u32 GetFreeCount() const
+    {
+        return (u32)m_freeSlots.size();
+    }
+
+protected:
+    u32 m_capacity{0};
+    stltype::hash_map<u64, u32> m_keyToSlot;
+    // Key stored in every slot of the used range, InvalidKey for holes
+    stltype::vector<u64> m_slotKeys;
+    stltype::vector<u32> m_freeSlots;
+};
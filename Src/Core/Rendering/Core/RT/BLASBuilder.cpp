@@ -14,10 +14,12 @@ u32 CalculatePrimitiveCount(const Mesh& mesh)
     return static_cast<u32>(mesh.indices.size() / 3);
 }
 
-AccelerationStructureBuildDesc BuildTrianglesDesc(const BLASRecord& record,
-                                                  const VertexBuffer& vertexBuffer,
-                                                  const IndexBuffer& indexBuffer)
+AccelerationStructureBuildDesc BuildTrianglesDesc(const BLASRecord& record, const BufferData& geometryBuffers)
 {
+    const IndexType indexType = (IndexType)record.rasterHandle.indexType;
+    const auto& vertexBuffer = geometryBuffers.GetVertexBuffer();
+    const auto& indexBuffer = geometryBuffers.GetIndexBuffer(indexType);
+
     AccelerationStructureBuildDesc desc{};
     desc.structureType = AccelerationStructureType::BottomLevel;
     desc.geometryType = AccelerationStructureGeometryType::Triangles;
@@ -25,13 +27,13 @@ AccelerationStructureBuildDesc BuildTrianglesDesc(const BLASRecord& record,
     desc.buildMode = AccelerationStructureBuildMode::Build;
     desc.geometryFlags = AccelerationStructureGeometryFlags::Opaque;
     desc.vertexFormat = RayTracingVertexFormat::Float3;
-    desc.vertexStride = sizeof(CompleteVertex);
+    desc.vertexStride = sizeof(ScenePositionVertex);
     desc.maxVertex = record.rasterHandle.vertCount - 1;
-    desc.indexType = RayTracingIndexType::UInt32;
+    desc.indexType = indexType == IndexType::UInt16 ? RayTracingIndexType::UInt16 : RayTracingIndexType::UInt32;
     desc.vertexDataAddress =
-        vertexBuffer.GetDeviceAddress() + (record.rasterHandle.vertBufferOffset * sizeof(CompleteVertex));
+        vertexBuffer.GetDeviceAddress() + (record.rasterHandle.vertBufferOffset * sizeof(ScenePositionVertex));
     desc.indexDataAddress =
-        indexBuffer.GetDeviceAddress() + (record.rasterHandle.indexBufferOffset * sizeof(u32));
+        indexBuffer.GetDeviceAddress() + (record.rasterHandle.indexBufferOffset * GetIndexSize(indexType));
     desc.primitiveCount = record.primitiveCount;
     return desc;
 }
@@ -97,11 +99,14 @@ bool BLASBuilder::PrepareBuildRecord(BLASRecord& record, SharedResourceManager&
 {
     if (record.pMesh == nullptr)
         return false;
+    // Defragmentation may have moved the mesh since the record was queued, build from where it lives now
+    if (resourceManager.TryGetMeshHandle(record.pMesh, record.rasterHandle) == false)
+        return false;
 
     const auto& rtCaps = RayTracingDevice::GetCapabilities();
     const auto& geometryBuffers = resourceManager.GetSceneGeometryBuffers();
     const auto& vertexBuffer = geometryBuffers.GetVertexBuffer();
-    const auto& indexBuffer = geometryBuffers.GetIndexBuffer();
+    const auto& indexBuffer = geometryBuffers.GetIndexBuffer((IndexType)record.rasterHandle.indexType);
 
     if (!vertexBuffer.IsCreated() || !indexBuffer.IsCreated())
         return false;
@@ -129,7 +134,7 @@ bool BLASBuilder::PrepareBuildRecord(BLASRecord& record, SharedResourceManager&
         return false;
     }
 
-    const AccelerationStructureBuildDesc buildDesc = BuildTrianglesDesc(record, vertexBuffer, indexBuffer);
+    const AccelerationStructureBuildDesc buildDesc = BuildTrianglesDesc(record, geometryBuffers);
     const AccelerationStructureBuildSizes sizeInfo = AccelerationStructure::GetBuildSizes(buildDesc);
 
     BufferCreateInfo storageInfo{};
@@ -168,10 +173,7 @@ bool BLASBuilder::PrepareBuildRecord(BLASRecord& record, SharedResourceManager&
 void BLASBuilder::ProcessBuildQueue(SharedResourceManager& resourceManager, u32 frameIdx)
 {
     const auto& geometryBuffers = resourceManager.GetSceneGeometryBuffers();
-    const auto& vertexBuffer = geometryBuffers.GetVertexBuffer();
-    const auto& indexBuffer = geometryBuffers.GetIndexBuffer();
-
-    if (!vertexBuffer.IsCreated() || !indexBuffer.IsCreated())
+    if (!geometryBuffers.GetVertexBuffer().IsCreated() || !geometryBuffers.HasIndices())
         return;
 
     for (auto& record : m_records)
@@ -190,7 +192,7 @@ void BLASBuilder::ProcessBuildQueue(SharedResourceManager& resourceManager, u32
         pBuildCmdBuffer->SetFrameIdx(frameIdx);
 
         BuildAccelerationStructureCmd buildCmd{};
-        buildCmd.buildDesc = BuildTrianglesDesc(record, vertexBuffer, indexBuffer);
+        buildCmd.buildDesc = BuildTrianglesDesc(record, geometryBuffers);
         buildCmd.dstAccelerationStructureHandle = record.accelerationStructure.GetNativeHandle();
         buildCmd.scratchAddress = record.scratchBuffer.GetDeviceAddress();
 
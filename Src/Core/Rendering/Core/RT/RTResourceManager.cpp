@@ -55,7 +55,9 @@ void RTResourceManager::CreateResource(RTTextureType type,
     auto& resource = Get(type);
     resource.textureHandle = request.handle;
     resource.pTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(request));
-    resource.bindlessHandle = g_pTexManager->MakeTextureBindless(request.handle, true);
+    const BindlessSlot slot = g_pTexManager->MakeTextureBindless(request.handle, true);
+    DEBUG_ASSERT(slot.IsValid());
+    resource.bindlessHandle = slot.index;
     resource.currentLayout = ImageLayout::UNDEFINED;
 }
 
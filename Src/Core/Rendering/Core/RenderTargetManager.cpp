@@ -4,6 +4,14 @@
 #include "Core/Rendering/Core/TextureManager.h"
 #include "Core/Rendering/Core/Utils/DeleteQueue.h"
 
+// Render targets live in the persistent partition which is sized for them, running out there is a bug
+static BindlessTextureHandle MakeRenderTargetBindless(TextureHandle handle)
+{
+    const BindlessSlot slot = g_pTexManager->MakeTextureBindless(handle, true);
+    DEBUG_ASSERT(slot.IsValid());
+    return slot.index;
+}
+
 void RenderTargetManager::Recreate(const mathstl::Vector2& renderResolution, const mathstl::Vector2& outputResolution)
 {
     stltype::vector<TextureHandle> oldTextureHandles;
@@ -66,14 +74,14 @@ void RenderTargetManager::CreateDepthAttachment(const mathstl::Vector2& renderRe
 
     m_depthTextureHandle = depthRequest.handle;
     m_pDepthTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(depthRequest));
-    m_depthBindlessHandle = g_pTexManager->MakeTextureBindless(depthRequest.handle, depthRequest.isPersistent);
+    m_depthBindlessHandle = MakeRenderTargetBindless(depthRequest.handle);
 
     depthRequest.handle = g_pTexManager->GenerateHandle();
     depthRequest.AddName("Last Frame Depth Buffer");
 
     m_lastFrameDepthTextureHandle = depthRequest.handle;
     m_pLastFrameDepthTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(depthRequest));
-    m_lastFrameDepthBindlessHandle = g_pTexManager->MakeTextureBindless(depthRequest.handle, depthRequest.isPersistent);
+    m_lastFrameDepthBindlessHandle = MakeRenderTargetBindless(depthRequest.handle);
 
     m_attachments.depthAttachment = DepthAttachment::Create(depthAttachmentInfo, m_pDepthTexture);
 }
@@ -129,7 +137,7 @@ void RenderTargetManager::RecreateGBufferTextures(const mathstl::Vector2& render
 
         m_gbuffer.Set(def.type, static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(req)));
         m_gbuffer.SetTextureHandle(def.type, req.handle);
-        m_gbuffer.SetHandle(def.type, g_pTexManager->MakeTextureBindless(req.handle, true));
+        m_gbuffer.SetHandle(def.type, MakeRenderTargetBindless(req.handle));
     }
 
     for (u32 frameSlot = 0; frameSlot < SWAPCHAIN_IMAGES; ++frameSlot)
@@ -150,7 +158,7 @@ void RenderTargetManager::RecreateGBufferTextures(const mathstl::Vector2& render
         m_gbuffer.SetVelocityFrameTarget(frameSlot,
                                          static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(velocityReq)),
                                          velocityReq.handle,
-                                         g_pTexManager->MakeTextureBindless(velocityReq.handle, true));
+                                         MakeRenderTargetBindless(velocityReq.handle));
 
         const TextureHandle oldResolveHandle = m_gbuffer.GetTemporalResolveFrameTextureHandle(frameSlot);
         if (oldResolveHandle != 0)
@@ -170,7 +178,7 @@ void RenderTargetManager::RecreateGBufferTextures(const mathstl::Vector2& render
         m_gbuffer.SetTemporalResolveFrameTarget(frameSlot,
                                                 static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(resolveReq)),
                                                 resolveReq.handle,
-                                                g_pTexManager->MakeTextureBindless(resolveReq.handle, true));
+                                                MakeRenderTargetBindless(resolveReq.handle));
     }
 }
 
@@ -192,7 +200,7 @@ void RenderTargetManager::RecreateAuxiliaryTextures(const mathstl::Vector2& rend
         oldTextureHandles.push_back(m_screenSpaceShadowsTextureHandle);
     m_pScreenSpaceShadowTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(sssRequest));
     m_screenSpaceShadowsTextureHandle = sssRequest.handle;
-    m_screenSpaceShadowBindlessHandle = g_pTexManager->MakeTextureBindless(sssRequest.handle, true);
+    m_screenSpaceShadowBindlessHandle = MakeRenderTargetBindless(sssRequest.handle);
     m_attachments.pScreenSpaceShadowTexture = m_pScreenSpaceShadowTexture;
 
     DynamicTextureRequest smaaEdgeReq = baseRequest;
@@ -205,7 +213,7 @@ void RenderTargetManager::RecreateAuxiliaryTextures(const mathstl::Vector2& rend
         oldTextureHandles.push_back(m_smaaEdgesTextureHandle);
     m_pSMAAEdgesTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(smaaEdgeReq));
     m_smaaEdgesTextureHandle = smaaEdgeReq.handle;
-    m_smaaEdgesBindlessHandle = g_pTexManager->MakeTextureBindless(smaaEdgeReq.handle, true);
+    m_smaaEdgesBindlessHandle = MakeRenderTargetBindless(smaaEdgeReq.handle);
 
     DynamicTextureRequest smaaBlendReq = baseRequest;
     smaaBlendReq.extents = DirectX::XMUINT3(outputResolution.x, outputResolution.y, 1);
@@ -217,7 +225,7 @@ void RenderTargetManager::RecreateAuxiliaryTextures(const mathstl::Vector2& rend
         oldTextureHandles.push_back(m_smaaBlendTextureHandle);
     m_pSMAABlendTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(smaaBlendReq));
     m_smaaBlendTextureHandle = smaaBlendReq.handle;
-    m_smaaBlendBindlessHandle = g_pTexManager->MakeTextureBindless(smaaBlendReq.handle, true);
+    m_smaaBlendBindlessHandle = MakeRenderTargetBindless(smaaBlendReq.handle);
 
     m_attachments.pSMAAEdgesTexture = m_pSMAAEdgesTexture;
     m_attachments.pSMAABlendTexture = m_pSMAABlendTexture;
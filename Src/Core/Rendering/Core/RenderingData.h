@@ -18,6 +18,13 @@ struct BufferData
         m_vertexBuffer = buffer;
     }
 
+    void SetAttributeBuffer(const VertexBuffer& buffer)
+    {
+        if (m_attributeBuffer.GetRef() != buffer.GetRef())
+            m_attributeBuffer.CleanUp();
+        m_attributeBuffer = buffer;
+    }
+
     void SetIndexBuffer(const IndexBuffer& buffer)
     {
         if (m_indexBuffer.GetRef() != buffer.GetRef())
@@ -25,10 +32,43 @@ struct BufferData
         m_indexBuffer = buffer;
     }
 
+    void SetIndex16Buffer(const IndexBuffer& buffer)
+    {
+        if (m_index16Buffer.GetRef() != buffer.GetRef())
+            m_index16Buffer.CleanUp();
+        m_index16Buffer = buffer;
+    }
+
+    void SetMeshletBuffers(const StorageBuffer& meshletBuffer, const StorageBuffer& meshletIndexBuffer)
+    {
+        if (m_meshletBuffer.GetRef() != meshletBuffer.GetRef())
+            m_meshletBuffer.CleanUp();
+        if (m_meshletIndexBuffer.GetRef() != meshletIndexBuffer.GetRef())
+            m_meshletIndexBuffer.CleanUp();
+        m_meshletBuffer = meshletBuffer;
+        m_meshletIndexBuffer = meshletIndexBuffer;
+    }
+
     void ClearBuffers()
     {
         m_indexBuffer.CleanUp();
+        m_index16Buffer.CleanUp();
         m_vertexBuffer.CleanUp();
+        m_attributeBuffer.CleanUp();
+        m_meshletBuffer.CleanUp();
+        m_meshletIndexBuffer.CleanUp();
+    }
+
+    // Split geometry keeps positions in the vertex buffer and all other attributes in a second stream
+    bool HasAttributeStream() const
+    {
+        return m_attributeBuffer.GetRef() != VK_NULL_HANDLE;
+    }
+
+    // Small meshes index into the 16 bit buffer, either of the two may be empty depending on the scene
+    bool HasIndices() const
+    {
+        return m_indexBuffer.GetRef() != VK_NULL_HANDLE || m_index16Buffer.GetRef() != VK_NULL_HANDLE;
     }
 
     const VertexBuffer& GetVertexBuffer() const
@@ -47,12 +87,71 @@ struct BufferData
     {
         return m_indexBuffer;
     }
+    const IndexBuffer& GetIndex16Buffer() const
+    {
+        return m_index16Buffer;
+    }
+    IndexBuffer& GetIndex16Buffer()
+    {
+        return m_index16Buffer;
+    }
+    const IndexBuffer& GetIndexBuffer(IndexType type) const
+    {
+        return type == IndexType::UInt16 ? m_index16Buffer : m_indexBuffer;
+    }
+    IndexBuffer& GetIndexBuffer(IndexType type)
+    {
+        return type == IndexType::UInt16 ? m_index16Buffer : m_indexBuffer;
+    }
+    // Descriptors need a valid buffer even if no mesh uses this index type, the other buffer stands in as nothing
+    // reads from it then
+    const IndexBuffer& GetIndexBufferForBinding(IndexType type) const
+    {
+        const IndexBuffer& buffer = GetIndexBuffer(type);
+        if (buffer.GetRef() != VK_NULL_HANDLE)
+            return buffer;
+        return GetIndexBuffer(type == IndexType::UInt16 ? IndexType::UInt32 : IndexType::UInt16);
+    }
+    const VertexBuffer& GetAttributeBuffer() const
+    {
+        return m_attributeBuffer;
+    }
+    VertexBuffer& GetAttributeBuffer()
+    {
+        return m_attributeBuffer;
+    }
+    // MeshletData of every mesh, MeshResourceData::meshletOffset points into it
+    const StorageBuffer& GetMeshletBuffer() const
+    {
+        return m_meshletBuffer;
+    }
+    StorageBuffer& GetMeshletBuffer()
+    {
+        return m_meshletBuffer;
+    }
+    // Meshlet vertex references and packed triangles
+    const StorageBuffer& GetMeshletIndexBuffer() const
+    {
+        return m_meshletIndexBuffer;
+    }
+    StorageBuffer& GetMeshletIndexBuffer()
+    {
+        return m_meshletIndexBuffer;
+    }
+    bool HasMeshlets() const
+    {
+        return m_meshletBuffer.GetRef() != VK_NULL_HANDLE;
+    }
 
 protected:
     // Just so setting buffers is safer, also because the TrackedResource class is not perfect but won't be refactored
     // for now
     IndexBuffer m_indexBuffer;
+    IndexBuffer m_index16Buffer;
     VertexBuffer m_vertexBuffer;
+    VertexBuffer m_attributeBuffer;
+    StorageBuffer m_meshletBuffer;
+    StorageBuffer m_meshletIndexBuffer;
 };
 
 struct RenderingData : BufferData
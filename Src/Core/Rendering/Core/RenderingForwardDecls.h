@@ -7,7 +7,28 @@
 #include "../../../../Shaders/Globals/Scene.h"
 
 // Common struct definitions (API-agnostic)
-using MeshHandle = MeshResourceData;
+// Index range of a level of detail, counted in elements of the index buffer selected by indexType
+struct MeshLODRange
+{
+    u32 indexBufferOffset{0};
+    u32 indexCount{0};
+    // Geometric error relative to the mesh radius
+    f32 error{0.0f};
+};
+
+// The GPU only ever sees the MeshResourceData part which always describes LOD 0, the coarser levels are CPU side only
+struct MeshHandle : MeshResourceData
+{
+    MeshLODRange lods[MESH_MAX_LODS - 1]{};
+    u32 lodCount{1};
+
+    MeshLODRange GetLOD(u32 lodIdx) const
+    {
+        if (lodIdx == 0 || lodIdx >= lodCount)
+            return {indexBufferOffset, indexCount, 0.0f};
+        return lods[lodIdx - 1];
+    }
+};
 
 // Note: ImageLayout is defined in Core/Rendering/Core/Texture.h
 // Include that file when you need ImageLayout
@@ -109,7 +130,11 @@ using IndexBuffer = IndexBufferT<CurrentAPI>;
 
 using PSO = GraphicsPipelineT<CurrentAPI>;
 using ComputePipeline = ComputePipelineT<CurrentAPI>;
-using GPUMemoryHandle = VmaAllocation;
+// Packs an allocation record slot and its generation, only GPUMemManager can make sense of it
+enum class GPUMemoryHandle : u64
+{
+    Invalid = 0
+};
 using GPUMappedMemoryHandle = void*;
 using RawSemaphoreHandle = VkSemaphore;
 using IndexedIndirectDrawCmd = VkDrawIndexedIndirectCommand;
@@ -46,7 +46,9 @@ void ShadowMapManager::Recreate(u32 cascades,
     req.usage = Usage::ShadowMap;
     req.samplerInfo.wrapU = req.samplerInfo.wrapV = req.samplerInfo.wrapW = TextureWrapMode::CLAMP_TO_BORDER;
     m_shadowMap.pTexture = static_cast<Texture*>(g_pTexManager->CreateTextureImmediate(req));
-    m_shadowMap.bindlessHandle = g_pTexManager->MakeTextureBindless(req.handle, true);
+    const BindlessSlot slot = g_pTexManager->MakeTextureBindless(req.handle, true);
+    DEBUG_ASSERT(slot.IsValid());
+    m_shadowMap.bindlessHandle = slot.index;
 
     m_shadowMap.cascadeViews.resize(cascades, VK_NULL_HANDLE);
     for (u32 i = 0; i < cascades; ++i)
@@ -9,13 +9,64 @@
 #include "Defines/GlobalBuffers.h"
 #include "Core/Rendering/Vulkan/Utils/VkDescriptorLayoutUtils.h"
 #include "Utils/GeometryBufferBuildUtils.h"
+#include <EASTL/sort.h>
+
+// Unchanged instance slots between two changed runs closer than this are uploaded with them instead of splitting the
+// transfer
+static constexpr u32 INSTANCE_UPLOAD_MERGE_GAP = 8;
+// Spare room the scene geometry buffers get on top of the loaded scene, meshes streamed in later go there
+static constexpr u64 SCENE_GEOMETRY_HEADROOM_PERCENT = 25;
+static constexpr u64 SCENE_GEOMETRY_MIN_SPARE_ELEMENTS = 64 * 1024;
+// A region gets defragmented once it's split into this many holes and the largest can't hold half the free space
+static constexpr u32 GEOMETRY_DEFRAG_MIN_FREE_BLOCKS = 16;
+// Caps the bytes a single defragmentation batch copies so it doesn't hold up regular uploads
+static constexpr u64 GEOMETRY_DEFRAG_MAX_BATCH_BYTES = 8 * 1024 * 1024;
+
+static u64 GetMeshIndexCountWithLODs(const Mesh& mesh)
+{
+    // Same cap as Utils::FillLODIndices
+    u64 indexCount = mesh.indices.size();
+    const u32 lodCount = stltype::min((u32)mesh.lods.size(), (u32)MESH_MAX_LODS - 1);
+    for (u32 i = 0; i < lodCount; ++i)
+        indexCount += mesh.lods[i].indices.size();
+    return indexCount;
+}
+
+static void GetMeshGeometryCounts(const Mesh& mesh, IndexType indexType, u64 (&outCounts)[(u32)GeometryRegion::Count])
+{
+    const u64 indexCount = GetMeshIndexCountWithLODs(mesh);
+    outCounts[(u32)GeometryRegion::Vertices] = mesh.vertices.size();
+    outCounts[(u32)GeometryRegion::Indices] = indexType == IndexType::UInt32 ? indexCount : 0;
+    outCounts[(u32)GeometryRegion::Indices16] = indexType == IndexType::UInt16 ? indexCount : 0;
+    outCounts[(u32)GeometryRegion::Meshlets] = mesh.meshlets.size();
+    outCounts[(u32)GeometryRegion::MeshletIndices] = mesh.meshletIndices.size();
+}
+
+static IndexType GetPreferredIndexType(const Mesh& mesh)
+{
+    return Utils::CanUse16BitIndices(mesh) ? IndexType::UInt16 : IndexType::UInt32;
+}
+
+static bool IsGeometryRegionFragmented(const TLSFAllocator& allocator)
+{
+    return allocator.GetFreeBlockCount() >= GEOMETRY_DEFRAG_MIN_FREE_BLOCKS &&
+           allocator.GetLargestFreeBlock() * 2 < allocator.GetFreeBytes();
+}
+
+// Pads an upload vector with zeroes up to where the next range starts, ranges handed out in order never go backwards
+template <typename T>
+static void PadGeometryUpload(stltype::vector<T>& data, u64 size)
+{
+    DEBUG_ASSERT(data.size() <= size);
+    data.resize(size);
+}
 
 void SharedResourceManager::UploadDebugMesh(const Mesh& mesh, u32 thisFrame)
 {
     ScopedZone("SharedResourceManager::UploadDebugMesh");
     DEBUG_LOGF("SharedResourceManager: Uploading debug mesh. Vertices: {}, Indices: {}", (u32)mesh.vertices.size(), (u32)mesh.indices.size());
     AsyncQueueHandler::MeshTransfer cmd{};
-    cmd.vertices.reserve(mesh.vertices.size());
+    cmd.vertexData.reserve(mesh.vertices.size() * sizeof(CompleteVertex));
     cmd.indices.reserve(mesh.indices.size());
     cmd.pBuffersToFill = &m_debugGeometryBuffers;
 
@@ -28,7 +79,7 @@ void SharedResourceManager::UploadDebugMesh(const Mesh& mesh, u32 thisFrame)
         cmd.vertexOffset = m_debugBufferOffsetData.vertBufferOffset * sizeof(CompleteVertex);
         cmd.indexOffset = m_debugBufferOffsetData.indexBufferOffset * sizeof(u32);
 
-        MeshResourceData meshData{};
+        MeshHandle meshData{};
         meshData.indexBufferOffset = m_debugBufferOffsetData.indexBufferOffset;
         meshData.vertBufferOffset = m_debugBufferOffsetData.vertBufferOffset;
         meshData.indexCount = mesh.indices.size();
@@ -39,7 +90,7 @@ void SharedResourceManager::UploadDebugMesh(const Mesh& mesh, u32 thisFrame)
 
         m_debugMeshHandles[&mesh] = meshData;
     }
-    Utils::GenerateDrawCommandForMesh(mesh, vertexBaseOffset, cmd.vertices, cmd.indices);
+    Utils::GenerateDrawCommandForMesh<CompleteVertex>(mesh, vertexBaseOffset, cmd.vertexData, cmd.indices);
     cmd.frameIdx = thisFrame;
 
     const Mesh* pMeshPtr = &mesh;
@@ -94,6 +145,9 @@ void SharedResourceManager::Init()
     
     m_viewSpaceLightsLayout = DescriptorLayoutUtils::CreateOneDescriptorSetForAll(
         {PipelineDescriptorLayout(UBO::BufferType::ViewSpaceLightsSSBO)});
+
+    m_transformScatterLayout = DescriptorLayoutUtils::CreateOneDescriptorSetForAll(
+        {PipelineDescriptorLayout(UBO::BufferType::TransformScatterSSBO)});
     
     m_frameData.resize(FRAMES_IN_FLIGHT);
     m_currentFrameInstanceData.reserve(MAX_ENTITIES);
@@ -124,6 +178,18 @@ void SharedResourceManager::Init()
         m_frameData[i].pViewSpaceLightsSet = m_descriptorPool.CreateDescriptorSet(m_viewSpaceLightsLayout);
         m_frameData[i].pViewSpaceLightsSet->SetBindingSlot(UBO::s_UBOTypeToBindingSlot[UBO::BufferType::ViewSpaceLightsSSBO]);
         m_frameData[i].pViewSpaceLightsSet->WriteSSBOUpdate(m_viewSpaceLightsSSBO, s_viewSpaceLightsSSBOBindingSlot);
+
+        // Transform Scatter Set
+        auto& frameData = m_frameData[i];
+        frameData.transformScatterBuffer = StorageBuffer(UBO::TransformScatterSSBOSize);
+        frameData.transformScatterBuffer.SetName("Transform Scatter SSBO");
+        frameData.pMappedTransformScatter =
+            static_cast<UBO::TransformScatterEntry*>(frameData.transformScatterBuffer.MapMemory());
+        frameData.pTransformScatterSet = m_descriptorPool.CreateDescriptorSet(m_transformScatterLayout);
+        frameData.pTransformScatterSet->SetBindingSlot(
+            UBO::s_UBOTypeToBindingSlot[UBO::BufferType::TransformScatterSSBO]);
+        frameData.pTransformScatterSet->WriteSSBOUpdate(frameData.transformScatterBuffer,
+                                                        s_transformScatterSSBOBindingSlot);
     }
 }
 
@@ -144,65 +210,156 @@ void SharedResourceManager::UploadSceneGeometry(const stltype::vector<stltype::u
 
     u64 vertexCount = 0;
     u64 indexCount = 0;
+    // Rounded up per mesh the same way the range allocator does
+    u64 regionElements[(u32)GeometryRegion::Count]{};
     for (const auto& pMesh : meshes)
     {
         vertexCount += pMesh->vertices.size();
         indexCount += pMesh->indices.size();
+
+        u64 counts[(u32)GeometryRegion::Count];
+        GetMeshGeometryCounts(*pMesh, GetPreferredIndexType(*pMesh), counts);
+        for (u32 region = 0; region < (u32)GeometryRegion::Count; ++region)
+        {
+            if (counts[region] > 0)
+                regionElements[region] += stltype::max(counts[region], TLSF_MIN_BLOCK_SIZE) + TLSF_MIN_BLOCK_SIZE - 1;
+        }
+    }
+    u32 instancedMeshCount = 0;
+    for (const auto& [pMesh, instanceCount] : g_pMeshManager->GetMeshInstanceCounts())
+    {
+        instancedMeshCount += instanceCount > 1 ? 1 : 0;
+    }
+    DEBUG_LOGF("SharedResourceManager: Uploading scene geometry. Total vertices: {}, Total indices: {}, Mesh count: {}, "
+               "Instanced meshes: {}",
+               (u32)vertexCount, (u32)indexCount, (u32)meshes.size(), instancedMeshCount);
+    constexpr u32 sceneVertexSize = sizeof(ScenePositionVertex) + sizeof(SceneVertexAttributes);
+    DEBUG_LOGF("SharedResourceManager: Scene vertex data {:.2f} MB ({} + {} bytes per vertex), {:.2f} MB with complete "
+               "vertices, {:.1f}% of the vertex fetch bandwidth for shaded passes, {:.1f}% for depth only passes",
+               (f64)(vertexCount * sceneVertexSize) / (1024.0 * 1024.0),
+               (u32)sizeof(ScenePositionVertex),
+               (u32)sizeof(SceneVertexAttributes),
+               (f64)(vertexCount * sizeof(CompleteVertex)) / (1024.0 * 1024.0),
+               (f64)sceneVertexSize / (f64)sizeof(CompleteVertex) * 100.0,
+               (f64)sizeof(ScenePositionVertex) / (f64)sizeof(CompleteVertex) * 100.0);
+
+    // Regions the scene doesn't use stay empty like before, streamed meshes fall back to 32 bit indices then
+    u64 regionCapacity[(u32)GeometryRegion::Count]{};
+    for (u32 region = 0; region < (u32)GeometryRegion::Count; ++region)
+    {
+        const u64 required = regionElements[region];
+        if (required > 0 || region == (u32)GeometryRegion::Vertices)
+        {
+            const u64 headroom = required * SCENE_GEOMETRY_HEADROOM_PERCENT / 100;
+            regionCapacity[region] = required + stltype::max(headroom, SCENE_GEOMETRY_MIN_SPARE_ELEMENTS);
+        }
     }
-    DEBUG_LOGF("SharedResourceManager: Uploading scene geometry. Total vertices: {}, Total indices: {}, Mesh count: {}",
-               (u32)vertexCount, (u32)indexCount, (u32)meshes.size());
 
     AsyncQueueHandler::MeshTransfer cmd{};
-    cmd.vertices.reserve(vertexCount);
-    cmd.indices.reserve(indexCount);
+    cmd.vertexData.reserve(vertexCount * sizeof(ScenePositionVertex));
+    cmd.attributeData.reserve(vertexCount * sizeof(SceneVertexAttributes));
     cmd.pBuffersToFill = &m_sceneGeometryBuffers;
+    cmd.vertexBufferSize = regionCapacity[(u32)GeometryRegion::Vertices] * sizeof(ScenePositionVertex);
+    cmd.attributeBufferSize = regionCapacity[(u32)GeometryRegion::Vertices] * sizeof(SceneVertexAttributes);
+    cmd.indexBufferSize = regionCapacity[(u32)GeometryRegion::Indices] * sizeof(u32);
+    cmd.index16BufferSize = regionCapacity[(u32)GeometryRegion::Indices16] * sizeof(u16);
+    cmd.meshletBufferSize = regionCapacity[(u32)GeometryRegion::Meshlets] * sizeof(MeshletData);
+    cmd.meshletIndexBufferSize = regionCapacity[(u32)GeometryRegion::MeshletIndices] * sizeof(u32);
 
-    stltype::vector<const Mesh*> meshPtrs;
-    meshPtrs.reserve(meshes.size());
+    stltype::vector<PendingMeshUpload> uploadedMeshes;
+    uploadedMeshes.reserve(meshes.size());
+    u64 index16Count = 0;
+    u64 lodIndexCount = 0;
+    u32 lodMeshCount = 0;
+    u64 meshletCount = 0;
+    u64 meshletIndexCount = 0;
     {
         SimpleScopedGuard lock(m_geometryStateMutex);
 
-        m_bufferOffsetData.vertexCount = vertexCount;
-        m_bufferOffsetData.indexCount = indexCount;
-        m_bufferOffsetData.vertBufferOffset = 0;
-        m_bufferOffsetData.indexBufferOffset = 0;
-        m_meshHandles.clear();
+        ResetGeometryRanges();
+        for (u32 region = 0; region < (u32)GeometryRegion::Count; ++region)
+        {
+            if (regionCapacity[region] > 0)
+                m_geometryRanges[region].Init(regionCapacity[region]);
+        }
         m_meshHandles.reserve(meshes.size());
 
+        // The upload mirrors the buffers from their start, fresh allocators hand out ranges in order
+        const u64 uploadBase[(u32)GeometryRegion::Count]{};
         for (const auto& pMesh : meshes)
         {
             if (m_meshHandles.find(pMesh.get()) != m_meshHandles.end())
                 continue;
 
-            MeshResourceData meshData{};
-            meshData.indexBufferOffset = m_bufferOffsetData.indexBufferOffset;
-            meshData.vertBufferOffset = m_bufferOffsetData.vertBufferOffset;
-            meshData.indexCount = pMesh->indices.size();
-            meshData.vertCount = pMesh->vertices.size();
+            IndexType indexType = GetPreferredIndexType(*pMesh);
+            MeshGeometryRanges ranges{};
+            // Can't fail, the buffers were sized for exactly these meshes
+            if (AllocateMeshGeometry(*pMesh, indexType, ranges) == false)
+            {
+                DEBUG_ASSERT(false);
+                continue;
+            }
+
+            MeshHandle meshData{};
+            WriteMeshGeometry(*pMesh, indexType, ranges, uploadBase, cmd, meshData);
 
-            Utils::GenerateDrawCommandForMesh(*pMesh.get(), m_bufferOffsetData.vertBufferOffset, cmd.vertices, cmd.indices);
-            m_bufferOffsetData.indexBufferOffset += pMesh->indices.size();
-            m_bufferOffsetData.vertBufferOffset += pMesh->vertices.size();
+            const u64 meshIndexCount = GetMeshIndexCountWithLODs(*pMesh);
+            index16Count += indexType == IndexType::UInt16 ? meshIndexCount : 0;
+            lodIndexCount += meshIndexCount - pMesh->indices.size();
+            lodMeshCount += meshData.lodCount > 1 ? 1 : 0;
+            meshletCount += pMesh->meshlets.size();
+            meshletIndexCount += pMesh->meshletIndices.size();
 
+            m_meshGeometryRanges[pMesh.get()] = ranges;
             m_meshHandles[pMesh.get()] = meshData;
-            meshPtrs.push_back(pMesh.get());
+            uploadedMeshes.push_back({pMesh.get(), ranges.serial});
         }
     }
     cmd.frameIdx = 0;
 
-    cmd.onComplete = [this, meshPtrs = stltype::move(meshPtrs)]()
+    const u64 uploadedIndexCount = indexCount + lodIndexCount;
+    const u64 indexBytes = (uploadedIndexCount - index16Count) * sizeof(u32) + index16Count * sizeof(u16);
+    const u64 savedIndexBytes = uploadedIndexCount * sizeof(u32) - indexBytes;
+    DEBUG_LOGF("SharedResourceManager: Scene index data {:.2f} MB, {} of {} indices stored as 16 bit, {:.2f} MB "
+               "({:.1f}%) saved over 32 bit indices",
+               (f64)indexBytes / (1024.0 * 1024.0),
+               (u32)index16Count,
+               (u32)uploadedIndexCount,
+               (f64)savedIndexBytes / (1024.0 * 1024.0),
+               uploadedIndexCount > 0 ? (f64)savedIndexBytes / (f64)(uploadedIndexCount * sizeof(u32)) * 100.0 : 0.0);
+    DEBUG_LOGF("SharedResourceManager: {} meshes with LODs, {} LOD indices ({:.1f}% of the index data)",
+               lodMeshCount,
+               (u32)lodIndexCount,
+               uploadedIndexCount > 0 ? (f64)lodIndexCount / (f64)uploadedIndexCount * 100.0 : 0.0);
+    DEBUG_LOGF("SharedResourceManager: {} meshlets, {:.1f} triangles per meshlet on average, {:.2f} MB of meshlet data",
+               (u32)meshletCount,
+               meshletCount == 0 ? 0.0 : (f64)indexCount / 3.0 / (f64)meshletCount,
+               (f64)(meshletCount * sizeof(MeshletData) + meshletIndexCount * sizeof(u32)) / (1024.0 * 1024.0));
+    DEBUG_LOGF("SharedResourceManager: Geometry buffers sized for {} vertices and {} + {} indices, {}% headroom for "
+               "streamed meshes",
+               (u32)regionCapacity[(u32)GeometryRegion::Vertices],
+               (u32)regionCapacity[(u32)GeometryRegion::Indices],
+               (u32)regionCapacity[(u32)GeometryRegion::Indices16],
+               (u32)SCENE_GEOMETRY_HEADROOM_PERCENT);
+    // RT shaders read the 16 bit indices as packed pairs, keep the buffer a whole number of words
+    if (cmd.indices16.size() % 2 != 0)
+        cmd.indices16.push_back(0);
+
+    cmd.onComplete = [this, uploadedMeshes = stltype::move(uploadedMeshes)]()
     {
+        for (const auto& upload : uploadedMeshes)
+            MarkGeometryUploaded(upload.pMesh, upload.geometrySerial);
         // RT gets all meshes immediately so BLAS builds can start as GPU data is ready
         {
             SimpleScopedGuard lock(m_residencyStateMutex);
-            for (const auto* pMesh : meshPtrs)
-                m_pendingRayTracingMeshes.push_back(pMesh);
+            for (const auto& upload : uploadedMeshes)
+                m_pendingRayTracingMeshes.push_back(upload.pMesh);
         }
         // Rendering visibility is streamed via FlushPendingMeshUploads
         {
             SimpleScopedGuard lock(m_pendingUploadMutex);
-            for (const auto* pMesh : meshPtrs)
-                m_pendingMeshUploads.push_back({pMesh});
+            for (const auto& upload : uploadedMeshes)
+                m_pendingMeshUploads.push_back(upload);
         }
     };
 
@@ -224,22 +381,199 @@ void SharedResourceManager::ClearGeometryCaches()
     }
     {
         SimpleScopedGuard lock(m_geometryStateMutex);
-        m_meshHandles.clear();
+        ResetGeometryRanges();
     }
+    m_currentFrameInstanceData.clear();
+}
+
+void SharedResourceManager::ResetGeometryRanges()
+{
+    m_meshHandles.clear();
+    m_meshGeometryRanges.clear();
+    m_retiredGeometryRanges.clear();
+    m_movedOutGeometryRanges.clear();
+    for (auto& allocator : m_geometryRanges)
+        allocator = TLSFAllocator{};
+    ++m_geometryBufferGeneration;
+    m_publishedGeometryLayoutVersion = m_geometryLayoutVersion;
+}
+
+bool SharedResourceManager::AllocateMeshGeometry(const Mesh& mesh,
+                                                 IndexType& inOutIndexType,
+                                                 MeshGeometryRanges& outRanges)
+{
+    u64 counts[(u32)GeometryRegion::Count];
+    GetMeshGeometryCounts(mesh, inOutIndexType, counts);
+
+    u32 region = 0;
+    for (; region < (u32)GeometryRegion::Count; ++region)
+    {
+        TLSFAllocator& allocator = m_geometryRanges[region];
+        if (counts[region] == 0)
+            continue;
+        if (allocator.GetSize() == 0)
+            break;
+        outRanges.ranges[region] = allocator.Allocate(counts[region], 1);
+        if (outRanges.ranges[region].IsValid() == false)
+            break;
+    }
+    if (region == (u32)GeometryRegion::Count)
+    {
+        outRanges.serial = ++m_geometryRangeSerial;
+        return true;
+    }
+
+    // Nothing was written to the partial allocation yet, it can go back right away
+    for (u32 allocatedRegion = 0; allocatedRegion < region; ++allocatedRegion)
+    {
+        if (outRanges.ranges[allocatedRegion].IsValid())
+            m_geometryRanges[allocatedRegion].Free(outRanges.ranges[allocatedRegion].node);
+    }
+    outRanges = MeshGeometryRanges{};
+    if (inOutIndexType == IndexType::UInt16 && region == (u32)GeometryRegion::Indices16)
+    {
+        inOutIndexType = IndexType::UInt32;
+        return AllocateMeshGeometry(mesh, inOutIndexType, outRanges);
+    }
+    return false;
+}
+
+void SharedResourceManager::WriteMeshGeometry(const Mesh& mesh,
+                                              IndexType indexType,
+                                              const MeshGeometryRanges& ranges,
+                                              const u64 (&uploadBase)[(u32)GeometryRegion::Count],
+                                              AsyncQueueHandler::MeshTransfer& cmd,
+                                              MeshHandle& outHandle) const
+{
+    const auto getUploadOffset = [&ranges, &uploadBase](GeometryRegion region)
+    { return ranges.ranges[(u32)region].offset - uploadBase[(u32)region]; };
+
+    const u64 vertexOffset = ranges.ranges[(u32)GeometryRegion::Vertices].offset;
+    PadGeometryUpload(cmd.vertexData, getUploadOffset(GeometryRegion::Vertices) * sizeof(ScenePositionVertex));
+    PadGeometryUpload(cmd.attributeData, getUploadOffset(GeometryRegion::Vertices) * sizeof(SceneVertexAttributes));
+
+    const GeometryRegion indexRegion =
+        indexType == IndexType::UInt16 ? GeometryRegion::Indices16 : GeometryRegion::Indices;
+    if (indexType == IndexType::UInt16)
+    {
+        PadGeometryUpload(cmd.indices16, getUploadOffset(indexRegion));
+        const IndexType usedIndexType = Utils::GenerateDrawCommandForMesh<SceneVertexAttributes>(
+            mesh, vertexOffset, cmd.vertexData, cmd.attributeData, cmd.indices, cmd.indices16);
+        DEBUG_ASSERT(usedIndexType == IndexType::UInt16);
+    }
+    else
+    {
+        PadGeometryUpload(cmd.indices, getUploadOffset(indexRegion));
+        Utils::GenerateDrawCommandForMesh<SceneVertexAttributes>(
+            mesh, vertexOffset, cmd.vertexData, cmd.attributeData, cmd.indices);
+    }
+
+    outHandle.vertBufferOffset = (u32)vertexOffset;
+    outHandle.indexBufferOffset = (u32)ranges.ranges[(u32)indexRegion].offset;
+    outHandle.indexCount = mesh.indices.size();
+    outHandle.vertCount = mesh.vertices.size();
+    outHandle.indexType = (u32)indexType;
+    Utils::FillLODIndices(
+        mesh, indexType, outHandle.indexBufferOffset + mesh.indices.size(), cmd.indices, cmd.indices16, outHandle);
+
+    if (mesh.meshlets.empty() == false)
+    {
+        PadGeometryUpload(cmd.meshlets, getUploadOffset(GeometryRegion::Meshlets));
+        PadGeometryUpload(cmd.meshletIndices, getUploadOffset(GeometryRegion::MeshletIndices));
+    }
+    Utils::FillMeshlets(mesh,
+                        ranges.ranges[(u32)GeometryRegion::Meshlets].offset,
+                        ranges.ranges[(u32)GeometryRegion::MeshletIndices].offset,
+                        cmd.meshlets,
+                        cmd.meshletIndices,
+                        outHandle);
+}
+
+void SharedResourceManager::RetireGeometryRange(GeometryRegion region, u32 node)
+{
+    // One extra frame since the instance data that stops referencing the range is only uploaded this frame
+    m_retiredGeometryRanges.push_back({region, node, m_geometryFrameCounter + FRAMES_IN_FLIGHT + 1});
+}
+
+void SharedResourceManager::RetireGeometryRanges(const TLSFAllocation (&ranges)[(u32)GeometryRegion::Count])
+{
+    for (u32 region = 0; region < (u32)GeometryRegion::Count; ++region)
+    {
+        if (ranges[region].IsValid())
+            RetireGeometryRange((GeometryRegion)region, ranges[region].node);
+    }
+}
+
+void SharedResourceManager::ReleaseMeshGeometry(const Mesh* pMesh)
+{
+    const auto it = m_meshGeometryRanges.find(pMesh);
+    if (it == m_meshGeometryRanges.end())
+        return;
+
+    // A defragmentation copy still in flight frees its destination itself once it sees the mesh is gone
+    RetireGeometryRanges(it->second.ranges);
+    m_meshGeometryRanges.erase(it);
+    m_meshHandles.erase(pMesh);
+}
+
+bool SharedResourceManager::IsGeometryCurrent(const Mesh* pMesh, u32 serial) const
+{
+    SimpleScopedGuard lock(m_geometryStateMutex);
+    const auto it = m_meshGeometryRanges.find(pMesh);
+    return it != m_meshGeometryRanges.end() && it->second.serial == serial;
+}
+
+bool SharedResourceManager::MarkGeometryUploaded(const Mesh* pMesh, u32 serial)
+{
+    SimpleScopedGuard lock(m_geometryStateMutex);
+    const auto it = m_meshGeometryRanges.find(pMesh);
+    if (it == m_meshGeometryRanges.end() || it->second.serial != serial)
+        return false;
+    it->second.isUploaded = true;
+    return true;
+}
+
+void SharedResourceManager::UpdateMeshUsers(const stltype::hash_map<const Mesh*, u32>& meshUsers)
+{
+    stltype::vector<const Mesh*> unusedMeshes;
+    {
+        SimpleScopedGuard lock(m_geometryStateMutex);
+        for (auto& [pMesh, ranges] : m_meshGeometryRanges)
+        {
+            const auto it = meshUsers.find(pMesh);
+            const u32 userCount = it != meshUsers.end() ? it->second : 0;
+            // Meshes nothing ever used stay, they were uploaded with the scene for a reason
+            if (userCount == 0 && ranges.userCount > 0)
+                unusedMeshes.push_back(pMesh);
+            ranges.userCount = userCount;
+        }
+
+        for (const Mesh* pMesh : unusedMeshes)
+            ReleaseMeshGeometry(pMesh);
+    }
+    if (unusedMeshes.empty())
+        return;
+
+    {
+        SimpleScopedGuard lock(m_residencyStateMutex);
+        for (const Mesh* pMesh : unusedMeshes)
+            m_residentMeshes.erase(pMesh);
+    }
+    DEBUG_LOGF("SharedResourceManager: Released the geometry of {} meshes without instances", (u32)unusedMeshes.size());
 }
 
 void SharedResourceManager::FlushPendingMeshUploads(u32 /*frameIdx*/, u32 maxCount)
 {
     ScopedZone("SharedResourceManager::FlushPendingMeshUploads");
 
-    stltype::vector<const Mesh*> batch;
+    stltype::vector<PendingMeshUpload> batch;
     batch.reserve(maxCount);
     {
         SimpleScopedGuard lock(m_pendingUploadMutex);
         const u32 count = (stltype::min)(maxCount, (u32)m_pendingMeshUploads.size());
         for (u32 i = 0; i < count; ++i)
         {
-            batch.push_back(m_pendingMeshUploads.front().pMesh);
+            batch.push_back(m_pendingMeshUploads.front());
             m_pendingMeshUploads.pop_front();
         }
     }
@@ -247,8 +581,17 @@ void SharedResourceManager::FlushPendingMeshUploads(u32 /*frameIdx*/, u32 maxCou
     if (batch.empty())
         return;
 
+    // Meshes released while their upload was queued would otherwise become visible on top of freed ranges
+    stltype::vector<const Mesh*> currentMeshes;
+    currentMeshes.reserve(batch.size());
+    for (const auto& upload : batch)
+    {
+        if (IsGeometryCurrent(upload.pMesh, upload.geometrySerial))
+            currentMeshes.push_back(upload.pMesh);
+    }
+
     SimpleScopedGuard lock(m_residencyStateMutex);
-    for (const Mesh* pMesh : batch)
+    for (const Mesh* pMesh : currentMeshes)
     {
         if (m_residentMeshes.insert(pMesh).second)
             m_pendingVisibleMeshes.push_back(pMesh);
@@ -256,21 +599,32 @@ void SharedResourceManager::FlushPendingMeshUploads(u32 /*frameIdx*/, u32 maxCou
 }
 
 void SharedResourceManager::UpdateInstanceDataSSBO(stltype::vector<RenderPasses::PassMeshData>& meshes,
+                                                   u32 instanceSlotCount,
                                                    u32 thisFrameNum)
 {
     ScopedZone("SharedResourceManager::UpdateInstanceDataSSBO");
-    auto& instanceData = m_currentFrameInstanceData;
-    instanceData.clear();
-    instanceData.reserve(meshes.size());
+    // Unused slots stay zeroed and therefore invisible
+    stltype::vector<UBO::InstanceData> instanceData(instanceSlotCount);
 
     {
         SimpleScopedGuard lock(m_residencyStateMutex);
         m_meshToInstanceIdx.clear();
     }
+    {
+        // Everything moved until now is published by the handles read below, the old ranges can retire
+        SimpleScopedGuard lock(m_geometryStateMutex);
+        for (const auto& [region, node] : m_movedOutGeometryRanges)
+            RetireGeometryRange(region, node);
+        m_movedOutGeometryRanges.clear();
+        m_publishedGeometryLayoutVersion = m_geometryLayoutVersion;
+    }
 
+    stltype::hash_map<const Mesh*, u32> meshUsers;
     for (auto& meshData : meshes)
     {
-        auto& data = instanceData.emplace_back();
+        const u32 instanceIdx = meshData.meshData.instanceDataIdx;
+        DEBUG_ASSERT(instanceIdx < instanceSlotCount);
+        auto& data = instanceData[instanceIdx];
         MeshHandle handle;
 
         if (meshData.meshData.IsDebugMesh())
@@ -294,8 +648,10 @@ void SharedResourceManager::UpdateInstanceDataSSBO(stltype::vector<RenderPasses:
         }
         else
         {
-            SimpleScopedGuard lock(m_geometryStateMutex);
-            handle = m_meshHandles.at(meshData.meshData.pMesh); // If this fails we have a problem either way
+            // Meshes released earlier or added after the scene load get streamed back in, invisible until resident
+            if (TryGetMeshHandle(meshData.meshData.pMesh, handle) == false)
+                handle = UploadMesh(*meshData.meshData.pMesh);
+            ++meshUsers[meshData.meshData.pMesh];
         }
 
         data.drawData = handle;
@@ -304,33 +660,114 @@ void SharedResourceManager::UpdateInstanceDataSSBO(stltype::vector<RenderPasses:
         data.SetMaterialIdx(g_pMaterialManager->GetMaterialIdx(meshData.meshData.pMaterial));
         data.SetTransformIdx(meshData.transformIdx);
 
-        meshData.meshData.meshResourceHandle = data.drawData;
-        meshData.meshData.instanceDataIdx = (u32)instanceData.size() - 1;
+        meshData.meshData.meshResourceHandle = handle;
 
         // Visibility set from residency
         {
             SimpleScopedGuard lock(m_residencyStateMutex);
             data.SetVisible(m_residentMeshes.count(meshData.meshData.pMesh) > 0);
-            m_meshToInstanceIdx[meshData.meshData.pMesh].push_back(meshData.meshData.instanceDataIdx);
+            m_meshToInstanceIdx[meshData.meshData.pMesh].push_back(instanceIdx);
         }
     }
-    AsyncQueueHandler::SSBOTransfer transfer;
-    transfer.pData = m_currentFrameInstanceData.data();
-    transfer.size = static_cast<u32>(m_currentFrameInstanceData.size() * sizeof(m_currentFrameInstanceData[0]));
-    transfer.offset = 0;
-    transfer.pDescriptor = nullptr;
-    transfer.pSSBO = &m_sceneInstanceBuffer;
-    transfer.dstBinding = s_globalInstanceDataSSBOSlot;
-    transfer.frameIdx = thisFrameNum;
-    DEBUG_LOGF("SharedResourceManager: Updating instance data SSBO. Entry count: {}, Size: {} bytes", 
-               (u32)m_currentFrameInstanceData.size(), transfer.size);
-    g_pQueueHandler->SubmitTransferCommandAsync(transfer);
-    g_pQueueHandler->DispatchAllRequests();
+
+    // Collect the runs of slots that differ from the GPU copy, unchanged slots between two close runs are uploaded
+    // along instead of splitting the transfer
+    stltype::vector<stltype::pair<u32, u32>> changedRuns;
+    for (u32 i = 0; i < instanceSlotCount; ++i)
+    {
+        if (i < m_currentFrameInstanceData.size() &&
+            memcmp(&instanceData[i], &m_currentFrameInstanceData[i], sizeof(UBO::InstanceData)) == 0)
+            continue;
+
+        if (changedRuns.empty() == false && i - changedRuns.back().second <= INSTANCE_UPLOAD_MERGE_GAP)
+            changedRuns.back().second = i + 1;
+        else
+            changedRuns.emplace_back(i, i + 1);
+    }
+    m_currentFrameInstanceData = stltype::move(instanceData);
+    UpdateMeshUsers(meshUsers);
+
+    u32 uploadedSlots = 0;
+    for (const auto& [begin, end] : changedRuns)
+    {
+        AsyncQueueHandler::SSBOTransfer transfer;
+        transfer.pData = &m_currentFrameInstanceData[begin];
+        transfer.size = static_cast<u32>((end - begin) * sizeof(UBO::InstanceData));
+        transfer.offset = begin * sizeof(UBO::InstanceData);
+        transfer.pDescriptor = nullptr;
+        transfer.pSSBO = &m_sceneInstanceBuffer;
+        transfer.dstBinding = s_globalInstanceDataSSBOSlot;
+        transfer.frameIdx = thisFrameNum;
+        g_pQueueHandler->SubmitTransferCommandAsync(transfer);
+        uploadedSlots += end - begin;
+    }
+    DEBUG_LOGF("SharedResourceManager: Updating instance data SSBO. Slot count: {}, uploaded {} slots in {} transfers",
+               instanceSlotCount,
+               uploadedSlots,
+               (u32)changedRuns.size());
+    if (changedRuns.empty() == false)
+        g_pQueueHandler->DispatchAllRequests();
 }
 
 MeshHandle SharedResourceManager::UploadMesh(const Mesh& mesh)
 {
-    return {};
+    ScopedZone("SharedResourceManager::UploadMesh");
+    MeshHandle meshData{};
+    if (TryGetMeshHandle(&mesh, meshData))
+        return meshData;
+    // Streamed meshes are copied into the buffers the scene upload created
+    if (m_sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE)
+        return {};
+
+    AsyncQueueHandler::MeshTransfer cmd{};
+    cmd.pBuffersToFill = &m_sceneGeometryBuffers;
+    cmd.writeToExistingBuffers = true;
+    u32 serial = 0;
+    {
+        SimpleScopedGuard lock(m_geometryStateMutex);
+
+        IndexType indexType = GetPreferredIndexType(mesh);
+        MeshGeometryRanges ranges{};
+        if (AllocateMeshGeometry(mesh, indexType, ranges) == false)
+        {
+            DEBUG_LOG_WARNF("SharedResourceManager: No room for a mesh with {} vertices and {} indices in the scene "
+                            "geometry buffers",
+                            (u32)mesh.vertices.size(),
+                            (u32)mesh.indices.size());
+            return {};
+        }
+
+        u64 uploadBase[(u32)GeometryRegion::Count];
+        for (u32 region = 0; region < (u32)GeometryRegion::Count; ++region)
+            uploadBase[region] = ranges.ranges[region].offset;
+        WriteMeshGeometry(mesh, indexType, ranges, uploadBase, cmd, meshData);
+
+        cmd.vertexOffset = uploadBase[(u32)GeometryRegion::Vertices] * sizeof(ScenePositionVertex);
+        cmd.attributeOffset = uploadBase[(u32)GeometryRegion::Vertices] * sizeof(SceneVertexAttributes);
+        cmd.indexOffset = uploadBase[(u32)GeometryRegion::Indices] * sizeof(u32);
+        cmd.index16Offset = uploadBase[(u32)GeometryRegion::Indices16] * sizeof(u16);
+        cmd.meshletOffset = uploadBase[(u32)GeometryRegion::Meshlets] * sizeof(MeshletData);
+        cmd.meshletIndexOffset = uploadBase[(u32)GeometryRegion::MeshletIndices] * sizeof(u32);
+
+        serial = ranges.serial;
+        m_meshGeometryRanges[&mesh] = ranges;
+        m_meshHandles[&mesh] = meshData;
+    }
+    cmd.frameIdx = 0;
+
+    const Mesh* pMeshPtr = &mesh;
+    cmd.onComplete = [this, pMeshPtr, serial]()
+    {
+        if (MarkGeometryUploaded(pMeshPtr, serial) == false)
+            return;
+        SimpleScopedGuard lock(m_residencyStateMutex);
+        m_pendingRayTracingMeshes.push_back(pMeshPtr);
+        if (m_residentMeshes.insert(pMeshPtr).second)
+            m_pendingVisibleMeshes.push_back(pMeshPtr);
+    };
+
+    g_pQueueHandler->SubmitTransferCommandAsync(cmd);
+    return meshData;
 }
 
 MeshHandle SharedResourceManager::GetMeshHandle(const Mesh* pMesh) const
@@ -339,6 +776,198 @@ MeshHandle SharedResourceManager::GetMeshHandle(const Mesh* pMesh) const
     return m_meshHandles.find(pMesh)->second;
 }
 
+bool SharedResourceManager::TryGetMeshHandle(const Mesh* pMesh, MeshHandle& outHandle) const
+{
+    SimpleScopedGuard lock(m_geometryStateMutex);
+    const auto it = m_meshHandles.find(pMesh);
+    if (it == m_meshHandles.end())
+        return false;
+    outHandle = it->second;
+    return true;
+}
+
+void SharedResourceManager::UpdateGeometryResidency(u32 frameIdx)
+{
+    ScopedZone("SharedResourceManager::UpdateGeometryResidency");
+    {
+        SimpleScopedGuard lock(m_geometryStateMutex);
+        ++m_geometryFrameCounter;
+
+        u32 keptCount = 0;
+        for (const auto& retired : m_retiredGeometryRanges)
+        {
+            if (retired.releaseFrame <= m_geometryFrameCounter)
+                m_geometryRanges[(u32)retired.region].Free(retired.node);
+            else
+                m_retiredGeometryRanges[keptCount++] = retired;
+        }
+        m_retiredGeometryRanges.resize(keptCount);
+    }
+    DefragmentGeometry(frameIdx);
+}
+
+bool SharedResourceManager::HasUnpublishedGeometryMoves() const
+{
+    SimpleScopedGuard lock(m_geometryStateMutex);
+    return m_publishedGeometryLayoutVersion != m_geometryLayoutVersion;
+}
+
+u64 SharedResourceManager::AppendGeometryMoveCopies(
+    GeometryRegion region,
+    u64 srcElement,
+    u64 dstElement,
+    u64 elementCount,
+    stltype::vector<AsyncQueueHandler::BufferMoveTransfer::Region>& outRegions)
+{
+    const auto appendCopy = [&](GenericBuffer::Ptr pBuffer, u64 stride)
+    {
+        outRegions.push_back({pBuffer, srcElement * stride, dstElement * stride, elementCount * stride});
+        return elementCount * stride;
+    };
+
+    switch (region)
+    {
+        case GeometryRegion::Vertices:
+        {
+            u64 copiedBytes = appendCopy(&m_sceneGeometryBuffers.GetVertexBuffer(), sizeof(ScenePositionVertex));
+            if (m_sceneGeometryBuffers.HasAttributeStream())
+                copiedBytes += appendCopy(&m_sceneGeometryBuffers.GetAttributeBuffer(), sizeof(SceneVertexAttributes));
+            return copiedBytes;
+        }
+        case GeometryRegion::Indices:
+            return appendCopy(&m_sceneGeometryBuffers.GetIndexBuffer(), sizeof(u32));
+        case GeometryRegion::Indices16:
+            return appendCopy(&m_sceneGeometryBuffers.GetIndex16Buffer(), sizeof(u16));
+        case GeometryRegion::Meshlets:
+            return appendCopy(&m_sceneGeometryBuffers.GetMeshletBuffer(), sizeof(MeshletData));
+        default:
+            DEBUG_ASSERT(false);
+            return 0;
+    }
+}
+
+void SharedResourceManager::DefragmentGeometry(u32 frameIdx)
+{
+    AsyncQueueHandler::BufferMoveTransfer cmd{};
+    stltype::vector<GeometryMove> moves;
+    u32 bufferGeneration = 0;
+    {
+        SimpleScopedGuard lock(m_geometryStateMutex);
+        if (m_isDefragmentationInFlight || m_sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE)
+            return;
+        bufferGeneration = m_geometryBufferGeneration;
+
+        u64 batchBytes = 0;
+        // Meshlets store absolute offsets into the meshlet index buffer, so that region can't move
+        for (u32 region = 0; region < (u32)GeometryRegion::MeshletIndices; ++region)
+        {
+            TLSFAllocator& allocator = m_geometryRanges[region];
+            if (batchBytes >= GEOMETRY_DEFRAG_MAX_BATCH_BYTES || allocator.GetSize() == 0 ||
+                IsGeometryRegionFragmented(allocator) == false)
+                continue;
+
+            // Highest ranges first, each one that fits lower down leaves a hole at the end the next can't fall into
+            stltype::vector<stltype::pair<u64, const Mesh*>> candidates;
+            for (const auto& [pMesh, ranges] : m_meshGeometryRanges)
+            {
+                if (ranges.isUploaded && ranges.isMoving == false && ranges.ranges[region].IsValid())
+                    candidates.emplace_back(ranges.ranges[region].offset, pMesh);
+            }
+            stltype::sort(candidates.begin(),
+                          candidates.end(),
+                          [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+
+            for (const auto& [offset, pMesh] : candidates)
+            {
+                if (batchBytes >= GEOMETRY_DEFRAG_MAX_BATCH_BYTES)
+                    break;
+
+                MeshGeometryRanges& ranges = m_meshGeometryRanges[pMesh];
+                const TLSFAllocation& current = ranges.ranges[region];
+                const TLSFAllocation target = allocator.Allocate(current.size, 1);
+                if (target.IsValid() == false)
+                    continue;
+                if (target.offset >= current.offset)
+                {
+                    allocator.Free(target.node);
+                    continue;
+                }
+
+                ranges.movingRanges[region] = target;
+                ranges.isMoving = true;
+                batchBytes += AppendGeometryMoveCopies(
+                    (GeometryRegion)region, current.offset, target.offset, current.size, cmd.regions);
+                moves.push_back({pMesh, ranges.serial, (GeometryRegion)region, target.node});
+            }
+        }
+        if (moves.empty())
+            return;
+        m_isDefragmentationInFlight = true;
+        DEBUG_LOGF("SharedResourceManager: Defragmenting scene geometry, moving {} ranges ({} bytes)",
+                   (u32)moves.size(),
+                   batchBytes);
+    }
+
+    cmd.frameIdx = frameIdx;
+    cmd.onComplete = [this, moves = stltype::move(moves), bufferGeneration]()
+    { ApplyGeometryMoves(moves, bufferGeneration); };
+    g_pQueueHandler->SubmitTransferCommandAsync(cmd);
+}
+
+void SharedResourceManager::ApplyGeometryMoves(const stltype::vector<GeometryMove>& moves, u32 bufferGeneration)
+{
+    SimpleScopedGuard lock(m_geometryStateMutex);
+    m_isDefragmentationInFlight = false;
+    // The buffers were recreated meanwhile, the allocators the targets came from are gone too
+    if (bufferGeneration != m_geometryBufferGeneration)
+        return;
+
+    for (const auto& move : moves)
+    {
+        const u32 region = (u32)move.region;
+        const auto it = m_meshGeometryRanges.find(move.pMesh);
+        if (it == m_meshGeometryRanges.end() || it->second.serial != move.serial)
+        {
+            // Released while the copy ran, nothing ever referenced the target
+            m_geometryRanges[region].Free(move.targetNode);
+            continue;
+        }
+
+        MeshGeometryRanges& ranges = it->second;
+        m_movedOutGeometryRanges.emplace_back(move.region, ranges.ranges[region].node);
+        const u64 oldOffset = ranges.ranges[region].offset;
+        ranges.ranges[region] = ranges.movingRanges[region];
+        ranges.movingRanges[region] = TLSFAllocation{};
+        ranges.isMoving = false;
+
+        MeshHandle& handle = m_meshHandles[move.pMesh];
+        const u32 newOffset = (u32)ranges.ranges[region].offset;
+        switch (move.region)
+        {
+            case GeometryRegion::Vertices:
+                handle.vertBufferOffset = newOffset;
+                break;
+            case GeometryRegion::Indices:
+            case GeometryRegion::Indices16:
+                // The LODs follow LOD 0 inside the same range
+                handle.indexBufferOffset = newOffset;
+                for (u32 lod = 0; lod + 1 < handle.lodCount; ++lod)
+                {
+                    MeshLODRange& range = handle.lods[lod];
+                    range.indexBufferOffset = range.indexBufferOffset - (u32)oldOffset + newOffset;
+                }
+                break;
+            case GeometryRegion::Meshlets:
+                handle.meshletOffset = newOffset;
+                break;
+            default:
+                DEBUG_ASSERT(false);
+                break;
+        }
+    }
+    ++m_geometryLayoutVersion;
+}
+
 void SharedResourceManager::WriteInstanceSSBODescriptorUpdate(u32 targetFrame)
 {
     ScopedZone("SharedResourceManager::WriteInstanceSSBODescriptorUpdate");
@@ -447,6 +1076,52 @@ void SharedResourceManager::UpdateSceneAABBRange(const stltype::vector<AABB>& aa
     g_pQueueHandler->SubmitTransferCommandAsync(transfer);
 }
 
+void SharedResourceManager::ResetTransformScatter(u32 frameIdx)
+{
+    m_frameData[frameIdx % m_frameData.size()].transformScatterCount = 0;
+}
+
+bool SharedResourceManager::CanScatter(u32 entryCount, u32 frameIdx) const
+{
+    const auto& frameData = m_frameData[frameIdx % m_frameData.size()];
+    return frameData.pMappedTransformScatter != nullptr &&
+           frameData.transformScatterCount + entryCount <= UBO::MaxTransformScatterEntries;
+}
+
+void SharedResourceManager::ScatterTransforms(const stltype::vector<DirectX::XMFLOAT4X4>& transformBuffer,
+                                              const stltype::vector<u32>& indices,
+                                              bool isPrevTransform,
+                                              u32 frameIdx)
+{
+    ScopedZone("SharedResourceManager::ScatterTransforms");
+    DEBUG_ASSERT(CanScatter((u32)indices.size(), frameIdx));
+    auto& frameData = m_frameData[frameIdx % m_frameData.size()];
+    const u32 target = isPrevTransform ? TRANSFORM_SCATTER_TARGET_PREV : TRANSFORM_SCATTER_TARGET_CURRENT;
+    for (u32 idx : indices)
+    {
+        auto& entry = frameData.pMappedTransformScatter[frameData.transformScatterCount++];
+        entry.dstIdx = idx;
+        entry.target = target;
+        memcpy(&entry.data, &transformBuffer[idx], sizeof(DirectX::XMFLOAT4X4));
+    }
+}
+
+void SharedResourceManager::ScatterSceneAABBs(const stltype::vector<AABB>& aabbBuffer,
+                                              const stltype::vector<u32>& indices,
+                                              u32 frameIdx)
+{
+    ScopedZone("SharedResourceManager::ScatterSceneAABBs");
+    DEBUG_ASSERT(CanScatter((u32)indices.size(), frameIdx));
+    auto& frameData = m_frameData[frameIdx % m_frameData.size()];
+    for (u32 idx : indices)
+    {
+        auto& entry = frameData.pMappedTransformScatter[frameData.transformScatterCount++];
+        entry.dstIdx = idx;
+        entry.target = TRANSFORM_SCATTER_TARGET_AABB;
+        memcpy(&entry.data, &aabbBuffer[idx], sizeof(AABB));
+    }
+}
+
 void SharedResourceManager::UpdateGlobalMaterialBuffer(const UBO::MaterialBuffer& materialBuffer, u32 thisFrame)
 {
     ScopedZone("SharedResourceManager::UpdateGlobalMaterialBuffer");
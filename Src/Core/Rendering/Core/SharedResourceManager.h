@@ -4,7 +4,8 @@
 #include "Core/Global/Profiling.h"
 #include "Core/Global/ThreadBase.h"
 #include "Core/Rendering/Core/Defines/GlobalBuffers.h"
-#include "Core/Rendering/Core/TransferUtils/TransferDefines.h"
+#include "Core/Rendering/Core/TLSFAllocator.h"
+#include "Core/Rendering/Core/TransferUtils/TransferQueueHandler.h"
 #include "Core/SceneGraph/Mesh.h"
 #include "Core/Rendering/Core/DescriptorSetLayout.h"
 #include "Core/Rendering/Core/DescriptorPool.h"
@@ -14,18 +15,33 @@ namespace RenderPasses
 {
 struct PassMeshData;
 };
+
+// Parts of the scene geometry buffers that get sub-allocated per mesh, ranges are counted in elements of the buffer
+enum class GeometryRegion : u32
+{
+    // Shared by the position and the attribute stream
+    Vertices,
+    Indices,
+    Indices16,
+    Meshlets,
+    MeshletIndices,
+    Count
+};
+
 // Main class to manage scene-wide resources like vertex/index buffers and other
 // things needed for our gpu driven pipeline All scene geometry is uploaded into
 // one giant buffer for now, managed by this manager who gives out mesh handles
 // to the rest of the engine Handles contain all the info to find the meshes and
-// their materials in the buffers Want to split the buffer to allow streaming of
-// meshes eventually... Mainly communicating with the PassManager
+// their materials in the buffers Every mesh gets its own ranges in the buffer so
+// meshes can be streamed in and released one by one, holes left behind get
+// closed by moving meshes on the GPU. Mainly communicating with the PassManager
 class SharedResourceManager
 {
 public:
     struct PendingMeshUpload
     {
         const Mesh* pMesh;
+        u32 geometrySerial;
     };
 
     void Init();
@@ -40,10 +56,22 @@ public:
     // This function is used for non-mesh updates, I assume the scene mesh data
     // itself won't update much Changing a material/scaling a mesh will be way
     // more common hence this separation
-    void UpdateInstanceDataSSBO(stltype::vector<RenderPasses::PassMeshData>& meshes, u32 thisFrameNum);
+    // Meshes come with their instance slot already assigned, only slots whose data changed get uploaded
+    void UpdateInstanceDataSSBO(stltype::vector<RenderPasses::PassMeshData>& meshes,
+                                u32 instanceSlotCount,
+                                u32 thisFrameNum);
 
+    // Streams a single mesh into free space of the scene geometry buffers, returns an empty handle if it doesn't fit
     MeshHandle UploadMesh(const Mesh& mesh);
     MeshHandle GetMeshHandle(const Mesh* pMesh) const;
+    bool TryGetMeshHandle(const Mesh* pMesh, MeshHandle& outHandle) const;
+
+    // Frees the ranges of released meshes the GPU is done with and moves a few meshes down into holes once a region
+    // fragments
+    void UpdateGeometryResidency(u32 frameIdx);
+    // Meshes moved by defragmentation whose new location isn't in the instance data yet, their old ranges stay
+    // allocated until the next UpdateInstanceDataSSBO publishes it
+    bool HasUnpublishedGeometryMoves() const;
 
     void UploadDebugMesh(const Mesh& mesh, u32 thisFrame);
 
@@ -62,6 +90,26 @@ public:
     void UpdateSceneAABBRange(const stltype::vector<AABB>& aabbBuffer, u32 startIdx, u32 count, u32 thisFrame);
     void UpdateGlobalMaterialBuffer(const UBO::MaterialBuffer& materialBuffer, u32 thisFrame);
 
+    // Sparse alternative to the range updates, entries are collected per frame in flight and written on the GPU by
+    // the transform scatter pass before anything reads the transforms
+    void ResetTransformScatter(u32 frameIdx);
+    bool CanScatter(u32 entryCount, u32 frameIdx) const;
+    void ScatterTransforms(const stltype::vector<DirectX::XMFLOAT4X4>& transformBuffer,
+                           const stltype::vector<u32>& indices,
+                           bool isPrevTransform,
+                           u32 frameIdx);
+    void ScatterSceneAABBs(const stltype::vector<AABB>& aabbBuffer, const stltype::vector<u32>& indices, u32 frameIdx);
+
+    u32 GetTransformScatterCount(u32 frameIdx) const
+    {
+        return m_frameData[frameIdx % m_frameData.size()].transformScatterCount;
+    }
+
+    DescriptorSet::Ptr GetTransformScatterDescriptorSet(u32 frameIdx)
+    {
+        return m_frameData[frameIdx % m_frameData.size()].pTransformScatterSet;
+    }
+
     DescriptorSet::Ptr GetInstanceSSBODescriptorSet(u32 frameIdx)
     {
         return m_frameData[frameIdx % m_frameData.size()].pSceneInstanceSSBOSet;
@@ -105,19 +153,72 @@ public:
     {
         u64 vertBufferOffset{0};
         u64 indexBufferOffset{0};
+        u64 index16BufferOffset{0};
         u64 vertexCount{0};
         u64 indexCount{0};
     };
 
-    const BufferStats& GetBufferOffsetData() const
+private:
+    struct MeshGeometryRanges
+    {
+        TLSFAllocation ranges[(u32)GeometryRegion::Count];
+        // Destination of the defragmentation copy in flight, only valid while isMoving
+        TLSFAllocation movingRanges[(u32)GeometryRegion::Count];
+        // Unique per allocation, lets transfer callbacks notice the mesh was released or re-uploaded meanwhile
+        u32 serial{0};
+        u32 userCount{0};
+        bool isMoving{false};
+        // Ranges are allocated before their upload is recorded, defragmentation may only copy them once it completed
+        bool isUploaded{false};
+    };
+
+    struct RetiredGeometryRange
     {
-        return m_bufferOffsetData;
-    }
+        GeometryRegion region;
+        u32 node;
+        u64 releaseFrame;
+    };
+
+    struct GeometryMove
+    {
+        const Mesh* pMesh;
+        u32 serial;
+        GeometryRegion region;
+        u32 targetNode;
+    };
 
-private:
     void UpdateInstanceBuffer(const Mesh& mesh);
     void UpdateSceneGeometryBuffer(const Mesh& mesh);
 
+    // All of the geometry helpers expect m_geometryStateMutex to be held
+    void ResetGeometryRanges();
+    // Falls back to 32 bit indices if the 16 bit region is out of space
+    bool AllocateMeshGeometry(const Mesh& mesh, IndexType& inOutIndexType, MeshGeometryRanges& outRanges);
+    // Appends the mesh to the upload, uploadBase is the element of each region the upload's data starts at
+    void WriteMeshGeometry(const Mesh& mesh,
+                           IndexType indexType,
+                           const MeshGeometryRanges& ranges,
+                           const u64 (&uploadBase)[(u32)GeometryRegion::Count],
+                           AsyncQueueHandler::MeshTransfer& cmd,
+                           MeshHandle& outHandle) const;
+    // Retired ranges are freed once the frames in flight that may still read them are done
+    void RetireGeometryRange(GeometryRegion region, u32 node);
+    void RetireGeometryRanges(const TLSFAllocation (&ranges)[(u32)GeometryRegion::Count]);
+    void ReleaseMeshGeometry(const Mesh* pMesh);
+    bool IsGeometryCurrent(const Mesh* pMesh, u32 serial) const;
+    // Called from the upload's completion, returns false if the mesh was released or re-uploaded meanwhile
+    bool MarkGeometryUploaded(const Mesh* pMesh, u32 serial);
+    // Releases the geometry of meshes whose last instance went away since the previous rebuild
+    void UpdateMeshUsers(const stltype::hash_map<const Mesh*, u32>& meshUsers);
+    // Returns the bytes copied, the vertex region moves the position and the attribute stream
+    u64 AppendGeometryMoveCopies(GeometryRegion region,
+                                 u64 srcElement,
+                                 u64 dstElement,
+                                 u64 elementCount,
+                                 stltype::vector<AsyncQueueHandler::BufferMoveTransfer::Region>& outRegions);
+    void DefragmentGeometry(u32 frameIdx);
+    void ApplyGeometryMoves(const stltype::vector<GeometryMove>& moves, u32 bufferGeneration);
+
     BufferData m_sceneGeometryBuffers;
     // Seperating the debug stuff to update it easier and so on, not sure about it
     // though...
@@ -132,20 +233,41 @@ private:
     DescriptorSetLayout m_sceneInstanceSSBOLayout;
     DescriptorSetLayout m_sceneAABBLayout;
     DescriptorSetLayout m_viewSpaceLightsLayout;
+    DescriptorSetLayout m_transformScatterLayout;
     DescriptorPool m_descriptorPool;
     struct FrameData
     {
         DescriptorSet::Ptr pSceneInstanceSSBOSet;
         DescriptorSet::Ptr pSceneAABBSet;
         DescriptorSet::Ptr pViewSpaceLightsSet;
+        DescriptorSet::Ptr pTransformScatterSet;
+
+        // Host visible and mapped for the whole lifetime, only written once the frame's fence was waited on
+        StorageBuffer transformScatterBuffer;
+        UBO::TransformScatterEntry* pMappedTransformScatter{nullptr};
+        u32 transformScatterCount{0};
     };
     stltype::fixed_vector<FrameData, SWAPCHAIN_IMAGES, false> m_frameData;
 
     
-    BufferStats m_bufferOffsetData;
     BufferStats m_debugBufferOffsetData;
 
-    // Duplicating it on cpu side for more efficient processing
+    TLSFAllocator m_geometryRanges[(u32)GeometryRegion::Count];
+    stltype::hash_map<const Mesh*, MeshGeometryRanges> m_meshGeometryRanges;
+    // Ranges of released meshes, freed once the frames that could still draw from them finished
+    stltype::vector<RetiredGeometryRange> m_retiredGeometryRanges;
+    // Ranges meshes were moved out of, retired once the instance data points at the new location
+    stltype::vector<stltype::pair<GeometryRegion, u32>> m_movedOutGeometryRanges;
+    // Counts UpdateGeometryResidency calls, the frame number wraps around every FRAMES_IN_FLIGHT frames
+    u64 m_geometryFrameCounter{0};
+    u32 m_geometryRangeSerial{0};
+    // Bumped whenever the buffers are recreated, moves recorded against older buffers are dropped
+    u32 m_geometryBufferGeneration{0};
+    u32 m_geometryLayoutVersion{0};
+    u32 m_publishedGeometryLayoutVersion{0};
+    bool m_isDefragmentationInFlight{false};
+
+    // Mirrors what the instance SSBO holds so rebuilds can upload just the slots that changed
     stltype::vector<UBO::InstanceData> m_currentFrameInstanceData;
 
     stltype::hash_map<const Mesh*, MeshHandle> m_meshHandles;
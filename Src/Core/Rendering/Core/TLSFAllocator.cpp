@@ -0,0 +1,247 @@
+#include "TLSFAllocator.h"
+#include <bit>
+
+static void MapSizeToBin(u64 size, u32& fl, u32& sl)
+{
+    if (size < (1ull << TLSF_FL_MIN_SHIFT))
+    {
+        fl = 0;
+        sl = (u32)(size >> (TLSF_FL_MIN_SHIFT - TLSF_SL_BITS));
+        return;
+    }
+    const u32 msb = 63 - (u32)std::countl_zero(size);
+    fl = stltype::min(msb - TLSF_FL_MIN_SHIFT + 1, TLSF_FL_COUNT - 1);
+    sl = (u32)(size >> (msb - TLSF_SL_BITS)) ^ TLSF_SL_COUNT;
+}
+
+// Rounds the size up to the next bin start, every block in that bin or above is then big enough
+static void MapSizeToSearchBin(u64 size, u32& fl, u32& sl)
+{
+    if (size < (1ull << TLSF_FL_MIN_SHIFT))
+    {
+        size += (1ull << (TLSF_FL_MIN_SHIFT - TLSF_SL_BITS)) - 1;
+    }
+    else
+    {
+        const u32 msb = 63 - (u32)std::countl_zero(size);
+        size += (1ull << (msb - TLSF_SL_BITS)) - 1;
+    }
+    MapSizeToBin(size, fl, sl);
+}
+
+static u64 AlignTLSFOffset(u64 offset, u64 alignment)
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+
+void TLSFAllocator::Init(u64 size)
+{
+    DEBUG_ASSERT(size > 0);
+    m_size = size;
+    m_allocatedBytes = 0;
+    m_allocationCount = 0;
+    m_freeBlockCount = 0;
+    m_flBitmap = 0;
+    for (u32 fl = 0; fl < TLSF_FL_COUNT; ++fl)
+    {
+        m_slBitmaps[fl] = 0;
+        for (u32 sl = 0; sl < TLSF_SL_COUNT; ++sl)
+            m_freeHeads[fl][sl] = InvalidNode;
+    }
+    m_nodes.clear();
+    m_unusedNodes.clear();
+
+    InsertFree(CreateNode(0, size));
+}
+
+TLSFAllocation TLSFAllocator::Allocate(u64 size, u64 alignment)
+{
+    DEBUG_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    size = AlignTLSFOffset(stltype::max(size, TLSF_MIN_BLOCK_SIZE), TLSF_MIN_BLOCK_SIZE);
+
+    // Worst case the block starts right after an aligned offset, so reserve room to shift the start
+    const u64 searchSize = alignment > TLSF_MIN_BLOCK_SIZE ? size + alignment - TLSF_MIN_BLOCK_SIZE : size;
+    if (searchSize > GetFreeBytes())
+        return TLSFAllocation{};
+
+    u32 node = FindFreeNode(searchSize);
+    if (node == InvalidNode)
+        return TLSFAllocation{};
+    RemoveFree(node);
+
+    const u64 alignedOffset = AlignTLSFOffset(m_nodes[node].offset, alignment);
+    const u64 padding = alignedOffset - m_nodes[node].offset;
+    if (padding > 0)
+    {
+        // The padding stays behind as its own free block, its physical predecessor is always in use since free
+        // neighbours get merged
+        const u32 alignedNode = CreateNode(alignedOffset, m_nodes[node].size - padding);
+        m_nodes[alignedNode].prevPhysical = node;
+        m_nodes[alignedNode].nextPhysical = m_nodes[node].nextPhysical;
+        if (m_nodes[node].nextPhysical != InvalidNode)
+            m_nodes[m_nodes[node].nextPhysical].prevPhysical = alignedNode;
+        m_nodes[node].nextPhysical = alignedNode;
+        m_nodes[node].size = padding;
+        InsertFree(node);
+        node = alignedNode;
+    }
+
+    SplitTail(node, size);
+
+    Node& allocated = m_nodes[node];
+    allocated.isFree = false;
+    m_allocatedBytes += allocated.size;
+    ++m_allocationCount;
+    return TLSFAllocation{allocated.offset, allocated.size, node};
+}
+
+void TLSFAllocator::Free(u32 node)
+{
+    DEBUG_ASSERT(node < m_nodes.size() && m_nodes[node].isFree == false);
+    m_allocatedBytes -= m_nodes[node].size;
+    --m_allocationCount;
+
+    const u32 prev = m_nodes[node].prevPhysical;
+    if (prev != InvalidNode && m_nodes[prev].isFree)
+    {
+        RemoveFree(prev);
+        m_nodes[prev].size += m_nodes[node].size;
+        m_nodes[prev].nextPhysical = m_nodes[node].nextPhysical;
+        if (m_nodes[node].nextPhysical != InvalidNode)
+            m_nodes[m_nodes[node].nextPhysical].prevPhysical = prev;
+        ReleaseNode(node);
+        node = prev;
+    }
+
+    const u32 next = m_nodes[node].nextPhysical;
+    if (next != InvalidNode && m_nodes[next].isFree)
+    {
+        RemoveFree(next);
+        m_nodes[node].size += m_nodes[next].size;
+        m_nodes[node].nextPhysical = m_nodes[next].nextPhysical;
+        if (m_nodes[next].nextPhysical != InvalidNode)
+            m_nodes[m_nodes[next].nextPhysical].prevPhysical = node;
+        ReleaseNode(next);
+    }
+
+    InsertFree(node);
+}
+
+u64 TLSFAllocator::GetLargestFreeBlock() const
+{
+    if (m_flBitmap == 0)
+        return 0;
+    const u32 fl = 63 - (u32)std::countl_zero(m_flBitmap);
+    const u32 sl = 31 - (u32)std::countl_zero(m_slBitmaps[fl]);
+
+    u64 largest = 0;
+    for (u32 node = m_freeHeads[fl][sl]; node != InvalidNode; node = m_nodes[node].nextFree)
+        largest = stltype::max(largest, m_nodes[node].size);
+    return largest;
+}
+
+u32 TLSFAllocator::CreateNode(u64 offset, u64 size)
+{
+    u32 node;
+    if (m_unusedNodes.empty() == false)
+    {
+        node = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+    }
+    else
+    {
+        node = (u32)m_nodes.size();
+        m_nodes.emplace_back();
+    }
+    m_nodes[node] = Node{};
+    m_nodes[node].offset = offset;
+    m_nodes[node].size = size;
+    return node;
+}
+
+void TLSFAllocator::ReleaseNode(u32 node)
+{
+    m_nodes[node] = Node{};
+    m_unusedNodes.push_back(node);
+}
+
+void TLSFAllocator::InsertFree(u32 node)
+{
+    u32 fl, sl;
+    MapSizeToBin(m_nodes[node].size, fl, sl);
+
+    Node& freeNode = m_nodes[node];
+    freeNode.isFree = true;
+    freeNode.prevFree = InvalidNode;
+    freeNode.nextFree = m_freeHeads[fl][sl];
+    if (freeNode.nextFree != InvalidNode)
+        m_nodes[freeNode.nextFree].prevFree = node;
+    m_freeHeads[fl][sl] = node;
+
+    m_flBitmap |= 1ull << fl;
+    m_slBitmaps[fl] |= 1u << sl;
+    ++m_freeBlockCount;
+}
+
+void TLSFAllocator::RemoveFree(u32 node)
+{
+    u32 fl, sl;
+    MapSizeToBin(m_nodes[node].size, fl, sl);
+
+    Node& freeNode = m_nodes[node];
+    if (freeNode.prevFree != InvalidNode)
+        m_nodes[freeNode.prevFree].nextFree = freeNode.nextFree;
+    else
+        m_freeHeads[fl][sl] = freeNode.nextFree;
+    if (freeNode.nextFree != InvalidNode)
+        m_nodes[freeNode.nextFree].prevFree = freeNode.prevFree;
+
+    if (m_freeHeads[fl][sl] == InvalidNode)
+    {
+        m_slBitmaps[fl] &= ~(1u << sl);
+        if (m_slBitmaps[fl] == 0)
+            m_flBitmap &= ~(1ull << fl);
+    }
+
+    freeNode.isFree = false;
+    freeNode.prevFree = InvalidNode;
+    freeNode.nextFree = InvalidNode;
+    --m_freeBlockCount;
+}
+
+void TLSFAllocator::SplitTail(u32 node, u64 size)
+{
+    const u64 remainder = m_nodes[node].size - size;
+    if (remainder < TLSF_MIN_BLOCK_SIZE)
+        return;
+
+    // The next physical block of a block that just came off the free list is in use, no merge needed
+    const u32 tail = CreateNode(m_nodes[node].offset + size, remainder);
+    m_nodes[tail].prevPhysical = node;
+    m_nodes[tail].nextPhysical = m_nodes[node].nextPhysical;
+    if (m_nodes[node].nextPhysical != InvalidNode)
+        m_nodes[m_nodes[node].nextPhysical].prevPhysical = tail;
+    m_nodes[node].nextPhysical = tail;
+    m_nodes[node].size = size;
+    InsertFree(tail);
+}
+
+u32 TLSFAllocator::FindFreeNode(u64 size) const
+{
+    u32 fl, sl;
+    MapSizeToSearchBin(size, fl, sl);
+    if (fl >= TLSF_FL_COUNT)
+        return InvalidNode;
+
+    u32 slMap = sl < TLSF_SL_COUNT ? m_slBitmaps[fl] & (~0u << sl) : 0;
+    if (slMap == 0)
+    {
+        const u64 flMap = fl + 1 < TLSF_FL_COUNT ? m_flBitmap & (~0ull << (fl + 1)) : 0;
+        if (flMap == 0)
+            return InvalidNode;
+        fl = (u32)std::countr_zero(flMap);
+        slMap = m_slBitmaps[fl];
+    }
+    sl = (u32)std::countr_zero(slMap);
+    return m_freeHeads[fl][sl];
+}
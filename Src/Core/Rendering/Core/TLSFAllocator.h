@@ -0,0 +1,99 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+
+// Second level subdivisions per power of two
+static inline constexpr u32 TLSF_SL_BITS = 4;
+static inline constexpr u32 TLSF_SL_COUNT = 1u << TLSF_SL_BITS;
+// Sizes below 1 << TLSF_FL_MIN_SHIFT share the first first-level bin in linear steps
+static inline constexpr u32 TLSF_FL_MIN_SHIFT = 8;
+static inline constexpr u32 TLSF_FL_COUNT = 48;
+// Smallest block that is split off, remainders below it stay part of the allocation
+static inline constexpr u64 TLSF_MIN_BLOCK_SIZE = 16;
+
+struct TLSFAllocation
+{
+    u64 offset{0};
+    u64 size{0};
+    u32 node{~0u};
+
+    bool IsValid() const
+    {
+        return node != ~0u;
+    }
+};
+
+// Two-level segregated fit allocator over an abstract [0, size) range, used to sub-allocate GPU memory blocks
+// Allocate and Free are O(1): the first level splits sizes by powers of two, the second linearly into TLSF_SL_COUNT
+// bins, and two bitmaps find the first non-empty bin that's guaranteed to fit. Neighbouring free blocks get merged
+// on free so the range doesn't fragment into slivers
+// Not thread safe, the owner is expected to lock around it
+class TLSFAllocator
+{
+public:
+    static inline constexpr u32 InvalidNode = ~0u;
+
+    void Init(u64 size);
+
+    // Invalid if no free block can hold size bytes at the given power of two alignment
+    TLSFAllocation Allocate(u64 size, u64 alignment);
+    void Free(u32 node);
+
+    u64 GetSize() const
+    {
+        return m_size;
+    }
+    u64 GetAllocatedBytes() const
+    {
+        return m_allocatedBytes;
+    }
+    u64 GetFreeBytes() const
+    {
+        return m_size - m_allocatedBytes;
+    }
+    u32 GetAllocationCount() const
+    {
+        return m_allocationCount;
+    }
+    u32 GetFreeBlockCount() const
+    {
+        return m_freeBlockCount;
+    }
+    bool IsEmpty() const
+    {
+        return m_allocationCount == 0;
+    }
+    // Walks the highest non-empty bin, only meant for stats
+    u64 GetLargestFreeBlock() const;
+
+protected:
+    struct Node
+    {
+        u64 offset{0};
+        u64 size{0};
+        u32 prevPhysical{InvalidNode};
+        u32 nextPhysical{InvalidNode};
+        u32 prevFree{InvalidNode};
+        u32 nextFree{InvalidNode};
+        bool isFree{false};
+    };
+
+    u32 CreateNode(u64 offset, u64 size);
+    void ReleaseNode(u32 node);
+    void InsertFree(u32 node);
+    void RemoveFree(u32 node);
+    // Splits everything past size off into a new free block if it's big enough to be worth tracking
+    void SplitTail(u32 node, u64 size);
+    u32 FindFreeNode(u64 size) const;
+
+    u64 m_size{0};
+    u64 m_allocatedBytes{0};
+    u32 m_allocationCount{0};
+    u32 m_freeBlockCount{0};
+
+    u64 m_flBitmap{0};
+    u32 m_slBitmaps[TLSF_FL_COUNT]{};
+    u32 m_freeHeads[TLSF_FL_COUNT][TLSF_SL_COUNT]{};
+
+    stltype::vector<Node> m_nodes;
+    stltype::vector<u32> m_unusedNodes;
+};
@@ -0,0 +1,76 @@
+#include "TextureRequestCache.h"
+#include "Core/Global/Profiling.h"
+#include <EASTL/chrono.h>
+#include <cctype>
+
+stltype::string TextureRequestKey::NormalizePath(const stltype::string& filePath)
+{
+    stltype::string normalized;
+    normalized.reserve(filePath.size());
+    for (const char c : filePath)
+    {
+        const char normalizedChar = c == '\\' ? '/' : (char)tolower((unsigned char)c);
+        // Doubled separators show up when paths from the model file get concatenated with the texture directory
+        if (normalizedChar == '/' && normalized.empty() == false && normalized.back() == '/')
+            continue;
+        normalized.push_back(normalizedChar);
+    }
+    return normalized;
+}
+
+TextureRequestCacheBenchmark RunTextureRequestCacheBenchmark(const stltype::vector<TextureRequestKey>& requests,
+                                                             u32 iterations)
+{
+    ScopedZone("TextureRequestCache::Run Benchmark");
+    using Clock = stltype::chrono::steady_clock;
+    const auto elapsedMs = [](Clock::time_point start)
+    {
+        return stltype::chrono::duration<f64, stltype::chrono::milliseconds::period>(Clock::now() - start).count();
+    };
+    iterations = stltype::max(iterations, 1u);
+
+    TextureRequestCacheBenchmark result{};
+    result.requestCount = (u32)requests.size();
+
+    // Handles are only summed so the lookups can't be optimized away
+    u64 handleSum = 0;
+    auto start = Clock::now();
+    for (u32 it = 0; it < iterations; ++it)
+    {
+        stltype::vector<stltype::pair<TextureRequestKey, TextureHandle>> linearCache;
+        for (const auto& request : requests)
+        {
+            const auto cached = stltype::find_if(linearCache.cbegin(),
+                                                 linearCache.cend(),
+                                                 [&request](const auto& entry) { return entry.first == request; });
+            if (cached != linearCache.cend())
+                handleSum += cached->second;
+            else
+                linearCache.emplace_back(request, (TextureHandle)linearCache.size());
+        }
+        result.uniqueTextureCount = (u32)linearCache.size();
+    }
+    result.linearScanMs = elapsedMs(start) / iterations;
+
+    start = Clock::now();
+    for (u32 it = 0; it < iterations; ++it)
+    {
+        TextureRequestCache cache;
+        for (const auto& request : requests)
+        {
+            if (const TextureHandle* pHandle = cache.Find(request))
+                handleSum += *pHandle;
+            else
+                cache.Insert(request, (TextureHandle)cache.GetSize());
+        }
+    }
+    result.hashedMs = elapsedMs(start) / iterations;
+
+    DEBUG_LOGF("[TextureRequestCache] {} requests, {} unique: linear {:.3f} ms, hashed {:.3f} ms ({})",
+               result.requestCount,
+               result.uniqueTextureCount,
+               result.linearScanMs,
+               result.hashedMs,
+               handleSum);
+    return result;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Global/Typedefs.h"
+#include <EASTL/hash_map.h>
+
+enum class TextureSemantic : u8;
+
+struct TextureRequestKey
+{
+    // Lower case with forward slashes so differently spelled references to one file share the texture
+    stltype::string normalizedPath;
+    TextureSemantic semantic{};
+
+    bool operator==(const TextureRequestKey& other) const
+    {
+        return semantic == other.semantic && normalizedPath == other.normalizedPath;
+    }
+
+    static stltype::string NormalizePath(const stltype::string& filePath);
+};
+
+struct TextureRequestKeyHash
+{
+    size_t operator()(const TextureRequestKey& key) const
+    {
+        return stltype::hash<stltype::string>()(key.normalizedPath) ^ ((size_t)key.semantic * 0x9E3779B97F4A7C15ull);
+    }
+};
+
+// Maps every requested texture file and semantic to its handle so repeated material references resolve in O(1)
+// Not thread safe, the owner is expected to lock around it
+class TextureRequestCache
+{
+public:
+    const TextureHandle* Find(const TextureRequestKey& key) const
+    {
+        const auto it = m_handles.find(key);
+        return it != m_handles.end() ? &it->second : nullptr;
+    }
+    void Insert(const TextureRequestKey& key, TextureHandle handle)
+    {
+        m_handles.emplace(key, handle);
+    }
+    void Clear()
+    {
+        m_handles.clear();
+    }
+    u32 GetSize() const
+    {
+        return (u32)m_handles.size();
+    }
+
+protected:
+    stltype::hash_map<TextureRequestKey, TextureHandle, TextureRequestKeyHash> m_handles;
+};
+
+struct TextureRequestCacheBenchmark
+{
+    u32 requestCount{0};
+    u32 uniqueTextureCount{0};
+    // Previous linear scan over every requested texture with string compares
+    f64 linearScanMs{0.0};
+    f64 hashedMs{0.0};
+};
+
+// Replays the given texture requests the way an import issues them, once against the hash index and once against
+// a linear scan of the unique requests seen so far
+TextureRequestCacheBenchmark RunTextureRequestCacheBenchmark(const stltype::vector<TextureRequestKey>& requests,
+                                                             u32 iterations = 8);
@@ -0,0 +1,70 @@
+#include "FrameUploadRing.h"
+
+void FrameUploadRing::Init()
+{
+    m_buffer.CreatePersistentlyMapped(FRAME_UPLOAD_RING_FRAME_SIZE * FRAMES_IN_FLIGHT, BufferUsage::Upload);
+    m_buffer.SetName("FrameUploadRing");
+}
+
+void FrameUploadRing::BeginFrame(u32 frameNumber, u64 completedTransferValue)
+{
+    // Regions of the previous frame that weren't dispatched yet stay valid, their part is only reused once they and
+    // everything else reading it were submitted and finished
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = {};
+    m_currentFrame = frameNumber;
+    m_currentPart = frameNumber % FRAMES_IN_FLIGHT;
+    m_head = 0;
+    bool hasPendingRegions = false;
+    for (const auto& region : m_pendingRegions)
+        hasPendingRegions |= region.srcOffset / FRAME_UPLOAD_RING_FRAME_SIZE == m_currentPart;
+    m_isPartWritable = hasPendingRegions == false && m_partSignalValues[m_currentPart] <= completedTransferValue;
+}
+
+bool FrameUploadRing::Write(const void* pData, u64 size, GenericBuffer::Ptr pDst, u64 dstOffset)
+{
+    if (m_isPartWritable == false || size == 0 || size > FRAME_UPLOAD_RING_MAX_UPDATE_SIZE)
+        return false;
+
+    const u64 offset = (m_head + FRAME_UPLOAD_RING_ALIGNMENT - 1) & ~(FRAME_UPLOAD_RING_ALIGNMENT - 1);
+    if (offset + size > FRAME_UPLOAD_RING_FRAME_SIZE)
+        return false;
+
+    const u64 srcOffset = m_currentPart * FRAME_UPLOAD_RING_FRAME_SIZE + offset;
+    m_buffer.CopyToMapped(pData, size, srcOffset);
+    m_head = offset + size;
+    m_pendingRegions.push_back(Region{pDst, srcOffset, dstOffset, size});
+
+    m_frameStats.ringBytes += size;
+    ++m_frameStats.ringUpdateCount;
+    return true;
+}
+
+stltype::vector<FrameUploadRing::Region> FrameUploadRing::PopRegions()
+{
+    stltype::vector<Region> regions = stltype::move(m_pendingRegions);
+    m_pendingRegions.clear();
+    return regions;
+}
+
+bool FrameUploadRing::HasPendingWrites(GenericBuffer::Ptr pDst) const
+{
+    for (const auto& region : m_pendingRegions)
+    {
+        if (region.pDst == pDst)
+            return true;
+    }
+    return false;
+}
+
+void FrameUploadRing::SetSubmittedValue(const stltype::vector<Region>& regions, u64 signalValue)
+{
+    for (const auto& region : regions)
+        m_partSignalValues[region.srcOffset / FRAME_UPLOAD_RING_FRAME_SIZE] = signalValue;
+}
+
+void FrameUploadRing::AddStagedUpdate(u64 size)
+{
+    m_frameStats.stagedBytes += size;
+    ++m_frameStats.stagedUpdateCount;
+}
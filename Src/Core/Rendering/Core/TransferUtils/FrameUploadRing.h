@@ -0,0 +1,72 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Rendering/Core/Buffer.h"
+
+// Part of the upload ring every frame in flight writes into
+static inline constexpr u64 FRAME_UPLOAD_RING_FRAME_SIZE = 8ull * 1024 * 1024;
+// Larger updates keep going through the staging ring with their own transfer command
+static inline constexpr u64 FRAME_UPLOAD_RING_MAX_UPDATE_SIZE = 1ull * 1024 * 1024;
+static inline constexpr u64 FRAME_UPLOAD_RING_ALIGNMENT = 16;
+
+struct FrameUploadStats
+{
+    u64 ringBytes{0};
+    u32 ringUpdateCount{0};
+    // Updates that didn't fit into the ring and went through their own staging copy
+    u64 stagedBytes{0};
+    u32 stagedUpdateCount{0};
+};
+
+// Linear upload ring with one part per frame in flight, small buffer updates are copied in right away and applied with
+// a single batched copy command per dispatch
+// A part is only written again once the transfer timeline passed the last submission reading from it
+// Not thread safe, the owner is expected to lock around it
+class FrameUploadRing
+{
+public:
+    struct Region
+    {
+        GenericBuffer::Ptr pDst{};
+        u64 srcOffset{0};
+        u64 dstOffset{0};
+        u64 size{0};
+    };
+
+    void Init();
+
+    // Switches to the part of the given frame, completedTransferValue decides whether it can be written yet
+    void BeginFrame(u32 frameNumber, u64 completedTransferValue);
+    bool IsCurrentFrame(u32 frameNumber) const
+    {
+        return m_currentFrame == frameNumber;
+    }
+
+    // False if the update is too large or the frame's part is full or still read by the GPU
+    bool Write(const void* pData, u64 size, GenericBuffer::Ptr pDst, u64 dstOffset);
+    // Regions written since the last call, the caller records them and reports the submission's signal value
+    stltype::vector<Region> PopRegions();
+    bool HasPendingWrites(GenericBuffer::Ptr pDst) const;
+    void SetSubmittedValue(const stltype::vector<Region>& regions, u64 signalValue);
+    void AddStagedUpdate(u64 size);
+
+    StagingBuffer& GetBuffer()
+    {
+        return m_buffer;
+    }
+    const FrameUploadStats& GetLastFrameStats() const
+    {
+        return m_lastFrameStats;
+    }
+
+protected:
+    StagingBuffer m_buffer;
+    u64 m_head{0};
+    u32 m_currentFrame{~0u};
+    u32 m_currentPart{0};
+    bool m_isPartWritable{false};
+    // Signal value of the last transfer submission reading from each part
+    stltype::array<u64, FRAMES_IN_FLIGHT> m_partSignalValues{};
+    stltype::vector<Region> m_pendingRegions;
+    FrameUploadStats m_frameStats{};
+    FrameUploadStats m_lastFrameStats{};
+};
@@ -0,0 +1,84 @@
+#include "StagingRingAllocator.h"
+#include "Core/Global/LogDefines.h"
+
+static u64 AlignStagingOffset(u64 offset)
+{
+    return (offset + STAGING_RING_ALIGNMENT - 1) & ~(STAGING_RING_ALIGNMENT - 1);
+}
+
+void StagingRingAllocator::Init(u32 initialBlockCount)
+{
+    DEBUG_ASSERT(initialBlockCount > 0 && initialBlockCount <= STAGING_RING_MAX_BLOCKS);
+    for (u32 i = 0; i < initialBlockCount; ++i)
+        CreateBlock();
+    m_currentBlock = 0;
+}
+
+void StagingRingAllocator::CreateBlock()
+{
+    auto& block = m_blocks.emplace_back();
+    block.buffer.CreatePersistentlyMapped(STAGING_RING_BLOCK_SIZE);
+    block.buffer.SetName("StagingRingBlock_" + stltype::to_string(m_blocks.size() - 1));
+}
+
+StagingAllocation StagingRingAllocator::Allocate(u64 size)
+{
+    if (size == 0 || size > STAGING_RING_MAX_ALLOCATION_SIZE || m_blocks.empty())
+        return StagingAllocation{};
+
+    Block* pBlock = &m_blocks[m_currentBlock];
+    if (pBlock->liveAllocations == 0)
+        pBlock->head = 0;
+
+    u64 offset = AlignStagingOffset(pBlock->head);
+    if (offset + size > STAGING_RING_BLOCK_SIZE)
+    {
+        // The current block is rewound later once its transfers finished, continue with the next one nothing reads
+        // from anymore
+        u32 nextBlock = ~0u;
+        for (u32 i = 1; i < m_blocks.size(); ++i)
+        {
+            const u32 idx = (m_currentBlock + i) % (u32)m_blocks.size();
+            if (m_blocks[idx].liveAllocations == 0)
+            {
+                nextBlock = idx;
+                break;
+            }
+        }
+        if (nextBlock == ~0u)
+        {
+            if (m_blocks.size() >= STAGING_RING_MAX_BLOCKS)
+                return StagingAllocation{};
+            nextBlock = (u32)m_blocks.size();
+            CreateBlock();
+            DEBUG_LOGF("[StagingRingAllocator] All {} blocks in flight, grew to {} MB",
+                       nextBlock,
+                       (m_blocks.size() * STAGING_RING_BLOCK_SIZE) / (1024 * 1024));
+        }
+
+        m_currentBlock = nextBlock;
+        pBlock = &m_blocks[m_currentBlock];
+        offset = 0;
+    }
+
+    pBlock->head = offset + size;
+    ++pBlock->liveAllocations;
+    return StagingAllocation{&pBlock->buffer, offset, m_currentBlock};
+}
+
+void StagingRingAllocator::Release(u32 blockIdx)
+{
+    DEBUG_ASSERT(blockIdx < m_blocks.size() && m_blocks[blockIdx].liveAllocations > 0);
+    --m_blocks[blockIdx].liveAllocations;
+}
+
+u64 StagingRingAllocator::GetUsedBytes() const
+{
+    u64 usedBytes = 0;
+    for (const auto& block : m_blocks)
+    {
+        if (block.liveAllocations > 0)
+            usedBytes += block.head;
+    }
+    return usedBytes;
+}
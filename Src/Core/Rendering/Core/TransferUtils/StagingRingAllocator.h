@@ -0,0 +1,59 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Rendering/Core/Buffer.h"
+#include <EASTL/deque.h>
+
+// Size of every persistently mapped block the staging ring sub-allocates from
+static inline constexpr u64 STAGING_RING_BLOCK_SIZE = 16ull * 1024 * 1024;
+static inline constexpr u32 STAGING_RING_INITIAL_BLOCKS = 2;
+// Blocks the ring may grow to before transfers fall back to dedicated staging buffers
+static inline constexpr u32 STAGING_RING_MAX_BLOCKS = 8;
+// Anything larger gets a dedicated staging buffer so a single upload can't take over a whole block
+static inline constexpr u64 STAGING_RING_MAX_ALLOCATION_SIZE = STAGING_RING_BLOCK_SIZE / 4;
+static inline constexpr u64 STAGING_RING_ALIGNMENT = 16;
+
+struct StagingAllocation
+{
+    StagingBuffer* pBuffer{nullptr};
+    u64 offset{0};
+    u32 blockIdx{~0u};
+
+    bool IsValid() const
+    {
+        return pBuffer != nullptr;
+    }
+};
+
+// Linear sub-allocator over a few large staging blocks that are filled one after another like a ring
+// A block is only rewound once every allocation in it was released, the owner releases them once the transfer
+// timeline passed the submission reading them
+// Not thread safe, the owner is expected to lock around it
+class StagingRingAllocator
+{
+public:
+    void Init(u32 initialBlockCount);
+
+    // Invalid if the size is above STAGING_RING_MAX_ALLOCATION_SIZE or every block is still read by transfers in flight
+    StagingAllocation Allocate(u64 size);
+    void Release(u32 blockIdx);
+
+    u32 GetBlockCount() const
+    {
+        return (u32)m_blocks.size();
+    }
+    // Bytes in blocks that still have live allocations, including the alignment padding between them
+    u64 GetUsedBytes() const;
+
+protected:
+    struct Block
+    {
+        StagingBuffer buffer;
+        u64 head{0};
+        u32 liveAllocations{0};
+    };
+
+    void CreateBlock();
+
+    stltype::deque<Block> m_blocks;
+    u32 m_currentBlock{0};
+};
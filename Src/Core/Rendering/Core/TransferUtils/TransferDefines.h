@@ -18,6 +18,12 @@ struct PendingMeshResult
     BufferData* pBuffersToFill;
     VertexBuffer vertexBuffer;
     IndexBuffer indexBuffer;
+    // Only created for split geometry
+    VertexBuffer attributeBuffer;
+    IndexBuffer index16Buffer;
+    // Only created if the upload carries meshlets
+    StorageBuffer meshletBuffer;
+    StorageBuffer meshletIndexBuffer;
 };
 
 struct RecorderContext
@@ -26,6 +32,7 @@ struct RecorderContext
     stltype::vector<CommandBuffer*> commandBuffers;
     stltype::vector<CommandBuffer*> freeBuffers;
     stltype::vector<u32> assignedStagingBuffers;
+    stltype::vector<u32> assignedStagingBlocks;
     stltype::vector<PendingMeshResult> pendingMeshResults;
     ProfiledLockable(CustomMutex, mutex);
 };
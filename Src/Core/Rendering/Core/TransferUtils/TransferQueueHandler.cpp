@@ -1,6 +1,7 @@
 #include "TransferQueueHandler.h"
 #include "../StaticFunctions.h"
 #include "Core/Events/EventSystem.h"
+#include "Core/Global/FrameGlobals.h"
 #include "Core/Global/GlobalVariables.h"
 #include "Core/Global/LogDefines.h"
 #include "Core/Global/Utils/MathFunctions.h"
@@ -11,6 +12,8 @@
 
 
 #define PREALLOC_STAGING_BUFFERS 512
+// Only large transfers end up in the dedicated pool, everything else is sub-allocated from the staging ring
+#define PREALLOC_DEDICATED_STAGING_BUFFERS 4
 
 // Specializations for variant members to use with SetBufferSyncInfo if needed
 static void SetBufferSyncInfo(const AsyncQueueHandler::MeshTransfer& cmd, CommandBuffer* pCmdBuffer)
@@ -29,6 +32,14 @@ static void SetBufferSyncInfo(const AsyncQueueHandler::SSBOTransfer& cmd, Comman
     pCmdBuffer->SetName("SSBOTransfer");
 }
 
+static void SetBufferSyncInfo(const AsyncQueueHandler::BufferMoveTransfer& cmd, CommandBuffer* pCmdBuffer)
+{
+    pCmdBuffer->SetWaitStages(SyncStages::TRANSFER);
+    // Completion tracking timeline must signal after full command buffer execution.
+    pCmdBuffer->SetSignalStages(SyncStages::BOTTOM_OF_PIPE);
+    pCmdBuffer->SetName("BufferMoveTransfer");
+}
+
 AsyncQueueHandler::~AsyncQueueHandler()
 {
     ShutdownThread();
@@ -93,7 +104,9 @@ void AsyncQueueHandler::Init()
 
     g_pEventSystem->AddPostFrameEventCallback([this](const PostFrameEventData& d) { DispatchAllRequests(); });
 
-    InitStagingBufferPool(PREALLOC_STAGING_BUFFERS, 256 * 1024);
+    m_stagingRing.Init(STAGING_RING_INITIAL_BLOCKS);
+    m_uploadRing.Init();
+    InitStagingBufferPool(PREALLOC_DEDICATED_STAGING_BUFFERS, STAGING_RING_MAX_ALLOCATION_SIZE);
 
     m_keepRunning = true;
     m_thread = threadstl::MakeThread([this] { CheckRequests(); });
@@ -119,22 +132,25 @@ StagingBuffer& AsyncQueueHandler::AcquireStagingBuffer(u64 requiredSize, u32& ou
 
 StagingBuffer& AsyncQueueHandler::AcquireStagingBufferLocked(u64 requiredSize, u32& outIdx)
 {
+    // Best fit so a small request doesn't take a buffer a larger one could have used without growing
+    u32 bestFit = ~0u;
+    u32 largest = ~0u;
     for (u32 i = 0; i < m_freeStagingBufferIndices.size(); ++i)
     {
-        u32 idx = m_freeStagingBufferIndices[i];
-        if (m_stagingBufferPool[idx].GetInfo().size >= requiredSize)
-        {
-            m_freeStagingBufferIndices.erase(m_freeStagingBufferIndices.begin() + i);
-            outIdx = idx;
-            return m_stagingBufferPool[idx];
-        }
+        const u64 size = m_stagingBufferPool[m_freeStagingBufferIndices[i]].GetInfo().size;
+        if (size >= requiredSize &&
+            (bestFit == ~0u || size < m_stagingBufferPool[m_freeStagingBufferIndices[bestFit]].GetInfo().size))
+            bestFit = i;
+        if (largest == ~0u || size > m_stagingBufferPool[m_freeStagingBufferIndices[largest]].GetInfo().size)
+            largest = i;
     }
 
-    // No suitable free buffer, try to resize the smallest free one
-    if (!m_freeStagingBufferIndices.empty())
+    // No suitable free buffer, grow the largest free one
+    const u32 pick = bestFit != ~0u ? bestFit : largest;
+    if (pick != ~0u)
     {
-        u32 idx = m_freeStagingBufferIndices.back();
-        m_freeStagingBufferIndices.pop_back();
+        u32 idx = m_freeStagingBufferIndices[pick];
+        m_freeStagingBufferIndices.erase(m_freeStagingBufferIndices.begin() + pick);
         m_stagingBufferPool[idx].EnsureCapacity(requiredSize);
         outIdx = idx;
         return m_stagingBufferPool[idx];
@@ -157,6 +173,31 @@ void AsyncQueueHandler::ReleaseStagingBuffers(const stltype::vector<u32>& indice
     }
 }
 
+StagingBuffer& AsyncQueueHandler::AllocateStagingLocked(u64 size, u64& outOffset, RecorderContext& ctx)
+{
+    const StagingAllocation allocation = m_stagingRing.Allocate(size);
+    if (allocation.IsValid())
+    {
+        ctx.assignedStagingBlocks.push_back(allocation.blockIdx);
+        outOffset = allocation.offset;
+        return *allocation.pBuffer;
+    }
+
+    u32 stagingIdx;
+    StagingBuffer& stagingBuffer = AcquireStagingBufferLocked(size, stagingIdx);
+    ctx.assignedStagingBuffers.push_back(stagingIdx);
+    outOffset = 0;
+    return stagingBuffer;
+}
+
+void AsyncQueueHandler::ReleaseStagingBlocks(const stltype::vector<u32>& blockIndices)
+{
+    for (u32 blockIdx : blockIndices)
+    {
+        m_stagingRing.Release(blockIdx);
+    }
+}
+
 void AsyncQueueHandler::DispatchAllRequests()
 {
     ReclaimCompletedResources(~0u);
@@ -173,6 +214,12 @@ void AsyncQueueHandler::DispatchAllRequests()
         auto it = m_transferCommands.begin();
         for (u32 i = 0; i < transferCmdsToProcessCount; ++i)
         {
+            if (const auto* pSSBOTransfer = stltype::get_if<SSBOTransfer>(&*it))
+            {
+                const auto queuedIt = m_queuedStagedSSBOWrites.find(pSSBOTransfer->pSSBO);
+                if (--queuedIt->second == 0)
+                    m_queuedStagedSSBOWrites.erase(queuedIt);
+            }
             transferCmdsToProcess.push_back(stltype::move(*it));
             ++it;
         }
@@ -184,9 +231,10 @@ void AsyncQueueHandler::DispatchAllRequests()
     {
         BuildTransferCommandBuffer(transferCmdsToProcess);
     }
-
     SubmitCommandBuffers(m_commandBufferRequests);
     m_commandBufferRequests.clear();
+    // After everything queued so far, ring writes are newer than any staged write submitted above
+    FlushUploadRing();
 
     SubmitCommandBuffers(m_thisFrameCommandBufferRequests);
     m_thisFrameCommandBufferRequests.clear();
@@ -272,16 +320,80 @@ void AsyncQueueHandler::SubmitToSwapchainForPresentation(const stltype::vector<P
 void AsyncQueueHandler::SubmitTransferCommandAsync(const TransferCommand& request)
 {
     SimpleScopedGuard lock(m_sharedDataMutex);
+    if (const auto* pSSBOTransfer = stltype::get_if<SSBOTransfer>(&request))
+    {
+        // Writes to one buffer have to land in submission order, the ring is only copied at the end of a dispatch
+        // while staged transfers can be held back to later ones by m_maxTransferCommandsPerFrame
+        if (m_queuedStagedSSBOWrites.find(pSSBOTransfer->pSSBO) == m_queuedStagedSSBOWrites.end() &&
+            TryWriteToUploadRing(*pSSBOTransfer))
+            return;
+        if (m_uploadRing.HasPendingWrites(pSSBOTransfer->pSSBO))
+            FlushUploadRing();
+        ++m_queuedStagedSSBOWrites[pSSBOTransfer->pSSBO];
+        m_uploadRing.AddStagedUpdate(pSSBOTransfer->size);
+    }
     m_transferCommands.push_back(request);
 }
 
+bool AsyncQueueHandler::TryWriteToUploadRing(const SSBOTransfer& request)
+{
+    if (request.pDescriptor || request.onComplete)
+        return false;
+
+    const u32 frameNumber = FrameGlobals::GetFrameNumber();
+    if (m_uploadRing.IsCurrentFrame(frameNumber) == false)
+        m_uploadRing.BeginFrame(frameNumber, GetCompletedValue(QueueType::Transfer));
+    return m_uploadRing.Write(request.pData, request.size, request.pSSBO, request.offset);
+}
+
+void AsyncQueueHandler::FlushUploadRing()
+{
+    const auto regions = m_uploadRing.PopRegions();
+    if (regions.empty())
+        return;
+    ScopedZone("AsyncQueueHandler::Flush Upload Ring");
+
+    CommandBuffer* pCmdBuffer = m_commandPools[QueueType::Transfer].CreateCommandBuffer(CommandBufferCreateInfo{});
+    pCmdBuffer->SetName("FrameUploadRing");
+    pCmdBuffer->SetWaitStages(SyncStages::TRANSFER);
+    pCmdBuffer->SetSignalStages(SyncStages::BOTTOM_OF_PIPE);
+    for (const auto& region : regions)
+    {
+        SimpleBufferCopyCmd copyCmd{&m_uploadRing.GetBuffer(), region.pDst};
+        copyCmd.srcOffset = region.srcOffset;
+        copyCmd.dstOffset = region.dstOffset;
+        copyCmd.size = region.size;
+        pCmdBuffer->RecordCommand(copyCmd);
+    }
+    pCmdBuffer->Bake();
+
+    CommandBufferRequest req;
+    req.pBuffer = pCmdBuffer;
+    req.queueType = QueueType::Transfer;
+    req.frameIdx = ~0u;
+    stltype::vector<CommandBufferRequest> requests{req};
+    SubmitCommandBuffers(requests);
+    m_uploadRing.SetSubmittedValue(regions, m_queueTimelines[QueueType::Transfer].lastSubmittedValue);
+}
+
+FrameUploadStats AsyncQueueHandler::GetUploadStats()
+{
+    SimpleScopedGuard lock(m_sharedDataMutex);
+    // Frames without any updates still need to roll the stats over
+    const u32 frameNumber = FrameGlobals::GetFrameNumber();
+    if (m_uploadRing.IsCurrentFrame(frameNumber) == false)
+        m_uploadRing.BeginFrame(frameNumber, GetCompletedValue(QueueType::Transfer));
+    return m_uploadRing.GetLastFrameStats();
+}
+
 void AsyncQueueHandler::SubmitTransferCommandAsync(const Mesh* pMesh,
                                                BufferData& renderDataToFill,
                                                u32 frameIdx,
                                                stltype::function<void()>&& callback)
 {
     MeshTransfer transfer;
-    transfer.vertices = pMesh->vertices;
+    transfer.vertexData.resize(pMesh->vertices.size() * sizeof(CompleteVertex));
+    memcpy(transfer.vertexData.data(), pMesh->vertices.data(), transfer.vertexData.size());
     transfer.indices = pMesh->indices;
     transfer.pBuffersToFill = &renderDataToFill;
     transfer.frameIdx = frameIdx;
@@ -352,7 +464,7 @@ void AsyncQueueHandler::BuildTransferCommandBuffer(const stltype::vector<Transfe
                 for (u32 j = start; j < end; ++j)
                 {
                     stltype::visit([this, pCmdBuffer, &ctx](auto&& arg)
-                                   { BuildTransferCommand(arg, pCmdBuffer, ctx.assignedStagingBuffers, ctx.pendingMeshResults); },
+                                   { BuildTransferCommand(arg, pCmdBuffer, ctx); },
                                    transferCommands[j]);
                 }
                 pCmdBuffer->Bake();
@@ -377,6 +489,11 @@ void AsyncQueueHandler::BuildTransferCommandBuffer(const stltype::vector<Transfe
         {
             res.pBuffersToFill->SetVertexBuffer(res.vertexBuffer);
             res.pBuffersToFill->SetIndexBuffer(res.indexBuffer);
+            res.pBuffersToFill->SetIndex16Buffer(res.index16Buffer);
+            if (res.attributeBuffer.GetRef() != VK_NULL_HANDLE)
+                res.pBuffersToFill->SetAttributeBuffer(res.attributeBuffer);
+            if (res.meshletBuffer.GetRef() != VK_NULL_HANDLE)
+                res.pBuffersToFill->SetMeshletBuffers(res.meshletBuffer, res.meshletIndexBuffer);
         }
         ctx.pendingMeshResults.clear();
 
@@ -386,6 +503,8 @@ void AsyncQueueHandler::BuildTransferCommandBuffer(const stltype::vector<Transfe
         req.frameIdx = ~0u;
         req.requiredStagingBuffers = stltype::move(ctx.assignedStagingBuffers);
         ctx.assignedStagingBuffers.clear();
+        req.requiredStagingBlocks = stltype::move(ctx.assignedStagingBlocks);
+        ctx.assignedStagingBlocks.clear();
         requests.push_back(stltype::move(req));
 
         // Return context to free list
@@ -478,10 +597,11 @@ void AsyncQueueHandler::ReclaimCompletedResources(u32 frameIdx)
                 }
             }
 
-            if (!req.requiredStagingBuffers.empty())
+            if (!req.requiredStagingBuffers.empty() || !req.requiredStagingBlocks.empty())
             {
                 SimpleScopedGuard<decltype(m_stagingBufferMutex)> lockSTG(m_stagingBufferMutex);
                 ReleaseStagingBuffers(req.requiredStagingBuffers);
+                ReleaseStagingBlocks(req.requiredStagingBlocks);
             }
         }
 
@@ -562,55 +682,149 @@ void AsyncQueueHandler::WaitForFences(u32 frameIdx)
 
 void AsyncQueueHandler::BuildTransferCommand(const MeshTransfer& request,
                                              CommandBuffer* pCmdBuffer,
-                                             stltype::vector<u32>& stagingIndices,
-                                             stltype::vector<PendingMeshResult>& meshResults)
+                                             RecorderContext& ctx)
 {
     ScopedZone("AsyncQueueHandler::Building MeshTransfer command");
-    const auto& vertexData = request.vertices;
+    const auto& vertexData = request.vertexData;
     const auto& indices = request.indices;
 
     if (vertexData.empty())
         return;
     SetBufferSyncInfo(request, pCmdBuffer);
 
-    const u64 vertDataSize = vertexData.size() * sizeof(vertexData[0]);
+    const u64 vertDataSize = vertexData.size();
     const u64 idxDataSize = indices.size() * sizeof(indices[0]);
-    meshResults.emplace_back(PendingMeshResult{
-        request.pBuffersToFill,
-        VertexBuffer(vertDataSize),
-        IndexBuffer(idxDataSize)});
-    auto& pendingResult = meshResults.back();
+    const u64 idx16DataSize = request.indices16.size() * sizeof(u16);
+    const u64 attributeDataSize = request.attributeData.size();
+    const u64 meshletDataSize = request.meshlets.size() * sizeof(MeshletData);
+    const u64 meshletIndexDataSize = request.meshletIndices.size() * sizeof(u32);
+
+    GenericBuffer::Ptr pVertexBuffer{};
+    GenericBuffer::Ptr pIndexBuffer{};
+    GenericBuffer::Ptr pIndex16Buffer{};
+    GenericBuffer::Ptr pAttributeBuffer{};
+    GenericBuffer::Ptr pMeshletBuffer{};
+    GenericBuffer::Ptr pMeshletIndexBuffer{};
+    if (request.writeToExistingBuffers)
+    {
+        BufferData& buffers = *request.pBuffersToFill;
+        pVertexBuffer = &buffers.GetVertexBuffer();
+        pIndexBuffer = &buffers.GetIndexBuffer();
+        pIndex16Buffer = &buffers.GetIndex16Buffer();
+        pAttributeBuffer = &buffers.GetAttributeBuffer();
+        pMeshletBuffer = &buffers.GetMeshletBuffer();
+        pMeshletIndexBuffer = &buffers.GetMeshletIndexBuffer();
+    }
+    else
+    {
+        const u64 vertBufferSize = stltype::max(request.vertexBufferSize, vertDataSize);
+        const u64 idxBufferSize = stltype::max(request.indexBufferSize, idxDataSize);
+        const u64 idx16BufferSize = stltype::max(request.index16BufferSize, idx16DataSize);
+        const u64 attributeBufferSize = stltype::max(request.attributeBufferSize, attributeDataSize);
+        // Either index buffer stays empty if every mesh of the upload uses the other index type
+        ctx.pendingMeshResults.emplace_back(PendingMeshResult{
+            request.pBuffersToFill,
+            VertexBuffer(vertBufferSize),
+            idxBufferSize > 0 ? IndexBuffer(idxBufferSize) : IndexBuffer{},
+            attributeBufferSize > 0 ? VertexBuffer(attributeBufferSize) : VertexBuffer{},
+            idx16BufferSize > 0 ? IndexBuffer(idx16BufferSize) : IndexBuffer{}});
+        auto& pendingResult = ctx.pendingMeshResults.back();
+        const u64 meshletBufferSize = stltype::max(request.meshletBufferSize, meshletDataSize);
+        if (meshletBufferSize > 0)
+        {
+            pendingResult.meshletBuffer = StorageBuffer(meshletBufferSize, true);
+            pendingResult.meshletIndexBuffer =
+                StorageBuffer(stltype::max(request.meshletIndexBufferSize, meshletIndexDataSize), true);
+        }
+        pVertexBuffer = &pendingResult.vertexBuffer;
+        pIndexBuffer = &pendingResult.indexBuffer;
+        pIndex16Buffer = &pendingResult.index16Buffer;
+        pAttributeBuffer = &pendingResult.attributeBuffer;
+        pMeshletBuffer = &pendingResult.meshletBuffer;
+        pMeshletIndexBuffer = &pendingResult.meshletIndexBuffer;
+    }
 
-    u32 vertStagingIdx, idxStagingIdx;
     {
         SimpleScopedGuard<decltype(m_stagingBufferMutex)> lock(m_stagingBufferMutex);
-        AcquireStagingBufferLocked(vertDataSize, vertStagingIdx);
-        AcquireStagingBufferLocked(idxDataSize, idxStagingIdx);
-
-        stagingIndices.push_back(vertStagingIdx);
-        stagingIndices.push_back(idxStagingIdx);
+        u64 vertStagingOffset;
+        StagingBuffer& vertStaging = AllocateStagingLocked(vertDataSize, vertStagingOffset, ctx);
 
-        StagingBuffer& vertStaging = m_stagingBufferPool[vertStagingIdx];
-        StagingBuffer& idxStaging = m_stagingBufferPool[idxStagingIdx];
-
-        vertStaging.CopyToMapped(vertexData.data(), vertDataSize);
-        SimpleBufferCopyCmd vertCopy{&vertStaging, &pendingResult.vertexBuffer};
+        vertStaging.CopyToMapped(vertexData.data(), vertDataSize, vertStagingOffset);
+        SimpleBufferCopyCmd vertCopy{&vertStaging, pVertexBuffer};
+        vertCopy.srcOffset = vertStagingOffset;
         vertCopy.dstOffset = request.vertexOffset;
         vertCopy.size = vertDataSize;
         pCmdBuffer->RecordCommand(vertCopy);
 
-        idxStaging.CopyToMapped(indices.data(), idxDataSize);
-        SimpleBufferCopyCmd idxCopy{&idxStaging, &pendingResult.indexBuffer};
-        idxCopy.dstOffset = request.indexOffset;
-        idxCopy.size = idxDataSize;
-        pCmdBuffer->RecordCommand(idxCopy);
+        if (idxDataSize > 0)
+        {
+            u64 idxStagingOffset;
+            StagingBuffer& idxStaging = AllocateStagingLocked(idxDataSize, idxStagingOffset, ctx);
+
+            idxStaging.CopyToMapped(indices.data(), idxDataSize, idxStagingOffset);
+            SimpleBufferCopyCmd idxCopy{&idxStaging, pIndexBuffer};
+            idxCopy.srcOffset = idxStagingOffset;
+            idxCopy.dstOffset = request.indexOffset;
+            idxCopy.size = idxDataSize;
+            pCmdBuffer->RecordCommand(idxCopy);
+        }
+
+        if (idx16DataSize > 0)
+        {
+            u64 idx16StagingOffset;
+            StagingBuffer& idx16Staging = AllocateStagingLocked(idx16DataSize, idx16StagingOffset, ctx);
+
+            idx16Staging.CopyToMapped(request.indices16.data(), idx16DataSize, idx16StagingOffset);
+            SimpleBufferCopyCmd idx16Copy{&idx16Staging, pIndex16Buffer};
+            idx16Copy.srcOffset = idx16StagingOffset;
+            idx16Copy.dstOffset = request.index16Offset;
+            idx16Copy.size = idx16DataSize;
+            pCmdBuffer->RecordCommand(idx16Copy);
+        }
+
+        if (attributeDataSize > 0)
+        {
+            u64 attributeStagingOffset;
+            StagingBuffer& attributeStaging = AllocateStagingLocked(attributeDataSize, attributeStagingOffset, ctx);
+
+            attributeStaging.CopyToMapped(request.attributeData.data(), attributeDataSize, attributeStagingOffset);
+            SimpleBufferCopyCmd attributeCopy{&attributeStaging, pAttributeBuffer};
+            attributeCopy.srcOffset = attributeStagingOffset;
+            attributeCopy.dstOffset = request.attributeOffset;
+            attributeCopy.size = attributeDataSize;
+            pCmdBuffer->RecordCommand(attributeCopy);
+        }
+
+        if (meshletDataSize > 0)
+        {
+            u64 meshletStagingOffset;
+            StagingBuffer& meshletStaging = AllocateStagingLocked(meshletDataSize, meshletStagingOffset, ctx);
+
+            meshletStaging.CopyToMapped(request.meshlets.data(), meshletDataSize, meshletStagingOffset);
+            SimpleBufferCopyCmd meshletCopy{&meshletStaging, pMeshletBuffer};
+            meshletCopy.srcOffset = meshletStagingOffset;
+            meshletCopy.dstOffset = request.meshletOffset;
+            meshletCopy.size = meshletDataSize;
+            pCmdBuffer->RecordCommand(meshletCopy);
+
+            u64 meshletIndexStagingOffset;
+            StagingBuffer& meshletIndexStaging =
+                AllocateStagingLocked(meshletIndexDataSize, meshletIndexStagingOffset, ctx);
+
+            meshletIndexStaging.CopyToMapped(
+                request.meshletIndices.data(), meshletIndexDataSize, meshletIndexStagingOffset);
+            SimpleBufferCopyCmd meshletIndexCopy{&meshletIndexStaging, pMeshletIndexBuffer};
+            meshletIndexCopy.srcOffset = meshletIndexStagingOffset;
+            meshletIndexCopy.dstOffset = request.meshletIndexOffset;
+            meshletIndexCopy.size = meshletIndexDataSize;
+            pCmdBuffer->RecordCommand(meshletIndexCopy);
+        }
     }
 }
 
 void AsyncQueueHandler::BuildTransferCommand(const SSBOTransfer& request,
                                              CommandBuffer* pCmdBuffer,
-                                             stltype::vector<u32>& stagingIndices,
-                                             stltype::vector<PendingMeshResult>& /*unused*/)
+                                             RecorderContext& ctx)
 {
     ScopedZone("AsyncQueueHandler::Building SSBOTransfer command");
     auto pSSBO = request.pSSBO;
@@ -621,12 +835,12 @@ void AsyncQueueHandler::BuildTransferCommand(const SSBOTransfer& request,
 
     {
         SimpleScopedGuard<decltype(m_stagingBufferMutex)> lock(m_stagingBufferMutex);
-        u32 stgIdx;
-        StagingBuffer& stgBuffer = AcquireStagingBufferLocked(request.size, stgIdx);
-        stagingIndices.push_back(stgIdx);
-        stgBuffer.CopyToMapped(request.pData, request.size);
+        u64 stgOffset;
+        StagingBuffer& stgBuffer = AllocateStagingLocked(request.size, stgOffset, ctx);
+        stgBuffer.CopyToMapped(request.pData, request.size, stgOffset);
 
         SimpleBufferCopyCmd copyCmd{&stgBuffer, pSSBO};
+        copyCmd.srcOffset = stgOffset;
         copyCmd.dstOffset = offset;
         copyCmd.size = request.size; pCmdBuffer->RecordCommand(copyCmd);
     }
@@ -640,6 +854,26 @@ void AsyncQueueHandler::BuildTransferCommand(const SSBOTransfer& request,
     SetBufferSyncInfo(request, pCmdBuffer);
 }
 
+void AsyncQueueHandler::BuildTransferCommand(const BufferMoveTransfer& request,
+                                             CommandBuffer* pCmdBuffer,
+                                             RecorderContext& ctx)
+{
+    ScopedZone("AsyncQueueHandler::Building BufferMoveTransfer command");
+    // The sources were written by earlier transfer submissions, their copies have to be visible before reading them
+    pCmdBuffer->RecordCommand(GlobalBarrierCmd(
+        SyncStages::TRANSFER, SyncStages::TRANSFER, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT));
+    // Source and destination never overlap, the owner only moves into ranges that were free
+    for (const auto& region : request.regions)
+    {
+        SimpleBufferCopyCmd copyCmd{region.pBuffer, region.pBuffer};
+        copyCmd.srcOffset = region.srcOffset;
+        copyCmd.dstOffset = region.dstOffset;
+        copyCmd.size = region.size;
+        pCmdBuffer->RecordCommand(copyCmd);
+    }
+    SetBufferSyncInfo(request, pCmdBuffer);
+}
+
 void AsyncQueueHandler::SubmitCommandBuffers(stltype::vector<CommandBufferRequest>& commandBuffers)
 {
     ScopedZone("AsyncQueueHandler::Submitting command buffers");
@@ -665,8 +899,20 @@ void AsyncQueueHandler::SubmitCommandBuffers(stltype::vector<CommandBufferReques
         if (req.signalStage != SyncStages::NONE)
             req.pBuffer->SetSignalStages(req.signalStage);
 
+        if (req.queueType == QueueType::Transfer && m_transferOrderValue > 0)
+        {
+            auto& orderTimeline = m_queueTimelines[m_transferOrderQueue];
+            if (orderTimeline.lastCompletedValue < m_transferOrderValue)
+                req.pBuffer->AddTimelineWait(&orderTimeline.timeline, m_transferOrderValue);
+        }
+
         // Every buffer gets its own tracking timeline signal
         req.pBuffer->AddTimelineSignal(&timelineData.timeline, signalValue);
+        if (req.ordersLaterTransfers)
+        {
+            m_transferOrderQueue = req.queueType;
+            m_transferOrderValue = signalValue;
+        }
 
         SRF::SubmitCommandBufferToQueue({req.pBuffer}, Fence{}, req.queueType);
 
@@ -5,6 +5,8 @@
 #include "Core/SceneGraph/Mesh.h"
 #include <eathread/eathread.h>
 #include "Core/Global/ThreadPool.h"
+#include "FrameUploadRing.h"
+#include "StagingRingAllocator.h"
 #include "TransferDefines.h"
 
 struct Mesh;
@@ -16,11 +18,48 @@ class AsyncQueueHandler : public ThreadBase
 public:
     struct MeshTransfer
     {
-        stltype::vector<CompleteVertex> vertices;
+        // Already converted to the layout of the target buffer
+        stltype::vector<u8> vertexData;
+        // Optional second vertex stream, filled for split geometry where vertexData only holds positions
+        stltype::vector<u8> attributeData;
         stltype::vector<u32> indices;
+        // Indices of meshes small enough for 16 bit indices, go into the second index buffer
+        stltype::vector<u16> indices16;
+        // Optional cluster data, see MeshletData
+        stltype::vector<MeshletData> meshlets;
+        stltype::vector<u32> meshletIndices;
         BufferData* pBuffersToFill;
         u64 vertexOffset{0};
+        u64 attributeOffset{0};
         u64 indexOffset{0};
+        u64 index16Offset{0};
+        u64 meshletOffset{0};
+        u64 meshletIndexOffset{0};
+        // Sizes of the buffers created for the upload, zero sizes them to the data. Anything above leaves room for
+        // meshes streamed in later
+        u64 vertexBufferSize{0};
+        u64 attributeBufferSize{0};
+        u64 indexBufferSize{0};
+        u64 index16BufferSize{0};
+        u64 meshletBufferSize{0};
+        u64 meshletIndexBufferSize{0};
+        // Copies into the buffers pBuffersToFill already holds instead of replacing them
+        bool writeToExistingBuffers{false};
+        u32 frameIdx;
+        stltype::function<void()> onComplete;
+    };
+
+    // Copies between ranges of the same GPU buffer, used to move resident data around without a CPU round trip
+    struct BufferMoveTransfer
+    {
+        struct Region
+        {
+            GenericBuffer::Ptr pBuffer{};
+            u64 srcOffset;
+            u64 dstOffset;
+            u64 size;
+        };
+        stltype::vector<Region> regions;
         u32 frameIdx;
         stltype::function<void()> onComplete;
     };
@@ -37,7 +76,7 @@ public:
         stltype::function<void()> onComplete;
     };
 
-    using TransferCommand = stltype::variant<MeshTransfer, SSBOTransfer>;
+    using TransferCommand = stltype::variant<MeshTransfer, SSBOTransfer, BufferMoveTransfer>;
 
     struct PresentRequest
     {
@@ -55,6 +94,11 @@ public:
         bool isLastInBatch{false};
         const char* name{"Unnamed CommandBuffer Batch"};
         stltype::vector<u32> requiredStagingBuffers;
+        // Blocks of the staging ring with one allocation each, released once the buffer finished executing
+        stltype::vector<u32> requiredStagingBlocks;
+        // Transfers submitted afterwards wait for this buffer, for GPU writes that newer uploads to the same data have
+        // to land after
+        bool ordersLaterTransfers{false};
     };
 
     struct InFlightBatch
@@ -100,15 +144,26 @@ public:
     StagingBuffer& AcquireStagingBuffer(u64 requiredSize, u32& outIdx);
     void ReleaseStagingBuffers(const stltype::vector<u32>& indices);
 
+    // Bytes that went through the upload ring and through staging copies during the last completed frame
+    FrameUploadStats GetUploadStats();
+
 private:
     void CheckRequests();
     void ReclaimCompletedResources(u32 frameIdx);
     void BuildTransferCommandBuffer(const stltype::vector<TransferCommand>& transferCommands);
     
-    void BuildTransferCommand(const MeshTransfer& request, CommandBuffer* pCmdBuffer, stltype::vector<u32>& stagingIndices, stltype::vector<PendingMeshResult>& meshResults);
-    void BuildTransferCommand(const SSBOTransfer& request, CommandBuffer* pCmdBuffer, stltype::vector<u32>& stagingIndices, stltype::vector<PendingMeshResult>& meshResults);
+    void BuildTransferCommand(const MeshTransfer& request, CommandBuffer* pCmdBuffer, RecorderContext& ctx);
+    void BuildTransferCommand(const SSBOTransfer& request, CommandBuffer* pCmdBuffer, RecorderContext& ctx);
+    void BuildTransferCommand(const BufferMoveTransfer& request, CommandBuffer* pCmdBuffer, RecorderContext& ctx);
 
     StagingBuffer& AcquireStagingBufferLocked(u64 requiredSize, u32& outIdx);
+    // Sub-allocates from the staging ring, transfers too large for it get a dedicated buffer from the pool
+    StagingBuffer& AllocateStagingLocked(u64 size, u64& outOffset, RecorderContext& ctx);
+    void ReleaseStagingBlocks(const stltype::vector<u32>& blockIndices);
+
+    // Small SSBO updates without callbacks are copied into the upload ring right away
+    bool TryWriteToUploadRing(const SSBOTransfer& request);
+    void FlushUploadRing();
 
     void SubmitCommandBuffers(stltype::vector<CommandBufferRequest>& requests);
     void SubmitToSwapchainForPresentation(const stltype::vector<PresentRequest>& requests);
@@ -121,6 +176,9 @@ private:
     };
 
     stltype::hash_map<QueueType, QueueTimeline> m_queueTimelines;
+    // Timeline value of the last buffer submitted with ordersLaterTransfers
+    QueueType m_transferOrderQueue{QueueType::Graphics};
+    u64 m_transferOrderValue{0};
     stltype::hash_map<QueueType, CommandPool> m_commandPools{};
 
     stltype::vector<stltype::unique_ptr<RecorderContext>> m_recorderContexts;
@@ -128,11 +186,16 @@ private:
     ProfiledLockable(CustomMutex, m_recorderContextMutex);
     ThreadPool m_recordingPool;
 
+    StagingRingAllocator m_stagingRing;
+    // Dedicated buffers for transfers above STAGING_RING_MAX_ALLOCATION_SIZE
     stltype::deque<StagingBuffer> m_stagingBufferPool;
     stltype::vector<u32> m_freeStagingBufferIndices;
     stltype::vector<u32> m_currentBatchStagingIndices;
     ProfiledLockable(CustomMutex, m_stagingBufferMutex);
 
+    FrameUploadRing m_uploadRing;
+    // Staged SSBO transfers per buffer still waiting in m_transferCommands, ring writes to them would overtake these
+    stltype::hash_map<const StorageBuffer*, u32> m_queuedStagedSSBOWrites;
     stltype::deque<TransferCommand> m_transferCommands;
     stltype::vector<CommandBufferRequest> m_commandBufferRequests;
     stltype::vector<CommandBufferRequest> m_thisFrameCommandBufferRequests;
@@ -1,14 +1,67 @@
 #pragma once
 #include "Core/Global/GlobalDefines.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include "Core/Rendering/Core/Buffer.h"
+#include "Core/Rendering/Core/RenderingForwardDecls.h"
 #include "Core/SceneGraph/Mesh.h"
 
 namespace Utils
 {
-static inline MinVertex ConvertVertexFormat(const CompleteVertex& completeVert)
+// Octahedral mapping of a unit vector onto [-1, 1]^2
+static inline mathstl::Vector2 EncodeOctahedral(const mathstl::Vector3& n)
+{
+    const f32 invL1 = 1.0f / (mathstl::abs(n.x) + mathstl::abs(n.y) + mathstl::abs(n.z) + 1e-12f);
+    mathstl::Vector2 oct{n.x * invL1, n.y * invL1};
+    if (n.z < 0.0f)
+    {
+        oct = mathstl::Vector2{(1.0f - mathstl::abs(oct.y)) * (oct.x >= 0.0f ? 1.0f : -1.0f),
+                               (1.0f - mathstl::abs(oct.x)) * (oct.y >= 0.0f ? 1.0f : -1.0f)};
+    }
+    return oct;
+}
+
+// Folds the bitangent sign into the second component, the magnitude never reaches zero so the sign survives snorm
+// quantization
+static inline mathstl::Vector2 EncodePackedTangent(const mathstl::Vector4& tangent)
+{
+    const mathstl::Vector2 oct = EncodeOctahedral(mathstl::Vector3(tangent.x, tangent.y, tangent.z));
+    const f32 sign = tangent.w < 0.0f ? -1.0f : 1.0f;
+    const f32 remapped = mathstl::clamp(oct.y * 0.5f + 0.5f, 1.0f / 32767.0f, 1.0f);
+    return {oct.x, remapped * sign};
+}
+
+template <typename T>
+static inline T ConvertVertexFormat(const CompleteVertex& completeVert)
+{
+    return completeVert;
+}
+
+template <>
+inline MinVertex ConvertVertexFormat(const CompleteVertex& completeVert)
 {
     return {completeVert.position};
 }
 
+template <>
+inline CompleteVertexAttributes ConvertVertexFormat(const CompleteVertex& completeVert)
+{
+    return {completeVert.normal, completeVert.texCoord, completeVert.tangent};
+}
+
+template <>
+inline PackedVertexAttributes ConvertVertexFormat(const CompleteVertex& completeVert)
+{
+    mathstl::Vector3 normal = completeVert.normal;
+    normal.Normalize();
+    const mathstl::Vector2 normalOct = EncodeOctahedral(normal);
+    const mathstl::Vector2 tangentOct = EncodePackedTangent(completeVert.tangent);
+
+    PackedVertexAttributes packed;
+    packed.normalTangentOct = DirectX::PackedVector::XMSHORTN4(normalOct.x, normalOct.y, tangentOct.x, tangentOct.y);
+    packed.texCoord = DirectX::PackedVector::XMHALF2(completeVert.texCoord.x, completeVert.texCoord.y);
+    return packed;
+}
+
 template <typename T>
 static inline void FillVertices(const Mesh& mesh, stltype::vector<T>& vertices)
 {
@@ -20,7 +73,20 @@ inline void FillVertices(const Mesh& mesh, stltype::vector<MinVertex>& vertices)
 {
     for (auto& vert : mesh.vertices)
     {
-        vertices.emplace_back(ConvertVertexFormat(vert));
+        vertices.emplace_back(ConvertVertexFormat<MinVertex>(vert));
+    }
+}
+
+// Writes the mesh vertices converted to T straight into a raw upload buffer
+template <typename T>
+static inline void FillVertexBytes(const Mesh& mesh, stltype::vector<u8>& vertexData)
+{
+    const u64 start = vertexData.size();
+    vertexData.resize(start + mesh.vertices.size() * sizeof(T));
+    T* pDst = reinterpret_cast<T*>(vertexData.data() + start);
+    for (const auto& vert : mesh.vertices)
+    {
+        *pDst++ = ConvertVertexFormat<T>(vert);
     }
 }
 
@@ -34,4 +100,125 @@ static inline void GenerateDrawCommandForMesh(const Mesh& mesh,
 
     indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
 }
+
+template <typename T>
+static inline void GenerateDrawCommandForMesh(const Mesh& mesh,
+                                              u64 vertexOffset,
+                                              stltype::vector<u8>& vertexData,
+                                              stltype::vector<u32>& indices)
+{
+    FillVertexBytes<T>(mesh, vertexData);
+
+    indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+}
+
+// Split geometry, positions go into their own stream and TAttributes into the second one
+template <typename TAttributes>
+static inline void GenerateDrawCommandForMesh(const Mesh& mesh,
+                                              u64 vertexOffset,
+                                              stltype::vector<u8>& positionData,
+                                              stltype::vector<u8>& attributeData,
+                                              stltype::vector<u32>& indices)
+{
+    FillVertexBytes<MinVertex>(mesh, positionData);
+    FillVertexBytes<TAttributes>(mesh, attributeData);
+
+    indices.insert(indices.end(), mesh.indices.begin(), mesh.indices.end());
+}
+
+// Every index of a mesh with at most 65536 vertices fits into 16 bits since indices are relative to the mesh
+static inline bool CanUse16BitIndices(const Mesh& mesh)
+{
+    return mesh.vertices.size() <= MESH_INDEX16_MAX_VERTICES;
+}
+
+static inline void FillIndices16(const Mesh& mesh, stltype::vector<u16>& indices)
+{
+    DEBUG_ASSERT(CanUse16BitIndices(mesh));
+    const u64 start = indices.size();
+    indices.resize(start + mesh.indices.size());
+    for (u64 i = 0; i < mesh.indices.size(); ++i)
+    {
+        indices[start + i] = static_cast<u16>(mesh.indices[i]);
+    }
+}
+
+// Same as above but small meshes get their indices narrowed into the 16 bit stream, returns the index type used
+template <typename TAttributes>
+static inline IndexType GenerateDrawCommandForMesh(const Mesh& mesh,
+                                                   u64 vertexOffset,
+                                                   stltype::vector<u8>& positionData,
+                                                   stltype::vector<u8>& attributeData,
+                                                   stltype::vector<u32>& indices,
+                                                   stltype::vector<u16>& indices16)
+{
+    if (CanUse16BitIndices(mesh) == false)
+    {
+        GenerateDrawCommandForMesh<TAttributes>(mesh, vertexOffset, positionData, attributeData, indices);
+        return IndexType::UInt32;
+    }
+
+    FillVertexBytes<MinVertex>(mesh, positionData);
+    FillVertexBytes<TAttributes>(mesh, attributeData);
+    FillIndices16(mesh, indices16);
+    return IndexType::UInt16;
+}
+
+// Appends the coarser LODs to the index stream LOD 0 went into and fills their ranges in the handle
+// indexBufferOffset is where the first LOD lands, returns the number of indices appended
+static inline u64 FillLODIndices(const Mesh& mesh,
+                                 IndexType indexType,
+                                 u64 indexBufferOffset,
+                                 stltype::vector<u32>& indices,
+                                 stltype::vector<u16>& indices16,
+                                 MeshHandle& handle)
+{
+    u64 appendedIndices = 0;
+    handle.lodCount = 1;
+    for (const auto& lod : mesh.lods)
+    {
+        if (handle.lodCount >= MESH_MAX_LODS)
+            break;
+
+        MeshLODRange& range = handle.lods[handle.lodCount - 1];
+        range.indexBufferOffset = (u32)(indexBufferOffset + appendedIndices);
+        range.indexCount = (u32)lod.indices.size();
+        range.error = lod.error;
+        if (indexType == IndexType::UInt16)
+        {
+            indices16.reserve(indices16.size() + lod.indices.size());
+            for (u32 idx : lod.indices)
+            {
+                indices16.push_back(static_cast<u16>(idx));
+            }
+        }
+        else
+        {
+            indices.insert(indices.end(), lod.indices.begin(), lod.indices.end());
+        }
+        appendedIndices += lod.indices.size();
+        ++handle.lodCount;
+    }
+    return appendedIndices;
+}
+// Appends the meshlets of a mesh with their offsets rebased onto the shared meshlet index stream
+// meshletOffset and meshletIndexOffset are where the appended data lands in the two meshlet buffers
+static inline void FillMeshlets(const Mesh& mesh,
+                                u64 meshletOffset,
+                                u64 meshletIndexOffset,
+                                stltype::vector<MeshletData>& meshlets,
+                                stltype::vector<u32>& meshletIndices,
+                                MeshHandle& handle)
+{
+    const u32 indexBase = (u32)meshletIndexOffset;
+    handle.meshletOffset = (u32)meshletOffset;
+    handle.meshletCount = (u32)mesh.meshlets.size();
+    meshletIndices.insert(meshletIndices.end(), mesh.meshletIndices.begin(), mesh.meshletIndices.end());
+    for (MeshletData meshlet : mesh.meshlets)
+    {
+        meshlet.vertexOffset += indexBase;
+        meshlet.triangleOffset += indexBase;
+        meshlets.push_back(meshlet);
+    }
+}
 } // namespace Utils
@@ -0,0 +1,65 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include "Core/Rendering/Core/AABB.h"
+#include "Core/Rendering/Core/RenderingForwardDecls.h"
+
+namespace Utils
+{
+// Pixels covered by one world unit at distance one for a vertical field of view
+static inline f32 ComputeLODProjectionScale(f32 fovRadians, f32 renderHeight)
+{
+    return renderHeight / (2.0f * tanf(fovRadians * 0.5f));
+}
+
+// Projected radius in pixels of the bounding sphere around the local space AABB placed with the world matrix
+static inline f32 ComputeProjectedRadius(const AABB& aabb,
+                                         const mathstl::Matrix& world,
+                                         const mathstl::Vector3& viewPos,
+                                         f32 projectionScale,
+                                         f32 zNear)
+{
+    const mathstl::Vector3 center =
+        mathstl::Vector3::Transform(mathstl::Vector3(aabb.center.x, aabb.center.y, aabb.center.z), world);
+    const f32 maxScaleSq = stltype::max(stltype::max(world.Right().LengthSquared(), world.Up().LengthSquared()),
+                                        world.Backward().LengthSquared());
+    const f32 radius = mathstl::Vector3(aabb.extents.x, aabb.extents.y, aabb.extents.z).Length() * sqrtf(maxScaleSq);
+    // Closest point of the sphere, once the camera is inside it this always resolves to full detail
+    const f32 distance = stltype::max((center - viewPos).Length() - radius, zNear);
+    return radius * projectionScale / distance;
+}
+
+// Coarsest LOD whose projected error stays below pixelErrorThreshold
+// Coarser levels are only picked once they're below the threshold by the hysteresis fraction and finer ones only once
+// the current level exceeds it by the same fraction, so objects sitting right at a switch distance don't pop back and forth
+static inline u32 SelectMeshLOD(const MeshHandle& handle,
+                                f32 projectedRadius,
+                                u32 currentLod,
+                                f32 pixelErrorThreshold,
+                                f32 hysteresis)
+{
+    if (handle.lodCount <= 1)
+        return 0;
+    currentLod = stltype::min(currentLod, handle.lodCount - 1);
+
+    const auto pixelError = [&](u32 lod) { return handle.GetLOD(lod).error * projectedRadius; };
+    u32 targetLod = 0;
+    while (targetLod + 1 < handle.lodCount && pixelError(targetLod + 1) <= pixelErrorThreshold)
+    {
+        ++targetLod;
+    }
+
+    if (targetLod > currentLod)
+    {
+        while (targetLod > currentLod && pixelError(targetLod) > pixelErrorThreshold * (1.0f - hysteresis))
+        {
+            --targetLod;
+        }
+    }
+    else if (targetLod < currentLod && pixelError(currentLod) <= pixelErrorThreshold * (1.0f + hysteresis))
+    {
+        targetLod = currentLod;
+    }
+    return targetLod;
+}
+} // namespace Utils
@@ -0,0 +1,106 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include "Core/Rendering/Core/RenderingForwardDecls.h"
+
+// CPU reference for cluster culling, mirrors what the GPU side does with the same MeshletData so results can be
+// compared against it
+namespace Utils
+{
+struct MeshletCullingView
+{
+    // World space planes pointing inwards, normalized so distances are in world units
+    mathstl::Vector4 frustumPlanes[6];
+    mathstl::Vector3 viewPos;
+};
+
+struct MeshletCullingStats
+{
+    u32 testedMeshlets{0};
+    u32 frustumCulledMeshlets{0};
+    u32 backfaceCulledMeshlets{0};
+    u32 visibleTriangles{0};
+};
+
+// Planes of a row vector view projection matrix, covers both regular and reversed depth since 0 <= z <= w either way
+static inline MeshletCullingView BuildMeshletCullingView(const mathstl::Matrix& viewProj, const mathstl::Vector3& viewPos)
+{
+    const mathstl::Vector4 col0(viewProj._11, viewProj._21, viewProj._31, viewProj._41);
+    const mathstl::Vector4 col1(viewProj._12, viewProj._22, viewProj._32, viewProj._42);
+    const mathstl::Vector4 col2(viewProj._13, viewProj._23, viewProj._33, viewProj._43);
+    const mathstl::Vector4 col3(viewProj._14, viewProj._24, viewProj._34, viewProj._44);
+
+    MeshletCullingView view{{col3 + col0, col3 - col0, col3 + col1, col3 - col1, col2, col3 - col2}, viewPos};
+    for (auto& plane : view.frustumPlanes)
+    {
+        const f32 length = mathstl::Vector3(plane.x, plane.y, plane.z).Length();
+        plane /= length > 0.0f ? length : 1.0f;
+    }
+    return view;
+}
+
+static inline bool IsSphereOutsideFrustum(const MeshletCullingView& view, const mathstl::Vector3& center, f32 radius)
+{
+    for (const auto& plane : view.frustumPlanes)
+    {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            return true;
+    }
+    return false;
+}
+
+// True if every triangle of the meshlet faces away from viewPos, see MeshletData for the cone test
+static inline bool IsMeshletBackfacing(const mathstl::Vector3& center,
+                                       f32 radius,
+                                       const mathstl::Vector3& coneAxis,
+                                       f32 coneCutoff,
+                                       const mathstl::Vector3& viewPos)
+{
+    const mathstl::Vector3 toCenter = center - viewPos;
+    return toCenter.Dot(coneAxis) >= coneCutoff * toCenter.Length() + radius;
+}
+
+// Culls the meshlets of one instance, bounds are moved into world space with the instance transform
+// Non uniform scale skews the normals which the transformed cone axis doesn't account for, fine for reference purposes
+// pVisibleMeshlets receives the indices of the surviving meshlets if set
+static inline MeshletCullingStats CullMeshlets(const stltype::vector<MeshletData>& meshlets,
+                                               const mathstl::Matrix& world,
+                                               const MeshletCullingView& view,
+                                               stltype::vector<u32>* pVisibleMeshlets = nullptr)
+{
+    const f32 maxScale = sqrtf(stltype::max(stltype::max(world.Right().LengthSquared(), world.Up().LengthSquared()),
+                                            world.Backward().LengthSquared()));
+
+    MeshletCullingStats stats{};
+    for (u32 i = 0; i < meshlets.size(); ++i)
+    {
+        const MeshletData& meshlet = meshlets[i];
+        ++stats.testedMeshlets;
+
+        const mathstl::Vector3 center = mathstl::Vector3::Transform(
+            mathstl::Vector3(meshlet.boundingSphere.x, meshlet.boundingSphere.y, meshlet.boundingSphere.z), world);
+        const f32 radius = meshlet.boundingSphere.w * maxScale;
+        if (IsSphereOutsideFrustum(view, center, radius))
+        {
+            ++stats.frustumCulledMeshlets;
+            continue;
+        }
+
+        mathstl::Vector3 coneAxis = mathstl::Vector3::TransformNormal(
+            mathstl::Vector3(meshlet.coneAxisCutoff.x, meshlet.coneAxisCutoff.y, meshlet.coneAxisCutoff.z), world);
+        coneAxis.Normalize();
+        if (IsMeshletBackfacing(center, radius, coneAxis, meshlet.coneAxisCutoff.w, view.viewPos))
+        {
+            ++stats.backfaceCulledMeshlets;
+            continue;
+        }
+
+        stats.visibleTriangles += meshlet.triangleCount;
+        if (pVisibleMeshlets)
+        {
+            pVisibleMeshlets->push_back(i);
+        }
+    }
+    return stats;
+}
+} // namespace Utils
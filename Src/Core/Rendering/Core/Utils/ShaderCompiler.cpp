@@ -1,6 +1,7 @@
 #include "ShaderCompiler.h"
 #include "Core/Global/GlobalDefines.h"
 #include "Core/Global/GlobalVariables.h"
+#include "Core/IO/AssetCache.h"
 #include "Core/IO/FileReader.h"
 #include <filesystem>
 #include <glslang/Public/ResourceLimits.h>
@@ -115,6 +116,24 @@ public:
         }
     }
 
+    // Every shader can pull in any include, so a change to one of them invalidates all cached binaries
+    u64 HashIncludes()
+    {
+        if (m_readShaderFiles > 0)
+        {
+            g_pFileReader->FinishAllRequests();
+        }
+
+        u64 hash = 0;
+        for (const auto& [path, contents] : m_includerMap)
+        {
+            // Summed up since the hash map iteration order isn't stable
+            hash += AssetHashing::Combine(AssetHashing::HashBytes(path.data(), path.size()),
+                                          AssetHashing::HashBytes(contents.data(), contents.size()));
+        }
+        return hash;
+    }
+
 private:
     IncluderMap m_includerMap;
     struct IncluderPathInfo
@@ -211,6 +230,11 @@ ShaderMap ShaderCompiler::CompileAllShaders()
     m_dataFutex.lock();
     glslang::InitializeProcess();
     ShaderMap rsltMap;
+
+    // Target environment and message flags used by CompileShader, changing them has to produce new keys
+    const u64 compileSettings = AssetHashing::Combine(
+        ((u64)glslang::EShTargetVulkan_1_4 << 32) | (u64)glslang::EShTargetSpv_1_6,
+        AssetHashing::Combine((u64)(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules), s_includer.HashIncludes()));
     for (auto& data : m_compileData)
     {
         EShLanguage type = EShLangVertex;
@@ -229,6 +253,22 @@ ShaderMap ShaderCompiler::CompileAllShaders()
                 DEBUG_ASSERT(false);
                 break;
         }
+        const AssetKey key = g_pAssetCache->BuildKey(AssetKind::Shader,
+                                                     data.contents.data(),
+                                                     data.contents.size(),
+                                                     AssetHashing::Combine(compileSettings, (u64)type));
+        stltype::vector<u8> cooked;
+        if (g_pAssetCache->Load(AssetKind::Shader, key, data.fileName, cooked) && cooked.empty() == false &&
+            cooked.size() % sizeof(u32) == 0)
+        {
+            SpirVBinary spirv;
+            spirv.words.resize(cooked.size() / sizeof(u32));
+            memcpy(spirv.words.data(), cooked.data(), cooked.size());
+            rsltMap.emplace(BuildOutputFileName(data.fileName), stltype::move(spirv));
+            continue;
+        }
+
+        const auto start = stltype::chrono::steady_clock::now();
         const auto spirv = CompileShader(type, data.contents, data.fileName.c_str());
         if (spirv.words.empty())
         {
@@ -236,10 +276,20 @@ ShaderMap ShaderCompiler::CompileAllShaders()
             m_dataFutex.unlock();
             return {};
         }
+        const f32 compileTimeMs = stltype::chrono::duration<f32, stltype::chrono::milliseconds::period>(
+                                      stltype::chrono::steady_clock::now() - start)
+                                      .count();
+        g_pAssetCache->Store(AssetKind::Shader,
+                             key,
+                             data.fileName,
+                             spirv.words.data(),
+                             spirv.words.size() * sizeof(u32),
+                             compileTimeMs);
         rsltMap.emplace(BuildOutputFileName(data.fileName), spirv);
     }
     glslang::FinalizeProcess();
     m_dataFutex.unlock();
+    g_pAssetCache->LogReport();
     return rsltMap;
 }
 
@@ -0,0 +1,31 @@
+#pragma once
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Global/Utils/MathFunctions.h"
+#include "Core/SceneGraph/Mesh.h"
+
+namespace Utils
+{
+// Texels a texture needs across the whole [0, 1] UV range so one texel covers at most one pixel of the mesh
+// projectedRadius comes from ComputeProjectedRadius, dividing by the object space radius instead of the world space one
+// cancels the world scale since the UV density is measured in object space as well
+// Meshes without a UV density are assumed to map the texture once across their bounding sphere
+static inline f32 ComputeRequiredTextureExtent(f32 projectedRadius, f32 localRadius, f32 uvDensity)
+{
+    localRadius = stltype::max(localRadius, FLOAT_TOLERANCE);
+    if (uvDensity <= 0.0f)
+        uvDensity = 1.0f / (2.0f * localRadius);
+    return projectedRadius / (localRadius * uvDensity);
+}
+
+// Most detailed mip a chain with the given full extent needs to cover requiredExtent texels, never coarser than
+// coarsestMip
+static inline u32 SelectStreamingMip(u32 fullExtent, f32 requiredExtent, u32 coarsestMip)
+{
+    if (requiredExtent <= 1.0f)
+        return coarsestMip;
+    const f32 ratio = (f32)fullExtent / requiredExtent;
+    if (ratio <= 1.0f)
+        return 0;
+    return stltype::min((u32)floorf(log2f(ratio)), coarsestMip);
+}
+} // namespace Utils
@@ -16,7 +16,7 @@ namespace RenderPasses
 
 SMAAPass::SMAAPass() : GenericGeometryPass("SMAAPass")
 {
-    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::Complete);
+    SetVertexInputDescriptions(VertexInputDefines::SceneVertexTemplate);
     CreateSharedDescriptorLayout();
 }
 
@@ -56,8 +56,11 @@ void SMAAPass::Init(RendererAttachmentInfo& attachmentInfo, const SharedResource
 
     g_pTexManager->SubmitTextureRequest(areaReq);
     
-    m_searchTexBindless = g_pTexManager->MakeTextureBindless(searchHandle, true);
-    m_areaTexBindless = g_pTexManager->MakeTextureBindless(areaReq.handle, true);
+    const BindlessSlot searchSlot = g_pTexManager->MakeTextureBindless(searchHandle, true);
+    const BindlessSlot areaSlot = g_pTexManager->MakeTextureBindless(areaReq.handle, true);
+    DEBUG_ASSERT(searchSlot.IsValid() && areaSlot.IsValid());
+    m_searchTexBindless = searchSlot.index;
+    m_areaTexBindless = areaSlot.index;
 
     BuildPipelines();
 }
@@ -76,7 +79,7 @@ void SMAAPass::BuildPipelines()
     });
     edgeInfo.pushConstantInfo.constants = {{ShaderTypeBits::Vertex | ShaderTypeBits::Fragment, 0, (u32)sizeof(SMAAPushConstants)}};
     edgeInfo.hasDepth = false;
-    m_edgePSO = PSO(ShaderCollection{&edgeVert, &edgeFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, edgeInfo);
+    m_edgePSO = PSO(ShaderCollection{&edgeVert, &edgeFrag}, GetVertexInputInfo(), edgeInfo);
 
     // 2. Blend Weight Calculation PSO
     auto blendVert = Shader("Shaders/SMAABlend.vert.spv", "main");
@@ -88,7 +91,7 @@ void SMAAPass::BuildPipelines()
     });
     blendInfo.pushConstantInfo.constants = {{ShaderTypeBits::Vertex | ShaderTypeBits::Fragment, 0, (u32)sizeof(SMAAPushConstants)}};
     blendInfo.hasDepth = false;
-    m_blendPSO = PSO(ShaderCollection{&blendVert, &blendFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, blendInfo);
+    m_blendPSO = PSO(ShaderCollection{&blendVert, &blendFrag}, GetVertexInputInfo(), blendInfo);
 
     // 3. Neighborhood Blending PSO
     auto neighborVert = Shader("Shaders/SMAANeighborhood.vert.spv", "main");
@@ -100,7 +103,7 @@ void SMAAPass::BuildPipelines()
     });
     neighborInfo.pushConstantInfo.constants = {{ShaderTypeBits::Vertex | ShaderTypeBits::Fragment, 0, (u32)sizeof(SMAAPushConstants)}};
     neighborInfo.hasDepth = false;
-    m_neighborhoodPSO = PSO(ShaderCollection{&neighborVert, &neighborFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, neighborInfo);
+    m_neighborhoodPSO = PSO(ShaderCollection{&neighborVert, &neighborFrag}, GetVertexInputInfo(), neighborInfo);
 }
 
 bool SMAAPass::WantsToRender() const
@@ -126,7 +129,12 @@ void SMAAPass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
     cmdBuf.EmptyCmds();
     const auto pFullScreenQuadMesh = g_pMeshManager->GetPrimitiveMesh(MeshManager::PrimitiveType::Quad);
     const auto meshHandle = previousFrameCtx.pResourceManager->GetMeshHandle(pFullScreenQuadMesh);
-    cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount, 1, meshHandle.indexBufferOffset, meshHandle.vertBufferOffset, 0);
+    cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount,
+                             1,
+                             meshHandle.indexBufferOffset,
+                             meshHandle.vertBufferOffset,
+                             0,
+                             (IndexType)meshHandle.indexType);
     RebuildPerObjectBuffer({0});
     cmdBuf.FillCmds();
 }
@@ -144,13 +152,12 @@ void SMAAPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
     const auto displayViewport = RenderViewUtils::CreateViewportFromData(extentsXY, ctx.zNear, ctx.zFar);
     auto& sceneGeometryBuffers = data.pResourceManager->GetSceneGeometryBuffers();
     if (sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE ||
-        sceneGeometryBuffers.GetIndexBuffer().GetRef() == VK_NULL_HANDLE)
+        sceneGeometryBuffers.HasIndices() == false ||
+        sceneGeometryBuffers.HasAttributeStream() == false)
     {
         return;
     }
     
-    BinRenderDataCmd geomBufferCmd(sceneGeometryBuffers.GetVertexBuffer(), sceneGeometryBuffers.GetIndexBuffer());
-    
     auto gbufferUBOSet = data.bufferDescriptors.at(UBO::DescriptorContentsType::GBuffer);
     auto texArraySet = data.bufferDescriptors.at(UBO::DescriptorContentsType::BindlessTextureArray);
 
@@ -171,9 +178,7 @@ void SMAAPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
         cmdEdge.SetPushConstants(0, pc, ShaderTypeBits::Vertex | ShaderTypeBits::Fragment);
 
         pCmdBuffer->RecordCommand(beginEdge);
-        if (geomBufferCmd.vertexBuffer != nullptr)
-            pCmdBuffer->RecordCommand(geomBufferCmd);
-        pCmdBuffer->RecordCommand(cmdEdge);
+        RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmdEdge, true);
         pCmdBuffer->RecordCommand(EndRenderingCmd{});
     }
 
@@ -202,9 +207,7 @@ void SMAAPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
         cmdBlend.SetPushConstants(0, pc, ShaderTypeBits::Vertex | ShaderTypeBits::Fragment);
 
         pCmdBuffer->RecordCommand(beginBlend);
-        if (geomBufferCmd.vertexBuffer != nullptr)
-            pCmdBuffer->RecordCommand(geomBufferCmd);
-        pCmdBuffer->RecordCommand(cmdBlend);
+        RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmdBlend, true);
         pCmdBuffer->RecordCommand(EndRenderingCmd{});
     }
 
@@ -242,9 +245,7 @@ void SMAAPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
         cmdNeighbor.SetPushConstants(0, pc, ShaderTypeBits::Vertex | ShaderTypeBits::Fragment);
 
         pCmdBuffer->RecordCommand(beginNeighbor);
-        if (geomBufferCmd.vertexBuffer != nullptr)
-            pCmdBuffer->RecordCommand(geomBufferCmd);
-        pCmdBuffer->RecordCommand(cmdNeighbor);
+        RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmdNeighbor, true);
         pCmdBuffer->RecordCommand(EndRenderingCmd{});
         
         ImageLayoutTransitionCmd outputBarrier2(pOutputTexture);
@@ -11,7 +11,7 @@ using namespace RenderPasses;
 
 CompositPass::CompositPass() : GenericGeometryPass("CompositPass")
 {
-    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::Complete);
+    SetVertexInputDescriptions(VertexInputDefines::SceneVertexTemplate);
     CreateSharedDescriptorLayout();
 }
 
@@ -48,8 +48,7 @@ void CompositPass::BuildPipelines()
     info.descriptorSetLayout.sharedDescriptors = m_sharedDescriptors;
     info.attachmentInfos = CreateAttachmentInfo({m_mainRenderingData.colorAttachments});
     info.hasDepth = false;
-    m_mainPSO = PSO(
-        ShaderCollection{&mainVert, &mainFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, info);
+    m_mainPSO = PSO(ShaderCollection{&mainVert, &mainFrag}, GetVertexInputInfo(), info);
 }
 
 void CompositPass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
@@ -61,8 +60,12 @@ void CompositPass::RebuildInternalData(const stltype::vector<PassMeshData>& mesh
     cmdBuf.EmptyCmds();
     const auto pFullScreenQuadMesh = g_pMeshManager->GetPrimitiveMesh(MeshManager::PrimitiveType::Quad);
     const auto meshHandle = previousFrameCtx.pResourceManager->GetMeshHandle(pFullScreenQuadMesh);
-    cmdBuf.AddIndexedDrawCmd(
-        meshHandle.indexCount, 1, meshHandle.indexBufferOffset, meshHandle.vertBufferOffset, 0);
+    cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount,
+                             1,
+                             meshHandle.indexBufferOffset,
+                             meshHandle.vertBufferOffset,
+                             0,
+                             (IndexType)meshHandle.indexType);
     RebuildPerObjectBuffer({0});
     cmdBuf.FillCmds();
 }
@@ -86,12 +89,11 @@ void CompositPass::Render(const MainPassData& data, FrameRendererContext& ctx, C
 
     auto& sceneGeometryBuffers = data.pResourceManager->GetSceneGeometryBuffers();
     if (sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE ||
-        sceneGeometryBuffers.GetIndexBuffer().GetRef() == VK_NULL_HANDLE)
+        sceneGeometryBuffers.HasIndices() == false ||
+        sceneGeometryBuffers.HasAttributeStream() == false)
     {
         return;
     }
-    BinRenderDataCmd geomBufferCmd(sceneGeometryBuffers.GetVertexBuffer(), sceneGeometryBuffers.GetIndexBuffer());
-    
     auto& cmdBuf = m_indirectCmdBuffers[m_currentFrameIdx];
     GenericIndirectDrawCmd cmd{&m_mainPSO, cmdBuf};
     cmd.drawCount = cmdBuf.GetDrawCmdNum();
@@ -110,8 +112,7 @@ void CompositPass::Render(const MainPassData& data, FrameRendererContext& ctx, C
 
     StartRenderPassProfilingScope(pCmdBuffer);
     pCmdBuffer->RecordCommand(cmdBegin);
-    pCmdBuffer->RecordCommand(geomBufferCmd);
-    pCmdBuffer->RecordCommand(cmd);
+    RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmd, true);
     pCmdBuffer->RecordCommand(EndRenderingCmd{});
     EndRenderPassProfilingScope(pCmdBuffer);
 }
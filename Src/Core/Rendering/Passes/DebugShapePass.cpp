@@ -56,14 +56,11 @@ void DebugShapePass::BuildPipelines()
     info.depthWriteEnable = false;
     info.attachmentInfos =
         CreateAttachmentInfo(m_mainRenderingData.colorAttachments, m_mainRenderingData.depthAttachment);
-    m_solidDebugObjectsPSO = PSO(
-        ShaderCollection{&mainVert, &mainFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, info);
+    m_solidDebugObjectsPSO = PSO(ShaderCollection{&mainVert, &mainFrag}, GetVertexInputInfo(), info);
 
     auto wireFrameInfo = info;
     wireFrameInfo.topology = Topology::Lines;
-    m_wireframeDebugObjectsPSO = PSO(ShaderCollection{&mainVert, &mainFrag},
-                                     PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions},
-                                     wireFrameInfo);
+    m_wireframeDebugObjectsPSO = PSO(ShaderCollection{&mainVert, &mainFrag}, GetVertexInputInfo(), wireFrameInfo);
 }
 
 void DebugShapePass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
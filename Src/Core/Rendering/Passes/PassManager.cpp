@@ -30,6 +30,7 @@
 #include "DebugShapePass.h"
 #include "ImGuiPass.h"
 #include "PreProcess/DepthPrePass.h"
+#include "PreProcess/TransformScatterComputePass.h"
 #include "RT/RTAOPass.h"
 #include "RT/RTCompositePass.h"
 #include "RT/RTDebugViewPass.h"
@@ -78,6 +79,7 @@ void PassManager::InitResourceManagerAndCallbacks()
     AddPass(PassType::TileAssignmentCompute, stltype::make_unique<RenderPasses::TileAssignmentComputePass>());
     AddPass(PassType::ClusterGenCompute, stltype::make_unique<RenderPasses::ClusterGeneratorComputePass>());
     AddPass(PassType::EarlyAsyncCompute, stltype::make_unique<RenderPasses::LightGridComputePass>());
+    AddPass(PassType::TransformScatterCompute, stltype::make_unique<RenderPasses::TransformScatterComputePass>());
     AddPass(PassType::PreProcess, stltype::make_unique<RenderPasses::DepthPrePass>());
     AddPass(PassType::DepthReliantCompute, stltype::make_unique<RenderPasses::ScreenSpaceShadowPass>());
     AddPass(PassType::Main, stltype::make_unique<RenderPasses::StaticMainMeshPass>());
@@ -486,6 +488,15 @@ void PassManager::RenderAllPassGroups(const MainPassData& mainPassData,
 
     // Depth Pre-Pass
     {
+        // Range copies into the transform SSBOs go through the transfer queue, the scatter below has to land after
+        // them and so does everything reading transforms from here on
+        // Newer range copies have to land after the scatter in turn, transfers submitted after this buffer wait for it
+        const bool hasTransformScatter = m_resourceManager.GetTransformScatterCount(ctx.currentFrame) > 0;
+        if (submittedTransferValue > 0)
+            pDepthWorkBuffer->AddTimelineWait(g_pQueueHandler->GetTimelineSemaphore(QueueType::Transfer),
+                                              submittedTransferValue);
+        RenderPassGroup(PassType::TransformScatterCompute, mainPassData, ctx, pDepthWorkBuffer);
+
         if (!pendingFlips.empty())
         {
             Profiling::StartScope(
@@ -510,11 +521,14 @@ void PassManager::RenderAllPassGroups(const MainPassData& mainPassData,
         RenderPassGroup(PassType::PreProcess, mainPassData, ctx, pDepthWorkBuffer);
         m_transitionRecorder.RecordDepthToReadOnly(pDepthWorkBuffer, attachments);
         pDepthWorkBuffer->AddTimelineSignal(&ctx.frameTimeline, depthPassSignalValue);
-        pDepthWorkBuffer->SetWaitStages(SyncStages::TRANSFER | SyncStages::VERTEX_SHADER | SyncStages::FRAGMENT_SHADER |
-                                        SyncStages::DEPTH_OUTPUT);
-        pDepthWorkBuffer->SetSignalStages(SyncStages::DEPTH_OUTPUT);
+        pDepthWorkBuffer->SetWaitStages(SyncStages::TRANSFER | SyncStages::COMPUTE_SHADER | SyncStages::VERTEX_SHADER |
+                                        SyncStages::FRAGMENT_SHADER | SyncStages::DEPTH_OUTPUT);
+        pDepthWorkBuffer->SetSignalStages(hasTransformScatter ? SyncStages::DEPTH_OUTPUT | SyncStages::COMPUTE_SHADER
+                                                              : SyncStages::DEPTH_OUTPUT);
         pDepthWorkBuffer->Bake();
-        g_pQueueHandler->SubmitCommandBufferThisFrame({pDepthWorkBuffer, QueueType::Graphics, ctx.currentFrame});
+        AsyncQueueHandler::CommandBufferRequest depthRequest{pDepthWorkBuffer, QueueType::Graphics, ctx.currentFrame};
+        depthRequest.ordersLaterTransfers = hasTransformScatter;
+        g_pQueueHandler->SubmitCommandBufferThisFrame(depthRequest);
     }
 
     // SSS (DepthReliantCompute)
@@ -883,6 +897,7 @@ void PassManager::ExecutePasses(u32 frameIdx)
 
     g_pQueueHandler->DispatchAllRequests();
     m_resourceManager.FlushPendingMeshUploads(frameIdx, 256);
+    m_resourceManager.UpdateGeometryResidency(frameIdx);
     m_rtSceneManager.Update(frameIdx, m_currentSwapChainIdx, m_frameResourceManager);
     g_pQueueHandler->DispatchAllRequests();
     PrepareMainPassDataForFrame(mainPassData, ctx, frameIdx);
@@ -1071,6 +1086,20 @@ void PassManager::PreProcessMeshData(const stltype::vector<PassMeshData>& meshes
     }
 }
 
+void PassManager::RebuildMeshDataForImage(const stltype::vector<PassMeshData>& meshes, u32 lastFrame, u32 imageIdx)
+{
+    ScopedZone("PassManager::RebuildMeshDataForImage");
+    auto& lastFrameCtx = m_frameResourceManager.GetFrameRendererContext(lastFrame);
+    lastFrameCtx.pResourceManager = &m_resourceManager;
+    for (auto& [type, passes] : m_passes)
+    {
+        for (auto& pass : passes)
+        {
+            pass->RebuildInternalData(meshes, lastFrameCtx, imageIdx);
+        }
+    }
+}
+
 void PassManager::RecreateShadowMaps(u32 cascades, const mathstl::Vector2& extents)
 {
     m_renderState.recreatedThisFrame = true;
@@ -99,6 +99,7 @@ struct MainPassData
 enum class PassType
 {
     LightTransformCompute,
+    TransformScatterCompute, // Sparse transform updates, recorded ahead of the depth pre-pass
     ClusterGenCompute,
     TileAssignmentCompute,
     EarlyAsyncCompute,
@@ -152,6 +153,7 @@ inline bool IsComputePass(PassType type)
 {
     return type == PassType::EarlyAsyncCompute || 
            type == PassType::LightTransformCompute || 
+           type == PassType::TransformScatterCompute ||
            type == PassType::ClusterGenCompute ||
            type == PassType::TileAssignmentCompute ||
            type == PassType::PostProcess ||
@@ -244,6 +246,7 @@ public:
     void RecreateShadowMapsPublic(u32 cascades, const mathstl::Vector2& extents) { RecreateShadowMaps(cascades, extents); }
     void RegisterImGuiTexturesPublic() { m_imguiRegistry.RegisterShadowMapTextures(m_shadowMapManager.GetShadowMap()); }
     void PreProcessMeshDataPublic(const stltype::vector<PassMeshData>& meshes, u32 lastFrame, u32 curFrame) { PreProcessMeshData(meshes, lastFrame, curFrame); }
+    void RebuildMeshDataForImagePublic(const stltype::vector<PassMeshData>& meshes, u32 lastFrame, u32 imageIdx) { RebuildMeshDataForImage(meshes, lastFrame, imageIdx); }
     void TransferPassDataPublic(PassGeometryData&& passData, u32 frameIdx) { TransferPassData(std::move(passData), frameIdx); }
 
 
@@ -258,6 +261,8 @@ public:
 
 protected:
     void PreProcessMeshData(const stltype::vector<PassMeshData>& meshes, u32 lastFrame, u32 curFrame);
+    // Same as above for a single swapchain image, used when only the draw ranges changed (e.g. LOD switches)
+    void RebuildMeshDataForImage(const stltype::vector<PassMeshData>& meshes, u32 lastFrame, u32 imageIdx);
 
     void RecreateShadowMaps(u32 cascades, const mathstl::Vector2& extents);
     // Helpers to split large Init / ExecutePasses
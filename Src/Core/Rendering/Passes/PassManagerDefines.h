@@ -52,6 +52,8 @@ struct PassMeshData
     EntityMeshData meshData;
     u32 transformIdx;
     u32 perObjectDataIdx;
+    // Selected per frame from the projected size, indexes MeshHandle::GetLOD
+    u32 lodIdx{0};
 };
 
 struct PassGeometryData
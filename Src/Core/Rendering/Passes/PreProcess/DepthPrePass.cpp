@@ -5,7 +5,7 @@
 using namespace RenderPasses;
 DepthPrePass::DepthPrePass() : GenericGeometryPass("DepthPrePass")
 {
-    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::Complete);
+    SetVertexInputDescriptions(VertexInputDefines::SceneVertexTemplate);
     CreateSharedDescriptorLayout();
 }
 
@@ -24,8 +24,7 @@ void DepthPrePass::BuildPipelines()
     info.depthWriteEnable = true;
     // info.rasterizerInfo.cullmode = CullMode::BACK;
 
-    m_mainPSO = PSO(
-        ShaderCollection{&mainVert, &mainFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, info);
+    m_mainPSO = PSO(ShaderCollection{&mainVert, &mainFrag}, GetVertexInputInfo(), info);
 }
 
 void DepthPrePass::Init(RendererAttachmentInfo& attachmentInfo, const SharedResourceManager& resourceManager)
@@ -70,12 +69,14 @@ void DepthPrePass::RebuildInternalData(const stltype::vector<PassMeshData>& mesh
         if (mesh.meshData.IsDebugMesh())
             continue;
         const auto& meshHandle = mesh.meshData.meshResourceHandle;
+        const MeshLODRange lod = meshHandle.GetLOD(mesh.lodIdx);
 
-        cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount,
+        cmdBuf.AddIndexedDrawCmd(lod.indexCount,
                                  1, // TODO: instanced rendering
-                                 meshHandle.indexBufferOffset,
+                                 lod.indexBufferOffset,
                                  meshHandle.vertBufferOffset,
-                                 instanceOffset);
+                                 instanceOffset,
+                                 (IndexType)meshHandle.indexType);
         instanceDataIndices.emplace_back(mesh.meshData.instanceDataIdx);
         ++instanceOffset;
     }
@@ -108,7 +109,8 @@ void DepthPrePass::Render(const MainPassData& data, FrameRendererContext& ctx, C
 
     auto& sceneGeometryBuffers = data.pResourceManager->GetSceneGeometryBuffers();
     if (sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE ||
-        sceneGeometryBuffers.GetIndexBuffer().GetRef() == VK_NULL_HANDLE)
+        sceneGeometryBuffers.HasIndices() == false ||
+        sceneGeometryBuffers.HasAttributeStream() == false)
     {
         return;
     }
@@ -121,9 +123,7 @@ void DepthPrePass::Render(const MainPassData& data, FrameRendererContext& ctx, C
 
     StartRenderPassProfilingScope(pCmdBuffer);
     pCmdBuffer->RecordCommand(cmdBegin);
-    BinRenderDataCmd geomBufferCmd(sceneGeometryBuffers.GetVertexBuffer(), sceneGeometryBuffers.GetIndexBuffer());
-    pCmdBuffer->RecordCommand(geomBufferCmd);
-    pCmdBuffer->RecordCommand(cmd);
+    RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmd, true);
     pCmdBuffer->RecordCommand(EndRenderingCmd{});
     EndRenderPassProfilingScope(pCmdBuffer);
 }
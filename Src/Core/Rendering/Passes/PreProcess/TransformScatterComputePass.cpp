@@ -0,0 +1,96 @@
+#include "TransformScatterComputePass.h"
+#include "../PassManager.h"
+#include "Core/Global/GlobalVariables.h"
+#include "Core/Rendering/Core/CommandBuffer.h"
+#include "Core/Rendering/Core/Defines/BindingSlots.h"
+#include "Core/Rendering/Core/Defines/GlobalBuffers.h"
+#include "Core/Rendering/Vulkan/Utils/VkDescriptorLayoutUtils.h"
+
+#define TransformSSBOSet    0
+#define SceneAABBSet        1
+#define TransformScatterSet 2
+
+using namespace RenderPasses;
+
+TransformScatterComputePass::TransformScatterComputePass() : ConvolutionRenderPass("TransformScatterComputePass")
+{
+    CreateSharedDescriptorLayout();
+}
+
+void TransformScatterComputePass::Init(RendererAttachmentInfo& attachmentInfo,
+                                       const SharedResourceManager& resourceManager)
+{
+    ScopedZone("TransformScatterComputePass::Init");
+    BuildBuffers();
+    BuildPipelines();
+}
+
+void TransformScatterComputePass::BuildBuffers()
+{
+}
+
+void TransformScatterComputePass::BuildPipelines()
+{
+    ScopedZone("TransformScatterComputePass::BuildPipelines");
+
+    auto scatterShader = Shader("Shaders/TransformScatter.comp.spv", "main");
+
+    PipelineInfo pipeInfo{};
+    pipeInfo.descriptorSetLayout.sharedDescriptors = m_sharedDescriptors;
+
+    PushConstant pushConst;
+    pushConst.shaderUsage = ShaderTypeBits::Compute;
+    pushConst.offset = 0;
+    pushConst.size = sizeof(TransformScatterPushConstants);
+    pipeInfo.pushConstantInfo.constants.push_back(pushConst);
+
+    ShaderCollection shaders{};
+    shaders.pComputeShader = &scatterShader;
+    m_pipeline = ComputePipeline(shaders, pipeInfo);
+}
+
+void TransformScatterComputePass::CreateSharedDescriptorLayout()
+{
+    // Same layout as the scene instance set of the SharedResourceManager
+    m_sharedDescriptors.emplace_back(PipelineDescriptorLayout(UBO::BufferType::TransformSSBO, TransformSSBOSet));
+    m_sharedDescriptors.emplace_back(PipelineDescriptorLayout(UBO::BufferType::PrevTransformSSBO, TransformSSBOSet));
+    m_sharedDescriptors.emplace_back(
+        PipelineDescriptorLayout(UBO::BufferType::GlobalObjectDataSSBOs, TransformSSBOSet));
+    m_sharedDescriptors.emplace_back(PipelineDescriptorLayout(UBO::BufferType::InstanceDataSSBO, TransformSSBOSet));
+    m_sharedDescriptors.emplace_back(PipelineDescriptorLayout(UBO::BufferType::SceneAABBsSSBO, SceneAABBSet));
+    m_sharedDescriptors.emplace_back(
+        PipelineDescriptorLayout(UBO::BufferType::TransformScatterSSBO, TransformScatterSet));
+}
+
+void TransformScatterComputePass::Render(const MainPassData& data,
+                                         FrameRendererContext& ctx,
+                                         CommandBuffer* pCmdBuffer)
+{
+    ScopedZone("TransformScatterComputePass::Render");
+
+    StartRenderPassProfilingScope(pCmdBuffer);
+
+    const u32 entryCount = data.pResourceManager->GetTransformScatterCount(ctx.currentFrame);
+    if (entryCount == 0)
+    {
+        EndRenderPassProfilingScope(pCmdBuffer);
+        return;
+    }
+
+    m_pushConstants.entryCount = entryCount;
+
+    GenericComputeDispatchCmd cmd(&m_pipeline, (entryCount + 63) / 64, 1, 1);
+    cmd.descriptorSets = {data.pResourceManager->GetInstanceSSBODescriptorSet(ctx.currentFrame),
+                          data.pResourceManager->GetSceneAABBSSBODescriptorSet(ctx.currentFrame),
+                          data.pResourceManager->GetTransformScatterDescriptorSet(ctx.currentFrame)};
+    cmd.SetPushConstants(0, m_pushConstants);
+    pCmdBuffer->RecordCommand(cmd);
+
+    pCmdBuffer->RecordCommand(
+        GlobalBarrierCmd(SyncStages::COMPUTE_SHADER,
+                         SyncStages::VERTEX_SHADER | SyncStages::FRAGMENT_SHADER | SyncStages::COMPUTE_SHADER,
+                         VK_ACCESS_SHADER_WRITE_BIT,
+                         VK_ACCESS_SHADER_READ_BIT));
+
+    EndRenderPassProfilingScope(pCmdBuffer);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "../RenderPass.h"
+#include "Core/Global/GlobalDefines.h"
+#include "Core/Rendering/Core/RenderingForwardDecls.h"
+#include "Core/Rendering/Vulkan/VkPipeline.h"
+
+namespace RenderPasses
+{
+// Applies the sparse transform and AABB updates collected by the SharedResourceManager this frame
+// Recorded at the start of the depth pre-pass so every later pass sees the new transforms
+class TransformScatterComputePass : public ConvolutionRenderPass
+{
+public:
+    TransformScatterComputePass();
+    ~TransformScatterComputePass() = default;
+
+    void Init(RendererAttachmentInfo& attachmentInfo, const SharedResourceManager& resourceManager) override;
+    void BuildPipelines() override;
+    void BuildBuffers() override;
+    void CreateSharedDescriptorLayout() override;
+
+    void RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
+                             FrameRendererContext& previousFrameCtx,
+                             u32 thisFrameNum) override {}
+    void Render(const MainPassData& data, FrameRendererContext& ctx, CommandBuffer* pCmdBuffer) override;
+
+    bool WantsToRender() const override { return true; }
+    QueueType GetQueueType() const override { return QueueType::Graphics; }
+
+protected:
+    ComputePipeline m_pipeline;
+    TransformScatterPushConstants m_pushConstants;
+};
+} // namespace RenderPasses
@@ -78,7 +78,8 @@ void RTAOPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
     }
 
     const auto& sceneGeometryBuffers = data.pResourceManager->GetSceneGeometryBuffers();
-    if (!sceneGeometryBuffers.GetVertexBuffer().IsCreated() || !sceneGeometryBuffers.GetIndexBuffer().IsCreated())
+    if (!sceneGeometryBuffers.GetVertexBuffer().IsCreated() || !sceneGeometryBuffers.HasIndices() ||
+        !sceneGeometryBuffers.GetAttributeBuffer().IsCreated())
     {
         return;
     }
@@ -107,8 +108,12 @@ void RTAOPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comma
                                                              s_rtInstanceHitDataBindingSlot);
             m_tlasDescriptors[ctx.currentFrame]->WriteSSBOUpdate(sceneGeometryBuffers.GetVertexBuffer(),
                                                              s_rtSceneVertexBufferBindingSlot);
-            m_tlasDescriptors[ctx.currentFrame]->WriteSSBOUpdate(sceneGeometryBuffers.GetIndexBuffer(),
-                                                             s_rtSceneIndexBufferBindingSlot);
+            m_tlasDescriptors[ctx.currentFrame]->WriteSSBOUpdate(
+                sceneGeometryBuffers.GetIndexBufferForBinding(IndexType::UInt32), s_rtSceneIndexBufferBindingSlot);
+            m_tlasDescriptors[ctx.currentFrame]->WriteSSBOUpdate(sceneGeometryBuffers.GetAttributeBuffer(),
+                                                             s_rtSceneAttributeBufferBindingSlot);
+            m_tlasDescriptors[ctx.currentFrame]->WriteSSBOUpdate(
+                sceneGeometryBuffers.GetIndexBufferForBinding(IndexType::UInt16), s_rtSceneIndex16BufferBindingSlot);
         }
     }
 
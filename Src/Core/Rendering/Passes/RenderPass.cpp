@@ -18,38 +18,50 @@ ConvolutionRenderPass::~ConvolutionRenderPass()
 
 void ConvolutionRenderPass::SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates vertexInputType)
 {
-    const auto vertAttributes = g_VertexInputToRenderDefs.at(vertexInputType);
-    const auto totalOffset = SetVertexAttributes(vertAttributes.attributes);
+    const auto& vertAttributes = g_VertexInputToRenderDefs.at(vertexInputType);
+    const auto totalOffset = SetVertexAttributes(vertAttributes);
 
     DEBUG_ASSERT(totalOffset != 0);
 
     m_vertexInputDescription = VkVertexInputBindingDescription{};
-    m_vertexInputDescription.binding = 0;
+    m_vertexInputDescription.binding = VertexInputDefines::POSITION_STREAM_BINDING;
     m_vertexInputDescription.stride = totalOffset;
     m_vertexInputDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    m_vertexBindingCount = vertAttributes.separatePositionStream ? 2 : 1;
 }
 
 void ConvolutionRenderPass::InitBaseData(const RendererAttachmentInfo& attachmentInfo)
 {
 }
 
-u32 ConvolutionRenderPass::SetVertexAttributes(
-    const stltype::vector<VertexInputDefines::VertexAttributes>& vertexAttributes)
+u32 ConvolutionRenderPass::SetVertexAttributes(const VertexInputDefines::VertexAttributeInfo& vertexAttributeInfo)
 {
+    using namespace VertexInputDefines;
     m_attributeDescriptions.clear();
     u32 offset = 0;
-    for (const auto& attribute : vertexAttributes)
+    u32 attributeStreamOffset = 0;
+    for (const auto& attribute : vertexAttributeInfo.attributes)
     {
+        const bool isInAttributeStream =
+            vertexAttributeInfo.separatePositionStream && attribute != VertexAttributes::Position;
+        u32& streamOffset = isInAttributeStream ? attributeStreamOffset : offset;
+
         VkVertexInputAttributeDescription attributeDescription{};
-        attributeDescription.binding = g_VertexAttributeBindingMap.at(attribute);
+        attributeDescription.binding =
+            isInAttributeStream ? ATTRIBUTE_STREAM_BINDING : g_VertexAttributeBindingMap.at(attribute);
         attributeDescription.location = g_VertexAttributeLocationMap.at(attribute);
         attributeDescription.format = g_VertexAttributeVkFormatMap.at(attribute);
-        attributeDescription.offset = offset;
+        attributeDescription.offset = streamOffset;
 
-        offset += g_VertexAttributeSizeMap.at(attribute);
+        streamOffset += g_VertexAttributeSizeMap.at(attribute);
 
         m_attributeDescriptions.push_back(attributeDescription);
     }
+
+    m_attributeStreamDescription = VkVertexInputBindingDescription{};
+    m_attributeStreamDescription.binding = ATTRIBUTE_STREAM_BINDING;
+    m_attributeStreamDescription.stride = attributeStreamOffset;
+    m_attributeStreamDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
     return offset;
 }
 void ConvolutionRenderPass::StartRenderPassProfilingScope(CommandBuffer* pCmdBuffer)
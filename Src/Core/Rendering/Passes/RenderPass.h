@@ -7,6 +7,7 @@
 #include "Core/Rendering/Core/TransferUtils/TransferQueueHandler.h"
 #include "Core/Rendering/Core/Shader.h"
 #include "Core/Rendering/Core/ProfilingUtils.h"
+#include "Core/Rendering/Vulkan/VkPipeline.h"
 
 class SharedResourceManager;
 class GPUTimingQueryBase;
@@ -84,8 +85,15 @@ protected:
         m_sharedDescriptors.insert(m_sharedDescriptors.end(), preset.begin(), preset.end());
     }
 
-    // Sets all vulkan vertex input attributes and returns the size of a vertex
-    u32 SetVertexAttributes(const stltype::vector<VertexInputDefines::VertexAttributes>& vertexAttributes);
+    PipeVertInfo GetVertexInputInfo() const
+    {
+        return PipeVertInfo{
+            m_vertexInputDescription, m_attributeDescriptions, m_vertexBindingCount, m_attributeStreamDescription};
+    }
+
+    // Sets all vulkan vertex input attributes and returns the size of a vertex in the position stream, the stride of the
+    // attribute stream is written to m_attributeStreamDescription for split layouts
+    u32 SetVertexAttributes(const VertexInputDefines::VertexAttributeInfo& vertexAttributeInfo);
 
 protected:
     struct InternalSynchronizationContext
@@ -99,6 +107,8 @@ protected:
     stltype::vector<PipelineDescriptorLayout> m_sharedDescriptors{};
 
     VkVertexInputBindingDescription m_vertexInputDescription{};
+    VkVertexInputBindingDescription m_attributeStreamDescription{};
+    u32 m_vertexBindingCount{1};
 
     stltype::string m_passName;
     GPUTimingQueryBase* m_pTimingQuery{nullptr};
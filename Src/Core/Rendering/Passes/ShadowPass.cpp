@@ -17,7 +17,7 @@ void CSMPass::BuildBuffers()
 
 CSMPass::CSMPass() : GenericGeometryPass("ShadowPass")
 {
-    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::Complete);
+    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::PositionOnly);
     CreateSharedDescriptorLayout();
 }
 
@@ -58,8 +58,7 @@ void CSMPass::BuildPipelines()
     info.depthCompareOp = kDepthWriteCompareOp;
     info.depthWriteEnable = true;
     info.rasterizerInfo.cullmode = CullMode::FRONT;
-    m_mainPSO = PSO(
-        ShaderCollection{&mainVert, nullptr}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, info);
+    m_mainPSO = PSO(ShaderCollection{&mainVert, nullptr}, GetVertexInputInfo(), info);
 }
 
 void CSMPass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
@@ -79,12 +78,14 @@ void CSMPass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
         if (mesh.meshData.IsDebugMesh())
             continue;
         const auto& meshHandle = mesh.meshData.meshResourceHandle;
+        const MeshLODRange lod = meshHandle.GetLOD(mesh.lodIdx);
 
-        cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount,
+        cmdBuf.AddIndexedDrawCmd(lod.indexCount,
                                  1, // TODO: instanced rendering
-                                 meshHandle.indexBufferOffset,
+                                 lod.indexBufferOffset,
                                  meshHandle.vertBufferOffset,
-                                 instanceOffset);
+                                 instanceOffset,
+                                 (IndexType)meshHandle.indexType);
         instanceDataIndices.emplace_back(mesh.meshData.instanceDataIdx);
         ++instanceOffset;
     }
@@ -131,9 +132,7 @@ void CSMPass::Render(const MainPassData& data, FrameRendererContext& ctx, Comman
     if (data.csmViews.empty() == false)
     {
         pCmdBuffer->RecordCommand(cmdBegin);
-        BinRenderDataCmd geomBufferCmd(sceneGeometryBuffers.GetVertexBuffer(), sceneGeometryBuffers.GetIndexBuffer());
-        pCmdBuffer->RecordCommand(geomBufferCmd);
-        pCmdBuffer->RecordCommand(cmd);
+        RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmd, false);
 
         pCmdBuffer->RecordCommand(EndRenderingCmd{});
     }
@@ -12,7 +12,7 @@ void StaticMainMeshPass::BuildBuffers()
 
 StaticMainMeshPass::StaticMainMeshPass() : GenericGeometryPass("StaticMainMeshPass")
 {
-    SetVertexInputDescriptions(VertexInputDefines::VertexAttributeTemplates::Complete);
+    SetVertexInputDescriptions(VertexInputDefines::SceneVertexTemplate);
     CreateSharedDescriptorLayout();
 }
 
@@ -64,8 +64,7 @@ void StaticMainMeshPass::BuildPipelines()
     info.depthWriteEnable = false;
     info.attachmentInfos =
         CreateAttachmentInfo({m_mainRenderingData.colorAttachments}, m_mainRenderingData.depthAttachment);
-    m_mainPSO = PSO(
-        ShaderCollection{&mainVert, &mainFrag}, PipeVertInfo{m_vertexInputDescription, m_attributeDescriptions}, info);
+    m_mainPSO = PSO(ShaderCollection{&mainVert, &mainFrag}, GetVertexInputInfo(), info);
 }
 
 void StaticMainMeshPass::RebuildInternalData(const stltype::vector<PassMeshData>& meshes,
@@ -85,12 +84,14 @@ void StaticMainMeshPass::RebuildInternalData(const stltype::vector<PassMeshData>
         if (mesh.meshData.IsDebugMesh())
             continue;
         const auto& meshHandle = mesh.meshData.meshResourceHandle;
+        const MeshLODRange lod = meshHandle.GetLOD(mesh.lodIdx);
 
-        cmdBuf.AddIndexedDrawCmd(meshHandle.indexCount,
+        cmdBuf.AddIndexedDrawCmd(lod.indexCount,
                                  1, // TODO: instanced rendering
-                                 meshHandle.indexBufferOffset,
+                                 lod.indexBufferOffset,
                                  meshHandle.vertBufferOffset,
-                                 instanceOffset);
+                                 instanceOffset,
+                                 (IndexType)meshHandle.indexType);
         instanceDataIndices.emplace_back(mesh.meshData.instanceDataIdx);
         ++instanceOffset;
     }
@@ -135,7 +136,8 @@ void StaticMainMeshPass::Render(const MainPassData& data, FrameRendererContext&
 
     auto& sceneGeometryBuffers = data.pResourceManager->GetSceneGeometryBuffers();
     if (sceneGeometryBuffers.GetVertexBuffer().GetRef() == VK_NULL_HANDLE ||
-        sceneGeometryBuffers.GetIndexBuffer().GetRef() == VK_NULL_HANDLE)
+        sceneGeometryBuffers.HasIndices() == false ||
+        sceneGeometryBuffers.HasAttributeStream() == false)
     {
         return;
     }
@@ -152,9 +154,7 @@ void StaticMainMeshPass::Render(const MainPassData& data, FrameRendererContext&
     cmdBegin.drawCmdBuffer = &cmdBuf;
     StartRenderPassProfilingScope(pCmdBuffer);
     pCmdBuffer->RecordCommand(cmdBegin);
-    BinRenderDataCmd geomBufferCmd(sceneGeometryBuffers.GetVertexBuffer(), sceneGeometryBuffers.GetIndexBuffer());
-    pCmdBuffer->RecordCommand(geomBufferCmd);
-    pCmdBuffer->RecordCommand(cmd);
+    RecordSceneGeometryDraws(pCmdBuffer, sceneGeometryBuffers, cmd, true);
     pCmdBuffer->RecordCommand(EndRenderingCmd{});
     EndRenderPassProfilingScope(pCmdBuffer);
 }
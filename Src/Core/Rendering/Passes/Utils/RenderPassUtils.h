@@ -68,6 +68,35 @@ static inline bool NeedToRender(const IndirectDrawCmdBuf& buffer)
     return true;
 }
 
+// Scene geometry draws are split by index type, binds the matching index buffer and issues one indirect range per type
+// Passes that only read positions leave bindAttributes off so the second vertex stream isn't bound
+static inline void RecordSceneGeometryDraws(CommandBuffer* pCmdBuffer,
+                                            BufferData& geometryBuffers,
+                                            GenericIndirectDrawCmd& drawCmd,
+                                            bool bindAttributes)
+{
+    const IndirectDrawCmdBuf& cmdBuf = *drawCmd.drawCmdBuffer;
+    for (const IndexType indexType : {IndexType::UInt32, IndexType::UInt16})
+    {
+        const u32 drawCount = cmdBuf.GetDrawCmdNum(indexType);
+        IndexBuffer& indexBuffer = geometryBuffers.GetIndexBuffer(indexType);
+        if (drawCount == 0 || indexBuffer.GetRef() == VK_NULL_HANDLE)
+            continue;
+
+        BinRenderDataCmd geomBufferCmd =
+            bindAttributes ? BinRenderDataCmd(geometryBuffers.GetVertexBuffer(),
+                                              geometryBuffers.GetAttributeBuffer(),
+                                              indexBuffer)
+                           : BinRenderDataCmd(geometryBuffers.GetVertexBuffer(), indexBuffer);
+        geomBufferCmd.indexType = indexType;
+        pCmdBuffer->RecordCommand(geomBufferCmd);
+
+        drawCmd.drawCount = drawCount;
+        drawCmd.bufferOffst = cmdBuf.GetDrawCmdByteOffset(indexType);
+        pCmdBuffer->RecordCommand(drawCmd);
+    }
+}
+
 static inline RenderAttachmentInfo ToRenderAttachmentInfo(const ColorAttachment& attachment)
 {
     RenderAttachmentInfo info{};
@@ -614,19 +614,21 @@ inline VkBufferUsageFlags Conv(const BufferUsage& m)
 {
     switch (m)
     {
+        // Transfer source so the scene geometry buffers can be defragmented with GPU copies
         case BufferUsage::Vertex:
-            return VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
-                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            return VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                   VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
                    VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
                    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
         case BufferUsage::Index:
-            return VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
-                   VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+            return VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                   VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
                    VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
                    VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
         case BufferUsage::Texture:
             return VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT;
         case BufferUsage::Staging:
+        case BufferUsage::Upload:
             return VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         case BufferUsage::Uniform:
             return VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
@@ -665,6 +667,7 @@ inline VkMemoryPropertyFlags Conv2MemFlags(const BufferUsage& m)
         case BufferUsage::Texture:
             return VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
         case BufferUsage::Staging:
+        case BufferUsage::Upload:
             return VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
         case BufferUsage::Uniform:
         case BufferUsage::SSBOHost:
@@ -696,6 +699,9 @@ inline VmaMemoryUsage Conv2VmaMemFlags(const BufferUsage& m)
             return VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
         case BufferUsage::Staging:
             return VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        case BufferUsage::Upload:
+            // Together with the sequential write flag VMA picks the mappable part of VRAM if there is one
+            return VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
         case BufferUsage::Uniform:
         case BufferUsage::SSBOHost:
             return VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
@@ -82,6 +82,8 @@ VkIndexType Conv(RayTracingIndexType type)
     {
         case RayTracingIndexType::UInt32:
             return VK_INDEX_TYPE_UINT32;
+        case RayTracingIndexType::UInt16:
+            return VK_INDEX_TYPE_UINT16;
         default:
             DEBUG_ASSERT(false);
             return VK_INDEX_TYPE_NONE_KHR;
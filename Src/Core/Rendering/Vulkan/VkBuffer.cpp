@@ -138,7 +138,7 @@ void GenBufferVulkan::MapAndCopyToMemory(const GPUMemoryHandle& memory, const vo
 
 void GenBufferVulkan::CheckCopyArgs(const void* data, u64 size, u64 offset)
 {
-    DEBUG_ASSERT(m_allocatedMemory != VK_NULL_HANDLE);
+    DEBUG_ASSERT(m_allocatedMemory != GPUMemoryHandle::Invalid);
     DEBUG_ASSERT(data != nullptr);
     DEBUG_ASSERT(m_info.size <= size);
 }
@@ -159,11 +159,11 @@ StagingBufferVulkan::StagingBufferVulkan(u64 size)
     Create(info);
 }
 
-void StagingBufferVulkan::CreatePersistentlyMapped(u64 size)
+void StagingBufferVulkan::CreatePersistentlyMapped(u64 size, BufferUsage usage)
 {
     BufferCreateInfo info{};
     info.size = size;
-    info.usage = BufferUsage::Staging;
+    info.usage = usage;
     Create(info);
     m_persistentMapping = MapMemory();
 }
@@ -220,7 +220,10 @@ IndirectDrawCommandBufferVulkan::IndirectDrawCommandBufferVulkan(u64 numOfComman
     info.size = sizeof(IndexedIndirectDrawCmd) * numOfCommands;
     info.usage = BufferUsage::IndirectDrawCmds;
     Create(info);
+    // Either index type may take the whole buffer, each list is sized for that on its own
     m_indexedIndirectCmds.reserve(numOfCommands);
+    m_indexed16IndirectCmds.reserve(numOfCommands);
+    m_maxDrawCmdCount = (u32)numOfCommands;
     // Will be reused and filled\mapped every frame so cheaper to just map forever
     m_mappedMemoryHandle = MapMemory();
 }
@@ -231,7 +234,10 @@ void IndirectDrawCommandBufferVulkan::Init(u64 numOfCommands)
     info.size = sizeof(IndexedIndirectDrawCmd) * numOfCommands;
     info.usage = BufferUsage::IndirectDrawCmds;
     Create(info);
+    // Either index type may take the whole buffer, each list is sized for that on its own
     m_indexedIndirectCmds.reserve(numOfCommands);
+    m_indexed16IndirectCmds.reserve(numOfCommands);
+    m_maxDrawCmdCount = (u32)numOfCommands;
     // Will be reused and filled\mapped every frame so cheaper to just map forever
     m_mappedMemoryHandle = MapMemory();
 }
@@ -249,15 +255,19 @@ void IndirectDrawCountBuffer::Init(u64 numOfCounts)
     Create(info);
 }
 
-void IndirectDrawCommandBufferVulkan::AddIndexedDrawCmd(
-    u32 indexCount, u32 instanceCount, u32 firstIndex, u32 vertexOffset, u32 firstInstance)
+void IndirectDrawCommandBufferVulkan::AddIndexedDrawCmd(u32 indexCount,
+                                                        u32 instanceCount,
+                                                        u32 firstIndex,
+                                                        u32 vertexOffset,
+                                                        u32 firstInstance,
+                                                        IndexType indexType)
 {
-    if (m_indexedIndirectCmds.capacity() == m_indexedIndirectCmds.size())
-    {
-        // Allocate enough space for all commands from the get go please
-        DEBUG_ASSERT(false);
-    }
-    m_indexedIndirectCmds.push_back({indexCount, instanceCount, firstIndex, (s32)vertexOffset, firstInstance});
+    auto& cmds = indexType == IndexType::UInt16 ? m_indexed16IndirectCmds : m_indexedIndirectCmds;
+    // Allocate enough space for all commands from the get go please
+    DEBUG_ASSERT(cmds.size() < cmds.capacity());
+    // Both lists are written into the same GPU buffer
+    DEBUG_ASSERT(GetDrawCmdNum() < m_maxDrawCmdCount);
+    cmds.push_back({indexCount, instanceCount, firstIndex, (s32)vertexOffset, firstInstance});
 }
 
 void IndirectDrawCommandBufferVulkan::FillCmds()
@@ -265,10 +275,14 @@ void IndirectDrawCommandBufferVulkan::FillCmds()
     memcpy((char*)m_mappedMemoryHandle,
            (void*)m_indexedIndirectCmds.data(),
            m_indexedIndirectCmds.size() * sizeof(IndexedIndirectDrawCmd));
+    memcpy((char*)m_mappedMemoryHandle + GetDrawCmdByteOffset(IndexType::UInt16),
+           (void*)m_indexed16IndirectCmds.data(),
+           m_indexed16IndirectCmds.size() * sizeof(IndexedIndirectDrawCmd));
 }
 
 void IndirectDrawCommandBufferVulkan::EmptyCmds()
 {
     m_indexedIndirectCmds.clear();
+    m_indexed16IndirectCmds.clear();
     // memcpy((char*)m_mappedMemoryHandle, (void*)0, m_info.size);
 }
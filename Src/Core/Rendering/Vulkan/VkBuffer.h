@@ -68,7 +68,7 @@ protected:
     void CheckCopyArgs(const void* data, u64 size, u64 offset);
     BufferInfo m_info{};
     VkBuffer m_buffer{VK_NULL_HANDLE};
-    GPUMemoryHandle m_allocatedMemory{VK_NULL_HANDLE};
+    GPUMemoryHandle m_allocatedMemory{GPUMemoryHandle::Invalid};
 };
 
 class VertexBufferVulkan : public GenBufferVulkan
@@ -104,7 +104,7 @@ public:
     StagingBufferVulkan() {}
     StagingBufferVulkan(u64 size);
 
-    void CreatePersistentlyMapped(u64 size);
+    void CreatePersistentlyMapped(u64 size, BufferUsage usage = BufferUsage::Staging);
     void CopyToMapped(const void* data, u64 size, u64 offset = 0);
     GPUMappedMemoryHandle GetPersistentMapping() const { return m_persistentMapping; }
 
@@ -134,20 +134,38 @@ public:
     }
 
     void Init(u64 numOfCommands);
-    void AddIndexedDrawCmd(u32 indexCount, u32 instanceCount, u32 firstIndex, u32 vertexOffset, u32 firstInstance);
-
+    void AddIndexedDrawCmd(u32 indexCount,
+                           u32 instanceCount,
+                           u32 firstIndex,
+                           u32 vertexOffset,
+                           u32 firstInstance,
+                           IndexType indexType = IndexType::UInt32);
+
+    // Writes all 32 bit index draws followed by all 16 bit ones so each type can be issued as one indirect range
     void FillCmds();
 
     void EmptyCmds();
 
     u32 GetDrawCmdNum() const
     {
-        return m_indexedIndirectCmds.size();
+        return m_indexedIndirectCmds.size() + m_indexed16IndirectCmds.size();
+    }
+
+    u32 GetDrawCmdNum(IndexType indexType) const
+    {
+        return indexType == IndexType::UInt16 ? m_indexed16IndirectCmds.size() : m_indexedIndirectCmds.size();
+    }
+
+    u32 GetDrawCmdByteOffset(IndexType indexType) const
+    {
+        return indexType == IndexType::UInt16 ? m_indexedIndirectCmds.size() * sizeof(IndexedIndirectDrawCmd) : 0;
     }
 
 protected:
     stltype::vector<IndexedIndirectDrawCmd> m_indexedIndirectCmds;
+    stltype::vector<IndexedIndirectDrawCmd> m_indexed16IndirectCmds;
     GPUMappedMemoryHandle m_mappedMemoryHandle;
+    u32 m_maxDrawCmdCount{0};
 };
 
 class IndirectDrawCountBuffer : public GenBufferVulkan
@@ -89,6 +89,8 @@ static VkIndexType Conv(RayTracingIndexType type)
     {
         case RayTracingIndexType::UInt32:
             return VK_INDEX_TYPE_UINT32;
+        case RayTracingIndexType::UInt16:
+            return VK_INDEX_TYPE_UINT16;
         default:
             DEBUG_ASSERT(false);
             return VK_INDEX_TYPE_NONE_KHR;
@@ -162,10 +164,15 @@ static void RecordCommand(CommandBase& cmd, CBufferVulkan& buffer)
 static void RecordCommand(BinRenderDataCmd& cmd, CBufferVulkan& buffer)
 {
     // Bind vertex and index buffers
-    VkBuffer vertexBuffer = cmd.vertexBuffer->GetRef();
-    VkDeviceSize offsets[] = {0};
-    vkCmdBindVertexBuffers(buffer.GetRef(), 0, 1, &vertexBuffer, offsets);
-    vkCmdBindIndexBuffer(buffer.GetRef(), cmd.indexBuffer->GetRef(), 0, VK_INDEX_TYPE_UINT32);
+    const VkBuffer vertexBuffers[] = {cmd.vertexBuffer->GetRef(),
+                                      cmd.attributeBuffer ? cmd.attributeBuffer->GetRef() : VK_NULL_HANDLE};
+    const VkDeviceSize offsets[] = {0, 0};
+    const u32 bindingCount = cmd.attributeBuffer ? 2 : 1;
+    vkCmdBindVertexBuffers(buffer.GetRef(), 0, bindingCount, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(buffer.GetRef(),
+                         cmd.indexBuffer->GetRef(),
+                         0,
+                         cmd.indexType == IndexType::UInt16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
 }
 
 static void RecordCommand(PushConstantCmd& cmd, CBufferVulkan& buffer)
@@ -1,27 +1,22 @@
 #define VMA_IMPLEMENTATION
 #include "VkGPUMemoryManager.h"
 #include "BackendDefines.h"
+#include "Core/Global/Profiling.h"
 #include "Utils/VkEnumHelpers.h"
 #include "VkGlobals.h"
 #include "vk_mem_alloc.h"
+#include <EASTL/chrono.h>
+#include <bit>
 
 // Don't want to include the VMA header in the header file, so we define it here
 static inline VmaAllocator s_vmaAllocator;
 
-struct DetailedAllocationData
-{
-    GPUMemoryHandle memoryHandle;
-    VmaAllocation vmaAllocation;
-    VkBuffer bufferHandle{VK_NULL_HANDLE};
-    VkImage imageHandle{VK_NULL_HANDLE};
-};
-stltype::vector<DetailedAllocationData> s_memoryHandles{};
-
 inline bool NeedsMappableHandle(const BufferUsage& m)
 {
     switch (m)
     {
         case BufferUsage::Staging:
+        case BufferUsage::Upload:
         case BufferUsage::Uniform:
         case BufferUsage::SSBOHost:
         case BufferUsage::IndirectDrawCmds:
@@ -33,9 +28,114 @@ inline bool NeedsMappableHandle(const BufferUsage& m)
     return false;
 }
 
+// Device memory block size per category, anything above half a block gets a dedicated allocation
+static constexpr u64 s_convBlockSizes[(u32)GPUMemoryCategory::Count] = {
+    128ull * 1024 * 1024, 64ull * 1024 * 1024, 32ull * 1024 * 1024, 256ull * 1024 * 1024, 0};
+// Default soft budget per category as a share of the device local memory
+static constexpr f32 s_convBudgetShares[(u32)GPUMemoryCategory::Count] = {0.25f, 0.15f, 0.1f, 0.5f, 0.25f};
+static constexpr u32 s_invalidConvSlot = ~0u;
+static constexpr u32 s_maxBufferAllocationHistory = 65536;
+// Bounds of the sample RunAllocatorBenchmark replays, every buffer of it is allocated at once
+static constexpr u32 s_maxBenchmarkAllocations = 4096;
+static constexpr u64 s_maxBenchmarkBytes = 256ull * 1024 * 1024;
+
+// Handles aren't pointers to anything, they pack the record slot and its generation so lookups index the slot map
+static GPUMemoryHandle EncodeAllocationHandle(u32 slot, u32 generation)
+{
+    return (GPUMemoryHandle)(((u64)generation << 32) | (u64)(slot + 1));
+}
+
+static u32 GetAllocationHandleSlot(GPUMemoryHandle handle)
+{
+    return (u32)((u64)handle & 0xFFFFFFFFull) - 1;
+}
+
+static u32 GetAllocationHandleGeneration(GPUMemoryHandle handle)
+{
+    return (u32)((u64)handle >> 32);
+}
+
+static GPUMemoryCategory GetConvolutionBufferCategory(BufferUsage usage)
+{
+    if (usage == BufferUsage::Vertex || usage == BufferUsage::Index)
+        return GPUMemoryCategory::Geometry;
+    return NeedsMappableHandle(usage) ? GPUMemoryCategory::HostUpload : GPUMemoryCategory::Buffers;
+}
+
+static void GetConvolutionBufferMemoryFlags(BufferUsage usage,
+                                            VkMemoryPropertyFlags& requiredFlags,
+                                            VkMemoryPropertyFlags& preferredFlags)
+{
+    constexpr VkMemoryPropertyFlags hostFlags =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    switch (usage)
+    {
+        // Same as VMA's CPU_TO_GPU, debug geometry gets filled through a mapping
+        case BufferUsage::Vertex:
+        case BufferUsage::Index:
+        case BufferUsage::Upload:
+            requiredFlags = hostFlags;
+            preferredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            return;
+        default:
+            break;
+    }
+    requiredFlags = NeedsMappableHandle(usage) ? hostFlags : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    preferredFlags = 0;
+}
+
+struct ConvolutionMemoryTypeCandidates
+{
+    u32 types[VK_MAX_MEMORY_TYPES]{};
+    u32 count{0};
+};
+
+// Every memory type meeting the required flags, the ones with the most preferred flags first. Device local memory
+// nobody asked for sorts last so small mappable VRAM heaps are left to the allocations that want them
+static ConvolutionMemoryTypeCandidates GetConvolutionMemoryTypes(u32 typeBits,
+                                                                 VkMemoryPropertyFlags requiredFlags,
+                                                                 VkMemoryPropertyFlags preferredFlags)
+{
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    const VkMemoryPropertyFlags avoidedFlags =
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT & ~(requiredFlags | preferredFlags);
+
+    ConvolutionMemoryTypeCandidates candidates{};
+    s32 scores[VK_MAX_MEMORY_TYPES]{};
+    for (u32 i = 0; i < memProps.memoryTypeCount; ++i)
+    {
+        const VkMemoryPropertyFlags flags = memProps.memoryTypes[i].propertyFlags;
+        if ((typeBits & (1u << i)) == 0 || (flags & requiredFlags) != requiredFlags)
+            continue;
+
+        // Insertion keeps equal scores in the driver's order, which already lists the faster types first
+        const s32 score = 2 + 2 * std::popcount(flags & preferredFlags) - std::popcount(flags & avoidedFlags);
+        u32 insertAt = candidates.count;
+        while (insertAt > 0 && scores[insertAt - 1] < score)
+        {
+            scores[insertAt] = scores[insertAt - 1];
+            candidates.types[insertAt] = candidates.types[insertAt - 1];
+            --insertAt;
+        }
+        scores[insertAt] = score;
+        candidates.types[insertAt] = i;
+        ++candidates.count;
+    }
+    return candidates;
+}
+
+static bool IsHostVisibleMemoryType(u32 memoryTypeIdx)
+{
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    return (memProps.memoryTypes[memoryTypeIdx].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
 void GPUMemManager<Vulkan>::Init(Allocator allocatorMode)
 {
     m_allocatorMode = allocatorMode;
+    for (u32 i = 0; i < (u32)GPUMemoryCategory::Count; ++i)
+        m_spareConvBlocks[i] = s_invalidConvSlot;
+
     if (allocatorMode == Allocator::VMA)
     {
         EnsureInitialized();
@@ -46,26 +146,80 @@ void GPUMemManager<Vulkan>::Init(Allocator allocatorMode)
     }
     else
     {
-        DEBUG_ASSERT(false);
+        // Blocks get created on demand, only the budgets need the device
+        const u64 totalVram = VkGlobals::GetTotalVram();
+        for (u32 i = 0; i < (u32)GPUMemoryCategory::Count; ++i)
+            m_categoryStats[i].budgetBytes = (u64)((f64)totalVram * s_convBudgetShares[i]);
     }
 }
 
 void GPUMemManager<Vulkan>::FreeMemory(GPUMemoryHandle memory)
 {
-    const auto it = std::find_if(s_memoryHandles.begin(),
-                                 s_memoryHandles.end(),
-                                 [&memory](const auto& elem) { return elem.memoryHandle == memory; });
-    if (it == s_memoryHandles.end())
+    AllocationRecord* pRecord = ResolveHandle(memory);
+    if (pRecord == nullptr)
         return;
-    if (it->bufferHandle != VK_NULL_HANDLE)
+
+    if (pRecord->vmaAllocation == VK_NULL_HANDLE)
     {
-        vmaDestroyBuffer(s_vmaAllocator, it->bufferHandle, it->vmaAllocation);
+        FreeConvolutionMemory(*pRecord);
     }
-    else if (it->imageHandle != VK_NULL_HANDLE)
+    else
     {
-        vmaDestroyImage(s_vmaAllocator, it->imageHandle, it->vmaAllocation);
+        // VMA refuses to destroy allocations that are still mapped
+        for (; pRecord->mapCount > 0; --pRecord->mapCount)
+            vmaUnmapMemory(s_vmaAllocator, pRecord->vmaAllocation);
+
+        if (pRecord->buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(s_vmaAllocator, pRecord->buffer, pRecord->vmaAllocation);
+        }
+        else if (pRecord->image != VK_NULL_HANDLE)
+        {
+            vmaDestroyImage(s_vmaAllocator, pRecord->image, pRecord->vmaAllocation);
+        }
     }
-    s_memoryHandles.erase(it);
+    ReleaseAllocationRecord(memory);
+}
+
+GPUMemoryHandle GPUMemManager<Vulkan>::AddAllocationRecord(const AllocationRecord& record)
+{
+    u32 slot;
+    if (m_freeAllocationSlots.empty() == false)
+    {
+        slot = m_freeAllocationSlots.back();
+        m_freeAllocationSlots.pop_back();
+    }
+    else
+    {
+        slot = (u32)m_allocations.size();
+        m_allocations.emplace_back();
+    }
+
+    const u32 generation = m_allocations[slot].generation;
+    m_allocations[slot] = record;
+    m_allocations[slot].generation = generation;
+    m_allocations[slot].isLive = true;
+    return EncodeAllocationHandle(slot, generation);
+}
+
+void GPUMemManager<Vulkan>::ReleaseAllocationRecord(GPUMemoryHandle memoryHandle)
+{
+    const u32 slot = GetAllocationHandleSlot(memoryHandle);
+    const u32 generation = m_allocations[slot].generation + 1;
+    m_allocations[slot] = AllocationRecord{};
+    m_allocations[slot].generation = generation;
+    m_freeAllocationSlots.push_back(slot);
+}
+
+GPUMemManager<Vulkan>::AllocationRecord* GPUMemManager<Vulkan>::ResolveHandle(GPUMemoryHandle memoryHandle)
+{
+    const u32 slot = GetAllocationHandleSlot(memoryHandle);
+    if (memoryHandle == GPUMemoryHandle::Invalid || slot >= m_allocations.size())
+        return nullptr;
+    auto& record = m_allocations[slot];
+    if (record.isLive == false || record.generation != GetAllocationHandleGeneration(memoryHandle))
+        return nullptr;
+    return &record;
 }
 
 void GPUMemManager<Vulkan>::InitializeVMA()
@@ -89,44 +243,38 @@ void GPUMemManager<Vulkan>::InitializeVMA()
 GPUMemManager<Vulkan>::~GPUMemManager()
 {
     SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
-    for (auto& handle : s_memoryHandles)
+    for (auto& record : m_allocations)
     {
-        if (m_allocatorMode != Allocator::VMA)
-        {
-            /*
-            UnmapMemory(handle);
-            vkFreeMemory(VK_LOGICAL_DEVICE, handle, VulkanAllocator());
-            */
-            DEBUG_ASSERT(false);
-        }
+        if (record.isLive == false)
+            continue;
 
-        // Unmap all mapped memory, otherwise leads to errors
-        bool wasMapped = true;
-        while (wasMapped)
+        if (record.vmaAllocation != VK_NULL_HANDLE)
         {
-            SimpleScopedGuard<CustomMutex> lock(m_mappingMutex);
-            auto mapped_it = std::find(m_mappedMemoryHandles.begin(), m_mappedMemoryHandles.end(), handle.memoryHandle);
-            if (mapped_it != m_mappedMemoryHandles.end())
-            {
-                vmaUnmapMemory(s_vmaAllocator, *mapped_it);
-                m_mappedMemoryHandles.erase(mapped_it);
-            }
-            else
-            {
-                wasMapped = false;
-            }
+            // Unmap all mapped memory, otherwise leads to errors
+            for (; record.mapCount > 0; --record.mapCount)
+                vmaUnmapMemory(s_vmaAllocator, record.vmaAllocation);
+
+            if (record.buffer != VK_NULL_HANDLE)
+                vmaDestroyBuffer(s_vmaAllocator, record.buffer, record.vmaAllocation);
+            else if (record.image != VK_NULL_HANDLE)
+                vmaDestroyImage(s_vmaAllocator, record.image, record.vmaAllocation);
+            continue;
         }
 
-        if (handle.bufferHandle != VK_NULL_HANDLE)
-        {
-            vmaDestroyBuffer(s_vmaAllocator, handle.bufferHandle, handle.vmaAllocation);
-        }
-        else if (handle.imageHandle != VK_NULL_HANDLE)
-        {
-            vmaDestroyImage(s_vmaAllocator, handle.imageHandle, handle.vmaAllocation);
-        }
+        if (record.buffer != VK_NULL_HANDLE)
+            vkDestroyBuffer(VK_LOGICAL_DEVICE, record.buffer, VulkanAllocator());
+        else if (record.image != VK_NULL_HANDLE)
+            vkDestroyImage(VK_LOGICAL_DEVICE, record.image, VulkanAllocator());
+        if (record.blockIdx == s_invalidConvSlot)
+            FreeDeviceMemory(record.memory, record.size, record.memoryTypeIdx);
+    }
+    m_allocations.clear();
+    m_freeAllocationSlots.clear();
+    for (u32 i = 0; i < m_convBlocks.size(); ++i)
+    {
+        if (m_convBlocks[i].memory != VK_NULL_HANDLE)
+            ReleaseConvolutionBlock(i);
     }
-    s_memoryHandles.clear();
     FreeVMA();
 }
 
@@ -151,13 +299,24 @@ GPUMemoryHandle GPUMemManager<Vulkan>::AllocateMemory(size_t size,
     // m_allocatinggMutex.Unlock();
 
     // return memory;
-    return VK_NULL_HANDLE;
+    return GPUMemoryHandle::Invalid;
 }
 
 GPUMemoryHandle GPUMemManager<Vulkan>::AllocateBuffer(BufferUsage usage,
                                                       VkBufferCreateInfo bufferInfo,
                                                       VkBuffer& bufferToCreate)
 {
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        if (m_bufferAllocationHistory.size() < s_maxBufferAllocationHistory)
+            m_bufferAllocationHistory.emplace_back(usage, (u64)bufferInfo.size);
+        if (m_allocatorMode == Allocator::Convolution)
+        {
+            const GPUMemoryHandle handle = AllocateConvolutionBuffer(usage, bufferInfo, bufferToCreate);
+            DEBUG_ASSERT(handle != GPUMemoryHandle::Invalid);
+            return handle;
+        }
+    }
     if (m_allocatorMode != Allocator::VMA)
     {
         DEBUG_ASSERT(false);
@@ -165,22 +324,40 @@ GPUMemoryHandle GPUMemManager<Vulkan>::AllocateBuffer(BufferUsage usage,
     EnsureInitialized();
     DEBUG_ASSERT(s_vmaAllocator != nullptr && "VMA allocator is null! Allocation early?");
     SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+    const GPUMemoryHandle handle = AllocateVMABuffer(usage, bufferInfo, bufferToCreate);
+    DEBUG_ASSERT(handle != GPUMemoryHandle::Invalid);
+    return handle;
+}
+
+GPUMemoryHandle GPUMemManager<Vulkan>::AllocateVMABuffer(BufferUsage usage,
+                                                         const VkBufferCreateInfo& bufferInfo,
+                                                         VkBuffer& bufferToCreate)
+{
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = Conv2VmaMemFlags(usage);
     allocInfo.flags = NeedsMappableHandle(usage) ? VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT : 0;
 
-    DetailedAllocationData allocation;
-    VkResult result = vmaCreateBuffer(
-            s_vmaAllocator, &bufferInfo, &allocInfo, &allocation.bufferHandle, &allocation.vmaAllocation, nullptr);
-    DEBUG_ASSERT(result == VK_SUCCESS);
-    bufferToCreate = allocation.bufferHandle;
-    allocation.memoryHandle = allocation.vmaAllocation; // Store the allocation handle
-    s_memoryHandles.push_back(allocation);
-    return allocation.vmaAllocation;
+    AllocationRecord record{};
+    VkResult result =
+        vmaCreateBuffer(s_vmaAllocator, &bufferInfo, &allocInfo, &record.buffer, &record.vmaAllocation, nullptr);
+    bufferToCreate = record.buffer;
+    if (result != VK_SUCCESS)
+    {
+        DEBUG_LOGF("[GPUMemManager] VMA failed to create a buffer of {} bytes: {}", (u64)bufferInfo.size, (s32)result);
+        bufferToCreate = VK_NULL_HANDLE;
+        return GPUMemoryHandle::Invalid;
+    }
+    record.size = bufferInfo.size;
+    return AddAllocationRecord(record);
 }
 
 GPUMemoryHandle GPUMemManager<Vulkan>::AllocateImage(VkImageCreateInfo imageInfo, VkImage& imageToCreate)
 {
+    if (m_allocatorMode == Allocator::Convolution)
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        return AllocateConvolutionImage(imageInfo, imageToCreate);
+    }
     if (m_allocatorMode != Allocator::VMA)
     {
         DEBUG_ASSERT(false);
@@ -191,20 +368,18 @@ GPUMemoryHandle GPUMemManager<Vulkan>::AllocateImage(VkImageCreateInfo imageInfo
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
 
-    DetailedAllocationData allocation;
+    AllocationRecord record{};
     
     if (s_vmaAllocator == VK_NULL_HANDLE) {
         DEBUG_LOGF("[GPUMemManager] CRITICAL: s_vmaAllocator is NULL!");
     }
 
-    VkResult result = vmaCreateImage(
-            s_vmaAllocator, &imageInfo, &allocInfo, &allocation.imageHandle, &allocation.vmaAllocation, nullptr);
+    VkResult result =
+        vmaCreateImage(s_vmaAllocator, &imageInfo, &allocInfo, &record.image, &record.vmaAllocation, nullptr);
             
     DEBUG_ASSERT(result == VK_SUCCESS);
-    imageToCreate = allocation.imageHandle;
-    allocation.memoryHandle = allocation.vmaAllocation; // Store the allocation handle
-    s_memoryHandles.push_back(allocation);
-    return allocation.vmaAllocation;
+    imageToCreate = record.image;
+    return AddAllocationRecord(record);
 }
 
 u32 GPUMemManager<Vulkan>::GetMemoryTypeIndex(VkMemoryPropertyFlags properties, u32 filter)
@@ -226,39 +401,43 @@ u32 GPUMemManager<Vulkan>::GetMemoryTypeIndex(VkMemoryPropertyFlags properties,
 
 GPUMappedMemoryHandle GPUMemManager<Vulkan>::MapMemory(GPUMemoryHandle memory, size_t size)
 {
-    SimpleScopedGuard<CustomMutex> allocGuard(m_allocatinggMutex);
-    SimpleScopedGuard<CustomMutex> mapGuard(m_mappingMutex);
-    const auto it = std::find_if(s_memoryHandles.begin(),
-                                 s_memoryHandles.end(),
-                                 [&memory](const auto& elem) { return elem.memoryHandle == memory; });
-    DEBUG_ASSERT(it != s_memoryHandles.end());
+    SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+    AllocationRecord* pRecord = ResolveHandle(memory);
+    DEBUG_ASSERT(pRecord != nullptr);
+    if (pRecord == nullptr)
+        return nullptr;
+
+    // Host visible Convolution blocks stay mapped for their whole lifetime
+    if (pRecord->vmaAllocation == VK_NULL_HANDLE)
+    {
+        DEBUG_ASSERT(pRecord->pMapped != nullptr);
+        return pRecord->pMapped;
+    }
+
     GPUMappedMemoryHandle data;
-    VkResult result = vmaMapMemory(s_vmaAllocator, it->vmaAllocation, &data);
+    VkResult result = vmaMapMemory(s_vmaAllocator, pRecord->vmaAllocation, &data);
     DEBUG_ASSERT(result == VK_SUCCESS);
-    m_mappedMemoryHandles.push_back(memory);
+    ++pRecord->mapCount;
     return data;
 }
 
 void GPUMemManager<Vulkan>::UnmapMemory(GPUMemoryHandle memory)
 {
-    SimpleScopedGuard<CustomMutex> lock(m_mappingMutex);
-    auto mapped_it = std::find(m_mappedMemoryHandles.begin(), m_mappedMemoryHandles.end(), memory);
+    SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+    AllocationRecord* pRecord = ResolveHandle(memory);
+    if (pRecord == nullptr || pRecord->vmaAllocation == VK_NULL_HANDLE || pRecord->mapCount == 0)
+        return;
 
-    if (mapped_it != m_mappedMemoryHandles.end())
-    {
-        // vkUnmapMemory(VK_LOGICAL_DEVICE, *it);
-        vmaUnmapMemory(s_vmaAllocator, *mapped_it);
-        m_mappedMemoryHandles.erase(mapped_it);
-    }
+    vmaUnmapMemory(s_vmaAllocator, pRecord->vmaAllocation);
+    --pRecord->mapCount;
 }
 
 void GPUMemManager<Vulkan>::TryFreeMemory(GPUMemoryHandle memory)
 {
     SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
-    if (memory != VK_NULL_HANDLE)
+    if (memory != GPUMemoryHandle::Invalid)
     {
-        UnmapMemory(memory);
-        // vkFreeMemory(VK_LOGICAL_DEVICE, memoryHandle, VulkanAllocator());
+        // Unmaps whatever is still mapped itself
         FreeMemory(memory);
     }
 }
@@ -266,10 +445,12 @@ void GPUMemManager<Vulkan>::TryFreeMemory(GPUMemoryHandle memory)
 void GPUMemManager<Vulkan>::BindImageMemory(GPUMemoryHandle handle)
 {
     SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
-    const auto it = std::find_if(s_memoryHandles.begin(),
-                                 s_memoryHandles.end(),
-                                 [&handle](const auto& elem) { return elem.memoryHandle == handle; });
-    DEBUG_ASSERT(vmaBindImageMemory(s_vmaAllocator, it->vmaAllocation, it->imageHandle) == VK_SUCCESS);
+    const AllocationRecord* pRecord = ResolveHandle(handle);
+    DEBUG_ASSERT(pRecord != nullptr);
+    // Convolution images are bound right when they're allocated
+    if (pRecord == nullptr || pRecord->vmaAllocation == VK_NULL_HANDLE)
+        return;
+    DEBUG_ASSERT(vmaBindImageMemory(s_vmaAllocator, pRecord->vmaAllocation, pRecord->image) == VK_SUCCESS);
 }
 
 void GPUMemManager<Vulkan>::FreeVMA()
@@ -281,10 +462,20 @@ void GPUMemManager<Vulkan>::GetVramStats(u64& total, u64& used)
 {
     total = VkGlobals::GetTotalVram();
     used = 0;
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    if (m_allocatorMode == Allocator::Convolution)
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        for (u32 i = 0; i < memProps.memoryHeapCount; ++i)
+        {
+            if (memProps.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+                used += m_convHeapUsage[i];
+        }
+        return;
+    }
     if (m_allocatorMode != Allocator::VMA || s_vmaAllocator == VK_NULL_HANDLE)
         return;
 
-    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
 
     VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
     vmaGetHeapBudgets(s_vmaAllocator, budgets);
@@ -298,6 +489,42 @@ void GPUMemManager<Vulkan>::GetVramStats(u64& total, u64& used)
     }
 }
 
+void GPUMemManager<Vulkan>::GetVramBudget(u64& budget, u64& usage)
+{
+    budget = 0;
+    usage = 0;
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    if (m_allocatorMode == Allocator::Convolution)
+    {
+        // Same estimate VMA falls back to without the memory budget extension
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        for (u32 i = 0; i < memProps.memoryHeapCount; ++i)
+        {
+            if (memProps.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            {
+                budget += memProps.memoryHeaps[i].size * 8 / 10;
+                usage += m_convHeapUsage[i];
+            }
+        }
+        return;
+    }
+    if (m_allocatorMode != Allocator::VMA || s_vmaAllocator == VK_NULL_HANDLE)
+        return;
+
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(s_vmaAllocator, budgets);
+
+    for (u32 i = 0; i < memProps.memoryHeapCount; ++i)
+    {
+        if (memProps.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+        {
+            budget += budgets[i].budget;
+            usage += budgets[i].usage;
+        }
+    }
+}
+
 void GPUMemManager<Vulkan>::EnsureInitialized()
 {
     if (m_allocatorMode != Allocator::VMA || m_isInitialized || s_vmaAllocator != nullptr)
@@ -306,3 +533,488 @@ void GPUMemManager<Vulkan>::EnsureInitialized()
     InitializeVMA();
     m_isInitialized = true;
 }
+
+void GPUMemManager<Vulkan>::SetCategoryBudget(GPUMemoryCategory category, u64 budgetBytes)
+{
+    SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+    m_categoryStats[(u32)category].budgetBytes = budgetBytes;
+}
+
+GPUMemoryCategoryStats GPUMemManager<Vulkan>::GetCategoryStats(GPUMemoryCategory category)
+{
+    SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+    GPUMemoryCategoryStats stats = m_categoryStats[(u32)category];
+    for (const auto& block : m_convBlocks)
+    {
+        if (block.memory == VK_NULL_HANDLE || block.category != category)
+            continue;
+        stats.freeBytes += block.allocator.GetFreeBytes();
+        stats.largestFreeBlock = stltype::max(stats.largestFreeBlock, block.allocator.GetLargestFreeBlock());
+        stats.freeRangeCount += block.allocator.GetFreeBlockCount();
+    }
+    return stats;
+}
+
+GPUAllocatorBenchmark GPUMemManager<Vulkan>::RunAllocatorBenchmark(u32 iterations)
+{
+    ScopedZone("GPUMemManager::Run Allocator Benchmark");
+    using Clock = stltype::chrono::steady_clock;
+    const auto elapsedMs = [](Clock::time_point start)
+    {
+        return stltype::chrono::duration<f64, stltype::chrono::milliseconds::period>(Clock::now() - start).count();
+    };
+    iterations = stltype::max(iterations, 1u);
+
+    // Replaying the whole history at once needs the memory of every buffer ever created on top of everything live,
+    // an evenly strided sample bounded in count and bytes keeps the size distribution without that
+    GPUAllocatorBenchmark result{};
+    stltype::vector<stltype::pair<BufferUsage, u64>> sample;
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        const u32 historySize = (u32)m_bufferAllocationHistory.size();
+        const u32 stride = stltype::max((historySize + s_maxBenchmarkAllocations - 1) / s_maxBenchmarkAllocations, 1u);
+        u64 sampleBytes = 0;
+        for (u32 i = 0; i < historySize; i += stride)
+        {
+            const auto& entry = m_bufferAllocationHistory[i];
+            if (sampleBytes + entry.second > s_maxBenchmarkBytes)
+                continue;
+            sampleBytes += entry.second;
+            sample.push_back(entry);
+        }
+        if (sample.empty())
+            return result;
+        if (s_vmaAllocator == VK_NULL_HANDLE)
+            InitializeVMA();
+    }
+    result.allocationCount = (u32)sample.size();
+
+    const auto makeBufferInfo = [&sample](u32 i)
+    {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = sample[i].second;
+        bufferInfo.usage = Conv(sample[i].first);
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        return bufferInfo;
+    };
+
+    // Every phase takes the lock on its own so the renderer can allocate in between, returns false once an
+    // allocation ran out of memory
+    const auto runPhase = [&](u32 first, u32 step, auto&& op, f64& phaseMs)
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        const auto start = Clock::now();
+        bool succeeded = true;
+        for (u32 i = first; i < result.allocationCount && succeeded; i += step)
+            succeeded = op(i);
+        phaseMs += elapsedMs(start);
+        return succeeded;
+    };
+
+    // Load everything, stream every other buffer out and back in like a partial level swap, then unload everything
+    // Returns false if it ran out of memory, whatever was allocated by then is freed again
+    const auto runChurn = [&](auto&& allocate, auto&& release, f64& allocateMs, f64& freeMs)
+    {
+        bool succeeded = true;
+        for (u32 it = 0; it < iterations && succeeded; ++it)
+        {
+            succeeded = runPhase(0, 1, allocate, allocateMs) && runPhase(0, 2, release, freeMs) &&
+                        runPhase(0, 2, allocate, allocateMs) && runPhase(0, 1, release, freeMs);
+        }
+        if (succeeded == false)
+        {
+            f64 cleanupMs = 0.0;
+            runPhase(0, 1, release, cleanupMs);
+            return false;
+        }
+        allocateMs /= iterations;
+        freeMs /= iterations;
+        return true;
+    };
+
+    // Both paths go through the handle table, so only the allocators themselves differ
+    stltype::vector<GPUMemoryHandle> handles(result.allocationCount, GPUMemoryHandle::Invalid);
+    const auto release = [&](u32 i)
+    {
+        FreeMemory(handles[i]);
+        handles[i] = GPUMemoryHandle::Invalid;
+        return true;
+    };
+    const bool vmaSucceeded = runChurn(
+        [&](u32 i)
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            handles[i] = AllocateVMABuffer(sample[i].first, makeBufferInfo(i), buffer);
+            return handles[i] != GPUMemoryHandle::Invalid;
+        },
+        release,
+        result.vmaAllocateMs,
+        result.vmaFreeMs);
+    result.vmaOutOfMemory = vmaSucceeded == false;
+
+    const bool convolutionSucceeded = runChurn(
+        [&](u32 i)
+        {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            handles[i] = AllocateConvolutionBuffer(sample[i].first, makeBufferInfo(i), buffer);
+            return handles[i] != GPUMemoryHandle::Invalid;
+        },
+        release,
+        result.convolutionAllocateMs,
+        result.convolutionFreeMs);
+    result.convolutionOutOfMemory = convolutionSucceeded == false;
+
+    // Nothing else uses the blocks the replay created when the Convolution allocator isn't active
+    {
+        SimpleScopedGuard<CustomMutex> lock(m_allocatinggMutex);
+        if (m_allocatorMode != Allocator::Convolution)
+        {
+            for (u32 i = 0; i < (u32)GPUMemoryCategory::Count; ++i)
+            {
+                if (m_spareConvBlocks[i] != s_invalidConvSlot)
+                    ReleaseConvolutionBlock(m_spareConvBlocks[i]);
+                m_spareConvBlocks[i] = s_invalidConvSlot;
+                m_categoryStats[i] = GPUMemoryCategoryStats{};
+            }
+        }
+    }
+
+    DEBUG_LOGF("[GPUMemManager] {} buffers: VMA {:.3f} ms alloc, {:.3f} ms free{}; Convolution {:.3f} ms alloc, "
+               "{:.3f} ms free{}",
+               result.allocationCount,
+               result.vmaAllocateMs,
+               result.vmaFreeMs,
+               result.vmaOutOfMemory ? " (out of memory)" : "",
+               result.convolutionAllocateMs,
+               result.convolutionFreeMs,
+               result.convolutionOutOfMemory ? " (out of memory)" : "");
+    return result;
+}
+
+GPUMemoryHandle GPUMemManager<Vulkan>::AllocateConvolutionBuffer(BufferUsage usage,
+                                                                 const VkBufferCreateInfo& bufferInfo,
+                                                                 VkBuffer& bufferToCreate)
+{
+    VkResult result = vkCreateBuffer(VK_LOGICAL_DEVICE, &bufferInfo, VulkanAllocator(), &bufferToCreate);
+    if (result != VK_SUCCESS)
+    {
+        DEBUG_LOGF("[GPUMemManager] Failed to create a buffer of {} bytes: {}", (u64)bufferInfo.size, (s32)result);
+        bufferToCreate = VK_NULL_HANDLE;
+        return GPUMemoryHandle::Invalid;
+    }
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(VK_LOGICAL_DEVICE, bufferToCreate, &requirements);
+    VkMemoryPropertyFlags requiredFlags, preferredFlags;
+    GetConvolutionBufferMemoryFlags(usage, requiredFlags, preferredFlags);
+
+    const GPUMemoryHandle handle = AllocateConvolutionMemory(
+        GetConvolutionBufferCategory(usage), requirements, requiredFlags, preferredFlags, false);
+    if (handle == GPUMemoryHandle::Invalid)
+    {
+        vkDestroyBuffer(VK_LOGICAL_DEVICE, bufferToCreate, VulkanAllocator());
+        bufferToCreate = VK_NULL_HANDLE;
+        return GPUMemoryHandle::Invalid;
+    }
+
+    AllocationRecord& record = *ResolveHandle(handle);
+    result = vkBindBufferMemory(VK_LOGICAL_DEVICE, bufferToCreate, record.memory, record.offset);
+    DEBUG_ASSERT(result == VK_SUCCESS);
+    record.buffer = bufferToCreate;
+    return handle;
+}
+
+GPUMemoryHandle GPUMemManager<Vulkan>::AllocateConvolutionImage(const VkImageCreateInfo& imageInfo,
+                                                                VkImage& imageToCreate)
+{
+    VkResult result = vkCreateImage(VK_LOGICAL_DEVICE, &imageInfo, VulkanAllocator(), &imageToCreate);
+    DEBUG_ASSERT(result == VK_SUCCESS);
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(VK_LOGICAL_DEVICE, imageToCreate, &requirements);
+
+    constexpr VkImageUsageFlags renderTargetUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT |
+                                                    VK_IMAGE_USAGE_STORAGE_BIT;
+    const GPUMemoryCategory category =
+        (imageInfo.usage & renderTargetUsage) ? GPUMemoryCategory::RenderTargets : GPUMemoryCategory::Textures;
+    // Linear images can't share a block with optimal ones without buffer image granularity padding
+    const bool isDedicated =
+        category == GPUMemoryCategory::RenderTargets || imageInfo.tiling != VK_IMAGE_TILING_OPTIMAL;
+
+    const GPUMemoryHandle handle =
+        AllocateConvolutionMemory(category, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, isDedicated);
+    if (handle == GPUMemoryHandle::Invalid)
+    {
+        vkDestroyImage(VK_LOGICAL_DEVICE, imageToCreate, VulkanAllocator());
+        imageToCreate = VK_NULL_HANDLE;
+        DEBUG_ASSERT(false);
+        return GPUMemoryHandle::Invalid;
+    }
+
+    AllocationRecord& record = *ResolveHandle(handle);
+    result = vkBindImageMemory(VK_LOGICAL_DEVICE, imageToCreate, record.memory, record.offset);
+    DEBUG_ASSERT(result == VK_SUCCESS);
+    record.image = imageToCreate;
+    return handle;
+}
+
+GPUMemoryHandle GPUMemManager<Vulkan>::AllocateConvolutionMemory(GPUMemoryCategory category,
+                                                                 const VkMemoryRequirements& requirements,
+                                                                 VkMemoryPropertyFlags requiredFlags,
+                                                                 VkMemoryPropertyFlags preferredFlags,
+                                                                 bool isDedicated)
+{
+    const ConvolutionMemoryTypeCandidates candidates =
+        GetConvolutionMemoryTypes(requirements.memoryTypeBits, requiredFlags, preferredFlags);
+    if (candidates.count == 0)
+    {
+        DEBUG_LOGF("[GPUMemManager] No memory type for {} allocation of {} bytes",
+                   GetGPUMemoryCategoryName(category),
+                   (u64)requirements.size);
+        return GPUMemoryHandle::Invalid;
+    }
+
+    const u64 blockSize = s_convBlockSizes[(u32)category];
+    isDedicated = isDedicated || requirements.size > blockSize / 2;
+
+    // A full heap only rules out its own memory types, e.g. vertex data falls back from a small BAR heap to
+    // plain host memory
+    for (u32 i = 0; i < candidates.count; ++i)
+    {
+        AllocationRecord allocation{};
+        const VkResult result =
+            AllocateConvolutionMemoryInType(category, requirements, candidates.types[i], isDedicated, allocation);
+        if (result == VK_SUCCESS)
+        {
+            TrackConvolutionAllocation(category, requirements.size);
+            return AddAllocationRecord(allocation);
+        }
+        if (result != VK_ERROR_OUT_OF_DEVICE_MEMORY)
+            return GPUMemoryHandle::Invalid;
+        if (i + 1 < candidates.count)
+        {
+            DEBUG_LOG_WARNF("[GPUMemManager] Memory type {} is full, falling back to type {} for {} allocation",
+                            candidates.types[i],
+                            candidates.types[i + 1],
+                            GetGPUMemoryCategoryName(category));
+        }
+    }
+
+    DEBUG_LOGF("[GPUMemManager] Every memory type is out of memory for {} allocation of {} bytes",
+               GetGPUMemoryCategoryName(category),
+               (u64)requirements.size);
+    return GPUMemoryHandle::Invalid;
+}
+
+VkResult GPUMemManager<Vulkan>::AllocateConvolutionMemoryInType(GPUMemoryCategory category,
+                                                                const VkMemoryRequirements& requirements,
+                                                                u32 memoryTypeIdx,
+                                                                bool isDedicated,
+                                                                AllocationRecord& allocation)
+{
+    allocation.category = category;
+    allocation.size = requirements.size;
+    allocation.memoryTypeIdx = memoryTypeIdx;
+    if (isDedicated)
+    {
+        const bool isBufferCategory =
+            category != GPUMemoryCategory::Textures && category != GPUMemoryCategory::RenderTargets;
+        const VkResult result =
+            AllocateDeviceMemory(requirements.size, memoryTypeIdx, isBufferCategory, allocation.memory);
+        if (result != VK_SUCCESS)
+            return result;
+        if (IsHostVisibleMemoryType(memoryTypeIdx))
+            vkMapMemory(VK_LOGICAL_DEVICE, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.pMapped);
+
+        auto& stats = m_categoryStats[(u32)category];
+        ++stats.dedicatedCount;
+        stats.reservedBytes += requirements.size;
+        return VK_SUCCESS;
+    }
+
+    // Only a handful of blocks exist per category, finding the range inside a block is O(1)
+    TLSFAllocation range{};
+    u32 blockIdx = 0;
+    for (; blockIdx < m_convBlocks.size(); ++blockIdx)
+    {
+        auto& block = m_convBlocks[blockIdx];
+        if (block.memory == VK_NULL_HANDLE || block.category != category || block.memoryTypeIdx != memoryTypeIdx)
+            continue;
+        range = block.allocator.Allocate(requirements.size, requirements.alignment);
+        if (range.IsValid())
+            break;
+    }
+    if (range.IsValid() == false)
+    {
+        const VkResult result =
+            CreateConvolutionBlock(category, memoryTypeIdx, s_convBlockSizes[(u32)category], blockIdx);
+        if (result != VK_SUCCESS)
+            return result;
+        range = m_convBlocks[blockIdx].allocator.Allocate(requirements.size, requirements.alignment);
+        DEBUG_ASSERT(range.IsValid());
+    }
+    if (m_spareConvBlocks[(u32)category] == blockIdx)
+        m_spareConvBlocks[(u32)category] = s_invalidConvSlot;
+
+    const auto& block = m_convBlocks[blockIdx];
+    allocation.memory = block.memory;
+    allocation.offset = range.offset;
+    allocation.blockIdx = blockIdx;
+    allocation.node = range.node;
+    allocation.pMapped = block.pMapped != nullptr ? (u8*)block.pMapped + range.offset : nullptr;
+    return VK_SUCCESS;
+}
+
+VkResult GPUMemManager<Vulkan>::CreateConvolutionBlock(GPUMemoryCategory category,
+                                                       u32 memoryTypeIdx,
+                                                       u64 size,
+                                                       u32& blockIdx)
+{
+    const bool isBufferCategory =
+        category != GPUMemoryCategory::Textures && category != GPUMemoryCategory::RenderTargets;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    const VkResult result = AllocateDeviceMemory(size, memoryTypeIdx, isBufferCategory, memory);
+    if (result != VK_SUCCESS)
+        return result;
+
+    if (m_freeConvBlockSlots.empty() == false)
+    {
+        blockIdx = m_freeConvBlockSlots.back();
+        m_freeConvBlockSlots.pop_back();
+    }
+    else
+    {
+        blockIdx = (u32)m_convBlocks.size();
+        m_convBlocks.emplace_back();
+    }
+
+    auto& block = m_convBlocks[blockIdx];
+    block.memory = memory;
+    block.memoryTypeIdx = memoryTypeIdx;
+    block.category = category;
+    block.pMapped = nullptr;
+    block.allocator.Init(size);
+    if (IsHostVisibleMemoryType(memoryTypeIdx))
+        vkMapMemory(VK_LOGICAL_DEVICE, memory, 0, VK_WHOLE_SIZE, 0, &block.pMapped);
+
+    auto& stats = m_categoryStats[(u32)category];
+    ++stats.blockCount;
+    stats.reservedBytes += size;
+    DEBUG_LOGF("[GPUMemManager] New {} block of {} MB in memory type {}",
+               GetGPUMemoryCategoryName(category),
+               size / (1024 * 1024),
+               memoryTypeIdx);
+    return VK_SUCCESS;
+}
+
+void GPUMemManager<Vulkan>::ReleaseConvolutionBlock(u32 blockIdx)
+{
+    auto& block = m_convBlocks[blockIdx];
+    DEBUG_ASSERT(block.memory != VK_NULL_HANDLE);
+    if (block.pMapped != nullptr)
+        vkUnmapMemory(VK_LOGICAL_DEVICE, block.memory);
+    FreeDeviceMemory(block.memory, block.allocator.GetSize(), block.memoryTypeIdx);
+
+    auto& stats = m_categoryStats[(u32)block.category];
+    --stats.blockCount;
+    stats.reservedBytes -= block.allocator.GetSize();
+
+    block.memory = VK_NULL_HANDLE;
+    block.pMapped = nullptr;
+    block.category = GPUMemoryCategory::Count;
+    m_freeConvBlockSlots.push_back(blockIdx);
+}
+
+void GPUMemManager<Vulkan>::FreeConvolutionMemory(AllocationRecord& record)
+{
+    if (record.buffer != VK_NULL_HANDLE)
+        vkDestroyBuffer(VK_LOGICAL_DEVICE, record.buffer, VulkanAllocator());
+    else if (record.image != VK_NULL_HANDLE)
+        vkDestroyImage(VK_LOGICAL_DEVICE, record.image, VulkanAllocator());
+
+    const u32 categoryIdx = (u32)record.category;
+    auto& stats = m_categoryStats[categoryIdx];
+    stats.allocatedBytes -= record.size;
+    --stats.allocationCount;
+
+    if (record.blockIdx == s_invalidConvSlot)
+    {
+        if (record.pMapped != nullptr)
+            vkUnmapMemory(VK_LOGICAL_DEVICE, record.memory);
+        FreeDeviceMemory(record.memory, record.size, record.memoryTypeIdx);
+        --stats.dedicatedCount;
+        stats.reservedBytes -= record.size;
+    }
+    else
+    {
+        auto& block = m_convBlocks[record.blockIdx];
+        block.allocator.Free(record.node);
+        if (block.allocator.IsEmpty())
+        {
+            if (m_spareConvBlocks[categoryIdx] == s_invalidConvSlot)
+                m_spareConvBlocks[categoryIdx] = record.blockIdx;
+            else if (m_spareConvBlocks[categoryIdx] != record.blockIdx)
+                ReleaseConvolutionBlock(record.blockIdx);
+        }
+    }
+}
+
+VkResult GPUMemManager<Vulkan>::AllocateDeviceMemory(u64 size,
+                                                     u32 memoryTypeIdx,
+                                                     bool needsDeviceAddress,
+                                                     VkDeviceMemory& memory)
+{
+    VkMemoryAllocateFlagsInfo flagsInfo{};
+    flagsInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    flagsInfo.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext = needsDeviceAddress ? &flagsInfo : nullptr;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIdx;
+
+    memory = VK_NULL_HANDLE;
+    const VkResult result = vkAllocateMemory(VK_LOGICAL_DEVICE, &allocInfo, VulkanAllocator(), &memory);
+    if (result != VK_SUCCESS)
+    {
+        DEBUG_LOGF("[GPUMemManager] vkAllocateMemory of {} bytes in memory type {} failed with {}",
+                   size,
+                   memoryTypeIdx,
+                   (s32)result);
+        memory = VK_NULL_HANDLE;
+        return result;
+    }
+
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    m_convHeapUsage[memProps.memoryTypes[memoryTypeIdx].heapIndex] += size;
+    return VK_SUCCESS;
+}
+
+void GPUMemManager<Vulkan>::FreeDeviceMemory(VkDeviceMemory memory, u64 size, u32 memoryTypeIdx)
+{
+    vkFreeMemory(VK_LOGICAL_DEVICE, memory, VulkanAllocator());
+    const VkPhysicalDeviceMemoryProperties& memProps = VkGlobals::GetPhysicalDeviceMemoryProperties();
+    m_convHeapUsage[memProps.memoryTypes[memoryTypeIdx].heapIndex] -= size;
+}
+
+void GPUMemManager<Vulkan>::TrackConvolutionAllocation(GPUMemoryCategory category, u64 size)
+{
+    auto& stats = m_categoryStats[(u32)category];
+    const bool wasOverBudget = stats.budgetBytes > 0 && stats.allocatedBytes > stats.budgetBytes;
+    stats.allocatedBytes += size;
+    ++stats.allocationCount;
+    if (stats.budgetBytes == 0 || stats.allocatedBytes <= stats.budgetBytes)
+        return;
+
+    if (wasOverBudget == false)
+    {
+        DEBUG_LOGF("[GPUMemManager] {} went over its budget: {} MB of {} MB",
+                   GetGPUMemoryCategoryName(category),
+                   stats.allocatedBytes / (1024 * 1024),
+                   stats.budgetBytes / (1024 * 1024));
+    }
+    ++stats.overBudgetAllocations;
+}
@@ -2,6 +2,7 @@
 #include "BackendDefines.h"
 #include "Core/Rendering/Core/Buffer.h"
 #include "Core/Rendering/Core/GPUMemoryManager.h"
+#include "Core/Rendering/Core/TLSFAllocator.h"
 #include "Core/Global/ThreadBase.h"
 
 template <>
@@ -24,6 +25,21 @@ public:
 
     void BindImageMemory(GPUMemoryHandle handle);
     void GetVramStats(u64& total, u64& used);
+    // Budget and usage of the device local heaps as reported by VMA or tracked by the Convolution allocator, both 0
+    // for the default allocator
+    void GetVramBudget(u64& budget, u64& usage);
+
+    Allocator GetAllocatorMode() const
+    {
+        return m_allocatorMode;
+    }
+    // Convolution allocator only, budgets are soft limits that get counted and logged when exceeded
+    void SetCategoryBudget(GPUMemoryCategory category, u64 budgetBytes);
+    GPUMemoryCategoryStats GetCategoryStats(GPUMemoryCategory category);
+    // Replays a bounded sample of the buffer allocations made so far like a scene getting loaded, half streamed out
+    // and in again and unloaded, once through VMA and once through the Convolution allocator
+    // Running out of memory stops that allocator's replay and is reported in the result
+    GPUAllocatorBenchmark RunAllocatorBenchmark(u32 iterations = 4);
 
 protected:
     void FreeMemory(GPUMemoryHandle memoryHandle);
@@ -31,12 +47,89 @@ protected:
 
     void FreeVMA();
 
+    struct ConvolutionMemoryBlock
+    {
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        GPUMappedMemoryHandle pMapped{nullptr};
+        TLSFAllocator allocator;
+        u32 memoryTypeIdx{0};
+        GPUMemoryCategory category{GPUMemoryCategory::Count};
+    };
+
+    // Everything known about one allocation, GPUMemoryHandles index these directly
+    struct AllocationRecord
+    {
+        // Set for VMA allocations, the Convolution fields below stay empty then
+        VmaAllocation vmaAllocation{VK_NULL_HANDLE};
+        VkDeviceMemory memory{VK_NULL_HANDLE};
+        u64 offset{0};
+        u64 size{0};
+        GPUMappedMemoryHandle pMapped{nullptr};
+        VkBuffer buffer{VK_NULL_HANDLE};
+        VkImage image{VK_NULL_HANDLE};
+        // Index into m_convBlocks, ~0u for dedicated allocations
+        u32 blockIdx{~0u};
+        u32 memoryTypeIdx{0};
+        u32 node{TLSFAllocator::InvalidNode};
+        // Outstanding vmaMapMemory calls, unmapped before the allocation is destroyed
+        u32 mapCount{0};
+        // Bumped on every free so stale handles don't resolve to the slot's next allocation
+        u32 generation{1};
+        GPUMemoryCategory category{GPUMemoryCategory::Count};
+        bool isLive{false};
+    };
+
+    // Stores the record in a free slot and returns the handle for it
+    GPUMemoryHandle AddAllocationRecord(const AllocationRecord& record);
+    void ReleaseAllocationRecord(GPUMemoryHandle memoryHandle);
+    // O(1), nullptr for null, freed or stale handles
+    AllocationRecord* ResolveHandle(GPUMemoryHandle memoryHandle);
+
+    GPUMemoryHandle AllocateVMABuffer(BufferUsage usage,
+                                      const VkBufferCreateInfo& bufferInfo,
+                                      VkBuffer& bufferToCreate);
+    GPUMemoryHandle AllocateConvolutionBuffer(BufferUsage usage,
+                                              const VkBufferCreateInfo& bufferInfo,
+                                              VkBuffer& bufferToCreate);
+    GPUMemoryHandle AllocateConvolutionImage(const VkImageCreateInfo& imageInfo, VkImage& imageToCreate);
+    // Finds or creates room for the requirements, the returned handle has no buffer or image bound yet
+    // Memory types are tried from the best match down while the heaps report being out of memory, Invalid once
+    // every type that meets the required flags is exhausted
+    GPUMemoryHandle AllocateConvolutionMemory(GPUMemoryCategory category,
+                                  const VkMemoryRequirements& requirements,
+                                  VkMemoryPropertyFlags requiredFlags,
+                                  VkMemoryPropertyFlags preferredFlags,
+                                  bool isDedicated);
+    VkResult AllocateConvolutionMemoryInType(GPUMemoryCategory category,
+                                             const VkMemoryRequirements& requirements,
+                                             u32 memoryTypeIdx,
+                                             bool isDedicated,
+                                             AllocationRecord& allocation);
+    VkResult CreateConvolutionBlock(GPUMemoryCategory category, u32 memoryTypeIdx, u64 size, u32& blockIdx);
+    void ReleaseConvolutionBlock(u32 blockIdx);
+    // Frees the memory and destroys the buffer or image bound to it, O(1)
+    void FreeConvolutionMemory(AllocationRecord& record);
+    VkResult AllocateDeviceMemory(u64 size, u32 memoryTypeIdx, bool needsDeviceAddress, VkDeviceMemory& memory);
+    void FreeDeviceMemory(VkDeviceMemory memory, u64 size, u32 memoryTypeIdx);
+    void TrackConvolutionAllocation(GPUMemoryCategory category, u64 size);
+
 private:
     void EnsureInitialized();
 
     Allocator m_allocatorMode{Allocator::VMA};
     bool m_isInitialized{false};
-    CustomMutex m_mappingMutex;
     CustomMutex m_allocatinggMutex;
-    stltype::vector<GPUMemoryHandle> m_mappedMemoryHandles{}; // Mostly just for debugging
+
+    // Slot map of every live allocation for both allocators, freed slots get reused with a bumped generation
+    stltype::vector<AllocationRecord> m_allocations{};
+    stltype::vector<u32> m_freeAllocationSlots{};
+
+    stltype::vector<ConvolutionMemoryBlock> m_convBlocks{};
+    stltype::vector<u32> m_freeConvBlockSlots{};
+    // Emptied block every category keeps around instead of handing it back, so load/unload churn doesn't hit the driver
+    u32 m_spareConvBlocks[(u32)GPUMemoryCategory::Count]{};
+    GPUMemoryCategoryStats m_categoryStats[(u32)GPUMemoryCategory::Count]{};
+    u64 m_convHeapUsage[VK_MAX_MEMORY_HEAPS]{};
+    // Usage and size of every buffer created, replayed by RunAllocatorBenchmark
+    stltype::vector<stltype::pair<BufferUsage, u64>> m_bufferAllocationHistory{};
 };
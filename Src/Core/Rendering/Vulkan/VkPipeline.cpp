@@ -232,8 +232,12 @@ VkPipelineVertexInputStateCreateInfo PipelineVulkanBase::CreateVertexInputInfo(c
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    DEBUG_ASSERT(m_vertexInfo.bindingDescriptionCount <= 2);
+    m_bindingDescriptions[0] = m_vertexInfo.m_vertexInputDescription;
+    m_bindingDescriptions[1] = m_vertexInfo.m_attributeStreamDescription;
+
     vertexInputInfo.vertexBindingDescriptionCount = m_vertexInfo.bindingDescriptionCount;
-    vertexInputInfo.pVertexBindingDescriptions = &m_vertexInfo.m_vertexInputDescription;
+    vertexInputInfo.pVertexBindingDescriptions = m_bindingDescriptions;
     vertexInputInfo.vertexAttributeDescriptionCount = m_vertexInfo.m_attributeDescriptions.size();
     vertexInputInfo.pVertexAttributeDescriptions = m_vertexInfo.m_attributeDescriptions.data();
 
@@ -11,6 +11,8 @@ struct PipeVertInfo
     VkVertexInputBindingDescription m_vertexInputDescription{};
     stltype::vector<VkVertexInputAttributeDescription> m_attributeDescriptions{};
     u32 bindingDescriptionCount{1};
+    // Second binding of split vertex layouts, only used when bindingDescriptionCount is 2
+    VkVertexInputBindingDescription m_attributeStreamDescription{};
 };
 
 // Base class that holds shared members and helpers for Vulkan pipelines
@@ -64,6 +66,7 @@ protected:
 
     PipelineInfo m_info{};
     PipeVertInfo m_vertexInfo{};
+    VkVertexInputBindingDescription m_bindingDescriptions[2]{};
     stltype::vector<VkPipelineColorBlendAttachmentState> m_colorBlendAttachments{};
 };
 
@@ -25,7 +25,11 @@ TextureVulkan::~TextureVulkan()
 
 void TextureVulkan::CleanUp()
 {
-    VK_FREE_IF(m_imageMemory, g_pGPUMemoryManager->TryFreeMemory(m_imageMemory));
+    if (m_imageMemory != GPUMemoryHandle::Invalid)
+    {
+        g_pGPUMemoryManager->TryFreeMemory(m_imageMemory);
+        m_imageMemory = GPUMemoryHandle::Invalid;
+    }
     VK_FREE_IF(m_imageView, vkDestroyImageView(VK_LOGICAL_DEVICE, m_imageView, VulkanAllocator()));
     VK_FREE_IF(m_sampler, vkDestroySampler(VK_LOGICAL_DEVICE, m_sampler, VulkanAllocator()));
     m_image = VK_NULL_HANDLE;
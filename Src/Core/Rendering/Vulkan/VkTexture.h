@@ -40,7 +40,7 @@ public:
 
 protected:
     VkImage m_image{VK_NULL_HANDLE};
-    GPUMemoryHandle m_imageMemory{VK_NULL_HANDLE};
+    GPUMemoryHandle m_imageMemory{GPUMemoryHandle::Invalid};
     VkSampler m_sampler{VK_NULL_HANDLE};
     VkImageView m_imageView{VK_NULL_HANDLE};
 };
@@ -5,6 +5,7 @@
 #include "Core/IO/FileReader.h"
 #include "Core/Rendering/Core/MaterialManager.h"
 #include "Core/Rendering/Core/TransferUtils/TransferQueueHandler.h"
+#include "Core/Rendering/Core/Utils/TextureStreamingSelection.h"
 #include "Core/Rendering/Vulkan/Utils/VkDescriptorLayoutUtils.h"
 #include "Utils/DescriptorSetLayoutConverters.h"
 #include "Utils/VkEnumHelpers.h"
@@ -18,6 +19,24 @@
 
 
 static constexpr u32 MAX_CACHE_BUFFERS = 512;
+// Start of every texture in the shared upload staging buffer, covers the 16 byte blocks of BC formats
+static constexpr u64 TEXTURE_UPLOAD_OFFSET_ALIGNMENT = 16;
+
+static u64 AlignUploadOffset(u64 offset)
+{
+    return (offset + TEXTURE_UPLOAD_OFFSET_ALIGNMENT - 1) & ~(TEXTURE_UPLOAD_OFFSET_ALIGNMENT - 1);
+}
+
+static void FreeReadTextureData(ReadTextureInfo& readInfo)
+{
+    if (readInfo.autoFree == false)
+        return;
+    FileReader::FreeImageData(readInfo.pixels);
+    for (auto& mipmap : readInfo.mipmapPixels)
+    {
+        FileReader::FreeImageData(mipmap.pData);
+    }
+}
 
 static TextureInfo RequestToTexInfo(const DynamicTextureRequest& info)
 {
@@ -79,7 +98,7 @@ VkTextureManager::VkTextureManager()
     m_availableCommandBuffers.reserve(MAX_CACHE_BUFFERS);
 }
 
-void VkTextureManager::Init()
+void VkTextureManager::Init(u32 persistentBindlessSlots)
 {
     ScopedZone("VkTextureManager::Init");
 
@@ -88,9 +107,8 @@ void VkTextureManager::Init()
     InitializeThread("Convolution_TextureManager");
     CreateBindlessDescriptorSet();
 
-    // Reserve slot 0 for placeholder / default sampling paths.
-    m_lastBindlessTextureWriteIdx = 1;
-    m_lastPersistentBindlessTextureWriteIdx = 14000;
+    // Slot 0 stays reserved for placeholder / default sampling paths.
+    m_bindlessSlots.Init(MAX_BINDLESS_TEXTURES, persistentBindlessSlots);
 }
 
 void VkTextureManager::SetPlaceholder(TextureHandle handle)
@@ -100,6 +118,7 @@ void VkTextureManager::SetPlaceholder(TextureHandle handle)
     {
         return;
     }
+    m_pPlaceholderTexture = pTex;
 
     for (u32 i = 0; i < MAX_BINDLESS_TEXTURES; ++i)
     {
@@ -121,8 +140,6 @@ void VkTextureManager::SetPlaceholder(TextureHandle handle)
             m_combinedBindlessDescriptorSet->WriteBindlessImageUpdate(pTex, i, s_globalBindlessImageBufferBindingSlot);
         }
     }
-
-    m_lastBindlessTextureWriteIdx = 1;
 }
 
 void VkTextureManager::CheckRequests()
@@ -164,6 +181,7 @@ void VkTextureManager::CheckRequests()
                 m_sharedDataMutex.unlock();
             }
         }
+        SubmitPendingUploads();
         DispatchAsyncOps();
         Suspend();
     }
@@ -175,63 +193,50 @@ void VkTextureManager::PostRender()
 
     SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
 
+    ApplyStreamingSwaps();
+    UpdateStreaming();
+
+    // Freed slots already sample the placeholder, they only wait for the frames in flight before being reused
+    m_bindlessSlots.ReleaseRetiredSlots(FrameGlobals::GetFrameNumber());
+
     if (m_texturesToMakeBindless.empty() && m_persistentTexturesToMakeBindless.empty())
         return;
 
-    auto processTextures = [this](stltype::vector<TextureHandle>& handles) -> bool
+    auto processTextures = [this](stltype::vector<PendingBindlessTexture>& pending) -> bool
     {
         bool wroteAny = false;
-        for (auto it = handles.begin(); it != handles.end();)
+        for (auto it = pending.begin(); it != pending.end();)
         {
+            // The slot was freed and maybe handed out again while the texture was still uploading
+            if (m_bindlessSlots.IsAlive(it->slot) == false)
+            {
+                it = pending.erase(it);
+                continue;
+            }
+
             TextureVulkan* pTex = nullptr;
-            if (auto mapIt = m_textures.find(*it); mapIt != m_textures.end())
+            if (auto mapIt = m_textures.find(it->handle); mapIt != m_textures.end())
             {
                 pTex = mapIt->second.get();
             }
-            else if (auto persistentIt = m_persistentTextures.find(*it); persistentIt != m_persistentTextures.end())
+            else if (auto persistentIt = m_persistentTextures.find(it->handle);
+                     persistentIt != m_persistentTextures.end())
             {
                 pTex = persistentIt->second.get();
             }
-            if (pTex == nullptr || pTex->GetImageView() == VK_NULL_HANDLE || pTex->GetSampler() == VK_NULL_HANDLE)
+            if (pTex == nullptr || pTex->GetImageView() == VK_NULL_HANDLE || pTex->GetSampler() == VK_NULL_HANDLE ||
+                m_texturesAwaitingUpload.find(pTex) != m_texturesAwaitingUpload.end())
             {
                 ++it;
                 continue;
             }
 
-            const auto mappedIt = m_bindlessTextureHandleMap.find(*it);
-            DEBUG_ASSERT(mappedIt != m_bindlessTextureHandleMap.end());
-            if (mappedIt == m_bindlessTextureHandleMap.end())
-            {
-                ++it;
-                continue;
-            }
-
-            const u32 targetIdx = mappedIt->second;
-            if (pTex->GetInfo().extents.z > 1)
-            {
-                m_bindlessDescriptorSet->WriteBindlessTextureUpdate(
-                    pTex, targetIdx, s_globalBindlessArrayTextureBufferBindingSlot);
-                m_combinedBindlessDescriptorSet->WriteBindlessTextureUpdate(
-                    pTex, targetIdx, s_globalBindlessArrayTextureBufferBindingSlot);
-            }
-            else
-            {
-                m_bindlessDescriptorSet->WriteBindlessTextureUpdate(pTex, targetIdx);
-                m_combinedBindlessDescriptorSet->WriteBindlessTextureUpdate(pTex, targetIdx);
-            }
-
-            if ((u32)pTex->GetInfo().usage & (u32)Usage::Storage)
-            {
-                m_bindlessImageDescriptorSet->WriteBindlessImageUpdate(
-                    pTex, targetIdx, s_globalBindlessImageBufferBindingSlot);
-                m_combinedBindlessDescriptorSet->WriteBindlessImageUpdate(
-                    pTex, targetIdx, s_globalBindlessImageBufferBindingSlot);
-            }
+            WriteBindlessDescriptors(pTex, it->slot.index);
 
             pTex->SetStatus(TextureStatus::Ready);
             wroteAny = true;
 
-            it = handles.erase(it);
+            it = pending.erase(it);
         }
         return wroteAny;
     };
@@ -253,6 +258,361 @@ void VkTextureManager::PostRender()
     }
 }
 
+void VkTextureManager::WriteBindlessDescriptors(TextureVulkan* pTex, u32 bindlessIdx)
+{
+    if (pTex->GetInfo().extents.z > 1)
+    {
+        m_bindlessDescriptorSet->WriteBindlessTextureUpdate(
+            pTex, bindlessIdx, s_globalBindlessArrayTextureBufferBindingSlot);
+        m_combinedBindlessDescriptorSet->WriteBindlessTextureUpdate(
+            pTex, bindlessIdx, s_globalBindlessArrayTextureBufferBindingSlot);
+    }
+    else
+    {
+        m_bindlessDescriptorSet->WriteBindlessTextureUpdate(pTex, bindlessIdx);
+        m_combinedBindlessDescriptorSet->WriteBindlessTextureUpdate(pTex, bindlessIdx);
+    }
+
+    if ((u32)pTex->GetInfo().usage & (u32)Usage::Storage)
+    {
+        m_bindlessImageDescriptorSet->WriteBindlessImageUpdate(
+            pTex, bindlessIdx, s_globalBindlessImageBufferBindingSlot);
+        m_combinedBindlessDescriptorSet->WriteBindlessImageUpdate(
+            pTex, bindlessIdx, s_globalBindlessImageBufferBindingSlot);
+    }
+}
+
+u64 VkTextureManager::StreamedTextureInfo::EstimateBytes(u32 firstMip) const
+{
+    // Every level holds a quarter of the one above it, close enough for the budget even though the smallest block
+    // compressed levels don't shrink anymore
+    if (firstMip >= fullMipCount)
+        return 0;
+    if (firstMip >= tailMip)
+        return tailBytes >> stltype::min(2 * (firstMip - tailMip), 63u);
+    return tailBytes << stltype::min(2 * (tailMip - firstMip), 63u);
+}
+
+TextureStreamingStats VkTextureManager::SubmitStreamingFeedback(
+    const TextureStreamingSettings& settings,
+    stltype::vector<stltype::pair<BindlessTextureHandle, f32>>&& requiredExtents)
+{
+    SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+    m_streamingSettings = settings;
+    m_streamingFeedback = stltype::move(requiredExtents);
+    m_hasStreamingFeedback = true;
+    return m_streamingStats;
+}
+
+void VkTextureManager::ApplyStreamingSwaps()
+{
+    for (auto it = m_pendingStreamingSwaps.begin(); it != m_pendingStreamingSwaps.end();)
+    {
+        auto& swap = it->second;
+        if (swap.isUploaded == false)
+        {
+            ++it;
+            continue;
+        }
+
+        Texture* pNewTex = swap.pTexture.release();
+        const auto streamedIt = m_streamedTextures.find(it->first);
+        if (streamedIt == m_streamedTextures.end())
+        {
+            // Freed while the new mips were uploading
+            g_pDeleteQueue->RegisterDeleteForNextFrame(
+                [pNewTex]()
+                {
+                    pNewTex->CleanUp();
+                    delete pNewTex;
+                });
+            it = m_pendingStreamingSwaps.erase(it);
+            continue;
+        }
+
+        auto& info = streamedIt->second;
+        DEBUG_ASSERT(m_bindlessSlots.IsAlive(info.bindlessSlot));
+        WriteBindlessDescriptors(pNewTex, info.bindlessSlot.index);
+        pNewTex->SetStatus(TextureStatus::Ready);
+
+        // Frames in flight might still sample the old image through the previous descriptor, evicted textures don't
+        // have one anymore
+        auto& pResidentTex = m_textures[it->first];
+        if (pResidentTex != nullptr)
+        {
+            Texture* pOldTex = pResidentTex.release();
+            g_pDeleteQueue->RegisterDeleteForNextFrame(
+                [pOldTex]()
+                {
+                    pOldTex->CleanUp();
+                    delete pOldTex;
+                });
+        }
+        pResidentTex.reset(pNewTex);
+
+        info.residentMip = swap.firstMip;
+        info.residentBytes = swap.bytes;
+        info.pendingMip = INVALID_STREAMING_MIP;
+        it = m_pendingStreamingSwaps.erase(it);
+    }
+}
+
+void VkTextureManager::UpdateStreaming()
+{
+    ScopedZone("VkTextureManager::Update Streaming");
+
+    // The frame number wraps with the frames in flight, usage and retries are tracked in streaming updates instead
+    const u64 frameNumber = ++m_streamingUpdateCount;
+    if (m_hasStreamingFeedback)
+    {
+        stltype::hash_map<BindlessTextureHandle, f32> requiredExtentBySlot;
+        for (const auto& [slot, requiredExtent] : m_streamingFeedback)
+        {
+            f32& maxExtent = requiredExtentBySlot[slot];
+            maxExtent = stltype::max(maxExtent, requiredExtent);
+        }
+        for (auto& [handle, info] : m_streamedTextures)
+        {
+            const auto it = requiredExtentBySlot.find(info.bindlessSlot.index);
+            info.requiredExtent = it != requiredExtentBySlot.end() ? it->second : 0.0f;
+            if (it != requiredExtentBySlot.end())
+                info.lastUsedFrame = frameNumber;
+        }
+        m_streamingFeedback.clear();
+        m_hasStreamingFeedback = false;
+    }
+
+    u64 vramBudget = 0;
+    u64 vramUsage = 0;
+    g_pGPUMemoryManager->GetVramBudget(vramBudget, vramUsage);
+
+    m_streamingStats = {};
+    m_streamingStats.vramBudgetBytes = vramBudget;
+    m_streamingStats.vramUsageBytes = vramUsage;
+    m_streamingStats.evictionCount = m_evictionCount;
+    m_streamingStats.uploadQueueDepth = (u32)m_pendingUploads.size();
+    m_streamingStats.uploadQueueBytes = m_pendingUploadBytes;
+    m_streamingStats.uploadedBytesLastFrame = m_uploadedBytesLastFrame;
+    if (m_streamedTextures.empty())
+        return;
+
+    u64 residentBytes = 0;
+    u64 wantedBytes = 0;
+    u32 pendingLoads = 0;
+    u32 evictedTextures = 0;
+    stltype::vector<stltype::pair<TextureHandle, StreamedTextureInfo*>> streamedTextures;
+    streamedTextures.reserve(m_streamedTextures.size());
+    for (auto& [handle, info] : m_streamedTextures)
+    {
+        if (info.IsEvicted() && info.requiredExtent <= 0.0f)
+        {
+            // Stays on the placeholder until something uses it again
+            info.wantedMip = info.fullMipCount;
+        }
+        else if (m_streamingSettings.enabled == false)
+        {
+            info.wantedMip = 0;
+        }
+        else
+        {
+            const u32 fullExtent = (u32)stltype::max(info.fullExtents.x, info.fullExtents.y);
+            info.wantedMip = Utils::SelectStreamingMip(fullExtent, info.requiredExtent, info.tailMip);
+        }
+        residentBytes += info.residentBytes;
+        wantedBytes += info.EstimateBytes(info.wantedMip);
+        if (info.pendingMip != INVALID_STREAMING_MIP)
+            ++pendingLoads;
+        if (info.IsEvicted())
+            ++evictedTextures;
+        streamedTextures.emplace_back(handle, &info);
+    }
+
+    // Textures can take whatever VMA reports as free on top of what they already hold, minus some headroom for
+    // everything else that gets allocated in the meantime
+    u64 budgetBytes = m_streamingSettings.enabled ? m_streamingSettings.budgetBytes : ~0ull;
+    if (vramBudget > 0)
+    {
+        const u64 headroomBytes = (u64)(vramBudget * TEXTURE_RESIDENCY_VRAM_HEADROOM);
+        const u64 freeBytes = vramBudget > vramUsage + headroomBytes ? vramBudget - vramUsage - headroomBytes : 0;
+        budgetBytes = stltype::min(budgetBytes, residentBytes + freeBytes);
+    }
+
+    // Least recently used textures give up their detail first, then the ones needing the least of it
+    // Only once they're all down to their tail, textures that haven't been seen for a while are evicted completely
+    u64 budgetedBytes = wantedBytes;
+    if (budgetedBytes > budgetBytes)
+    {
+        stltype::sort(streamedTextures.begin(),
+                      streamedTextures.end(),
+                      [](const auto& a, const auto& b)
+                      {
+                          if (a.second->lastUsedFrame != b.second->lastUsedFrame)
+                              return a.second->lastUsedFrame < b.second->lastUsedFrame;
+                          return a.second->requiredExtent < b.second->requiredExtent;
+                      });
+        if (m_streamingSettings.enabled)
+        {
+            for (auto& [handle, pInfo] : streamedTextures)
+            {
+                while (budgetedBytes > budgetBytes && pInfo->wantedMip < pInfo->tailMip)
+                {
+                    budgetedBytes -=
+                        pInfo->EstimateBytes(pInfo->wantedMip) - pInfo->EstimateBytes(pInfo->wantedMip + 1);
+                    ++pInfo->wantedMip;
+                }
+                if (budgetedBytes <= budgetBytes)
+                    break;
+            }
+        }
+        for (auto& [handle, pInfo] : streamedTextures)
+        {
+            if (budgetedBytes <= budgetBytes || pInfo->lastUsedFrame + TEXTURE_RESIDENCY_MIN_UNUSED_FRAMES > frameNumber)
+                break;
+            budgetedBytes -= pInfo->EstimateBytes(pInfo->wantedMip);
+            pInfo->wantedMip = pInfo->fullMipCount;
+        }
+    }
+
+    const bool isOverBudget = residentBytes > budgetBytes;
+    stltype::vector<stltype::pair<TextureHandle, StreamedTextureInfo*>> streamIns;
+    stltype::vector<stltype::pair<TextureHandle, StreamedTextureInfo*>> streamOuts;
+    for (auto& entry : streamedTextures)
+    {
+        auto* pInfo = entry.second;
+        if (pInfo->wantedMip <= pInfo->residentMip)
+            pInfo->framesWantingLess = 0;
+        if (pInfo->pendingMip != INVALID_STREAMING_MIP || pInfo->retryUpdate > frameNumber)
+            continue;
+
+        if (pInfo->wantedMip < pInfo->residentMip)
+        {
+            streamIns.push_back(entry);
+        }
+        else if (pInfo->wantedMip > pInfo->residentMip)
+        {
+            // Dropping detail that's asked for again a moment later costs a reload, only do it when needed
+            ++pInfo->framesWantingLess;
+            if (isOverBudget || pInfo->framesWantingLess >= TEXTURE_STREAMING_DROP_DELAY_FRAMES)
+                streamOuts.push_back(entry);
+        }
+    }
+
+    // Evictions don't load anything and happen right away, everything else shares the pending load limit
+    for (auto it = streamOuts.begin(); it != streamOuts.end();)
+    {
+        if (it->second->wantedMip >= it->second->fullMipCount)
+        {
+            // Textures still in the upload queue have transfers pending against their image, they stay until uploaded
+            const auto texIt = m_textures.find(it->first);
+            if (texIt == m_textures.end() ||
+                m_texturesAwaitingUpload.find(texIt->second.get()) == m_texturesAwaitingUpload.end())
+            {
+                EvictTexture(it->first, *it->second);
+                ++evictedTextures;
+            }
+            it = streamOuts.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Freeing memory comes first, then the textures furthest away from the detail they need
+    stltype::sort(streamIns.begin(),
+                  streamIns.end(),
+                  [](const auto& a, const auto& b)
+                  {
+                      return a.second->residentMip - a.second->wantedMip > b.second->residentMip - b.second->wantedMip;
+                  });
+    for (auto* pRequests : {&streamOuts, &streamIns})
+    {
+        for (auto& [handle, pInfo] : *pRequests)
+        {
+            if (pendingLoads >= TEXTURE_STREAMING_MAX_PENDING_LOADS)
+                break;
+            if (pInfo->IsEvicted())
+                --evictedTextures;
+            RequestStreamedMips(handle, *pInfo, pInfo->wantedMip);
+            ++pendingLoads;
+        }
+    }
+
+    m_streamingStats.streamedTextureCount = (u32)m_streamedTextures.size();
+    m_streamingStats.pendingLoadCount = pendingLoads;
+    m_streamingStats.evictedTextureCount = evictedTextures;
+    m_streamingStats.evictionCount = m_evictionCount;
+    m_streamingStats.residentBytes = residentBytes;
+    m_streamingStats.wantedBytes = wantedBytes;
+    m_streamingStats.budgetBytes = budgetBytes;
+}
+
+void VkTextureManager::EvictTexture(TextureHandle handle, StreamedTextureInfo& info)
+{
+    // Materials keep their slot, it samples the placeholder until the texture is needed again
+    DEBUG_ASSERT(m_bindlessSlots.IsAlive(info.bindlessSlot));
+    if (m_pPlaceholderTexture != nullptr)
+        WriteBindlessDescriptors(m_pPlaceholderTexture, info.bindlessSlot.index);
+
+    if (auto it = m_textures.find(handle); it != m_textures.end())
+    {
+        RetireTexture(it->second.release());
+        m_textures.erase(it);
+    }
+
+    info.residentMip = info.fullMipCount;
+    info.residentBytes = 0;
+    info.framesWantingLess = 0;
+    ++m_evictionCount;
+}
+
+void VkTextureManager::RetireTexture(Texture* pTex)
+{
+    // Frames in flight may still sample the image through its old descriptor
+    g_pDeleteQueue->RegisterDeleteForNextFrame(
+        [pTex]()
+        {
+            pTex->CleanUp();
+            delete pTex;
+        });
+}
+
+void VkTextureManager::RequestStreamedMips(TextureHandle handle, StreamedTextureInfo& info, u32 firstMip)
+{
+    info.pendingMip = firstMip;
+    info.framesWantingLess = 0;
+
+    // Both directions reload the mips from disk, DDS and KTX2 files only read the requested levels anyway
+    IORequest req{};
+    const TextureSemantic semantic = info.semantic;
+    req.filePath = info.filePath;
+    req.requestType = RequestType::Image;
+    req.textureSemantic = semantic;
+    req.firstMipLevel = firstMip;
+    req.callback = [this, handle, semantic](const ReadTextureInfo& result)
+    {
+        if (result.isValid == false)
+        {
+            // Keeps the mips it has, the slot is freed up and the reload is tried again after a while
+            SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+            const auto it = m_streamedTextures.find(handle);
+            if (it != m_streamedTextures.end() && it->second.pendingMip == result.firstMipLevel)
+            {
+                it->second.pendingMip = INVALID_STREAMING_MIP;
+                it->second.retryUpdate = m_streamingUpdateCount + TEXTURE_STREAMING_RETRY_DELAY_FRAMES;
+            }
+            return;
+        }
+        FileTextureRequest texReq{};
+        texReq.ioInfo = result;
+        texReq.handle = handle;
+        texReq.semantic = semantic;
+        texReq.isStreamingUpdate = true;
+        SubmitTextureRequest(texReq);
+    };
+    g_pFileReader->SubmitIORequest(req);
+}
+
 void VkTextureManager::CreateSwapchainTextures(const TextureCreationInfoVulkanImage& info,
                                                const TextureInfoBase& infoBase)
 {
@@ -275,35 +635,22 @@ void VkTextureManager::CreateTexture(const FileTextureRequest& req)
     u64 imageSize = readInfo.dataSize > 0 ? readInfo.dataSize : (u64)readInfo.extents.x * readInfo.extents.y * 4;
 
     m_sharedDataMutex.lock();
-
-    StagingBufferVulkan& pStgBuffer = m_stagingBufferInUse.emplace_back(imageSize);
-    if (mips != 0)
+    if (req.isStreamingUpdate)
     {
-        u64 offset = 0;
-        for (auto& mipPixels : readInfo.mipmapPixels)
+        // The texture might have been freed or asked for another mip range in the meantime
+        const auto it = m_streamedTextures.find(req.handle);
+        if (it == m_streamedTextures.end() || it->second.pendingMip != readInfo.firstMipLevel)
         {
-            pStgBuffer.FillImmediate(mipPixels.pData, mipPixels.size, offset);
-            offset = offset + mipPixels.size;
+            if (it != m_streamedTextures.end())
+                it->second.pendingMip = INVALID_STREAMING_MIP;
+            m_sharedDataMutex.unlock();
+            FreeReadTextureData(readInfo);
+            return;
         }
     }
-    else
-    {
-        ASSERT(readInfo.pixels);
-        pStgBuffer.FillImmediate(readInfo.pixels);
-    }
 
-    pStgBuffer.SetName(readInfo.filePath + "_StagingBuffer");
     m_sharedDataMutex.unlock();
 
-    if (readInfo.autoFree)
-    {
-        FileReader::FreeImageData(readInfo.pixels);
-        for (auto& mipmap : readInfo.mipmapPixels)
-        {
-            FileReader::FreeImageData(mipmap.pData);
-        }
-    }
-
     DynamicTextureRequest info{};
     info.extents.x = readInfo.extents.x;
     info.extents.y = readInfo.extents.y;
@@ -312,10 +659,18 @@ void VkTextureManager::CreateTexture(const FileTextureRequest& req)
     {
         info.format = req.format;
     }
+    else if (readInfo.vkFormat != 0)
+    {
+        info.format = ApplySemanticColorSpace(Conv((VkFormat)readInfo.vkFormat), req.semantic);
+    }
     else if (readInfo.ddsFormat != 0)
     {
         info.format = ApplySemanticColorSpace(Conv(GetVkFormatFromDXGI(readInfo.ddsFormat)), req.semantic);
     }
+    else if (readInfo.isHDR)
+    {
+        info.format = TexFormat::R16G16B16A16_FLOAT;
+    }
     else
     {
         info.format = ChooseTextureFormatForSemantic(req.semantic);
@@ -328,39 +683,156 @@ void VkTextureManager::CreateTexture(const FileTextureRequest& req)
     info.hasMipMaps = mips != 0;
     info.mipLevels = mips > 0 ? mips : 1;
 
-    Texture* pTex = CreateTextureImmediate(info);
+    // Streaming updates build a second image that replaces the resident one once it's uploaded
+    stltype::unique_ptr<Texture> pStreamedTex;
+    Texture* pTex = nullptr;
+    if (req.isStreamingUpdate)
+    {
+        pStreamedTex = AllocateTexture(info);
+        pTex = pStreamedTex.get();
+    }
+    else
+    {
+        pTex = CreateTextureImmediate(info);
+    }
 
     pTex->SetName(readInfo.filePath);
 
-    EnqueueAsyncImageLayoutTransition(
-        static_cast<Texture*>(pTex), ImageLayout::UNDEFINED, ImageLayout::TRANSFER_DST_OPTIMAL);
-    
-    stltype::vector<u32> mipLevels;
-    stltype::vector<u64> mipOffsets;
-    u64 currentOffset = 0;
-    if (mips > 0)
+    // The data is copied into the shared staging buffer once the frame's upload budget gets to it
+    {
+        SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+        PendingTextureUpload upload{};
+        upload.pTexture = pTex;
+        upload.handle = req.handle;
+        upload.ioInfo = readInfo;
+        upload.byteSize = imageSize;
+        upload.isPersistent = req.isPersistent;
+        upload.isStreamingUpdate = req.isStreamingUpdate;
+        upload.isReadyOnSubmit = req.makeBindless == false && req.isStreamingUpdate == false;
+        m_pendingUploads.push_back(stltype::move(upload));
+        m_pendingUploadBytes += imageSize;
+        if (req.isStreamingUpdate)
+            m_pendingStreamingSwaps[req.handle] =
+                PendingStreamingSwap{stltype::move(pStreamedTex), readInfo.firstMipLevel, imageSize, false};
+        else if (req.makeBindless)
+            m_texturesAwaitingUpload.insert(pTex);
+    }
+
+    // Note: ImageView and Sampler are already created by CreateTextureImmediate
+
+    if (req.isStreamingUpdate)
+        return;
+
+    if (req.makeBindless)
     {
-        for (u32 i = 0; i < mips; ++i)
+        const BindlessSlot slot = MakeTextureBindless(req.handle, req.isPersistent);
+        // Without a slot there's nothing for the streamer to swap, the texture stays on the placeholder
+        if (req.isStreamed && slot.IsValid())
         {
-            mipLevels.push_back(i);
-            mipOffsets.push_back(currentOffset);
-            currentOffset += readInfo.mipmapPixels[i].size;
+            StreamedTextureInfo streamedInfo{};
+            streamedInfo.filePath = readInfo.filePath;
+            streamedInfo.semantic = req.semantic;
+            streamedInfo.fullExtents = readInfo.fullExtents;
+            streamedInfo.fullMipCount = stltype::max(readInfo.fullMipCount, 1u);
+            streamedInfo.tailMip = readInfo.firstMipLevel;
+            streamedInfo.residentMip = readInfo.firstMipLevel;
+            streamedInfo.wantedMip = readInfo.firstMipLevel;
+            streamedInfo.residentBytes = imageSize;
+            streamedInfo.tailBytes = imageSize;
+
+            SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+            streamedInfo.lastUsedFrame = m_streamingUpdateCount;
+            streamedInfo.bindlessSlot = slot;
+            m_streamedTextures[req.handle] = stltype::move(streamedInfo);
         }
     }
-    else
+}
+
+void VkTextureManager::SubmitPendingUploads()
+{
+    ScopedZone("VkTextureManager::Submit Pending Uploads");
+
+    stltype::vector<PendingTextureUpload> batch;
+    u64 batchBytes = 0;
+    StagingBufferVulkan* pStgBuffer = nullptr;
     {
-        mipLevels.push_back(0);
-        mipOffsets.push_back(0);
+        SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+        const u32 frameNumber = FrameGlobals::GetFrameNumber();
+        if (frameNumber == m_lastUploadFrame || m_isFlushing)
+            return;
+        m_lastUploadFrame = frameNumber;
+        m_uploadedBytesLastFrame = 0;
+        if (m_pendingUploads.empty())
+            return;
+
+        // Always take the first one so textures bigger than the whole budget still get uploaded
+        while (m_pendingUploads.empty() == false)
+        {
+            const u64 uploadBytes = AlignUploadOffset(m_pendingUploads.front().byteSize);
+            if (batch.empty() == false && batchBytes + uploadBytes > m_streamingSettings.uploadBytesPerFrame)
+                break;
+            batchBytes += uploadBytes;
+            m_pendingUploadBytes -= m_pendingUploads.front().byteSize;
+            m_uploadsBeingRecorded.insert(m_pendingUploads.front().handle);
+            batch.push_back(stltype::move(m_pendingUploads.front()));
+            m_pendingUploads.pop_front();
+        }
+        m_uploadedBytesLastFrame = batchBytes;
+        m_processingRequest = true;
+
+        pStgBuffer = &m_stagingBufferInUse.emplace_back(batchBytes);
+        pStgBuffer->SetName("TextureManager_UploadStagingBuffer_" + stltype::to_string(frameNumber));
     }
 
-    EnqueueAsyncTextureTransfer(&pStgBuffer, static_cast<Texture*>(pTex), VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, mipOffsets);
+    // Filling happens outside the lock, the render thread only needs it briefly in PostRender
+    // FreeTexture and Flush wait for m_uploadsBeingRecorded, so the textures stay alive until the copies are enqueued
+    u64 offset = 0;
+    for (auto& upload : batch)
+    {
+        auto& readInfo = upload.ioInfo;
+        stltype::vector<u32> mipLevels;
+        stltype::vector<u64> mipOffsets;
+        if (readInfo.mipmapPixels.empty() == false)
+        {
+            u64 mipOffset = offset;
+            for (u32 i = 0; i < readInfo.mipmapPixels.size(); ++i)
+            {
+                const auto& mipPixels = readInfo.mipmapPixels[i];
+                pStgBuffer->FillImmediate(mipPixels.pData, mipPixels.size, mipOffset);
+                mipLevels.push_back(i);
+                mipOffsets.push_back(mipOffset);
+                mipOffset += mipPixels.size;
+            }
+        }
+        else
+        {
+            ASSERT(readInfo.pixels);
+            pStgBuffer->FillImmediate(readInfo.pixels, upload.byteSize, offset);
+            mipLevels.push_back(0);
+            mipOffsets.push_back(offset);
+        }
+        FreeReadTextureData(readInfo);
+
+        // Every texture's last copy cleans up the staging buffer, which only happens once since they all finish
+        // together with the one submission
+        EnqueueAsyncImageLayoutTransition(upload.pTexture, ImageLayout::UNDEFINED, ImageLayout::TRANSFER_DST_OPTIMAL);
+        EnqueueAsyncTextureTransfer(pStgBuffer, upload.pTexture, VK_IMAGE_ASPECT_COLOR_BIT, mipLevels, mipOffsets);
+        if (upload.isReadyOnSubmit)
+            upload.pTexture->SetStatus(TextureStatus::Ready);
 
-    // Note: ImageView and Sampler are already created by CreateTextureImmediate
+        offset += AlignUploadOffset(upload.byteSize);
+    }
 
-    if (req.makeBindless)
-        MakeTextureBindless(req.handle, req.isPersistent);
-    else
-        pTex->SetStatus(TextureStatus::Ready);
+    SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+    m_uploadsBeingRecorded.clear();
+    m_processingRequest = false;
+}
+
+void VkTextureManager::DropPendingUpload(PendingTextureUpload& upload)
+{
+    FreeReadTextureData(upload.ioInfo);
+    m_pendingUploadBytes -= upload.byteSize;
+    m_texturesAwaitingUpload.erase(upload.pTexture);
 }
 
 Texture* VkTextureManager::CreateDynamicTexture(const DynamicTextureRequest& req)
@@ -372,32 +844,32 @@ Texture* VkTextureManager::CreateTextureImmediate(const DynamicTextureRequest& r
 {
     ScopedZone("VkTextureManager::Create Texture Immediate");
 
-    const auto vulkanTexCreateInfo = FillImageCreateInfoFlat2D(req);
-
-    TextureInfo genericInfo = RequestToTexInfo(req);
+    auto mapEntry = AllocateTexture(req);
+    Texture* pTex = mapEntry.get();
 
     m_sharedDataMutex.lock();
-    Texture* pTex = nullptr;
     if (req.isPersistent)
-    {
-        auto mapEntry = stltype::make_unique<Texture>(vulkanTexCreateInfo, genericInfo);
-        pTex = static_cast<Texture*>(mapEntry.get());
         m_persistentTextures.emplace(req.handle, std::move(mapEntry));
-    }
     else
-    {
-        auto mapEntry = stltype::make_unique<Texture>(vulkanTexCreateInfo, genericInfo);
-        pTex = static_cast<Texture*>(mapEntry.get());
         m_textures.emplace(req.handle, std::move(mapEntry));
-    }
     m_sharedDataMutex.unlock();
 
+    return pTex;
+}
+
+stltype::unique_ptr<Texture> VkTextureManager::AllocateTexture(const DynamicTextureRequest& req)
+{
+    const auto vulkanTexCreateInfo = FillImageCreateInfoFlat2D(req);
+
+    TextureInfo genericInfo = RequestToTexInfo(req);
+
+    auto pTex = stltype::make_unique<Texture>(vulkanTexCreateInfo, genericInfo);
     pTex->SetName(req.GetName());
 
-    CreateImageViewForTexture(pTex, req.hasMipMaps);
+    CreateImageViewForTexture(pTex.get(), req.hasMipMaps);
     if (req.createSampler)
     {
-        CreateSamplerForTexture(pTex, req.hasMipMaps, req.samplerInfo);
+        CreateSamplerForTexture(pTex.get(), req.hasMipMaps, req.samplerInfo);
     }
 
     return pTex;
@@ -444,21 +916,47 @@ TextureHandle VkTextureManager::SubmitAsyncTextureCreation(const TexCreateInfo&
         return 0;
     }
 
-    if (auto* pCachedData = IsAlreadyRequested(filePath, createInfo.semantic); pCachedData != nullptr)
+    // Lookup and insertion happen under one lock so concurrent imports can't request the same file twice
+    TextureHandle handle;
     {
-        return pCachedData->handle;
+        const TextureRequestKey key{TextureRequestKey::NormalizePath(filePath), createInfo.semantic};
+        SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+        m_requestHistory.push_back(key);
+        if (const TextureHandle* pCachedHandle = IsAlreadyRequested(key); pCachedHandle != nullptr)
+        {
+            return *pCachedHandle;
+        }
+
+        handle = GenerateHandle();
+        if (createInfo.isPersistent)
+            m_persistentLoadedTextureCache.Insert(key, handle);
+        else
+            m_loadedTextureCache.Insert(key, handle);
     }
 
     IORequest req{};
-    const auto handle = GenerateHandle();
     bool makeBindless = createInfo.makeBindless;
     TextureSemantic semantic = createInfo.semantic;
     bool isPersistent = createInfo.isPersistent;
+    // Residency of every scene texture is managed, only with streaming enabled they start out with the small mips
+    bool isStreamed = makeBindless && isPersistent == false;
+    bool startsWithTail = false;
+    if (isStreamed)
+    {
+        SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+        startsWithTail = m_streamingSettings.enabled;
+    }
 
     req.filePath = filePath;
     req.requestType = RequestType::Image;
-    req.callback = [this, handle, makeBindless, semantic, isPersistent](const ReadTextureInfo& result)
+    req.textureSemantic = semantic;
+    // Streamed textures start out with their small mips only, the rest follows once something needs them
+    req.maxMipExtent = startsWithTail ? TEXTURE_STREAMING_INITIAL_MAX_EXTENT : 0;
+    req.callback = [this, handle, makeBindless, semantic, isPersistent, isStreamed](const ReadTextureInfo& result)
     {
+        // Materials referencing it keep sampling the placeholder
+        if (result.isValid == false)
+            return;
         FileTextureRequest texReq{};
         texReq.ioInfo = result;
 
@@ -466,15 +964,9 @@ TextureHandle VkTextureManager::SubmitAsyncTextureCreation(const TexCreateInfo&
         texReq.makeBindless = makeBindless;
         texReq.semantic = semantic;
         texReq.isPersistent = isPersistent;
+        texReq.isStreamed = isStreamed;
         SubmitTextureRequest(texReq);
     };
-    {
-        SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
-        if (isPersistent)
-            m_persistentLoadedTextureCache.emplace_back(LoadedTexInfo{filePath, semantic, handle});
-        else
-            m_loadedTextureCache.emplace_back(LoadedTexInfo{filePath, semantic, handle});
-    }
 
     g_pFileReader->SubmitIORequest(req);
     return handle;
@@ -575,6 +1067,15 @@ stltype::vector<Texture*> VkTextureManager::PopPendingGraphicsShaderReadTransiti
     SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
     stltype::vector<Texture*> pending = stltype::move(m_pendingGraphicsShaderReadTransitions);
     m_pendingGraphicsShaderReadTransitions.clear();
+    for (Texture* pTex : pending)
+        m_texturesAwaitingUpload.erase(pTex);
+
+    // The caller records the transitions for this frame, streamed mips can be swapped in at the end of it
+    for (auto& [handle, swap] : m_pendingStreamingSwaps)
+    {
+        if (stltype::find(pending.begin(), pending.end(), swap.pTexture.get()) != pending.end())
+            swap.isUploaded = true;
+    }
     return pending;
 }
 
@@ -701,36 +1202,33 @@ void VkTextureManager::WaitFor(TextureHandle handle)
     }
 }
 
-BindlessTextureHandle VkTextureManager::MakeTextureBindless(TextureHandle handle, bool isPersistent)
+BindlessSlot VkTextureManager::MakeTextureBindless(TextureHandle handle, bool isPersistent)
 {
     SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
     if (const auto it = m_bindlessTextureHandleMap.find(handle); it != m_bindlessTextureHandleMap.end())
     {
-        auto existing = it->second;
-        return existing;
+        return it->second;
     }
 
-    BindlessTextureHandle bindlessHandle = 0;
-    if (isPersistent)
+    const BindlessSlot slot = m_bindlessSlots.Allocate(isPersistent);
+    if (slot.IsValid() == false)
     {
-        DEBUG_ASSERT(m_lastPersistentBindlessTextureWriteIdx < MAX_BINDLESS_TEXTURES);
-        bindlessHandle = m_lastPersistentBindlessTextureWriteIdx++;
-        m_persistentTexturesToMakeBindless.push_back(handle);
+        DEBUG_LOG_WARNF("[VkTextureManager] Out of bindless slots, texture handle {} keeps the placeholder", handle);
+        return slot;
     }
+
+    if (isPersistent)
+        m_persistentTexturesToMakeBindless.push_back({handle, slot});
     else
-    {
-        DEBUG_ASSERT(m_lastBindlessTextureWriteIdx < 14000);
-        bindlessHandle = m_lastBindlessTextureWriteIdx++;
-        m_texturesToMakeBindless.push_back(handle);
-    }
-    m_bindlessTextureHandleMap[handle] = bindlessHandle;
-    return bindlessHandle;
+        m_texturesToMakeBindless.push_back({handle, slot});
+    m_bindlessTextureHandleMap[handle] = slot;
+    return slot;
 }
 
-BindlessTextureHandle VkTextureManager::MakeTextureBindless(TextureVulkan* pTex, bool isPersistent)
+BindlessSlot VkTextureManager::MakeTextureBindless(TextureVulkan* pTex, bool isPersistent)
 {
     DEBUG_ASSERT(false);
-    return 0;
+    return {};
 }
 
 VkTextureManager::~VkTextureManager()
@@ -743,10 +1241,15 @@ VkTextureManager::~VkTextureManager()
         pair.second->CleanUp();
     for (auto& pair : m_persistentTextures)
         pair.second->CleanUp();
+    for (auto& pair : m_pendingStreamingSwaps)
+        pair.second.pTexture->CleanUp();
+    for (auto& upload : m_pendingUploads)
+        FreeReadTextureData(upload.ioInfo);
 
     m_swapChainTextures.clear();
     m_textures.clear();
     m_persistentTextures.clear();
+    m_pendingStreamingSwaps.clear();
 }
 
 void VkTextureManager::EnqueueAsyncTextureTransfer(StagingBufferVulkan* pStagingBuffer,
@@ -858,39 +1361,112 @@ void VkTextureManager::Flush()
 {
     DEBUG_LOGF("[VkTextureManager] Flushing scene textures, keeping persistent ones");
 
+    // No further upload batch is taken until the flush is done, FinishAllRequests waits for the one being recorded
+    m_sharedDataMutex.lock();
+    m_isFlushing = true;
+    m_sharedDataMutex.unlock();
+
     CancelAllRequests();
     FinishAllRequests();
 
     DispatchAsyncOps();
     g_pQueueHandler->DispatchAllRequests();
     SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+    DEBUG_ASSERT(m_uploadsBeingRecorded.empty());
+    m_isFlushing = false;
+
+    // Persistent textures keep their place in the upload queue
+    for (auto it = m_pendingUploads.begin(); it != m_pendingUploads.end();)
+    {
+        if (it->isPersistent)
+        {
+            ++it;
+            continue;
+        }
+        DropPendingUpload(*it);
+        it = m_pendingUploads.erase(it);
+    }
 
     for (auto it = m_textures.begin(); it != m_textures.end();)
     {
-        it->second->CleanUp();
+        m_texturesAwaitingUpload.erase(it->second.get());
+        RetireTexture(it->second.release());
         it = m_textures.erase(it);
     }
 
+    for (auto& [handle, swap] : m_pendingStreamingSwaps)
+    {
+        auto pendingIt = stltype::find(m_pendingGraphicsShaderReadTransitions.begin(),
+                                       m_pendingGraphicsShaderReadTransitions.end(),
+                                       swap.pTexture.get());
+        if (pendingIt != m_pendingGraphicsShaderReadTransitions.end())
+            m_pendingGraphicsShaderReadTransitions.erase(pendingIt);
+        swap.pTexture->CleanUp();
+    }
+    m_pendingStreamingSwaps.clear();
+    m_streamedTextures.clear();
+    m_streamingFeedback.clear();
+    m_hasStreamingFeedback = false;
+
     m_texturesToMakeBindless.clear();
-    m_loadedTextureCache.clear();
-    m_bindlessTextureHandleMap.clear();
-    // Keep slot 0 reserved as invalid/placeholder for material paths that treat 0 specially.
-    m_lastBindlessTextureWriteIdx = 1;
-    m_lastPersistentBindlessTextureWriteIdx = 14000;
+    m_loadedTextureCache.Clear();
+    m_requestHistory.clear();
+    // Persistent textures survive the flush and keep their slots
+    const auto freedSlots = m_bindlessSlots.FreeAll(false, FrameGlobals::GetFrameNumber());
+    if (m_pPlaceholderTexture != nullptr)
+    {
+        for (const u32 slot : freedSlots)
+            WriteBindlessDescriptors(m_pPlaceholderTexture, slot);
+    }
+    for (auto it = m_bindlessTextureHandleMap.begin(); it != m_bindlessTextureHandleMap.end();)
+    {
+        if (it->second.index < m_bindlessSlots.GetTransientEnd())
+            it = m_bindlessTextureHandleMap.erase(it);
+        else
+            ++it;
+    }
 }
 
 void VkTextureManager::FreeTexture(TextureHandle handle)
 {
+    // Its upload might be getting recorded outside the lock right now, the texture has to outlive that
     m_sharedDataMutex.lock();
+    while (m_uploadsBeingRecorded.find(handle) != m_uploadsBeingRecorded.end())
+    {
+        m_sharedDataMutex.unlock();
+        Sleep(1);
+        m_sharedDataMutex.lock();
+    }
     auto it = m_textures.find(handle);
     auto itPersistent = m_persistentTextures.find(handle);
 
     DEBUG_ASSERT(!(it != m_textures.end() && itPersistent != m_persistentTextures.end())); // Should not be in both!
 
+    // Nothing was recorded for queued uploads yet, so queued streaming swaps can go right away as well
+    for (auto uploadIt = m_pendingUploads.begin(); uploadIt != m_pendingUploads.end();)
+    {
+        if (uploadIt->handle != handle)
+        {
+            ++uploadIt;
+            continue;
+        }
+        DropPendingUpload(*uploadIt);
+        if (uploadIt->isStreamingUpdate)
+        {
+            if (auto swapIt = m_pendingStreamingSwaps.find(handle); swapIt != m_pendingStreamingSwaps.end())
+            {
+                swapIt->second.pTexture->CleanUp();
+                m_pendingStreamingSwaps.erase(swapIt);
+            }
+        }
+        uploadIt = m_pendingUploads.erase(uploadIt);
+    }
+
     if (it != m_textures.end())
     {
         DEBUG_LOGF("[VkTextureManager] Freeing scene texture \"{}\" handle {}", it->second->GetName().c_str(), handle);
-        it->second->CleanUp();
+        m_texturesAwaitingUpload.erase(it->second.get());
+        RetireTexture(it->second.release());
         m_textures.erase(it);
     }
     else if (itPersistent != m_persistentTextures.end())
@@ -898,18 +1474,27 @@ void VkTextureManager::FreeTexture(TextureHandle handle)
         DEBUG_LOGF("[VkTextureManager] Freeing persistent texture \"{}\" handle {}",
                    itPersistent->second->GetName().c_str(),
                    handle);
-        itPersistent->second->CleanUp();
+        m_texturesAwaitingUpload.erase(itPersistent->second.get());
+        RetireTexture(itPersistent->second.release());
         m_persistentTextures.erase(itPersistent);
     }
-    else
+    else if (m_streamedTextures.find(handle) == m_streamedTextures.end())
     {
         DEBUG_LOGF("[VkTextureManager] Tried to free invalid texture handle {}", handle);
     }
 
-    m_bindlessTextureHandleMap.erase(handle);
+    if (const auto slotIt = m_bindlessTextureHandleMap.find(handle); slotIt != m_bindlessTextureHandleMap.end())
+    {
+        // Stale material indices keep sampling the slot, point it at the placeholder before the view goes away
+        if (m_bindlessSlots.Free(slotIt->second, FrameGlobals::GetFrameNumber()) && m_pPlaceholderTexture != nullptr)
+            WriteBindlessDescriptors(m_pPlaceholderTexture, slotIt->second.index);
+        m_bindlessTextureHandleMap.erase(slotIt);
+    }
+    // A streaming swap still in flight is thrown away once its upload finished
+    m_streamedTextures.erase(handle);
     for (auto pendingIt = m_texturesToMakeBindless.begin(); pendingIt != m_texturesToMakeBindless.end();)
     {
-        if (*pendingIt == handle)
+        if (pendingIt->handle == handle)
             pendingIt = m_texturesToMakeBindless.erase(pendingIt);
         else
             ++pendingIt;
@@ -917,7 +1502,7 @@ void VkTextureManager::FreeTexture(TextureHandle handle)
     for (auto pendingIt = m_persistentTexturesToMakeBindless.begin();
          pendingIt != m_persistentTexturesToMakeBindless.end();)
     {
-        if (*pendingIt == handle)
+        if (pendingIt->handle == handle)
             pendingIt = m_persistentTexturesToMakeBindless.erase(pendingIt);
         else
             ++pendingIt;
@@ -1329,25 +1914,16 @@ void VkTextureManager::CreateBindlessDescriptorSet()
     }
 }
 
-const VkTextureManager::LoadedTexInfo* VkTextureManager::IsAlreadyRequested(const stltype::string& filePath,
-                                                                            TextureSemantic semantic) const
+const TextureHandle* VkTextureManager::IsAlreadyRequested(const TextureRequestKey& key) const
 {
     SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
-    if (const auto it = stltype::find_if(m_loadedTextureCache.cbegin(),
-                                         m_loadedTextureCache.cend(),
-                                         [&filePath, semantic](const LoadedTexInfo& info)
-                                         { return info.filePath == filePath && info.semantic == semantic; });
-        it != m_loadedTextureCache.cend())
-    {
-        return &(*it);
-    }
-    if (const auto it = stltype::find_if(m_persistentLoadedTextureCache.cbegin(),
-                                         m_persistentLoadedTextureCache.cend(),
-                                         [&filePath, semantic](const LoadedTexInfo& info)
-                                         { return info.filePath == filePath && info.semantic == semantic; });
-        it != m_persistentLoadedTextureCache.cend())
-    {
-        return &(*it);
-    }
-    return nullptr;
+    if (const TextureHandle* pHandle = m_loadedTextureCache.Find(key))
+        return pHandle;
+    return m_persistentLoadedTextureCache.Find(key);
+}
+
+stltype::vector<TextureRequestKey> VkTextureManager::GetRequestHistory() const
+{
+    SimpleScopedGuard<tracy::Lockable<CustomMutex>> lock(m_sharedDataMutex);
+    return m_requestHistory;
 }
@@ -5,9 +5,11 @@
 #include "Core/Global/ThreadBase.h"
 #include "Core/Global/Typedefs.h"
 #include "Core/IO/FileReader.h"
+#include "Core/Rendering/Core/BindlessSlotAllocator.h"
 #include "Core/Rendering/Core/CommandBuffer.h"
 #include "Core/Rendering/Core/RenderingForwardDecls.h"
 #include "Core/Rendering/Core/RenderDefinitions.h"
+#include "Core/Rendering/Core/TextureRequestCache.h"
 #include "Core/Rendering/Vulkan/Utils/TextureEnums.h"
 #include "Core/Rendering/Core/TransferUtils/TransferDefines.h"
 #include "Core/Rendering/Vulkan/VkCommandBuffer.h"
@@ -85,9 +87,57 @@ struct FileTextureRequest
     TextureHandle handle;
     bool makeBindless{true};
     bool isPersistent{false};
+    // Reloadable from its file, so its mips are streamed and it can be evicted under memory pressure
+    bool isStreamed{false};
+    // Different mip range for an already streamed texture, replaces its image once uploaded
+    bool isStreamingUpdate{false};
     TextureSemantic semantic{TextureSemantic::Auto};
     TexFormat format{TexFormat::UNDEFINED};
 };
+
+// Largest side of the mips a streamed texture starts with, anything more detailed is streamed in on demand
+static inline constexpr u32 TEXTURE_STREAMING_INITIAL_MAX_EXTENT = 128;
+// Residency changes allowed to be loading at once
+static inline constexpr u32 TEXTURE_STREAMING_MAX_PENDING_LOADS = 8;
+// Frames a texture has to ask for less detail before its mips are dropped while the budget isn't exceeded
+static inline constexpr u32 TEXTURE_STREAMING_DROP_DELAY_FRAMES = 120;
+// Frames before a texture whose reload failed is considered for residency changes again
+static inline constexpr u32 TEXTURE_STREAMING_RETRY_DELAY_FRAMES = 300;
+// Part of the VMA budget kept free for other allocations when deriving how much textures may use
+static inline constexpr f32 TEXTURE_RESIDENCY_VRAM_HEADROOM = 0.1f;
+// Frames a texture has to be unused before it's evicted to the placeholder instead of just giving up mips
+static inline constexpr u64 TEXTURE_RESIDENCY_MIN_UNUSED_FRAMES = 300;
+
+struct TextureStreamingSettings
+{
+    // Only affects textures requested afterwards, disabling it streams the existing ones back in completely
+    // Eviction under the VMA budget stays active either way
+    bool enabled{true};
+    u64 budgetBytes{1024ull * 1024 * 1024};
+    // Texture data copied into the shared staging buffer per frame, a single larger texture still goes through alone
+    u64 uploadBytesPerFrame{32ull * 1024 * 1024};
+};
+
+struct TextureStreamingStats
+{
+    u32 streamedTextureCount{0};
+    u32 pendingLoadCount{0};
+    u32 evictedTextureCount{0};
+    // Since startup
+    u64 evictionCount{0};
+    u64 residentBytes{0};
+    // Everything the feedback asked for before the budget was applied
+    u64 wantedBytes{0};
+    // Configured budget clamped to what the VMA budget leaves for textures
+    u64 budgetBytes{0};
+    u64 vramBudgetBytes{0};
+    u64 vramUsageBytes{0};
+    // Loaded textures waiting for their share of the per frame upload budget
+    u32 uploadQueueDepth{0};
+    u64 uploadQueueBytes{0};
+    u64 uploadedBytesLastFrame{0};
+};
+
 struct AsyncLayoutTransitionRequest
 {
     stltype::vector<const Texture*> textures;
@@ -126,9 +176,12 @@ public:
     VkTextureManager();
     ~VkTextureManager();
 
-    void Init();
+    // persistentBindlessSlots are taken from the end of the bindless table, the rest is shared by scene textures
+    void Init(u32 persistentBindlessSlots = DEFAULT_PERSISTENT_BINDLESS_SLOTS);
 
     void CheckRequests();
+    // Copies queued texture data into one staging buffer and records the transfers, at most once per frame
+    void SubmitPendingUploads();
 
     // Mainly used to upload new bindless textures
     void PostRender();
@@ -181,8 +234,9 @@ public:
     // Async operations to transfer texture data to the global bindless texture array
     // Immediately returns a handle to the texture, if the texture is not ready yet a placeholder texture will be used
     // Should take one frame max so who cares
-    BindlessTextureHandle MakeTextureBindless(TextureHandle handle, bool isPersistent = false);
-    BindlessTextureHandle MakeTextureBindless(TextureVulkan* pTex, bool isPersistent = false);
+    // The slot is invalid if the bindless table ran out, slot index 0 then keeps sampling the placeholder
+    BindlessSlot MakeTextureBindless(TextureHandle handle, bool isPersistent = false);
+    BindlessSlot MakeTextureBindless(TextureVulkan* pTex, bool isPersistent = false);
 
     void EnqueueAsyncTextureTransfer(StagingBufferVulkan* pStagingBuffer,
                                      Texture* pTex,
@@ -200,6 +254,13 @@ public:
 
     void FreeTexture(TextureHandle handle);
 
+    // Texels every bindless texture needs across its UV range as seen this frame, residency follows it in PostRender
+    // Takes the settings along and returns the stats of the last update so the renderer only locks once per frame
+    TextureStreamingStats SubmitStreamingFeedback(
+        const TextureStreamingSettings& settings,
+        stltype::vector<stltype::pair<BindlessTextureHandle, f32>>&& requiredExtents);
+    stltype::vector<TextureRequestKey> GetRequestHistory() const;
+
     bool ShouldFlipNormalMap(const stltype::string& path) const;
 
     stltype::vector<TextureVulkan>& GetSwapChainTextures()
@@ -231,18 +292,72 @@ protected:
     static void SetNoSwizzle(VkImageViewCreateInfo& createInfo);
 
     VkImageCreateInfo FillImageCreateInfoFlat2D(const DynamicTextureRequest& info);
+    // Creates the image, view and sampler without registering the texture anywhere
+    stltype::unique_ptr<Texture> AllocateTexture(const DynamicTextureRequest& req);
+    void WriteBindlessDescriptors(TextureVulkan* pTex, u32 bindlessIdx);
 
     void CreateTransferCommandPool();
     void CreateTransferCommandBuffer();
     void CreateBindlessDescriptorSet();
 
-    struct LoadedTexInfo
+    const TextureHandle* IsAlreadyRequested(const TextureRequestKey& key) const;
+
+    static inline constexpr u32 INVALID_STREAMING_MIP = ~0u;
+    struct StreamedTextureInfo
     {
         stltype::string filePath;
         TextureSemantic semantic{TextureSemantic::Auto};
-        TextureHandle handle;
+        BindlessSlot bindlessSlot{};
+        DirectX::XMINT2 fullExtents{};
+        u32 fullMipCount{0};
+        // Mips are addressed by their level in the full chain, the tail is what's loaded up front and only dropped by
+        // evicting the whole texture, which is marked by residentMip == fullMipCount
+        u32 tailMip{0};
+        u32 residentMip{0};
+        u32 pendingMip{INVALID_STREAMING_MIP};
+        u32 wantedMip{0};
+        u64 residentBytes{0};
+        u64 tailBytes{0};
+        f32 requiredExtent{0.0f};
+        // In streaming updates, see m_streamingUpdateCount
+        u64 lastUsedFrame{0};
+        u32 framesWantingLess{0};
+        // No residency changes before this streaming update, set after a failed reload
+        u64 retryUpdate{0};
+
+        // Memory of the chain starting at firstMip, extrapolated from the tail
+        u64 EstimateBytes(u32 firstMip) const;
+        bool IsEvicted() const
+        {
+            return residentMip >= fullMipCount;
+        }
     };
-    const LoadedTexInfo* IsAlreadyRequested(const stltype::string& filePath, TextureSemantic semantic) const;
+    struct PendingStreamingSwap
+    {
+        stltype::unique_ptr<Texture> pTexture;
+        u32 firstMip{0};
+        u64 bytes{0};
+        bool isUploaded{false};
+    };
+    void UpdateStreaming();
+    void RequestStreamedMips(TextureHandle handle, StreamedTextureInfo& info, u32 firstMip);
+    void ApplyStreamingSwaps();
+    void EvictTexture(TextureHandle handle, StreamedTextureInfo& info);
+    // Destroys the texture once the frames that might still reference it are done
+    void RetireTexture(Texture* pTex);
+
+    struct PendingTextureUpload
+    {
+        Texture* pTexture{nullptr};
+        TextureHandle handle{0};
+        ReadTextureInfo ioInfo;
+        u64 byteSize{0};
+        bool isPersistent{false};
+        bool isStreamingUpdate{false};
+        // Textures outside the bindless table don't wait for the descriptor write in PostRender
+        bool isReadyOnSubmit{false};
+    };
+    void DropPendingUpload(PendingTextureUpload& upload);
 
 protected:
     // Manager thread data
@@ -250,9 +365,12 @@ protected:
     CommandBuffer* m_transferCommandBuffer{nullptr};
     stltype::vector<CommandBuffer*> m_inflightCommandBuffers;
     stltype::vector<CommandBuffer*> m_availableCommandBuffers;
-    stltype::vector<LoadedTexInfo> m_loadedTextureCache;
-    stltype::vector<LoadedTexInfo> m_persistentLoadedTextureCache;
-    stltype::hash_map<TextureHandle, BindlessTextureHandle> m_bindlessTextureHandleMap;
+    TextureRequestCache m_loadedTextureCache;
+    TextureRequestCache m_persistentLoadedTextureCache;
+    // Every file request since the last flush, replayed by the request cache benchmark
+    stltype::vector<TextureRequestKey> m_requestHistory;
+    stltype::hash_map<TextureHandle, BindlessSlot> m_bindlessTextureHandleMap;
+    BindlessSlotAllocator m_bindlessSlots;
     DescriptorPoolVulkan m_bindlessDescriptorPool;
     DescriptorSetVulkan* m_bindlessDescriptorSet{nullptr};
     DescriptorSetLayoutVulkan m_bindlessDescriptorSetLayout;
@@ -260,9 +378,34 @@ protected:
     DescriptorSetLayoutVulkan m_bindlessImageDescriptorSetLayout;
     DescriptorSetVulkan* m_combinedBindlessDescriptorSet{nullptr};
     DescriptorSetLayoutVulkan m_combinedBindlessDescriptorSetLayout;
-    stltype::vector<TextureHandle> m_texturesToMakeBindless;
-    stltype::vector<TextureHandle> m_persistentTexturesToMakeBindless;
+    struct PendingBindlessTexture
+    {
+        TextureHandle handle{0};
+        BindlessSlot slot{};
+    };
+    stltype::vector<PendingBindlessTexture> m_texturesToMakeBindless;
+    stltype::vector<PendingBindlessTexture> m_persistentTexturesToMakeBindless;
     stltype::vector<Texture*> m_pendingGraphicsShaderReadTransitions;
+    stltype::hash_map<TextureHandle, StreamedTextureInfo> m_streamedTextures;
+    stltype::hash_map<TextureHandle, PendingStreamingSwap> m_pendingStreamingSwaps;
+    stltype::vector<stltype::pair<BindlessTextureHandle, f32>> m_streamingFeedback;
+    bool m_hasStreamingFeedback{false};
+    TextureStreamingSettings m_streamingSettings{};
+    TextureStreamingStats m_streamingStats{};
+    u64 m_evictionCount{0};
+    // Incremented by every UpdateStreaming
+    u64 m_streamingUpdateCount{0};
+    TextureVulkan* m_pPlaceholderTexture{nullptr};
+    stltype::deque<PendingTextureUpload> m_pendingUploads;
+    u64 m_pendingUploadBytes{0};
+    u64 m_uploadedBytesLastFrame{0};
+    u32 m_lastUploadFrame{~0u};
+    // Bindless textures keep sampling the placeholder until their transfer finished
+    stltype::hash_set<Texture*> m_texturesAwaitingUpload;
+    // Handles of the batch SubmitPendingUploads took out of m_pendingUploads and is still recording
+    stltype::hash_set<TextureHandle> m_uploadsBeingRecorded;
+    // Set by Flush, keeps SubmitPendingUploads from taking another batch meanwhile
+    bool m_isFlushing{false};
 
     // Frequently accessed by threads
     stltype::queue<TextureRequest> m_requests{}; // Pending texture requests, mainly handled by manager thread
@@ -272,8 +415,6 @@ protected:
     stltype::vector<TextureVulkan> m_swapChainTextures;
 
     stltype::atomic<u32> m_baseHandle{0};
-    u32 m_lastBindlessTextureWriteIdx{0};
-    u32 m_lastPersistentBindlessTextureWriteIdx{14000}; // Around 15% of 16536 reserved for persistent
     
     stltype::atomic<bool> m_processingRequest{false};
 };
@@ -1,4 +1,6 @@
 #include "Mesh.h"
+#include "Core/IO/AssetCache.h"
+#include "Core/Global/Utils/MathFunctions.h"
 
 
 MeshManager::MeshManager()
@@ -151,9 +153,87 @@ void MeshManager::Flush()
     // Keep only the first three (Triangle, Plane and Cube primitives)
     m_meshes.erase(m_meshes.begin() + 3, m_meshes.end());
 
+    m_meshesByContentHash.clear();
+    m_meshInstanceCounts.clear();
+    m_deduplicatedMeshCount = 0;
+
     // Clear AABBs but re-add primitives
     m_meshAABBs.clear();
     CalcAABB(mathstl::Vector3{-1.0f, -3.0f, 0.0f}, mathstl::Vector3{3.0f, 1.0f, 0.0f}, m_pFullscreenTrianglePrimitive);
     CalcAABB(mathstl::Vector3{-1.0f, -1.0f, 0.0f}, mathstl::Vector3{1.0f, 1.0f, 0.0f}, m_pPlanePrimitive);
     CalcAABB(mathstl::Vector3{-0.5f}, mathstl::Vector3{0.5f}, m_pCubePrimitive);
 }
+
+Mesh* MeshManager::FindOrAllocateMesh(stltype::vector<CompleteVertex>&& vertices,
+                                      stltype::vector<u32>&& indices,
+                                      u64 contentHash,
+                                      stltype::vector<MeshLOD>&& lods,
+                                      stltype::vector<MeshletData>&& meshlets,
+                                      stltype::vector<u32>&& meshletIndices)
+{
+    const auto range = m_meshesByContentHash.equal_range(contentHash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        const Mesh* pCandidate = it->second;
+        // Hash collisions are unlikely but would render the wrong geometry, so compare the actual data
+        if (pCandidate->vertices.size() == vertices.size() && pCandidate->indices.size() == indices.size() &&
+            memcmp(pCandidate->vertices.data(), vertices.data(), vertices.size() * sizeof(CompleteVertex)) == 0 &&
+            memcmp(pCandidate->indices.data(), indices.data(), indices.size() * sizeof(u32)) == 0)
+        {
+            ++m_deduplicatedMeshCount;
+            return it->second;
+        }
+    }
+
+    auto* pMesh = AllocateMesh(stltype::move(vertices), stltype::move(indices));
+    pMesh->lods = stltype::move(lods);
+    pMesh->meshlets = stltype::move(meshlets);
+    pMesh->meshletIndices = stltype::move(meshletIndices);
+    m_meshesByContentHash.insert({contentHash, pMesh});
+    return pMesh;
+}
+
+u64 MeshManager::HashMeshContent(const stltype::vector<CompleteVertex>& vertices, const stltype::vector<u32>& indices)
+{
+    const u64 vertexHash = AssetHashing::HashBytes(vertices.data(), vertices.size() * sizeof(CompleteVertex));
+    return AssetHashing::HashBytes(indices.data(), indices.size() * sizeof(u32), vertexHash);
+}
+
+f32 MeshManager::ComputeUVDensity(const stltype::vector<CompleteVertex>& vertices, const stltype::vector<u32>& indices)
+{
+    f64 surfaceArea = 0.0;
+    f64 uvArea = 0.0;
+    for (u64 i = 0; i + 2 < indices.size(); i += 3)
+    {
+        const auto& v0 = vertices[indices[i]];
+        const auto& v1 = vertices[indices[i + 1]];
+        const auto& v2 = vertices[indices[i + 2]];
+        surfaceArea += (v1.position - v0.position).Cross(v2.position - v0.position).Length();
+        const mathstl::Vector2 uv1 = v1.texCoord - v0.texCoord;
+        const mathstl::Vector2 uv2 = v2.texCoord - v0.texCoord;
+        uvArea += mathstl::abs(uv1.x * uv2.y - uv1.y * uv2.x);
+    }
+    if (surfaceArea <= FLOAT_TOLERANCE || uvArea <= FLOAT_TOLERANCE)
+        return 0.0f;
+    return (f32)sqrt(uvArea / surfaceArea);
+}
+
+void MeshManager::AddMeshInstance(const Mesh* pMesh)
+{
+    ++m_meshInstanceCounts[pMesh];
+}
+
+void MeshManager::RemoveMeshInstance(const Mesh* pMesh)
+{
+    const auto it = m_meshInstanceCounts.find(pMesh);
+    if (it == m_meshInstanceCounts.end())
+        return;
+    if (--it->second == 0)
+        m_meshInstanceCounts.erase(it);
+}
+
+u32 MeshManager::GetMeshInstanceCount(const Mesh* pMesh) const
+{
+    const auto it = m_meshInstanceCounts.find(pMesh);
+    return it != m_meshInstanceCounts.end() ? it->second : 0;
+}
@@ -4,6 +4,14 @@
 #include "Core/Rendering/Core/Defines/GlobalBuffers.h"
 #include "Core/Rendering/Core/Defines/VertexDefines.h"
 
+// Simplified version of a mesh, shares the vertices of the full detail mesh and only carries its own indices
+struct MeshLOD
+{
+    stltype::vector<u32> indices;
+    // Geometric error relative to the mesh bounding sphere radius, used for screen space selection
+    f32 error{0.0f};
+};
+
 struct Mesh
 {
 public:
@@ -17,7 +25,15 @@ public:
 
     stltype::vector<CompleteVertex> vertices;
     stltype::vector<u32> indices;
+    // Coarser levels only, the indices above are always LOD 0
+    stltype::vector<MeshLOD> lods;
+    // Clusters of LOD 0, MeshletData offsets point into meshletIndices which holds the vertex references followed by
+    // the packed triangles of every meshlet
+    stltype::vector<MeshletData> meshlets;
+    stltype::vector<u32> meshletIndices;
     AABB boundingBox{};
+    // UV units per object space unit for texture streaming, set by the mesh converter, 0 if unknown
+    f32 uvDensity{0.0f};
     u32 rtMeshId{InvalidRTMeshId};
     u32 rtMeshGeneration{0};
 };
@@ -38,6 +54,42 @@ public:
         return pMesh;
     }
 
+    Mesh* AllocateMesh(stltype::vector<CompleteVertex> vertices, stltype::vector<u32> indices)
+    {
+        m_meshes.push_back(stltype::make_unique<Mesh>(stltype::move(vertices), stltype::move(indices)));
+        auto* pMesh = m_meshes.back().get();
+        AllocateRTMeshIdentity(*pMesh);
+        return pMesh;
+    }
+
+    // Returns an already allocated mesh with identical vertex and index data if there is one, so duplicates share one
+    // Mesh and with it one MeshHandle. The hash is passed in so callers can compute it on their jobs
+    // LODs and meshlets are derived from the vertex and index data so they don't take part in the comparison
+    Mesh* FindOrAllocateMesh(stltype::vector<CompleteVertex>&& vertices,
+                             stltype::vector<u32>&& indices,
+                             u64 contentHash,
+                             stltype::vector<MeshLOD>&& lods = {},
+                             stltype::vector<MeshletData>&& meshlets = {},
+                             stltype::vector<u32>&& meshletIndices = {});
+    static u64 HashMeshContent(const stltype::vector<CompleteVertex>& vertices, const stltype::vector<u32>& indices);
+    // UV units per object space unit, from the ratio of the summed UV area to the summed triangle area
+    // Walks every triangle so it's meant for load time, returns 0 for meshes without usable UVs
+    static f32 ComputeUVDensity(const stltype::vector<CompleteVertex>& vertices, const stltype::vector<u32>& indices);
+
+    // Number of render components referencing a mesh, anything above one can be batched into instanced draws
+    void AddMeshInstance(const Mesh* pMesh);
+    // Meshes whose last instance is removed drop out of GetMeshInstanceCounts, untracked meshes are ignored
+    void RemoveMeshInstance(const Mesh* pMesh);
+    u32 GetMeshInstanceCount(const Mesh* pMesh) const;
+    const stltype::hash_map<const Mesh*, u32>& GetMeshInstanceCounts() const
+    {
+        return m_meshInstanceCounts;
+    }
+    u32 GetDeduplicatedMeshCount() const
+    {
+        return m_deduplicatedMeshCount;
+    }
+
     AABB CalcAABB(const mathstl::Vector3& min, const mathstl::Vector3& max, const Mesh* pMesh = nullptr)
     {
         AABB aabb{};
@@ -76,6 +128,9 @@ private:
 
     stltype::vector<stltype::unique_ptr<Mesh>> m_meshes;
     stltype::hash_map<const Mesh*, AABB> m_meshAABBs;
+    stltype::hash_multimap<u64, Mesh*> m_meshesByContentHash;
+    stltype::hash_map<const Mesh*, u32> m_meshInstanceCounts;
+    u32 m_deduplicatedMeshCount{0};
     Mesh* m_pPlanePrimitive;
     Mesh* m_pCubePrimitive;
     Mesh* m_pFullscreenTrianglePrimitive;
@@ -5,8 +5,11 @@
 #include "Core/Global/GlobalVariables.h"
 #include "Core/Global/Profiling.h"
 #include "Core/Global/State/ApplicationState.h"
+#include "Core/Global/ThreadPool.h"
 #include "Core/Global/Utils/MathFunctions.h"
+#include "Core/IO/ImageDecoder.h"
 #include "Core/Rendering/Core/Nvidia/StreamlineManager.h"
+#include "Core/Rendering/Core/TextureManager.h"
 #include "Core/Rendering/Vulkan/VkGlobals.h"
 #include "InfoWindow.h"
 #include <EASTL/hash_map.h>
@@ -23,6 +26,11 @@ public:
         g_pEventSystem->AddUpdateEventCallback([this](const UpdateEventData& d) { OnUpdate(d); });
     }
 
+    ~PerformanceDiagnosticsWindow()
+    {
+        g_pJobPool->Wait(m_decodeBenchmarkJobs);
+    }
+
     void DrawWindow(f32 dt)
     {
         ScopedZone("PerformanceDiagnosticsWindow");
@@ -93,6 +101,157 @@ public:
             ImGui::Text("Resident RT Instances: %u", m_lastState.rt.residentInstanceCount);
         }
 
+        if (ImGui::CollapsingHeader("Texture Residency"))
+        {
+            const f64 toMB = 1.0 / (1024.0 * 1024.0);
+            ImGui::Text("VMA Budget: %.1f MB used of %.1f MB",
+                        m_lastState.vramBudgetUsageBytes * toMB,
+                        m_lastState.vramBudgetBytes * toMB);
+            ImGui::Text("Texture Budget: %.1f MB", m_lastState.textureResidencyBudgetBytes * toMB);
+            ImGui::Text("Resident Textures: %.1f MB, %.1f MB wanted",
+                        m_lastState.textureStreamingResidentBytes * toMB,
+                        m_lastState.textureStreamingWantedBytes * toMB);
+            ImGui::Text("Managed Textures: %u, %u evicted, %u loading",
+                        m_lastState.streamedTextureCount,
+                        m_lastState.evictedTextureCount,
+                        m_lastState.pendingTextureStreamingLoads);
+            ImGui::Text("Evictions: %llu", m_lastState.textureEvictionCount);
+            ImGui::Text("Upload Queue: %u textures, %.1f MB",
+                        m_lastState.textureUploadQueueDepth,
+                        m_lastState.textureUploadQueueBytes * toMB);
+            ImGui::Text("Uploaded Last Frame: %.1f MB of %u MB budget",
+                        m_lastState.textureUploadedBytesLastFrame * toMB,
+                        m_lastState.textureUploadBudgetMB);
+        }
+
+        if (ImGui::CollapsingHeader("Buffer Uploads"))
+        {
+            const f64 toKB = 1.0 / 1024.0;
+            ImGui::Text("Upload Ring: %.1f KB in %u updates",
+                        m_lastState.uploadRingBytes * toKB,
+                        m_lastState.uploadRingUpdateCount);
+            ImGui::Text("Staging Copies: %.1f KB in %u updates",
+                        m_lastState.stagedUploadBytes * toKB,
+                        m_lastState.stagedUploadCount);
+        }
+
+        if (ImGui::CollapsingHeader("GPU Memory"))
+        {
+            const f64 toMB = 1.0 / (1024.0 * 1024.0);
+            if (g_pGPUMemoryManager->GetAllocatorMode() == Allocator::Convolution)
+            {
+                for (u32 i = 0; i < (u32)GPUMemoryCategory::Count; ++i)
+                {
+                    const GPUMemoryCategory category = (GPUMemoryCategory)i;
+                    const GPUMemoryCategoryStats stats = g_pGPUMemoryManager->GetCategoryStats(category);
+                    ImGui::Separator();
+                    ImGui::Text("%s: %.1f MB of %.1f MB budget in %u allocations%s",
+                                GetGPUMemoryCategoryName(category),
+                                stats.allocatedBytes * toMB,
+                                stats.budgetBytes * toMB,
+                                stats.allocationCount,
+                                stats.overBudgetAllocations > 0 ? ", over budget" : "");
+                    ImGui::Text("Reserved: %.1f MB in %u blocks, %u dedicated",
+                                stats.reservedBytes * toMB,
+                                stats.blockCount,
+                                stats.dedicatedCount);
+                    ImGui::Text("Free: %.1f MB in %u ranges, largest %.1f MB, %.0f%% fragmented",
+                                stats.freeBytes * toMB,
+                                stats.freeRangeCount,
+                                stats.largestFreeBlock * toMB,
+                                stats.GetFragmentation() * 100.0f);
+                }
+            }
+            else
+            {
+                ImGui::Text("Category stats are only tracked by the Convolution allocator");
+            }
+
+            ImGui::Separator();
+            // Creates and destroys real buffers on the render device from a bounded sample of the history
+            if (ImGui::Button("Replay scene buffer churn"))
+            {
+                m_allocatorBenchmark = g_pGPUMemoryManager->RunAllocatorBenchmark();
+            }
+            if (m_allocatorBenchmark.allocationCount > 0)
+            {
+                ImGui::Text("%u buffers per load", m_allocatorBenchmark.allocationCount);
+                ImGui::Text("VMA: %.3f ms allocate, %.3f ms free%s",
+                            m_allocatorBenchmark.vmaAllocateMs,
+                            m_allocatorBenchmark.vmaFreeMs,
+                            m_allocatorBenchmark.vmaOutOfMemory ? ", out of memory" : "");
+                ImGui::Text("Convolution: %.3f ms allocate, %.3f ms free%s",
+                            m_allocatorBenchmark.convolutionAllocateMs,
+                            m_allocatorBenchmark.convolutionFreeMs,
+                            m_allocatorBenchmark.convolutionOutOfMemory ? ", out of memory" : "");
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Texture Request Cache Benchmark"))
+        {
+            // Replays every texture reference the current scene's import made, e.g. Bistro's material set
+            if (ImGui::Button("Replay scene texture requests"))
+            {
+                m_requestCacheBenchmark = RunTextureRequestCacheBenchmark(g_pTexManager->GetRequestHistory());
+            }
+            if (m_requestCacheBenchmark.requestCount > 0)
+            {
+                ImGui::Text("%u requests, %u unique textures",
+                            m_requestCacheBenchmark.requestCount,
+                            m_requestCacheBenchmark.uniqueTextureCount);
+                ImGui::Text("Linear scan: %.3f ms", m_requestCacheBenchmark.linearScanMs);
+                const f64 hashedMs = stltype::max(m_requestCacheBenchmark.hashedMs, 0.0001);
+                ImGui::Text("Hashed: %.3f ms, %.1fx", hashedMs, m_requestCacheBenchmark.linearScanMs / hashedMs);
+            }
+        }
+
+        if (ImGui::CollapsingHeader("Texture Decode Benchmark"))
+        {
+            // Decodes every texture the loaded scene requested a few times on the job pool, results show up once done
+            if (m_decodeBenchmarkReady.exchange(false, stltype::memory_order_acquire))
+            {
+                m_decodeBenchmark = stltype::move(m_pendingDecodeBenchmark);
+                m_pendingDecodeBenchmark = {};
+                m_isDecodeBenchmarkRunning = false;
+            }
+            if (m_isDecodeBenchmarkRunning)
+            {
+                ImGui::Text("Decoding scene textures...");
+            }
+            else if (ImGui::Button("Run on scene textures"))
+            {
+                stltype::vector<stltype::string> filePaths;
+                for (const auto& request : g_pTexManager->GetRequestHistory())
+                {
+                    filePaths.push_back(request.normalizedPath);
+                }
+                m_isDecodeBenchmarkRunning = true;
+                g_pJobPool->Submit(
+                    [this, filePaths = stltype::move(filePaths)]()
+                    {
+                        m_pendingDecodeBenchmark = ImageDecoding::RunDecodeBenchmark(filePaths);
+                        m_decodeBenchmarkReady.store(true, stltype::memory_order_release);
+                    },
+                    &m_decodeBenchmarkJobs);
+            }
+            for (const auto& entry : m_decodeBenchmark)
+            {
+                if (entry.imageCount == 0)
+                    continue;
+                ImGui::Separator();
+                ImGui::Text("%s: %u images, %.1f MB",
+                            entry.decoderName.c_str(),
+                            entry.imageCount,
+                            static_cast<f32>(entry.sourceBytes) / (1024.0f * 1024.0f));
+                ImGui::Text("Decode: %.2f ms (%.1f MTexels/s)",
+                            entry.decodeTimeMs,
+                            entry.texelCount / (entry.decodeTimeMs * 1000.0));
+                ImGui::Text("Reference: %.2f ms, %.2fx",
+                            entry.referenceTimeMs,
+                            entry.referenceTimeMs / entry.decodeTimeMs);
+            }
+        }
+
         if (m_lastState.dlssSupported && ImGui::CollapsingHeader("NVIDIA DLSS & Streamline Diagnostics"))
         {
             const auto debugState = Nvidia::StreamlineManager::GetDLSSDebugState();
@@ -450,6 +609,14 @@ private:
     };
 
     RendererState m_lastState;
+    TextureRequestCacheBenchmark m_requestCacheBenchmark{};
+    GPUAllocatorBenchmark m_allocatorBenchmark{};
+    stltype::vector<ImageDecoding::DecodeBenchmarkEntry> m_decodeBenchmark;
+    // Written by the benchmark job, handed over to m_decodeBenchmark once m_decodeBenchmarkReady is set
+    stltype::vector<ImageDecoding::DecodeBenchmarkEntry> m_pendingDecodeBenchmark;
+    stltype::atomic<bool> m_decodeBenchmarkReady{false};
+    bool m_isDecodeBenchmarkRunning{false};
+    ThreadPool::JobGroup m_decodeBenchmarkJobs;
     stltype::hash_map<stltype::string, PassAvgData> m_avgPassTimings;
     f32 m_avgTotalGPUTime{0.f};
     u32 m_frameCount{0};
@@ -66,6 +66,56 @@ public:
                                     state.renderState.debugFlags, (u32)DebugFlags::CullFrustum, debugCulling);
                             });
                     }
+                    if (debugCulling)
+                    {
+                        ImGui::Text("Meshlets (CPU reference): %u, %u frustum culled, %u backface culled, %u "
+                                    "triangles visible",
+                                    renderState.meshletCount,
+                                    renderState.frustumCulledMeshletCount,
+                                    renderState.backfaceCulledMeshletCount,
+                                    renderState.visibleMeshletTriangleCount);
+                    }
+
+                    f32 lodPixelError = renderState.lodPixelError;
+                    if (ImGui::SliderFloat("LOD Pixel Error", &lodPixelError, 0.1f, 10.0f))
+                    {
+                        g_pApplicationState->RegisterUpdateFunction(
+                            [lodPixelError](ApplicationState& state) { state.renderState.lodPixelError = lodPixelError; });
+                    }
+
+                    f32 lodHysteresis = renderState.lodHysteresis;
+                    if (ImGui::SliderFloat("LOD Hysteresis", &lodHysteresis, 0.0f, 0.9f))
+                    {
+                        g_pApplicationState->RegisterUpdateFunction(
+                            [lodHysteresis](ApplicationState& state) { state.renderState.lodHysteresis = lodHysteresis; });
+                    }
+
+                    bool textureStreaming = renderState.textureStreaming;
+                    if (ImGui::Checkbox("Texture Streaming", &textureStreaming))
+                    {
+                        g_pApplicationState->RegisterUpdateFunction(
+                            [textureStreaming](ApplicationState& state)
+                            { state.renderState.textureStreaming = textureStreaming; });
+                    }
+                    s32 streamingBudgetMB = (s32)renderState.textureStreamingBudgetMB;
+                    if (ImGui::SliderInt("Texture Streaming Budget (MB)", &streamingBudgetMB, 64, 8192))
+                    {
+                        g_pApplicationState->RegisterUpdateFunction(
+                            [streamingBudgetMB](ApplicationState& state)
+                            { state.renderState.textureStreamingBudgetMB = (u32)streamingBudgetMB; });
+                    }
+                    s32 uploadBudgetMB = (s32)renderState.textureUploadBudgetMB;
+                    if (ImGui::SliderInt("Texture Upload Budget (MB/frame)", &uploadBudgetMB, 1, 256))
+                    {
+                        g_pApplicationState->RegisterUpdateFunction(
+                            [uploadBudgetMB](ApplicationState& state)
+                            { state.renderState.textureUploadBudgetMB = (u32)uploadBudgetMB; });
+                    }
+                    ImGui::Text("Streamed textures: %u, %u loading, %.1f MB resident, %.1f MB wanted",
+                                renderState.streamedTextureCount,
+                                renderState.pendingTextureStreamingLoads,
+                                renderState.textureStreamingResidentBytes / (1024.0 * 1024.0),
+                                renderState.textureStreamingWantedBytes / (1024.0 * 1024.0));
 
                     if (ImGui::Button("Hot Reload Shaders", ImVec2(-FLT_MIN, 30.0f)))
                     {